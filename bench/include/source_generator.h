@@ -0,0 +1,57 @@
+#ifndef NICO_SOURCE_GENERATOR_H
+#define NICO_SOURCE_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nico {
+
+/**
+ * @brief Options for generating a synthetic Nico program.
+ */
+struct SourceGeneratorOptions {
+    // The approximate size of the program in bytes. Whole namespaces are
+    // generated until the program is at least this large.
+    size_t target_size = 8 * 1024 * 1024;
+    // How many namespaces are nested inside each top-level namespace.
+    size_t namespace_depth = 6;
+    // The number of functions in the innermost namespace.
+    size_t funcs_per_namespace = 40;
+    // The number of elements in each array literal.
+    size_t array_length = 64;
+    // The number of terms in each long expression.
+    size_t expression_terms = 48;
+    // The seed for the random choices of numbers and operators.
+    uint32_t seed = 1;
+};
+
+/**
+ * @brief A generated program.
+ */
+struct GeneratedSource {
+    // The source code.
+    std::string code;
+    // The number of statements in the source code, including nested ones.
+    size_t num_statements = 0;
+};
+
+/**
+ * @brief Generates a large, valid Nico program for benchmarking the front end.
+ *
+ * The program is made of top-level namespaces. Each one nests
+ * `namespace_depth` namespaces, and the innermost holds functions with big
+ * array literals, long arithmetic expressions, and conditionals. Each
+ * top-level namespace is followed by a table of constants at the top level.
+ *
+ * The output depends only on the options, so runs with the same options are
+ * comparable.
+ *
+ * @param options The options for the program.
+ * @return The generated program.
+ */
+GeneratedSource generate_source(const SourceGeneratorOptions& options);
+
+} // namespace nico
+
+#endif // NICO_SOURCE_GENERATOR_H
@@ -0,0 +1,389 @@
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "nico/frontend/components/lexer.h"
+#include "nico/frontend/components/parser.h"
+#include "nico/frontend/utils/char_scan.h"
+#include "nico/frontend/utils/frontend_context.h"
+#include "nico/shared/code_file.h"
+#include "nico/shared/diagnostics.h"
+#include "nico/shared/status.h"
+
+#include "source_generator.h"
+
+// The total number of bytes allocated through operator new. Only ever
+// increases, so the bytes allocated by a phase are the difference between
+// readings before and after it.
+static std::atomic<size_t> bytes_allocated{0};
+
+void* operator new(size_t size) {
+    bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size > 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+/**
+ * @brief The results of the fastest run of a phase.
+ */
+struct PhaseResult {
+    // The wall time of the fastest run, in seconds.
+    double seconds = 0;
+    // The bytes allocated during the fastest run.
+    size_t bytes = 0;
+
+    /**
+     * @brief Records a run, keeping it if it is the fastest so far.
+     */
+    void add_run(double run_seconds, size_t run_bytes) {
+        if (seconds == 0 || run_seconds < seconds) {
+            seconds = run_seconds;
+            bytes = run_bytes;
+        }
+    }
+};
+
+/**
+ * @brief Parses a positive integer option value.
+ *
+ * @return True if the value was parsed, false otherwise.
+ */
+static bool parse_count(std::string_view value, size_t& out) {
+    auto [end, ec] =
+        std::from_chars(value.data(), value.data() + value.size(), out);
+    return !value.empty() && ec == std::errc() &&
+           end == value.data() + value.size() && out > 0;
+}
+
+/**
+ * @brief Generates a table of constants, with a mix of bases, underscores,
+ * signs, and suffixes, so that most of the parser's time is spent on number
+ * literals.
+ *
+ * @param num_literals Set to the number of literals in the source.
+ * @return The source code.
+ */
+static std::string number_source(size_t& num_literals) {
+    std::string src;
+    num_literals = 0;
+    for (size_t i = 0; i < 20000; i++) {
+        src += "let table_" + std::to_string(i) + " = [";
+        src += std::to_string(i * 7919) + ", ";
+        src += "-" + std::to_string(i % 1000) + "_000, ";
+        src += "0x" + std::to_string(i % 10000) + "_u32, ";
+        src += std::to_string(i) + ".5e3, ";
+        src += "1_000_000_000_000_i64]\n";
+        num_literals += 5;
+    }
+    return src;
+}
+
+/**
+ * @brief Generates long chains of operators at every precedence level, so that
+ * most of the parser's time is spent on infix operators.
+ *
+ * @param num_operators Set to the number of operators in the source.
+ * @return The source code.
+ */
+static std::string operator_source(size_t& num_operators) {
+    std::string src;
+    num_operators = 0;
+    for (size_t i = 0; i < 5000; i++) {
+        src += "x_" + std::to_string(i) + " = ";
+        for (size_t j = 0; j < 10; j++) {
+            src += "a * " + std::to_string(j) + " + b - c / 2 < d and e == "
+                   "f or g as i32 >= h % 3";
+            src += j < 9 ? " or " : "\n";
+        }
+        // Eleven operators per term, nine `or`s between terms, and the `=`.
+        num_operators += 10 * 11 + 9 + 1;
+    }
+    return src;
+}
+
+/**
+ * @brief Generates source with long identifiers, deep indentation, comments,
+ * and strings, the parts that the vectorized scanning functions speed up.
+ *
+ * @return The source code.
+ */
+static std::string scanning_source() {
+    std::string src;
+    for (size_t i = 0; i < 20000; i++) {
+        src += "func compute_value_" + std::to_string(i) +
+               "(first_argument: i32, second_argument: i32) -> i32:\n";
+        src += "        // Adds the two arguments and prints a message.\n";
+        src += "        /* The message is printed for every call. */\n";
+        src += "        printout \"computing the sum of both arguments\\n\"\n";
+        src += "        return first_argument + second_argument\n";
+    }
+    return src;
+}
+
+/**
+ * @brief Times parsing a source, excluding scanning.
+ *
+ * @return The fastest parse in seconds, or 0 if the source failed to parse.
+ */
+static double
+time_parse(const std::shared_ptr<nico::CodeFile>& file, size_t runs) {
+    PhaseResult parse;
+    for (size_t run = 0; run < runs; run++) {
+        auto context = std::make_unique<nico::FrontendContext>();
+        nico::Lexer::scan(context, file);
+        auto start = std::chrono::steady_clock::now();
+        nico::Parser::parse(context);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        parse.add_run(elapsed.count(), 0);
+        if (!IS_VARIANT(context->status, nico::Status::Ok)) {
+            return 0;
+        }
+    }
+    return parse.seconds;
+}
+
+/**
+ * @brief Times scanning a source with the current instruction set.
+ *
+ * @param num_threads The number of threads to scan on. 1 scans serially.
+ * @return The fastest scan in seconds.
+ */
+static double time_scan(
+    const std::shared_ptr<nico::CodeFile>& file,
+    size_t runs,
+    unsigned num_threads
+) {
+    PhaseResult lex;
+    for (size_t run = 0; run < runs; run++) {
+        auto context = std::make_unique<nico::FrontendContext>();
+        auto start = std::chrono::steady_clock::now();
+        if (num_threads > 1) {
+            nico::Lexer::scan_parallel(context, file, num_threads);
+        }
+        else {
+            nico::Lexer::scan(context, file);
+        }
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        lex.add_run(elapsed.count(), 0);
+    }
+    return lex.seconds;
+}
+
+/**
+ * @brief Runs the focused benchmarks, each on a small program that exercises
+ * one part of the front end.
+ *
+ * @return The exit code for the benchmark.
+ */
+static int run_focused(size_t runs) {
+    std::cout << std::fixed << std::setprecision(2);
+
+    size_t num_literals;
+    auto file = std::make_shared<nico::CodeFile>(
+        number_source(num_literals),
+        "<generated>"
+    );
+    double seconds = time_parse(file, runs);
+    if (seconds == 0) {
+        std::cerr << "The number literal program failed to parse.\n";
+        return 1;
+    }
+    std::cout << "Number literals: " << num_literals / seconds / 1e6
+              << " M literals/s\n";
+
+    size_t num_operators;
+    file = std::make_shared<nico::CodeFile>(
+        operator_source(num_operators),
+        "<generated>"
+    );
+    seconds = time_parse(file, runs);
+    if (seconds == 0) {
+        std::cerr << "The infix operator program failed to parse.\n";
+        return 1;
+    }
+    std::cout << "Infix operators: " << num_operators / seconds / 1e6
+              << " M operators/s\n";
+
+    using nico::char_scan::Isa;
+    file = std::make_shared<nico::CodeFile>(scanning_source(), "<generated>");
+    size_t size = file->src_code().size();
+    Isa best = nico::char_scan::best_supported_isa();
+    const char* isa_names[] = {"Scalar", "SSE2", "AVX2"};
+    for (Isa isa : {Isa::Scalar, Isa::SSE2, Isa::AVX2}) {
+        if (nico::char_scan::set_isa(isa) != isa) {
+            continue;
+        }
+        seconds = time_scan(file, runs, 1);
+        std::cout << "Scanning (" << isa_names[static_cast<int>(isa)]
+                  << "): " << size / seconds / 1e6 << " MB/s\n";
+    }
+    nico::char_scan::set_isa(best);
+
+    for (unsigned threads : {2u, 4u, std::thread::hardware_concurrency()}) {
+        seconds = time_scan(file, runs, threads);
+        std::cout << "Scanning (" << threads
+                  << " threads): " << size / seconds / 1e6 << " MB/s\n";
+    }
+    return 0;
+}
+
+static void print_usage(std::ostream& out) {
+    out << R"(Usage: nico_bench [options]
+
+Generates a large synthetic Nico program, then scans and parses it several
+times, reporting the fastest run of each phase. With --focused, instead times
+small programs that each exercise one part of the front end: number literals,
+infix operators, and scanning with each instruction set and thread count.
+
+Options:
+  --size=<MiB>          Generate about <MiB> mebibytes of source. (Default: 8)
+  --runs=<n>            Scan and parse <n> times. (Default: 5)
+  --depth=<n>           Nest <n> namespaces in each top-level namespace.
+                        (Default: 6)
+  --lex-threads=<n>     Scan on <n> threads. (Default: 1)
+  --parse-threads=<n>   Parse on <n> threads. (Default: 1)
+  --output=<file>       Also write the generated program to <file>.
+  --focused             Run the focused benchmarks instead.
+  --help                Show this message.
+)";
+}
+
+int main(int argc, char** argv) {
+    nico::SourceGeneratorOptions gen_options;
+    size_t runs = 5;
+    size_t lex_threads = 1;
+    size_t parse_threads = 1;
+    std::string output_path;
+    bool focused = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        size_t value = 0;
+        if (arg == "--help") {
+            print_usage(std::cout);
+            return 0;
+        }
+        else if (arg.starts_with("--size=") &&
+                 parse_count(arg.substr(7), value)) {
+            gen_options.target_size = value * 1024 * 1024;
+        }
+        else if (arg.starts_with("--runs=") &&
+                 parse_count(arg.substr(7), value)) {
+            runs = value;
+        }
+        else if (arg.starts_with("--depth=") &&
+                 parse_count(arg.substr(8), value)) {
+            gen_options.namespace_depth = value;
+        }
+        else if (arg.starts_with("--lex-threads=") &&
+                 parse_count(arg.substr(14), value)) {
+            lex_threads = value;
+        }
+        else if (arg.starts_with("--parse-threads=") &&
+                 parse_count(arg.substr(16), value)) {
+            parse_threads = value;
+        }
+        else if (arg.starts_with("--output=") && arg.size() > 9) {
+            output_path = arg.substr(9);
+        }
+        else if (arg == "--focused") {
+            focused = true;
+        }
+        else {
+            std::cerr << "Invalid option '" << arg << "'.\n";
+            print_usage(std::cerr);
+            return 64;
+        }
+    }
+
+    if (focused) {
+        return run_focused(runs);
+    }
+
+    auto source = nico::generate_source(gen_options);
+    if (!output_path.empty()) {
+        std::ofstream out(output_path);
+        out << source.code;
+    }
+    size_t source_size = source.code.size();
+    auto file =
+        std::make_shared<nico::CodeFile>(std::move(source.code), "<generated>");
+
+    PhaseResult lex;
+    PhaseResult parse;
+    size_t num_tokens = 0;
+    for (size_t run = 0; run < runs; run++) {
+        // Creating the context sets up LLVM, which is not part of either
+        // phase.
+        auto context = std::make_unique<nico::FrontendContext>();
+
+        size_t bytes_before = bytes_allocated.load();
+        auto start = std::chrono::steady_clock::now();
+        if (lex_threads > 1) {
+            nico::Lexer::scan_parallel(context, file, lex_threads);
+        }
+        else {
+            nico::Lexer::scan(context, file);
+        }
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        lex.add_run(elapsed.count(), bytes_allocated.load() - bytes_before);
+        if (!IS_VARIANT(context->status, nico::Status::Ok)) {
+            std::cerr << "The generated program failed to scan.\n";
+            return 1;
+        }
+        num_tokens = context->scanned_tokens.size();
+
+        bytes_before = bytes_allocated.load();
+        start = std::chrono::steady_clock::now();
+        if (parse_threads > 1) {
+            nico::Parser::parse_parallel(context, parse_threads);
+        }
+        else {
+            nico::Parser::parse(context);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        parse.add_run(elapsed.count(), bytes_allocated.load() - bytes_before);
+        if (!IS_VARIANT(context->status, nico::Status::Ok)) {
+            std::cerr << "The generated program failed to parse.\n";
+            return 1;
+        }
+        nico::Diagnostics::inst().reset();
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Source: " << source_size / (1024.0 * 1024.0) << " MiB, "
+              << num_tokens << " tokens, " << source.num_statements
+              << " statements\n";
+    std::cout << "Lexer::scan:   " << lex.seconds * 1e3 << " ms, "
+              << num_tokens / lex.seconds / 1e6 << " M tokens/s, "
+              << static_cast<double>(lex.bytes) / num_tokens
+              << " bytes allocated/token\n";
+    std::cout << "Parser::parse: " << parse.seconds * 1e3 << " ms, "
+              << source.num_statements / parse.seconds / 1e3
+              << " K statements/s, "
+              << static_cast<double>(parse.bytes) / num_tokens
+              << " bytes allocated/token\n";
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include "source_generator.h"
+
+#include <random>
+#include <string>
+#include <utility>
+
+namespace nico {
+
+/**
+ * @brief Writes generated code, keeping count of the statements written.
+ */
+class SourceWriter {
+    const SourceGeneratorOptions& options;
+    std::mt19937 rng;
+    GeneratedSource result;
+    // The number of functions written so far, used to name them.
+    size_t num_funcs = 0;
+    // The number of namespaces written so far, used to name them.
+    size_t num_namespaces = 0;
+
+    /**
+     * @brief Picks a random number in the range [lo, hi].
+     *
+     * The standard distributions differ between standard libraries, so the
+     * engine's output, which does not, is used directly.
+     */
+    uint32_t random(uint32_t lo, uint32_t hi) {
+        return lo + static_cast<uint32_t>(rng() % (hi - lo + 1));
+    }
+
+    /**
+     * @brief Starts a new line with the given indentation level.
+     */
+    void line(size_t level) {
+        result.code += '\n';
+        result.code.append(level * 4, ' ');
+    }
+
+    /**
+     * @brief Writes an integer literal in a random base and format.
+     */
+    void int_literal() {
+        uint32_t value = random(0, 1'000'000);
+        switch (random(0, 3)) {
+        case 0:
+            result.code += std::to_string(value);
+            break;
+        case 1:
+            result.code += std::to_string(value / 1000) + "_" +
+                           std::to_string(1000 + value % 1000).substr(1);
+            break;
+        case 2: {
+            static const char* digits = "0123456789ABCDEF";
+            std::string hex;
+            do {
+                hex.insert(hex.begin(), digits[value % 16]);
+                value /= 16;
+            } while (value > 0);
+            result.code += "0x" + hex;
+            break;
+        }
+        default:
+            result.code += "-" + std::to_string(value % 1000);
+            break;
+        }
+    }
+
+    /**
+     * @brief Writes an array literal of integers.
+     */
+    void array_literal() {
+        result.code += '[';
+        for (size_t i = 0; i < options.array_length; i++) {
+            if (i > 0) {
+                result.code += ", ";
+            }
+            int_literal();
+        }
+        result.code += ']';
+    }
+
+    /**
+     * @brief Writes a long arithmetic expression of the parameters and
+     * literals.
+     */
+    void long_expression() {
+        static const char* operators[] = {" + ", " - ", " * "};
+        for (size_t i = 0; i < options.expression_terms; i++) {
+            if (i > 0) {
+                result.code += operators[random(0, 2)];
+            }
+            switch (random(0, 3)) {
+            case 0:
+                result.code += "a";
+                break;
+            case 1:
+                result.code += "b";
+                break;
+            case 2:
+                result.code += "(a - " + std::to_string(random(1, 99)) + ")";
+                break;
+            default:
+                result.code += std::to_string(random(1, 9999));
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Writes a function with an array, a long expression, and a
+     * conditional.
+     */
+    void func(size_t level) {
+        line(level);
+        result.code += "func f_" + std::to_string(num_funcs++) +
+                       "(a: i32, b: i32) -> i32:";
+        line(level + 1);
+        result.code += "let values = ";
+        array_literal();
+        line(level + 1);
+        result.code += "let x = ";
+        long_expression();
+        line(level + 1);
+        result.code += "if x > " + std::to_string(random(0, 9999)) + ":";
+        line(level + 2);
+        result.code += "return x / " + std::to_string(random(1, 99));
+        line(level + 1);
+        result.code += "return x + values[" +
+                       std::to_string(random(0, options.array_length - 1)) +
+                       "]";
+        // The function, two lets, the if, and two returns.
+        result.num_statements += 6;
+    }
+
+    /**
+     * @brief Writes a namespace, nesting further namespaces until the given
+     * depth, and then functions.
+     */
+    void namespace_block(size_t level, size_t depth) {
+        line(level);
+        result.code +=
+            "namespace ns_" + std::to_string(num_namespaces++) + ":";
+        result.num_statements++;
+        if (depth > 0) {
+            namespace_block(level + 1, depth - 1);
+            return;
+        }
+        for (size_t i = 0; i < options.funcs_per_namespace; i++) {
+            func(level + 1);
+        }
+    }
+
+    /**
+     * @brief Writes a table of constants at the top level.
+     */
+    void table() {
+        line(0);
+        result.code += "let table_" + std::to_string(num_namespaces) + " = ";
+        array_literal();
+        result.num_statements++;
+    }
+
+public:
+    SourceWriter(const SourceGeneratorOptions& options)
+        : options(options), rng(options.seed) {}
+
+    /**
+     * @brief Generates the program.
+     *
+     * @return The generated program.
+     */
+    GeneratedSource generate() {
+        result.code.reserve(options.target_size + options.target_size / 8);
+        result.code += "// Generated by nico_bench.";
+        while (result.code.size() < options.target_size) {
+            namespace_block(0, options.namespace_depth);
+            table();
+        }
+        result.code += '\n';
+        return std::move(result);
+    }
+};
+
+GeneratedSource generate_source(const SourceGeneratorOptions& options) {
+    return SourceWriter(options).generate();
+}
+
+} // namespace nico
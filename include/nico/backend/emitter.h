@@ -1,7 +1,10 @@
 #ifndef NICO_EMITTER_H
 #define NICO_EMITTER_H
 
+#include <optional>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include <llvm/IR/Module.h>
 
@@ -23,11 +26,44 @@ public:
      * context, and target machine.
      * @param target_destination A string specifying the target destination for
      * the object file. E.g. "./bin/output.o". Paths are relative to CWD.
+     * @return True if the object file was emitted successfully, false
+     * otherwise. On failure, an error is reported to the Diagnostics singleton.
      */
-    void emit(
+    bool emit(
         const IRModuleContext& mod_ctx,
         std::string_view target_destination = "output.o"
     );
+
+    /**
+     * @brief Emit the IR module to several object files, generating code for
+     * each on its own thread.
+     *
+     * The module is split into `num_parts` parts, and each part is compiled by
+     * its own target machine. The object files, when linked together, are
+     * equivalent to the single object file produced by `emit`.
+     *
+     * The first part is written to `target_destination`. Each other part `i`
+     * is written next to it, with `.i` inserted before the extension. E.g.
+     * "output.o", "output.1.o", "output.2.o".
+     *
+     * The module may be modified by splitting, so it should not be used after
+     * this call.
+     *
+     * @param mod_ctx The IRModuleContext object containing the LLVM module,
+     * context, and target machine.
+     * @param target_destination A string specifying the target destination for
+     * the first object file. Paths are relative to CWD.
+     * @param num_parts The number of parts, and threads, to split the module
+     * into. Must be at least 1.
+     * @return The paths of the object files if they were emitted successfully,
+     * std::nullopt otherwise. On failure, an error is reported to the
+     * Diagnostics singleton, and any object files already created are removed.
+     */
+    std::optional<std::vector<std::string>> emit_split(
+        const IRModuleContext& mod_ctx,
+        std::string_view target_destination,
+        unsigned num_parts
+    );
 };
 
 } // namespace nico
@@ -2,15 +2,23 @@
 #define NICO_JIT_H
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <vector>
 
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Passes/OptimizationLevel.h>
 #include <llvm/Support/Error.h>
 
+#include "nico/backend/object_cache.h"
+#include "nico/backend/perf_map_listener.h"
 #include "nico/shared/ir_module_context.h"
+#include "nico/shared/target_spec.h"
 
 namespace nico {
 
@@ -86,6 +94,35 @@ public:
      * @brief Resets the JIT to its initial state, clearing all added modules.
      */
     virtual void reset() = 0;
+
+    /**
+     * @brief Sets the optimization level applied to modules added to the JIT.
+     *
+     * Only modules added after this call are affected. O0 disables
+     * optimization entirely, which keeps startup latency low for short
+     * programs.
+     *
+     * @param opt_level The optimization level to use.
+     */
+    virtual void set_opt_level(llvm::OptimizationLevel opt_level) = 0;
+};
+
+/**
+ * @brief Options for configuring a JIT.
+ */
+struct JITOptions {
+    // The optimization level applied to modules added to the JIT.
+    llvm::OptimizationLevel opt_level = llvm::OptimizationLevel::O0;
+    // The target to compile for. Defaults to the host.
+    TargetSpec target_spec;
+    // The directory of the on-disk object cache, or std::nullopt to disable
+    // caching. See `ObjectFileCache` for which modules are cached.
+    std::optional<std::string> cache_dir = std::nullopt;
+    // The number of threads to compile on. 0 compiles on the calling thread.
+    unsigned num_compile_threads = 0;
+    // Whether to register JIT-compiled code with profilers and debuggers. See
+    // `SimpleJIT` for details.
+    bool enable_profiling = false;
 };
 
 /**
@@ -93,24 +130,159 @@ public:
  *
  * This class provides a basic JIT compiler that can add modules and look up
  * symbols.
+ *
+ * Optimization is applied through LLJIT's IR transform layer, so each module
+ * is optimized just before it is compiled to machine code.
+ *
+ * The LLJIT instance and the optimizer create their target machines from the
+ * same target spec, so optimized code makes use of the target's CPU features.
+ *
+ * If a cache directory is set, compiled objects are stored in an
+ * `ObjectFileCache`. Modules found in the cache skip both the optimizer and
+ * the backend.
+ *
+ * If two or more compile threads are set, large modules are split into
+ * independent parts, each with its own LLVM context. The parts are optimized
+ * and compiled concurrently the first time a symbol is looked up.
+ *
+ * If profiling is enabled, compiled objects are linked with RuntimeDyld so
+ * that JIT event listeners can be registered. Code is registered with GDB,
+ * with perf through `PerfMapListener`, and through LLVM's perf JIT event
+ * listener if LLVM was built with perf support.
  */
 class SimpleJIT : public IJIT {
 protected:
+    // The minimum number of instructions in each part of a split module.
+    // Smaller parts are not worth the overhead of splitting.
+    static constexpr size_t MIN_INSTRUCTIONS_PER_PART = 2000;
+
+    // The options this JIT was created with. The optimization level may be
+    // changed later with `set_opt_level`.
+    JITOptions options;
+    // The object cache, if caching is enabled.
+    std::unique_ptr<ObjectFileCache> object_cache;
+    // The perf map listener, if profiling is enabled. Declared before `jit` so
+    // that it outlives the object linking layer it is registered with.
+    std::unique_ptr<PerfMapListener> perf_map_listener;
+    // The target machine builder for the current LLJIT instance.
+    std::optional<llvm::orc::JITTargetMachineBuilder> target_machine_builder;
     // LLJIT instance for managing JIT compilation.
     std::unique_ptr<llvm::orc::LLJIT> jit;
+    // Functions defined by split modules that have not been compiled yet.
+    std::vector<std::string> pending_functions;
+    // The number of modules split so far, used to keep local names unique.
+    size_t split_count = 0;
 
     llvm::Error add_module(llvm::orc::ThreadSafeModule tsm) override;
 
     llvm::Expected<llvm::orc::ExecutorAddr>
     lookup(std::string_view name) override;
 
+    /**
+     * @brief Creates a new LLJIT instance, replacing the current one.
+     *
+     * The instance is built for the target spec using `build_jit`, and its IR
+     * transform layer is set up according to the current optimization level.
+     */
+    void create_jit();
+
+    /**
+     * @brief Builds a new LLJIT instance.
+     *
+     * Subclasses may override this to build a different kind of LLJIT.
+     *
+     * @param jtmb The target machine builder to build the LLJIT with.
+     * @return The new LLJIT instance, or an error if it could not be built.
+     */
+    virtual llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>>
+    build_jit(llvm::orc::JITTargetMachineBuilder jtmb);
+
+    /**
+     * @brief Creates a compile function that compiles modules through the
+     * object cache.
+     *
+     * If compile threads are enabled, the compile function creates a target
+     * machine for each module, since target machines are not thread-safe.
+     *
+     * @return The compile function creator to give to an LLJIT builder.
+     *
+     * @warning The object cache must be enabled.
+     */
+    llvm::orc::LLJITBuilderState::CompileFunctionCreator
+    make_cached_compile_function_creator();
+
+    /**
+     * @brief Creates an object linking layer that notifies the profiling JIT
+     * event listeners of each loaded object.
+     *
+     * JITLink, LLJIT's default linker on most platforms, does not support JIT
+     * event listeners, so the layer uses RuntimeDyld instead.
+     *
+     * @return The object linking layer creator to give to an LLJIT builder.
+     *
+     * @warning Profiling must be enabled.
+     */
+    llvm::orc::LLJITBuilderState::ObjectLinkingLayerCreator
+    make_profiling_object_linking_layer_creator();
+
+    /**
+     * @brief Splits a module into parts that can be compiled concurrently.
+     *
+     * Each part is given its own LLVM context so that parts do not contend for
+     * a shared context lock. Local symbols are renamed so that they stay unique
+     * once they are made external by the split.
+     *
+     * The names of all functions defined by the parts are added to
+     * `pending_functions`.
+     *
+     * @param tsm The module to split.
+     * @param num_parts The number of parts to split the module into.
+     * @return The parts, or an error if a part could not be moved to its own
+     * context.
+     */
+    llvm::Expected<std::vector<llvm::orc::ThreadSafeModule>>
+    split_module(llvm::orc::ThreadSafeModule tsm, unsigned num_parts);
+
+    /**
+     * @brief Compiles all pending functions at once.
+     *
+     * Looking up all functions in a single lookup lets ORC dispatch every
+     * part to the compile thread pool, rather than compiling the parts one by
+     * one as they are reached from the entry point.
+     *
+     * @return An Error indicating success or failure of the operation.
+     */
+    llvm::Error compile_pending_functions();
+
+    // A tag to select the constructor that does not create the LLJIT.
+    struct DeferCreation {};
+
+    /**
+     * @brief Construct a new SimpleJIT object without creating the LLJIT
+     * instance.
+     *
+     * Virtual functions called from a base class constructor do not dispatch
+     * to the subclass, so subclasses that override `build_jit` use this
+     * constructor and call `create_jit` from their own constructor.
+     *
+     * @param options The options to configure the JIT with.
+     */
+    SimpleJIT(const JITOptions& options, DeferCreation);
+
 public:
     virtual ~SimpleJIT() = default;
 
-    SimpleJIT();
+    /**
+     * @brief Construct a new SimpleJIT object.
+     *
+     * @param options The options to configure the JIT with.
+     */
+    SimpleJIT(const JITOptions& options = JITOptions());
 
     void reset() override;
 
+    void set_opt_level(llvm::OptimizationLevel opt_level) override;
+
     /**
      * @brief Adds a static library to the JIT.
      *
@@ -128,6 +300,36 @@ public:
     llvm::Error add_static_library(const std::string& lib_path);
 };
 
+/**
+ * @brief A JIT implementation that compiles each function on its first call,
+ * using LLVM's LLLazyJIT.
+ *
+ * Each function in an added module is replaced by a stub. When a stub is
+ * first called, only the function it stands for is optimized and compiled
+ * to machine code. As a result, startup time scales with the code that is
+ * actually executed rather than with the size of the program.
+ *
+ * Functions are compiled individually, so the optimizer cannot inline across
+ * them. Objects for individual functions are not stored in the object cache.
+ */
+class LazyJIT : public SimpleJIT {
+protected:
+    llvm::Error add_module(llvm::orc::ThreadSafeModule tsm) override;
+
+    llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>>
+    build_jit(llvm::orc::JITTargetMachineBuilder jtmb) override;
+
+public:
+    virtual ~LazyJIT() = default;
+
+    /**
+     * @brief Construct a new LazyJIT object.
+     *
+     * @param options The options to configure the JIT with.
+     */
+    LazyJIT(const JITOptions& options = JITOptions());
+};
+
 } // namespace nico
 
 #endif // NICO_JIT_H
@@ -0,0 +1,123 @@
+#ifndef NICO_OBJECT_CACHE_H
+#define NICO_OBJECT_CACHE_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include "nico/shared/code_file.h"
+
+namespace nico {
+
+/**
+ * @brief An on-disk cache of object files compiled by the JIT.
+ *
+ * Objects are stored in a cache directory under a key derived from the
+ * source file, the compiler version, the code generation options, and the
+ * target.
+ * When a module with a known key is added to the JIT again, the cached object
+ * is loaded instead of running the optimizer and backend.
+ *
+ * A module opts in to caching by having its module identifier set to a key
+ * created by `make_key`. Modules with any other identifier are never cached.
+ * This includes REPL modules and the per-function modules that the lazy JIT
+ * splits a keyed module into.
+ */
+class ObjectFileCache : public llvm::ObjectCache {
+    // The directory in which cached objects are stored.
+    const std::string cache_dir;
+
+    /**
+     * @brief Gets the path of the cached object file for a module.
+     *
+     * @param module The module to get the path for.
+     * @return The path of the cached object file, or an empty string if the
+     * module does not have a cache key.
+     */
+    std::string get_object_path(const llvm::Module* module) const;
+
+public:
+    // The prefix of all cache keys.
+    static constexpr std::string_view KEY_PREFIX = "nico-obj-";
+    // The length of all cache keys: the prefix followed by a SHA-256 in hex.
+    static constexpr size_t KEY_LENGTH = KEY_PREFIX.size() + 64;
+
+    /**
+     * @brief Construct a new ObjectFileCache object.
+     *
+     * The cache directory is created when the first object is stored.
+     *
+     * @param cache_dir The directory in which to store cached objects.
+     */
+    ObjectFileCache(std::string_view cache_dir)
+        : cache_dir(cache_dir) {}
+
+    /**
+     * @brief Creates a cache key for a module.
+     *
+     * The key is a hash of the compiler version and build, the source code
+     * and path of the file, whether panics are recoverable, the optimization
+     * level, and the target triple, CPU, and features of the target machine.
+     * The build is identified by the LLVM version and the running executable,
+     * so objects cached by an older build of the compiler are not reused. The
+     * path is included because panic messages in the module name the file.
+     *
+     * @param code_file The code file that the module was generated from.
+     * @param panic_recoverable Whether the module was generated with
+     * recoverable panics.
+     * @param opt_level The optimization level that the module is compiled at.
+     * @param target_machine The target machine that the module is compiled
+     * for.
+     * @return The cache key.
+     */
+    static std::string make_key(
+        const CodeFile& code_file,
+        bool panic_recoverable,
+        llvm::OptimizationLevel opt_level,
+        const llvm::TargetMachine& target_machine
+    );
+
+    /**
+     * @brief Gets the default cache directory.
+     *
+     * This is `$XDG_CACHE_HOME/nico` if `XDG_CACHE_HOME` is set,
+     * `$HOME/.cache/nico` if `HOME` is set, or `.nico_cache` in the CWD
+     * otherwise.
+     *
+     * @return The default cache directory.
+     */
+    static std::string default_cache_dir();
+
+    /**
+     * @brief Checks if a module has a cache key, i.e. has opted in to caching.
+     *
+     * @param module The module to check.
+     * @return True if the module's identifier is a cache key, false otherwise.
+     */
+    static bool has_key(const llvm::Module* module);
+
+    /**
+     * @brief Checks if an object for the module is in the cache.
+     *
+     * @param module The module to check.
+     * @return True if a cached object exists for the module, false otherwise.
+     */
+    bool contains(const llvm::Module* module) const;
+
+    void notifyObjectCompiled(
+        const llvm::Module* module, llvm::MemoryBufferRef object
+    ) override;
+
+    std::unique_ptr<llvm::MemoryBuffer>
+    getObject(const llvm::Module* module) override;
+};
+
+} // namespace nico
+
+#endif // NICO_OBJECT_CACHE_H
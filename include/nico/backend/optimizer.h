@@ -5,6 +5,7 @@
 
 #include <llvm/IR/Module.h>
 #include <llvm/Passes/PassBuilder.h>
+#include <llvm/Target/TargetMachine.h>
 
 namespace nico {
 
@@ -13,9 +14,28 @@ namespace nico {
  *
  * Optimization helps remove unnecessary code and make the code more efficient.
  * This may be unnecessary for some applications, such as JIT-compilation.
+ *
+ * If a target machine is provided, passes such as the loop and SLP vectorizers
+ * use its cost model, allowing them to make use of target-specific
+ * instructions (e.g., AVX2). Otherwise, a generic cost model is used.
  */
 class Optimizer {
+    // The target machine that the module will be compiled for, or nullptr if
+    // unknown.
+    llvm::TargetMachine* target_machine = nullptr;
+
 public:
+    Optimizer() = default;
+
+    /**
+     * @brief Construct a new Optimizer object for a specific target.
+     *
+     * @param target_machine The target machine that the module will be
+     * compiled for. Must outlive the optimizer.
+     */
+    Optimizer(llvm::TargetMachine* target_machine)
+        : target_machine(target_machine) {}
+
     /**
      * @brief Optimizes the given IR module.
      *
@@ -28,6 +48,20 @@ public:
         std::unique_ptr<llvm::Module>& ir_module,
         llvm::OptimizationLevel opt_level = llvm::OptimizationLevel::O2
     );
+
+    /**
+     * @brief Optimizes the given IR module in place.
+     *
+     * This overload is useful when the module is not owned by the caller, such
+     * as when it is being transformed inside the JIT.
+     *
+     * @param ir_module The IR module to optimize.
+     * @param opt_level The optimization level to use. Defaults to O2.
+     */
+    void optimize(
+        llvm::Module& ir_module,
+        llvm::OptimizationLevel opt_level = llvm::OptimizationLevel::O2
+    );
 };
 
 } // namespace nico
@@ -0,0 +1,68 @@
+#ifndef NICO_PERF_MAP_LISTENER_H
+#define NICO_PERF_MAP_LISTENER_H
+
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/ExecutionEngine/RuntimeDyld.h>
+#include <llvm/Object/ObjectFile.h>
+
+namespace nico {
+
+/**
+ * @brief A JIT event listener that writes the address of each JIT-compiled
+ * function to a perf map file.
+ *
+ * `perf report` reads `/tmp/perf-<pid>.map` to name samples that fall in
+ * anonymous memory, so with this listener registered, samples in JIT-compiled
+ * code are attributed to `$script`, user functions, and so on. Panic blocks
+ * are part of the function they panic from, so their samples are attributed
+ * to that function.
+ *
+ * Unlike LLVM's perf JIT event listener, this does not require LLVM to be
+ * built with perf support, nor a `perf inject` step.
+ */
+class PerfMapListener : public llvm::JITEventListener {
+    // Guards the map file, since objects may be loaded on several threads.
+    std::mutex mutex;
+    // The path of the perf map file.
+    const std::string path;
+    // The perf map file, opened for appending.
+    std::ofstream map_file;
+
+public:
+    /**
+     * @brief Construct a new PerfMapListener object.
+     *
+     * @param path The path of the perf map file. Default is the path that perf
+     * looks for, given by `default_map_path`.
+     */
+    PerfMapListener(const std::string& path = default_map_path());
+
+    /**
+     * @brief Gets the path that perf looks for the current process's map
+     * file at.
+     *
+     * @return The string "/tmp/perf-<pid>.map".
+     */
+    static std::string default_map_path();
+
+    /**
+     * @brief Gets the path of the perf map file.
+     *
+     * @return The path of the perf map file.
+     */
+    const std::string& get_path() const { return path; }
+
+    void notifyObjectLoaded(
+        ObjectKey key,
+        const llvm::object::ObjectFile& obj,
+        const llvm::RuntimeDyld::LoadedObjectInfo& info
+    ) override;
+};
+
+} // namespace nico
+
+#endif // NICO_PERF_MAP_LISTENER_H
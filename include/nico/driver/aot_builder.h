@@ -0,0 +1,30 @@
+#ifndef NICO_AOT_BUILDER_H
+#define NICO_AOT_BUILDER_H
+
+#include "nico/driver/driver_options.h"
+
+namespace nico {
+
+/**
+ * @brief Compiles a source file ahead of time into an executable.
+ *
+ * The file is run through the frontend, optimized at the given level, emitted
+ * as an object file, and linked into an executable using the system C
+ * compiler. The compiler used for linking is `cc` unless the `CC` environment
+ * variable is set, in which case it is split into words at spaces. The
+ * compiler is run directly rather than through the shell, so paths are passed
+ * to it as is.
+ *
+ * The intermediate object file is written next to the executable and removed
+ * once linking is complete.
+ *
+ * If any step fails, an error is printed and the program exits.
+ *
+ * @param options The driver options. The input file, output file,
+ * optimization level, and target spec are used.
+ */
+void compile_and_build(const DriverOptions& options);
+
+} // namespace nico
+
+#endif // NICO_AOT_BUILDER_H
@@ -0,0 +1,76 @@
+#ifndef NICO_COMPILE_SERVER_H
+#define NICO_COMPILE_SERVER_H
+
+#include <optional>
+#include <string>
+
+#include "nico/driver/driver_options.h"
+
+namespace nico {
+
+/**
+ * @brief Gets the default path of the compile server's socket.
+ *
+ * The socket is placed in `$XDG_RUNTIME_DIR` if it is set, and in /tmp
+ * otherwise. The name includes the user ID so that users do not share a
+ * server.
+ *
+ * @return The default socket path.
+ */
+std::string default_socket_path();
+
+/**
+ * @brief Runs a compile server until the process is terminated.
+ *
+ * The server keeps a warm front end and JIT, configured by the server's
+ * options, so that LLVM's targets are initialized and the front end's LLVM
+ * context, module, and target machine and the JIT are created before any
+ * request arrives.
+ *
+ * Each request is handled in a forked process that inherits a copy of the warm
+ * instances. There is a single warm front end and JIT; forking gives each
+ * request its own copy rather than drawing from a pool. Requests are therefore
+ * handled concurrently, and a request that panics or crashes cannot take down
+ * the server. The request's program runs with the client's stdin, stdout, and
+ * stderr, and in the client's working directory. The request's phase report,
+ * if asked for with `--time-phases`, is printed to the client's stderr.
+ *
+ * If the request's JIT options differ from the server's, other than the
+ * optimization level, a new JIT is created for that request. A new JIT is
+ * also created for every request if the server's options use compile threads,
+ * since threads do not survive a fork.
+ *
+ * The socket is only accessible to the user that started the server, since
+ * requests run arbitrary code as that user. Connections from other users are
+ * closed without being read.
+ *
+ * @param options The driver options. The socket path and the options used by
+ * `create_jit` are used.
+ * @return The exit code for the driver, if the server could not be started.
+ */
+int serve(const DriverOptions& options);
+
+/**
+ * @brief Runs a file on a compile server.
+ *
+ * The client's working directory, arguments, and standard streams are sent to
+ * the server, which compiles and runs the file.
+ *
+ * The server is only used if its socket is owned by the current user with
+ * mode 0600 and the server runs as the current user, since it receives the
+ * client's standard streams.
+ *
+ * @param options The driver options. The socket path is used.
+ * @param argc The number of arguments the driver was invoked with, including
+ * the program name.
+ * @param argv The arguments the driver was invoked with, including the program
+ * name. These are forwarded to the server.
+ * @return The exit code of the request, or std::nullopt if no trusted
+ * server is listening, in which case the caller should run the file itself.
+ */
+std::optional<int>
+run_on_server(const DriverOptions& options, int argc, const char* const* argv);
+
+} // namespace nico
+
+#endif // NICO_COMPILE_SERVER_H
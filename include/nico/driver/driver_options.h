@@ -0,0 +1,142 @@
+#ifndef NICO_DRIVER_OPTIONS_H
+#define NICO_DRIVER_OPTIONS_H
+
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <llvm/Passes/OptimizationLevel.h>
+
+#include "nico/shared/target_spec.h"
+
+namespace nico {
+
+/**
+ * @brief The mode that the driver should run in.
+ */
+enum class DriverMode {
+    // Start the REPL.
+    Repl,
+    // JIT-compile and run a source file.
+    Run,
+    // Compile a source file ahead of time into an executable.
+    Build,
+    // Serve compile-and-run requests from clients over a local socket.
+    Serve,
+    // Print usage information and exit.
+    Help,
+    // Print version information and exit.
+    Version
+};
+
+/**
+ * @brief How the driver should report the time taken by each compile phase.
+ */
+enum class PhaseTiming {
+    // Do not time phases.
+    Off,
+    // Print a table of phase times to stderr.
+    Text,
+    // Print phase times as JSON to stderr.
+    Json
+};
+
+/**
+ * @brief The options that the driver was invoked with.
+ *
+ * Options are produced by `parse_driver_options` from the command line
+ * arguments and consumed by `main`.
+ */
+struct DriverOptions {
+    // The mode that the driver should run in.
+    DriverMode mode = DriverMode::Repl;
+    // The path to the source file. Empty when in REPL mode.
+    std::string input_file;
+    // The path to the executable produced in build mode.
+    std::string output_file = "a.out";
+    // The optimization level to apply to the generated IR.
+    llvm::OptimizationLevel opt_level = llvm::OptimizationLevel::O0;
+    // The target to generate code for.
+    TargetSpec target_spec;
+    // The directory of the JIT's on-disk object cache, or std::nullopt to
+    // disable caching. Only used in run mode.
+    std::optional<std::string> cache_dir = std::nullopt;
+    // Whether the JIT should compile each function on its first call.
+    bool lazy_jit = false;
+    // The number of threads to compile on. In run mode, this is the number of
+    // JIT compile threads. In build mode, the module is split into this many
+    // parts for code generation. 0 compiles on the main thread.
+    unsigned num_compile_threads = 0;
+    // The number of threads to scan the source file on. 0 or 1 scans
+    // serially.
+    unsigned num_lexer_threads = 0;
+    // The number of threads to parse the source file on. 0 or 1 parses
+    // serially.
+    unsigned num_parser_threads = 0;
+    // Whether to register JIT-compiled code with perf and GDB.
+    bool enable_profiling = false;
+    // How to report the time taken by each compile phase.
+    PhaseTiming time_phases = PhaseTiming::Off;
+    // Whether to run the file on a compile server instead of in this process.
+    // Only used in run mode.
+    bool use_server = false;
+    // The path of the compile server's socket. Empty for the default path.
+    std::string socket_path;
+};
+
+/**
+ * @brief Parses an optimization level flag such as `-O2`.
+ *
+ * Accepted flags are `-O0`, `-O1`, `-O2`, `-O3`, `-Os`, and `-Oz`.
+ *
+ * @param flag The flag to parse, including the leading `-O`.
+ * @return The optimization level, or std::nullopt if the flag is not a valid
+ * optimization level flag.
+ */
+std::optional<llvm::OptimizationLevel> parse_opt_level(std::string_view flag);
+
+/**
+ * @brief Parses the command line arguments passed to the driver.
+ *
+ * The accepted forms are:
+ * - `nico [options]` to start the REPL.
+ * - `nico [options] <file>` to JIT-compile and run a file.
+ * - `nico build [options] <file> [-o <output>]` to build an executable.
+ * - `nico --serve [options]` to start a compile server.
+ *
+ * If the arguments are malformed, a message is printed to `err` and
+ * std::nullopt is returned.
+ *
+ * @param argc The number of arguments, including the program name.
+ * @param argv The arguments, including the program name.
+ * @param err The stream to print errors to. Default is std::cerr.
+ * @return The parsed options, or std::nullopt if the arguments are malformed.
+ */
+std::optional<DriverOptions> parse_driver_options(
+    int argc, const char* const* argv, std::ostream& err = std::cerr
+);
+
+/**
+ * @brief Starts timing compile phases and prints a report of them to stderr
+ * when the process exits.
+ *
+ * The report is printed by a `std::atexit` handler rather than at the end of
+ * `main`, since the driver also exits through `std::exit`, e.g. on a compile
+ * error or when a JIT-compiled program exits. Should be called at most once
+ * per process.
+ *
+ * @param format The format of the report. If Off, nothing is timed.
+ */
+void report_phases_at_exit(PhaseTiming format);
+
+/**
+ * @brief Prints the driver's usage information.
+ *
+ * @param out The stream to print to.
+ */
+void print_usage(std::ostream& out);
+
+} // namespace nico
+
+#endif // NICO_DRIVER_OPTIONS_H
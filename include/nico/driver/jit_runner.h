@@ -1,11 +1,56 @@
 #ifndef NICO_JIT_RUNNER_H
 #define NICO_JIT_RUNNER_H
 
-#include <string_view>
+#include <memory>
+
+#include "nico/backend/jit.h"
+#include "nico/driver/driver_options.h"
+#include "nico/frontend/frontend.h"
 
 namespace nico {
 
-void compile_and_run(std::string_view file_name);
+/**
+ * @brief Creates a JIT configured by the driver options.
+ *
+ * A `LazyJIT` is created if lazy compilation is requested. Otherwise, a
+ * `SimpleJIT` is created.
+ *
+ * @param options The driver options. The optimization level, target spec,
+ * cache directory, and lazy flag are used.
+ * @return The new JIT.
+ */
+std::unique_ptr<IJIT> create_jit(const DriverOptions& options);
+
+/**
+ * @brief Compiles a source file and runs it in the JIT.
+ *
+ * If the file cannot be read or compiled, an error is printed and the program
+ * exits.
+ *
+ * The optimization level is applied in the JIT's IR transform layer. O0
+ * favors startup latency.
+ *
+ * @param options The driver options. The input file, optimization level, and
+ * target spec are used.
+ */
+void compile_and_run(const DriverOptions& options);
+
+/**
+ * @brief Compiles a source file with an existing front end and runs it in an
+ * existing JIT.
+ *
+ * This lets a caller that keeps warm instances around, such as the compile
+ * server, skip creating them. The front end and JIT should be fresh, and
+ * configured for the driver options.
+ *
+ * @param options The driver options. The input file, optimization level, and
+ * cache directory are used.
+ * @param frontend The front end to compile with.
+ * @param jit The JIT to run in.
+ */
+void compile_and_run(
+    const DriverOptions& options, Frontend& frontend, IJIT& jit
+);
 
 } // namespace nico
 
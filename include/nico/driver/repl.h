@@ -6,7 +6,11 @@
 #include <string>
 #include <unordered_map>
 
+#include <llvm/Passes/OptimizationLevel.h>
+
 #include "nico/backend/jit.h"
+#include "nico/driver/driver_options.h"
+#include "nico/driver/jit_runner.h"
 #include "nico/frontend/frontend.h"
 
 namespace nico {
@@ -32,6 +36,14 @@ class REPL {
         Discard,
         // Reset the REPL state.
         Reset,
+        // Disable optimization of subsequent inputs.
+        OptO0,
+        // Optimize subsequent inputs at O1.
+        OptO1,
+        // Optimize subsequent inputs at O2.
+        OptO2,
+        // Optimize subsequent inputs at O3.
+        OptO3,
         // Exit the REPL.
         Exit
     };
@@ -58,7 +70,7 @@ class REPL {
     // The frontend instance for compiling code.
     Frontend frontend;
     // The JIT instance for executing compiled code.
-    std::unique_ptr<IJIT> jit = std::make_unique<SimpleJIT>();
+    std::unique_ptr<IJIT> jit;
     // The current input buffer.
     std::string input;
     // Whether the REPL is in "continue mode" (i.e., waiting for more input to
@@ -68,8 +80,16 @@ class REPL {
     // possibly corrupted).
     bool use_caution = false;
 
-    REPL(std::istream& in = std::cin, std::ostream& out = std::cout)
-        : in(&in), out(&out) {}
+    REPL(
+        std::istream& in = std::cin,
+        std::ostream& out = std::cout,
+        const DriverOptions& options = DriverOptions()
+    )
+        : in(&in),
+          out(&out),
+          jit(create_jit(options)) {
+        frontend.set_target_spec(options.target_spec);
+    }
 
     /**
      * @brief Discards the current input buffer.
@@ -95,6 +115,15 @@ class REPL {
      */
     void reset();
 
+    /**
+     * @brief Sets the optimization level for subsequent inputs.
+     *
+     * Inputs that have already been run are not affected.
+     *
+     * @param opt_level The optimization level to use.
+     */
+    void set_opt_level(llvm::OptimizationLevel opt_level);
+
     /**
      * @brief Prints the REPL version information.
      */
@@ -165,8 +194,14 @@ public:
      *
      * @param in The input stream to read from. Default is std::cin.
      * @param out The output stream to write to. Default is std::cout.
+     * @param options The driver options, which configure the JIT. Default is
+     * the default driver options.
      */
-    static void run(std::istream& in = std::cin, std::ostream& out = std::cout);
+    static void run(
+        std::istream& in = std::cin,
+        std::ostream& out = std::cout,
+        const DriverOptions& options = DriverOptions()
+    );
 };
 
 } // namespace nico
@@ -1,7 +1,6 @@
 #ifndef NICO_CODE_GENERATOR_H
 #define NICO_CODE_GENERATOR_H
 
-#include <any>
 #include <memory>
 
 #include <llvm/IR/IRBuilder.h>
@@ -23,7 +22,8 @@ namespace nico {
  * It does not perform type-checking, it does not check for memory safety, and
  * it does not check for undefined behavior.
  */
-class CodeGenerator : public Stmt::Visitor, public Expr::Visitor {
+class CodeGenerator : public Stmt::Visitor<void>,
+                      public Expr::Visitor<llvm::Value*> {
     // A static counter for generating unique names in REPL mode.
     static int repl_counter;
 
@@ -52,43 +52,43 @@ class CodeGenerator : public Stmt::Visitor, public Expr::Visitor {
         bool repl_mode
     );
 
-    std::any visit(Stmt::Expression* stmt) override;
-    std::any visit(Stmt::Let* stmt) override;
-    std::any visit(Stmt::Static* stmt) override;
-    std::any visit(Stmt::Func* stmt) override;
-    std::any visit(Stmt::Print* stmt) override;
-    std::any visit(Stmt::Dealloc* stmt) override;
-    std::any visit(Stmt::Pass* stmt) override;
-    std::any visit(Stmt::Yield* stmt) override;
-    std::any visit(Stmt::Continue* stmt) override;
-    std::any visit(Stmt::Namespace* stmt) override;
-    std::any visit(Stmt::ExternBlock* stmt) override;
-    std::any visit(Stmt::TypeDef* stmt) override;
-    std::any visit(Stmt::StructDef* stmt) override;
-    std::any visit(Stmt::Field* stmt) override;
-    std::any visit(Stmt::Eof* stmt) override;
+    void visit(Stmt::Expression* stmt) override;
+    void visit(Stmt::Let* stmt) override;
+    void visit(Stmt::Static* stmt) override;
+    void visit(Stmt::Func* stmt) override;
+    void visit(Stmt::Print* stmt) override;
+    void visit(Stmt::Dealloc* stmt) override;
+    void visit(Stmt::Pass* stmt) override;
+    void visit(Stmt::Yield* stmt) override;
+    void visit(Stmt::Continue* stmt) override;
+    void visit(Stmt::Namespace* stmt) override;
+    void visit(Stmt::ExternBlock* stmt) override;
+    void visit(Stmt::TypeDef* stmt) override;
+    void visit(Stmt::StructDef* stmt) override;
+    void visit(Stmt::Field* stmt) override;
+    void visit(Stmt::Eof* stmt) override;
 
-    std::any visit(Expr::Assign* expr, bool as_lvalue) override;
-    std::any visit(Expr::Logical* expr, bool as_lvalue) override;
-    std::any visit(Expr::Binary* expr, bool as_lvalue) override;
-    std::any visit(Expr::Unary* expr, bool as_lvalue) override;
-    std::any visit(Expr::Address* expr, bool as_lvalue) override;
-    std::any visit(Expr::Deref* expr, bool as_lvalue) override;
-    std::any visit(Expr::Cast* expr, bool as_lvalue) override;
-    std::any visit(Expr::Access* expr, bool as_lvalue) override;
-    std::any visit(Expr::Subscript* expr, bool as_lvalue) override;
-    std::any visit(Expr::Call* expr, bool as_lvalue) override;
-    std::any visit(Expr::SizeOf* expr, bool as_lvalue) override;
-    std::any visit(Expr::Alloc* expr, bool as_lvalue) override;
-    std::any visit(Expr::NewInst* expr, bool as_lvalue) override;
-    std::any visit(Expr::NameRef* expr, bool as_lvalue) override;
-    std::any visit(Expr::Literal* expr, bool as_lvalue) override;
-    std::any visit(Expr::Tuple* expr, bool as_lvalue) override;
-    std::any visit(Expr::Array* expr, bool as_lvalue) override;
-    std::any visit(Expr::Object* expr, bool as_lvalue) override;
-    std::any visit(Expr::Block* expr, bool as_lvalue) override;
-    std::any visit(Expr::Conditional* expr, bool as_lvalue) override;
-    std::any visit(Expr::Loop* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Assign* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Logical* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Binary* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Unary* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Address* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Deref* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Cast* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Access* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Subscript* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Call* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::SizeOf* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Alloc* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::NewInst* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::NameRef* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Literal* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Tuple* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Array* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Object* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Block* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Conditional* expr, bool as_lvalue) override;
+    llvm::Value* visit(Expr::Loop* expr, bool as_lvalue) override;
 
     /**
      * @brief Adds C standard library functions to the module that are useful
@@ -1,7 +1,6 @@
 #ifndef NICO_GLOBAL_CHECKER_H
 #define NICO_GLOBAL_CHECKER_H
 
-#include <any>
 #include <memory>
 
 #include "nico/frontend/utils/annotation_checker.h"
@@ -18,7 +17,7 @@ namespace nico {
  * This allows functions and types to be used before they are defined, as long
  * as they are declared somewhere in the global scope.
  */
-class GlobalChecker : public Stmt::Visitor {
+class GlobalChecker : public Stmt::Visitor<void> {
     // The symbol tree used for type checking.
     const std::shared_ptr<SymbolTree> symbol_tree;
     // Whether or not the checker is running in REPL mode.
@@ -33,21 +32,21 @@ class GlobalChecker : public Stmt::Visitor {
         annotation_checker = AnnotationChecker::create(symbol_tree, true);
     };
 
-    std::any visit(Stmt::Expression* stmt) override;
-    std::any visit(Stmt::Let* stmt) override;
-    std::any visit(Stmt::Static* stmt) override;
-    std::any visit(Stmt::Func* stmt) override;
-    std::any visit(Stmt::Print* stmt) override;
-    std::any visit(Stmt::Dealloc* stmt) override;
-    std::any visit(Stmt::Pass* stmt) override;
-    std::any visit(Stmt::Yield* stmt) override;
-    std::any visit(Stmt::Continue* stmt) override;
-    std::any visit(Stmt::Namespace* stmt) override;
-    std::any visit(Stmt::ExternBlock* stmt) override;
-    std::any visit(Stmt::TypeDef* stmt) override;
-    std::any visit(Stmt::StructDef* stmt) override;
-    std::any visit(Stmt::Field* stmt) override;
-    std::any visit(Stmt::Eof* stmt) override;
+    void visit(Stmt::Expression* stmt) override;
+    void visit(Stmt::Let* stmt) override;
+    void visit(Stmt::Static* stmt) override;
+    void visit(Stmt::Func* stmt) override;
+    void visit(Stmt::Print* stmt) override;
+    void visit(Stmt::Dealloc* stmt) override;
+    void visit(Stmt::Pass* stmt) override;
+    void visit(Stmt::Yield* stmt) override;
+    void visit(Stmt::Continue* stmt) override;
+    void visit(Stmt::Namespace* stmt) override;
+    void visit(Stmt::ExternBlock* stmt) override;
+    void visit(Stmt::TypeDef* stmt) override;
+    void visit(Stmt::StructDef* stmt) override;
+    void visit(Stmt::Field* stmt) override;
+    void visit(Stmt::Eof* stmt) override;
 
     /**
      * @brief Type checks the given context at the global level.
@@ -1,15 +1,14 @@
 #ifndef NICO_LEXER_H
 #define NICO_LEXER_H
 
-#include <any>
 #include <memory>
 #include <string_view>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "nico/frontend/utils/frontend_context.h"
+#include "nico/frontend/utils/token_store.h"
 #include "nico/shared/code_file.h"
+#include "nico/shared/error_code.h"
 #include "nico/shared/token.h"
 
 namespace nico {
@@ -18,18 +17,18 @@ namespace nico {
  * @brief A lexer for scanning source code into a list of tokens.
  */
 class Lexer {
-    // A map of keywords to their respective token types.
-    static std::unordered_map<std::string_view, Tok> keywords;
-    // A set of reserved words that cannot be used as identifiers.
-    static std::unordered_set<std::string_view> reserved_words;
-
     // The file being scanned.
     const std::shared_ptr<CodeFile> file;
+    // The source code being scanned. When scanning a chunk of the file in
+    // parallel, this ends at the end of the chunk.
+    std::string_view src;
+    // The store that string literal values are added to.
+    TokenStore& token_store;
     // Whether or not the lexer is in REPL mode.
     const bool repl_mode = false;
 
     // The tokens scanned from the file.
-    std::vector<std::shared_ptr<Token>> tokens;
+    std::vector<Token> tokens;
     // The index of the first character of the current token.
     size_t start = 0;
     // The index of the character from the source currently being considered.
@@ -46,9 +45,55 @@ class Lexer {
     char left_spacing_type = '\0';
     // Whether or not there is an unclosed multi-line comment in REPL mode.
     bool unclosed_comment = false;
+    // Whether diagnostics are held back instead of reported. Set when scanning
+    // a chunk in parallel, since the file is scanned again serially if any
+    // chunk finds an error.
+    bool speculative = false;
+    // Whether an error was found while speculative.
+    bool found_error = false;
+    // In REPL mode, the state at the start of the last whitespace that ends a
+    // line. Its tokens are left empty until the scan ends; only their count is
+    // kept, along with the type of the last one, since a colon may become an
+    // indent after the checkpoint.
+    LexerCheckpoint checkpoint;
+    size_t checkpoint_token_count = 0;
+    Tok checkpoint_last_tok_type = Tok::Unknown;
+
+    Lexer(
+        std::shared_ptr<CodeFile> file,
+        TokenStore& token_store,
+        bool repl_mode = false
+    )
+        : file(file),
+          src(file->src_code()),
+          token_store(token_store),
+          repl_mode(repl_mode) {}
+
+    /**
+     * @brief Reports an error, unless the lexer is speculative.
+     *
+     * @param ec The error code to report.
+     * @param location The location of the error in the source code.
+     * @param message The message to report with the error.
+     */
+    void
+    report_error(Err ec, const Location& location, std::string_view message);
 
-    Lexer(std::shared_ptr<CodeFile> file, bool repl_mode = false)
-        : file(file), repl_mode(repl_mode) {}
+    /**
+     * @brief Reports a note with a location, unless the lexer is speculative.
+     *
+     * @param location The location of the note in the source code.
+     * @param message The message to report with the note.
+     */
+    void report_note(const Location& location, std::string_view message);
+
+    /**
+     * @brief Reports a note without a location, unless the lexer is
+     * speculative.
+     *
+     * @param message The message to report with the note.
+     */
+    void report_note(std::string_view message);
 
     /**
      * @brief Checks if the lexer has reached the end of the source code.
@@ -69,11 +114,10 @@ class Lexer {
      *
      * @param tok_type The type of token to create.
      * @param literal The literal value of the token, if any. Default is an
-     * empty std::any value.
-     * @return A shared pointer to the new token.
+     * empty literal.
+     * @return The new token.
      */
-    std::shared_ptr<Token>
-    make_token(Tok tok_type, std::any literal = std::any()) const;
+    Token make_token(Tok tok_type, Literal literal = Literal()) const;
 
     /**
      * @brief Creates a new token with the provided type and adds it to the list
@@ -83,9 +127,9 @@ class Lexer {
      *
      * @param tok_type The type of token to add.
      * @param literal The literal value of the token, if any. Default is an
-     * empty std::any value.
+     * empty literal.
      */
-    void add_token(Tok tok_type, std::any literal = std::any());
+    void add_token(Tok tok_type, Literal literal = Literal());
 
     /**
      * @brief Peeks at the next character, plus lookahead, without advancing the
@@ -275,6 +319,39 @@ class Lexer {
      */
     void multi_line_comment();
 
+    /**
+     * @brief Saves the lexer's state as the checkpoint, if the whitespace that
+     * starts at the current token ends a line.
+     *
+     * Should be called before consuming the whitespace. Only used in REPL mode.
+     */
+    void save_checkpoint();
+
+    /**
+     * @brief Restores the lexer's state from the context's checkpoint, if the
+     * file continues the input that the checkpoint was taken from.
+     *
+     * The file continues the input if it starts with the input followed by a
+     * newline, which is how the REPL adds lines. Otherwise, the checkpoint is
+     * discarded and the file is scanned from the start.
+     *
+     * @param context The context holding the checkpoint.
+     */
+    void resume_from_checkpoint(std::unique_ptr<FrontendContext>& context);
+
+    /**
+     * @brief Stores the checkpoint in the context, so that the next scan can
+     * resume from it.
+     *
+     * Should be called when a scan in REPL mode pauses for more input. The
+     * tokens before the checkpoint are moved into it. If any errors were found,
+     * the checkpoint is discarded instead, so that the next scan reports them
+     * again.
+     *
+     * @param context The context to store the checkpoint in.
+     */
+    void store_checkpoint(std::unique_ptr<FrontendContext>& context);
+
     /**
      * @brief Scans a token from the source code and adds it to the list of
      * tokens.
@@ -284,6 +361,14 @@ class Lexer {
      */
     void scan_token();
 
+    /**
+     * @brief Adds the tokens that close the input: dedents for any open
+     * indentation, followed by the EOF token.
+     *
+     * If there are unclosed grouping tokens, an error will be logged.
+     */
+    void add_end_tokens();
+
     /**
      * @brief Scans the input file, adding the tokens to
      * the provided context.
@@ -296,6 +381,9 @@ public:
     /**
      * @brief Scans the input file, adding the tokens to the provided context.
      *
+     * In REPL mode, if the context holds a checkpoint from incomplete input
+     * that the file continues, scanning resumes from the checkpoint.
+     *
      * If the context is in an error state, this function will abort.
      *
      * @param context The context to add the tokens to.
@@ -308,6 +396,36 @@ public:
         const std::shared_ptr<CodeFile>& file,
         bool repl_mode = false
     );
+
+    /**
+     * @brief Scans the input file on multiple threads, adding the tokens to the
+     * provided context.
+     *
+     * The file is split before lines that start at column 0 outside of any
+     * grouping tokens or comments. The indentation is fully closed at such a
+     * line, so each chunk can be scanned from a fresh state, and the dedents
+     * before the line come from the chunk before it. The chunks are scanned on
+     * a pool of threads and their tokens are joined in order.
+     *
+     * The result is identical to `scan`. If any chunk finds an error or does
+     * not end in a fresh state, the file is scanned again serially, so that
+     * diagnostics are reported exactly as `scan` would report them. Small files
+     * are always scanned serially.
+     *
+     * If the context is in an error state, this function will abort.
+     *
+     * @param context The context to add the tokens to.
+     * @param file The file to scan.
+     * @param num_threads The number of threads to scan on, including the
+     * calling thread.
+     * @return The number of chunks whose tokens were used. 1 if the file was
+     * scanned serially, including after a chunk's tokens were discarded.
+     */
+    static size_t scan_parallel(
+        std::unique_ptr<FrontendContext>& context,
+        const std::shared_ptr<CodeFile>& file,
+        unsigned num_threads
+    );
 };
 
 } // namespace nico
@@ -1,7 +1,6 @@
 #ifndef NICO_LOCAL_CHECKER_H
 #define NICO_LOCAL_CHECKER_H
 
-#include <any>
 #include <memory>
 
 #include "nico/frontend/utils/annotation_checker.h"
@@ -9,6 +8,7 @@
 #include "nico/frontend/utils/expression_checker.h"
 #include "nico/frontend/utils/frontend_context.h"
 #include "nico/frontend/utils/symbol_tree.h"
+#include "nico/frontend/utils/token_store.h"
 
 namespace nico {
 
@@ -18,9 +18,11 @@ namespace nico {
  * The local type checker checks statements and expressions at the local level,
  * i.e., within functions, blocks, and the main script.
  */
-class LocalChecker : public Stmt::Visitor {
+class LocalChecker : public Stmt::Visitor<void> {
     // The symbol tree used for type checking.
     const std::shared_ptr<SymbolTree> symbol_tree;
+    // The store that tokens created during checking are added to.
+    TokenStore& token_store;
     // Whether or not the checker is running in REPL mode.
     const bool repl_mode = false;
     // The expression checker used for checking expressions.
@@ -29,31 +31,39 @@ class LocalChecker : public Stmt::Visitor {
     std::shared_ptr<AnnotationChecker> annotation_checker;
 
     LocalChecker(
-        std::shared_ptr<SymbolTree> symbol_tree, bool repl_mode = false
+        std::shared_ptr<SymbolTree> symbol_tree,
+        TokenStore& token_store,
+        bool repl_mode = false
     )
-        : symbol_tree(symbol_tree), repl_mode(repl_mode) {
+        : symbol_tree(symbol_tree),
+          token_store(token_store),
+          repl_mode(repl_mode) {
 
-        auto [expr_checker, anno_checker] =
-            ExpressionChecker::create(symbol_tree, this, repl_mode);
+        auto [expr_checker, anno_checker] = ExpressionChecker::create(
+            symbol_tree,
+            token_store,
+            this,
+            repl_mode
+        );
         expression_checker = expr_checker;
         annotation_checker = anno_checker;
     };
 
-    std::any visit(Stmt::Expression* stmt) override;
-    std::any visit(Stmt::Let* stmt) override;
-    std::any visit(Stmt::Static* stmt) override;
-    std::any visit(Stmt::Func* stmt) override;
-    std::any visit(Stmt::Print* stmt) override;
-    std::any visit(Stmt::Dealloc* stmt) override;
-    std::any visit(Stmt::Pass* stmt) override;
-    std::any visit(Stmt::Yield* stmt) override;
-    std::any visit(Stmt::Continue* stmt) override;
-    std::any visit(Stmt::Namespace* stmt) override;
-    std::any visit(Stmt::ExternBlock* stmt) override;
-    std::any visit(Stmt::TypeDef* stmt) override;
-    std::any visit(Stmt::StructDef* stmt) override;
-    std::any visit(Stmt::Field* stmt) override;
-    std::any visit(Stmt::Eof* stmt) override;
+    void visit(Stmt::Expression* stmt) override;
+    void visit(Stmt::Let* stmt) override;
+    void visit(Stmt::Static* stmt) override;
+    void visit(Stmt::Func* stmt) override;
+    void visit(Stmt::Print* stmt) override;
+    void visit(Stmt::Dealloc* stmt) override;
+    void visit(Stmt::Pass* stmt) override;
+    void visit(Stmt::Yield* stmt) override;
+    void visit(Stmt::Continue* stmt) override;
+    void visit(Stmt::Namespace* stmt) override;
+    void visit(Stmt::ExternBlock* stmt) override;
+    void visit(Stmt::TypeDef* stmt) override;
+    void visit(Stmt::StructDef* stmt) override;
+    void visit(Stmt::Field* stmt) override;
+    void visit(Stmt::Eof* stmt) override;
 
     /**
      * @brief Type checks the given context at the local level.
@@ -1,7 +1,6 @@
 #ifndef NICO_MIR_BUILDER_H
 #define NICO_MIR_BUILDER_H
 
-#include <any>
 #include <memory>
 
 #include "nico/frontend/utils/ast_node.h"
@@ -9,7 +8,8 @@
 
 namespace nico {
 
-class MIRBuilder : public Stmt::Visitor, public Expr::Visitor {
+class MIRBuilder : public Stmt::Visitor<void>,
+                   public Expr::Visitor<std::shared_ptr<MIRValue>> {
     // The MIR module to store the built MIR.
     const std::shared_ptr<MIRModule> mir_module;
     // The symbol tree used for type checking.
@@ -25,42 +25,53 @@ class MIRBuilder : public Stmt::Visitor, public Expr::Visitor {
           symbol_tree(symbol_tree),
           current_block(mir_module->get_script_function()->get_entry_block()) {}
 
-    std::any visit(Stmt::Expression* stmt) override;
-    std::any visit(Stmt::Let* stmt) override;
-    std::any visit(Stmt::Static* stmt) override;
-    std::any visit(Stmt::Func* stmt) override;
-    std::any visit(Stmt::Print* stmt) override;
-    std::any visit(Stmt::Dealloc* stmt) override;
-    std::any visit(Stmt::Pass* stmt) override;
-    std::any visit(Stmt::Yield* stmt) override;
-    std::any visit(Stmt::Continue* stmt) override;
-    std::any visit(Stmt::Namespace* stmt) override;
-    std::any visit(Stmt::ExternBlock* stmt) override;
-    std::any visit(Stmt::TypeDef* stmt) override;
-    std::any visit(Stmt::StructDef* stmt) override;
-    std::any visit(Stmt::Field* stmt) override;
-    std::any visit(Stmt::Eof* stmt) override;
+    void visit(Stmt::Expression* stmt) override;
+    void visit(Stmt::Let* stmt) override;
+    void visit(Stmt::Static* stmt) override;
+    void visit(Stmt::Func* stmt) override;
+    void visit(Stmt::Print* stmt) override;
+    void visit(Stmt::Dealloc* stmt) override;
+    void visit(Stmt::Pass* stmt) override;
+    void visit(Stmt::Yield* stmt) override;
+    void visit(Stmt::Continue* stmt) override;
+    void visit(Stmt::Namespace* stmt) override;
+    void visit(Stmt::ExternBlock* stmt) override;
+    void visit(Stmt::TypeDef* stmt) override;
+    void visit(Stmt::StructDef* stmt) override;
+    void visit(Stmt::Field* stmt) override;
+    void visit(Stmt::Eof* stmt) override;
 
-    std::any visit(Expr::Assign* expr, bool as_lvalue) override;
-    std::any visit(Expr::Logical* expr, bool as_lvalue) override;
-    std::any visit(Expr::Binary* expr, bool as_lvalue) override;
-    std::any visit(Expr::Unary* expr, bool as_lvalue) override;
-    std::any visit(Expr::Address* expr, bool as_lvalue) override;
-    std::any visit(Expr::Deref* expr, bool as_lvalue) override;
-    std::any visit(Expr::Cast* expr, bool as_lvalue) override;
-    std::any visit(Expr::Access* expr, bool as_lvalue) override;
-    std::any visit(Expr::Subscript* expr, bool as_lvalue) override;
-    std::any visit(Expr::Call* expr, bool as_lvalue) override;
-    std::any visit(Expr::SizeOf* expr, bool as_lvalue) override;
-    std::any visit(Expr::Alloc* expr, bool as_lvalue) override;
-    std::any visit(Expr::NameRef* expr, bool as_lvalue) override;
-    std::any visit(Expr::Literal* expr, bool as_lvalue) override;
-    std::any visit(Expr::Tuple* expr, bool as_lvalue) override;
-    std::any visit(Expr::Array* expr, bool as_lvalue) override;
-    std::any visit(Expr::Object* expr, bool as_lvalue) override;
-    std::any visit(Expr::Block* expr, bool as_lvalue) override;
-    std::any visit(Expr::Conditional* expr, bool as_lvalue) override;
-    std::any visit(Expr::Loop* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Assign* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Logical* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Binary* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Unary* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Address* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Deref* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Cast* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Access* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Subscript* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Call* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::SizeOf* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Alloc* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::NameRef* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Literal* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Tuple* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Array* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Object* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Block* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue>
+    visit(Expr::Conditional* expr, bool as_lvalue) override;
+    std::shared_ptr<MIRValue> visit(Expr::Loop* expr, bool as_lvalue) override;
 
     void run_build();
 
@@ -1,11 +1,13 @@
 #ifndef NICO_PARSER_H
 #define NICO_PARSER_H
 
-#include <any>
 #include <charconv>
 #include <concepts>
+#include <cstdint>
+#include <initializer_list>
 #include <memory>
 #include <optional>
+#include <string_view>
 #include <system_error>
 #include <utility>
 #include <vector>
@@ -13,16 +15,38 @@
 #include "nico/frontend/utils/ast_node.h"
 #include "nico/frontend/utils/frontend_context.h"
 #include "nico/frontend/utils/nodes.h"
+#include "nico/frontend/utils/token_store.h"
+#include "nico/shared/error_code.h"
 #include "nico/shared/token.h"
 
 namespace nico {
 
+/**
+ * @brief How tightly an infix operator binds to its operands.
+ *
+ * Listed from loosest to tightest. Tokens that are not infix operators have a
+ * binding power of `None`.
+ */
+enum class BindingPower : uint8_t {
+    None,
+    Assignment,
+    Or,
+    And,
+    Equality,
+    Comparison,
+    Term,
+    Factor,
+    Cast
+};
+
 /**
  * @brief A parser to parse a vector of tokens into an abstract syntax tree.
  */
 class Parser {
-    // The vector of tokens to parse.
-    const std::vector<std::shared_ptr<Token>> tokens;
+    // The vector of tokens to parse. Owned by the context's token store.
+    std::vector<Token>& tokens;
+    // The store that tokens created by the parser are added to.
+    TokenStore& token_store;
     // Whether the parser is running in REPL mode.
     const bool repl_mode;
 
@@ -30,12 +54,76 @@ class Parser {
     unsigned current = 0;
     // Whether or not there is an incomplete statement in REPL mode.
     bool incomplete_statement = false;
+    // The last `-` token parsed as a negation. A number literal right after it
+    // is parsed as a negative number.
+    const Token* negation_token = nullptr;
+    // Whether diagnostics are held back instead of reported. Set when parsing
+    // a chunk of top-level statements in parallel, since a chunk with an error
+    // is parsed again serially.
+    bool speculative = false;
+    // Whether an error was found while speculative.
+    bool found_error = false;
+
+    /**
+     * @brief The top-level statements parsed from a chunk of the tokens on
+     * another thread.
+     */
+    struct ParsedChunk {
+        // The index of the chunk's first token.
+        unsigned start = 0;
+        // The index of the token after the last statement parsed. May be past
+        // the end of the chunk if its last statement continued into the next.
+        unsigned end = 0;
+        // The statements parsed, in order.
+        std::vector<std::shared_ptr<Stmt>> stmts;
+        // Whether an error was found, in which case the statements are not
+        // used.
+        bool found_error = false;
+    };
 
     Parser(
-        const std::vector<std::shared_ptr<Token>>&& tokens,
+        std::vector<Token>& tokens,
+        TokenStore& token_store,
         bool repl_mode = false
     )
-        : tokens(std::move(tokens)), repl_mode(repl_mode) {}
+        : tokens(tokens), token_store(token_store), repl_mode(repl_mode) {}
+
+    /**
+     * @brief Reports an error, unless the parser is speculative.
+     *
+     * @param ec The error code to report.
+     * @param location The location of the error in the source code.
+     * @param message The message to report with the error.
+     */
+    void
+    report_error(Err ec, const Location& location, std::string_view message);
+
+    /**
+     * @brief Reports an error with a location pointer, unless the parser is
+     * speculative.
+     *
+     * @param ec The error code to report.
+     * @param location The location of the error in the source code.
+     * @param message The message to report with the error.
+     */
+    void
+    report_error(Err ec, const Location* location, std::string_view message);
+
+    /**
+     * @brief Reports a note with a location, unless the parser is speculative.
+     *
+     * @param location The location of the note in the source code.
+     * @param message The message to report with the note.
+     */
+    void report_note(const Location& location, std::string_view message);
+
+    /**
+     * @brief Reports a note without a location, unless the parser is
+     * speculative.
+     *
+     * @param message The message to report with the note.
+     */
+    void report_note(std::string_view message);
 
     /**
      * @brief Checks if the parser has reached the end of the tokens list.
@@ -53,7 +141,7 @@ class Parser {
      * @return A pointer to the current token. If the parser has reached the end
      * of the tokens list, the last token will be returned instead.
      */
-    const std::shared_ptr<Token>& peek() const;
+    Token* peek() const;
 
     /**
      * @brief Peeks at the previous token.
@@ -61,7 +149,7 @@ class Parser {
      * @return A pointer to the previous token.
      * @warning If there is no previous token, the program will abort.
      */
-    const std::shared_ptr<Token>& previous() const;
+    Token* previous() const;
 
     /**
      * @brief Advances the parser to the next token, returning the token that
@@ -74,7 +162,15 @@ class Parser {
      * reached the end of the tokens list, the last token will be returned
      * instead.
      */
-    const std::shared_ptr<Token>& advance();
+    Token* advance();
+
+    /**
+     * @brief Peeks at the type of the token after the current token.
+     *
+     * @return The type of the token after the current token, or `Tok::Eof` if
+     * there is none.
+     */
+    Tok peek_next_type() const;
 
     /**
      * @brief Checks if the current token's type matches any of the provided
@@ -84,7 +180,7 @@ class Parser {
      * @return True if the current token's type matches any of the provided
      * types. False otherwise.
      */
-    bool match(const std::vector<Tok>& types);
+    bool match(std::initializer_list<Tok> types);
 
     /**
      * @brief Recover from errors that occur while parsing elements in list-like
@@ -124,13 +220,12 @@ class Parser {
      * helps create the `+` token from the `+=` token.
      *
      * @param compound_op The compound assignment operator token.
-     * @return A shared pointer to the binary operator token.
+     * @return A pointer to the binary operator token.
      *
      * @warning If the provided token is not a compound assignment operator,
      * the program will panic.
      */
-    std::shared_ptr<Token>
-    binary_op_from_compound_op(const std::shared_ptr<Token>& compound_op);
+    const Token* binary_op_from_compound_op(const Token* compound_op);
 
     /**
      * @brief Parses an integer from a string view.
@@ -152,7 +247,7 @@ class Parser {
      * @return A pair containing the parsed number and an error code.
      */
     template <std::integral T>
-    std::pair<std::any, std::errc>
+    std::pair<Literal, std::errc>
     parse_number(std::string_view str, int base) {
         T value = T();
         auto [ptr, ec] =
@@ -161,7 +256,7 @@ class Parser {
             // Not all characters were consumed
             ec = std::errc::invalid_argument;
         }
-        return {value, ec};
+        return {Literal::of(value), ec};
     }
 
     /**
@@ -179,7 +274,7 @@ class Parser {
      * @return A pair containing the parsed number and an error code.
      */
     template <std::floating_point T>
-    std::pair<std::any, std::errc> parse_number(std::string_view str) {
+    std::pair<Literal, std::errc> parse_number(std::string_view str) {
         T value = T();
         auto [ptr, ec] =
             std::from_chars(str.data(), str.data() + str.size(), value);
@@ -187,7 +282,7 @@ class Parser {
             // Not all characters were consumed
             ec = std::errc::invalid_argument;
         }
-        return {value, ec};
+        return {Literal::of(value), ec};
     }
 
     /**
@@ -392,86 +487,23 @@ class Parser {
     std::optional<std::shared_ptr<Expr>> unary();
 
     /**
-     * @brief Parses a cast expression.
-     *
-     * Includes `a as T` where `T` is a type annotation.
-     *
-     * @return A shared pointer to the parsed expression, or nullopt if the
-     * expression could not be parsed.
-     */
-    std::optional<std::shared_ptr<Expr>> cast();
-
-    /**
-     * @brief Parses a factor expression.
-     *
-     * Includes `a * b`, `a / b`, `a % b`
-     *
-     * @return A shared pointer to the parsed expression, or nullopt if the
-     * expression could not be parsed.
-     */
-    std::optional<std::shared_ptr<Expr>> factor();
-
-    /**
-     * @brief Parses a term expression.
-     *
-     * Includes `a + b`, `a - b`
+     * @brief Parses a sequence of infix operators and their operands, using
+     * precedence climbing.
      *
-     * @return A shared pointer to the parsed expression, or nullopt if the
-     * expression could not be parsed.
-     */
-    std::optional<std::shared_ptr<Expr>> term();
-
-    /**
-     * @brief Parses a comparison expression.
+     * Each infix operator's binding power is looked up in a table indexed by
+     * its token type. Operators that bind at least as tightly as `min_power`
+     * are consumed; looser operators are left for the caller.
      *
-     * Includes `a < b`, `a > b`, `a <= b`, `a >= b`
+     * Includes assignments (`a = b`, `a += b`), logical operators (`a or b`),
+     * equality, comparison, and arithmetic operators, and casts (`a as T`).
+     * Assignments are right-associative and all other operators are
+     * left-associative.
      *
+     * @param min_power The loosest binding power to consume.
      * @return A shared pointer to the parsed expression, or nullopt if the
      * expression could not be parsed.
      */
-    std::optional<std::shared_ptr<Expr>> comparison();
-
-    /**
-     * @brief Parses an equality expression.
-     *
-     * Includes `a == b`, `a != b`
-     *
-     * @return A shared pointer to the parsed expression, or nullopt if the
-     * expression could not be parsed.
-     */
-    std::optional<std::shared_ptr<Expr>> equality();
-
-    /**
-     * @brief Parses a logical and expression.
-     *
-     * Logical and expressions include `a && b`.
-     *
-     * @return A shared pointer to the parsed expression, or nullopt if the
-     * expression could not be parsed.
-     */
-    std::optional<std::shared_ptr<Expr>> logical_and();
-
-    /**
-     * @brief Parses a logical or expression.
-     *
-     * Logical or expressions include `a || b`.
-     *
-     * @return A shared pointer to the parsed expression, or nullopt if the
-     * expression could not be parsed.
-     */
-    std::optional<std::shared_ptr<Expr>> logical_or();
-
-    /**
-     * @brief Parses an assignment expression.
-     *
-     * Assignment expressions assign an rvalue to an lvalue.
-     * Unlike other binary expressions, assignment expressions are
-     * right-associative and have their own class.
-     *
-     * @return A shared pointer to the parsed expression, or nullopt if the
-     * expression could not be parsed.
-     */
-    std::optional<std::shared_ptr<Expr>> assignment();
+    std::optional<std::shared_ptr<Expr>> infix(BindingPower min_power);
 
     /**
      * @brief Parses an expression.
@@ -687,20 +719,42 @@ class Parser {
      */
     std::optional<std::shared_ptr<Annotation>> annotation();
 
+    /**
+     * @brief Parses a statement at the top level.
+     *
+     * If the statement cannot be parsed, the parser is synchronized to the
+     * start of the next statement.
+     *
+     * @return A shared pointer to the parsed statement, or nullopt if the
+     * statement could not be parsed or is not allowed at the top level.
+     */
+    std::optional<std::shared_ptr<Stmt>> top_level_statement();
+
     /**
      * @brief Parses the vector of tokens contained in the provided context into
      * an AST.
      *
+     * Wherever a chunk parsed in parallel starts at the current token and
+     * found no errors, its statements are taken instead of parsing them again.
+     *
      * Upon success, the parsed AST will be appended to the context's AST.
+     *
+     * @param context The context to append the AST to.
+     * @param chunks Chunks of top-level statements parsed in parallel, in
+     * order. Defaults to none.
      */
-    void run_parse(std::unique_ptr<FrontendContext>& context);
+    void run_parse(
+        std::unique_ptr<FrontendContext>& context,
+        std::vector<ParsedChunk> chunks = {}
+    );
 
 public:
     /**
      * @brief Parses the vector of tokens contained in the provided context into
      * an AST.
      *
-     * The tokens will be moved from the context into the parser.
+     * The tokens will be moved from the context into its token store, where
+     * the AST can refer to them.
      * Upon success, the parsed AST will be appended to the context's AST.
      *
      * @param context The context containing the tokens to parse.
@@ -709,6 +763,32 @@ public:
      */
     static void
     parse(std::unique_ptr<FrontendContext>& context, bool repl_mode = false);
+
+    /**
+     * @brief Parses the vector of tokens contained in the provided context on
+     * multiple threads.
+     *
+     * A pre-pass splits the tokens before statement-starting keywords outside
+     * of any blocks or grouping tokens, i.e. between top-level statements. The
+     * chunks are parsed on a pool of threads, each adding tokens to its own
+     * nested token store, and their statements are appended in source order.
+     *
+     * The result is identical to `parse`. Chunks hold back their diagnostics,
+     * and any chunk that finds an error is parsed again serially, in order, so
+     * that diagnostics are reported exactly as `parse` would report them. Small
+     * inputs are always parsed serially.
+     *
+     * If the context is in an error state, this function will abort.
+     *
+     * @param context The context containing the tokens to parse.
+     * @param num_threads The number of threads to parse on, including the
+     * calling thread.
+     * @warning Parallel parsing does not support REPL mode.
+     */
+    static void parse_parallel(
+        std::unique_ptr<FrontendContext>& context,
+        unsigned num_threads
+    );
 };
 
 } // namespace nico
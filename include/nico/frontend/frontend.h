@@ -8,6 +8,7 @@
 
 #include "nico/frontend/utils/frontend_context.h"
 #include "nico/shared/code_file.h"
+#include "nico/shared/target_spec.h"
 
 namespace nico {
 
@@ -22,6 +23,10 @@ class Frontend {
     bool panic_recoverable = false;
     // A flag to indicate whether IR should be printed just before verification.
     bool ir_printing_enabled = false;
+    // The number of threads to scan files on. 0 or 1 scans serially.
+    unsigned num_lexer_threads = 0;
+    // The number of threads to parse files on. 0 or 1 parses serially.
+    unsigned num_parser_threads = 0;
 
 public:
     Frontend()
@@ -59,6 +64,13 @@ public:
      */
     void set_panic_recoverable(bool value) { panic_recoverable = value; }
 
+    /**
+     * @brief Checks whether the code generator uses panic recovery.
+     *
+     * @return True if panic recovery is enabled, false otherwise.
+     */
+    bool is_panic_recoverable() const { return panic_recoverable; }
+
     /**
      * @brief Sets whether the code generator should print the generated IR just
      * before verification.
@@ -70,6 +82,40 @@ public:
      */
     void set_ir_printing_enabled(bool value) { ir_printing_enabled = value; }
 
+    /**
+     * @brief Sets the number of threads that files should be scanned on.
+     *
+     * Large files are split at top-level lines and scanned in parallel, with
+     * the same result as a serial scan. REPL input is always scanned serially.
+     *
+     * @param value The number of threads. 0 or 1 scans serially.
+     */
+    void set_num_lexer_threads(unsigned value) { num_lexer_threads = value; }
+
+    /**
+     * @brief Sets the number of threads that files should be parsed on.
+     *
+     * Large files are split between top-level statements and parsed in
+     * parallel, with the same result and diagnostics as a serial parse. REPL
+     * input is always parsed serially.
+     *
+     * @param value The number of threads. 0 or 1 parses serially.
+     */
+    void set_num_parser_threads(unsigned value) { num_parser_threads = value; }
+
+    /**
+     * @brief Sets the target that code should be generated for.
+     *
+     * The target affects the data layout of the generated IR, so make sure to
+     * call this function before any code is generated.
+     *
+     * @param target_spec The target to generate code for.
+     */
+    void set_target_spec(const TargetSpec& target_spec) {
+        context->target_spec = target_spec;
+        context->initialize();
+    }
+
     /**
      * @brief Resets the front end to its initial state.
      *
@@ -1,8 +1,8 @@
 #ifndef NICO_ANNOTATION_CHECKER_H
 #define NICO_ANNOTATION_CHECKER_H
 
-#include <any>
 #include <memory>
+#include <optional>
 
 #include "nico/frontend/utils/ast_node.h"
 #include "nico/frontend/utils/expression_checker.h"
@@ -17,10 +17,12 @@ namespace nico {
  * checker without an expression checker.
  * For complete expression checking with annotation checking, use
  * `ExpressionChecker::create` instead.
- *
+ * Visit functions in this class return the checked type, or nullopt if the
+ * annotation is invalid.
  * Visit functions in this class return shared pointers to type nodes.
  */
-class AnnotationChecker : public Annotation::Visitor {
+class AnnotationChecker
+    : public Annotation::Visitor<std::optional<std::shared_ptr<Type>>> {
     // The symbol tree used for type checking.
     std::shared_ptr<SymbolTree> symbol_tree;
     // A weak pointer to the expression checker, used for checking
@@ -36,15 +38,24 @@ class AnnotationChecker : public Annotation::Visitor {
         explicit Private() = default;
     };
 
-    std::any visit(Annotation::NameRef* annotation) override;
-    std::any visit(Annotation::Pointer* annotation) override;
-    std::any visit(Annotation::Nullptr* annotation) override;
-    std::any visit(Annotation::Void* annotation) override;
-    std::any visit(Annotation::Reference* annotation) override;
-    std::any visit(Annotation::Array* annotation) override;
-    std::any visit(Annotation::Object* annotation) override;
-    std::any visit(Annotation::Tuple* annotation) override;
-    std::any visit(Annotation::TypeOf* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::NameRef* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::Pointer* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::Nullptr* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::Void* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::Reference* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::Array* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::Object* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::Tuple* annotation) override;
+    std::optional<std::shared_ptr<Type>>
+    visit(Annotation::TypeOf* annotation) override;
 
 public:
     virtual ~AnnotationChecker() = default;
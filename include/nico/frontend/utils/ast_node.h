@@ -1,7 +1,6 @@
 #ifndef NICO_AST_NODE_H
 #define NICO_AST_NODE_H
 
-#include <any>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,7 +21,12 @@ namespace nico {
  * This class adds no additional members to Stmt.
  * It is used for organizational purposes.
  */
-class Stmt::ITopLevel : virtual public Stmt {};
+class Stmt::ITopLevel : virtual public Stmt {
+public:
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind >= Kind::Static && stmt->kind <= Kind::Continue;
+    }
+};
 
 /**
  * @brief A statement that is allowed inside a struct definition.
@@ -33,7 +37,12 @@ class Stmt::ITopLevel : virtual public Stmt {};
  * such as visibility modifiers.
  *
  */
-class Stmt::IStructAllowed : virtual public Stmt {};
+class Stmt::IStructAllowed : virtual public Stmt {
+public:
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind >= Kind::Field && stmt->kind <= Kind::Eof;
+    }
+};
 
 /**
  * @brief A statement in the AST that is allowed in a region that is strictly
@@ -47,7 +56,12 @@ class Stmt::IStructAllowed : virtual public Stmt {};
  * Stmt::IStructAllowed. It is used for organizational purposes.
  */
 class Stmt::IDeclAllowed : virtual public Stmt::ITopLevel,
-                           virtual public Stmt::IStructAllowed {};
+                           virtual public Stmt::IStructAllowed {
+public:
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind >= Kind::Static && stmt->kind <= Kind::Eof;
+    }
+};
 
 /**
  * @brief A declaration-space allowed statement that has its own binding entry.
@@ -67,6 +81,10 @@ public:
     // A custom symbol for the declaration.
     std::optional<std::string> custom_symbol_opt;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind >= Kind::Static && stmt->kind <= Kind::Func;
+    }
+
     virtual bool apply_modifier(const Modifier& modifier) override;
 };
 
@@ -81,24 +99,33 @@ public:
  * This class adds no additional members to Stmt::ITopLevel.
  * It is used for organizational purposes.
  */
-class Stmt::IExecAllowed : virtual public Stmt::ITopLevel {};
+class Stmt::IExecAllowed : virtual public Stmt::ITopLevel {
+public:
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind >= Kind::Pass && stmt->kind <= Kind::Continue;
+    }
+};
 
 /**
  * @brief An expression statement.
  *
  * Expression statements are statements that consist of an expression.
  */
-class Stmt::Expression : public Stmt::IExecAllowed {
+class Stmt::Expression final : public Stmt::IExecAllowed {
 public:
     // The expression in the statement.
     std::shared_ptr<Expr> expression;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Expression;
+    }
+
     Expression(std::shared_ptr<Expr> expression)
-        : expression(expression) {
+        : Stmt(Kind::Expression), expression(expression) {
         location = expression->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -106,10 +133,10 @@ public:
  *
  * Let statements introduce an execution-space variable into the current scope.
  */
-class Stmt::Let : public Stmt::IExecAllowed {
+class Stmt::Let final : public Stmt::IExecAllowed {
 public:
     // The identifier token.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // The expression in the statement; nullopt if absent.
     std::optional<std::shared_ptr<Expr>> expression;
     // Whether the variable is declared as mutable.
@@ -119,19 +146,24 @@ public:
     // A weak pointer to the binding entry in the symbol table.
     std::weak_ptr<Node::BindingEntry> binding_entry;
 
-    Let(std::shared_ptr<Token> start_token,
-        std::shared_ptr<Token> identifier,
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Let;
+    }
+
+    Let(const Token* start_token,
+        const Token* identifier,
         std::optional<std::shared_ptr<Expr>> expression,
         bool has_var,
         std::optional<std::shared_ptr<Annotation>> annotation)
-        : identifier(identifier),
+        : Stmt(Kind::Let),
+          identifier(identifier),
           expression(expression),
           has_var(has_var),
           annotation(annotation) {
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -140,10 +172,10 @@ public:
  * Static statements introduce a declaration-space variable into the current
  * scope.
  */
-class Stmt::Static : public Stmt::IBindingDecl {
+class Stmt::Static final : public Stmt::IBindingDecl {
 public:
     // The identifier token.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // The expression in the statement; nullopt if absent.
     std::optional<std::shared_ptr<Expr>> expression;
     // Whether the variable is declared as mutable.
@@ -151,21 +183,26 @@ public:
     // The type annotation; should be type-checked, even if not nullopt.
     std::optional<std::shared_ptr<Annotation>> annotation;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Static;
+    }
+
     Static(
-        std::shared_ptr<Token> start_token,
-        std::shared_ptr<Token> identifier,
+        const Token* start_token,
+        const Token* identifier,
         std::optional<std::shared_ptr<Expr>> expression,
         bool has_var,
         std::optional<std::shared_ptr<Annotation>> annotation
     )
-        : identifier(identifier),
+        : Stmt(Kind::Static),
+          identifier(identifier),
           expression(expression),
           has_var(has_var),
           annotation(annotation) {
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -173,7 +210,7 @@ public:
  *
  * Function declarations introduce a new function into the current scope.
  */
-class Stmt::Func : public Stmt::IBindingDecl {
+class Stmt::Func final : public Stmt::IBindingDecl {
 public:
     /**
      * @brief A parameter in a function declaration.
@@ -182,7 +219,7 @@ public:
         // Whether the parameter is declared with `var` or not.
         bool has_var;
         // The identifier token.
-        std::shared_ptr<Token> identifier;
+        const Token* identifier;
         // The type annotation, always required.
         std::shared_ptr<Annotation> annotation;
         // An optional expression for the default value.
@@ -192,7 +229,7 @@ public:
 
         Param(
             bool has_var,
-            std::shared_ptr<Token> identifier,
+            const Token* identifier,
             std::shared_ptr<Annotation> annotation,
             std::optional<std::shared_ptr<Expr>> expression
         )
@@ -202,7 +239,7 @@ public:
               expression(expression) {}
     };
     // The function name token.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // The annotation for the return type.
     std::optional<std::shared_ptr<Annotation>> annotation;
     // The parameters of the function.
@@ -215,15 +252,20 @@ public:
     // extern block.
     std::optional<std::shared_ptr<Expr::Block>> body;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Func;
+    }
+
     Func(
-        std::shared_ptr<Token> start_token,
-        std::shared_ptr<Token> identifier,
+        const Token* start_token,
+        const Token* identifier,
         std::optional<std::shared_ptr<Annotation>> annotation,
         std::vector<Param>&& parameters,
         bool is_variadic,
         std::optional<std::shared_ptr<Expr::Block>> body
     )
-        : identifier(identifier),
+        : Stmt(Kind::Func),
+          identifier(identifier),
           annotation(annotation),
           parameters(std::move(parameters)),
           is_variadic(is_variadic),
@@ -231,7 +273,7 @@ public:
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -240,10 +282,10 @@ public:
  * Namespace declarations introduce a new namespace into the current scope
  * and contain a block of statements that are part of the namespace.
  */
-class Stmt::Namespace : public Stmt::IDeclAllowed {
+class Stmt::Namespace final : public Stmt::IDeclAllowed {
 public:
     // The name of the namespace.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // Whether this namespace is meant to span the entire file (should only
     // be allowed if the current scope is the root scope).
     bool is_file_spanning;
@@ -252,19 +294,24 @@ public:
     // A weak pointer to the namespace node in the symbol tree.
     std::weak_ptr<Node::Namespace> namespace_node;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Namespace;
+    }
+
     Namespace(
-        std::shared_ptr<Token> start_token,
-        std::shared_ptr<Token> identifier,
+        const Token* start_token,
+        const Token* identifier,
         bool is_file_spanning,
         std::vector<std::shared_ptr<Stmt::IDeclAllowed>>&& stmts
     )
-        : identifier(identifier),
+        : Stmt(Kind::Namespace),
+          identifier(identifier),
           is_file_spanning(is_file_spanning),
           stmts(std::move(stmts)) {
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -274,10 +321,10 @@ public:
  * declarations and contain a block of statements that are part of the
  * extern namespace.
  */
-class Stmt::ExternBlock : public Stmt::IDeclAllowed {
+class Stmt::ExternBlock final : public Stmt::IDeclAllowed {
 public:
     // The name of the extern block.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // The ABI for the extern declaration block.
     ABI abi;
     // The declarations in the extern block.
@@ -285,17 +332,24 @@ public:
     // A weak pointer to the extern block node in the symbol tree.
     std::weak_ptr<Node::ExternBlock> extern_block_node;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::ExternBlock;
+    }
+
     ExternBlock(
-        std::shared_ptr<Token> start_token,
-        std::shared_ptr<Token> identifier,
+        const Token* start_token,
+        const Token* identifier,
         std::vector<std::shared_ptr<Stmt::IDeclAllowed>>&& stmts,
         ABI abi = ABI::C
     )
-        : identifier(identifier), abi(abi), stmts(std::move(stmts)) {
+        : Stmt(Kind::ExternBlock),
+          identifier(identifier),
+          abi(abi),
+          stmts(std::move(stmts)) {
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -305,26 +359,30 @@ public:
  * name to a type, creating a new named type. They are analogous to type aliases
  * in other languages.
  */
-class Stmt::TypeDef : public Stmt::IDeclAllowed {
+class Stmt::TypeDef final : public Stmt::IDeclAllowed {
 public:
     // The name of the type being defined.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // The annotation for the type being defined.
     std::shared_ptr<Annotation> annotation;
     // A weak pointer to the type definition node in the symbol tree. To be set
     // during type checking.
     std::weak_ptr<Node::TypeDef> type_def_node;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::TypeDef;
+    }
+
     TypeDef(
-        std::shared_ptr<Token> start_token,
-        std::shared_ptr<Token> identifier,
+        const Token* start_token,
+        const Token* identifier,
         std::shared_ptr<Annotation> annotation
     )
-        : identifier(identifier), annotation(annotation) {
+        : Stmt(Kind::TypeDef), identifier(identifier), annotation(annotation) {
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -333,26 +391,32 @@ public:
  * Struct definition statements introduce a new struct type into the current
  * scope and contain a list of properties that are part of the struct.
  */
-class Stmt::StructDef : public Stmt::IDeclAllowed {
+class Stmt::StructDef final : public Stmt::IDeclAllowed {
 public:
     // The name of the struct.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // The statements in the struct body.
     std::vector<std::shared_ptr<Stmt::IStructAllowed>> stmts;
     // A weak pointer to the struct definition node in the symbol tree. To be
     // set during type checking.
     std::weak_ptr<Node::StructDef> struct_def_node;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::StructDef;
+    }
+
     StructDef(
-        std::shared_ptr<Token> start_token,
-        std::shared_ptr<Token> identifier,
+        const Token* start_token,
+        const Token* identifier,
         std::vector<std::shared_ptr<Stmt::IStructAllowed>>&& stmts
     )
-        : identifier(identifier), stmts(std::move(stmts)) {
+        : Stmt(Kind::StructDef),
+          identifier(identifier),
+          stmts(std::move(stmts)) {
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -360,32 +424,37 @@ public:
  *
  * Field declaration statements introduce a new field into a struct definition.
  */
-class Stmt::Field : public Stmt::IStructAllowed {
+class Stmt::Field final : public Stmt::IStructAllowed {
 public:
     // The mutability of the field.
     Binding::Mutability mutability;
     // The identifier token.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // The type annotation for the field, always required.
     std::shared_ptr<Annotation> annotation;
     // The expression for the field initializer; nullopt if absent.
     std::optional<std::shared_ptr<Expr>> expression;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Field;
+    }
+
     Field(
-        std::shared_ptr<Token> start_token,
+        const Token* start_token,
         Binding::Mutability mutability,
-        std::shared_ptr<Token> identifier,
+        const Token* identifier,
         std::shared_ptr<Annotation> annotation,
         std::optional<std::shared_ptr<Expr>> expression
     )
-        : mutability(mutability),
+        : Stmt(Kind::Field),
+          mutability(mutability),
           identifier(identifier),
           annotation(annotation),
           expression(expression) {
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -394,29 +463,33 @@ public:
  * Since a proper print function is not yet implemented, this is a temporary
  * statement for development and will be removed in the future.
  */
-class Stmt::Print : public Stmt::IExecAllowed {
+class Stmt::Print final : public Stmt::IExecAllowed {
 public:
     // The expressions to print.
     std::vector<std::shared_ptr<Expr>> expressions;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Print;
+    }
+
     Print(
-        std::shared_ptr<Token> start_token,
+        const Token* start_token,
         std::vector<std::shared_ptr<Expr>>&& expressions
     )
-        : expressions(std::move(expressions)) {
+        : Stmt(Kind::Print), expressions(std::move(expressions)) {
 
         location = &start_token->location;
     }
 
     Print(std::vector<std::shared_ptr<Expr>>&& expressions)
-        : expressions(std::move(expressions)) {
+        : Stmt(Kind::Print), expressions(std::move(expressions)) {
         if (this->expressions.empty()) {
             panic("Stmt::Print::Print: expressions cannot be empty.");
         }
         location = this->expressions.at(0)->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -424,19 +497,23 @@ public:
  *
  * Deallocation statements free memory allocated for a given expression.
  */
-class Stmt::Dealloc : public Stmt::IExecAllowed {
+class Stmt::Dealloc final : public Stmt::IExecAllowed {
 public:
     // The expression to deallocate.
     std::shared_ptr<Expr> expression;
 
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Dealloc;
+    }
+
     Dealloc(
-        std::shared_ptr<Token> start_token, std::shared_ptr<Expr> expression
+        const Token* start_token, std::shared_ptr<Expr> expression
     )
-        : expression(expression) {
+        : Stmt(Kind::Dealloc), expression(expression) {
         location = &start_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -451,13 +528,18 @@ public:
  *
  * Pass is allowed in both declaration and execution spaces.
  */
-class Stmt::Pass : public Stmt::IExecAllowed, public Stmt::IDeclAllowed {
+class Stmt::Pass final : public Stmt::IExecAllowed, public Stmt::IDeclAllowed {
 public:
-    Pass(std::shared_ptr<Token> pass_token) {
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Pass;
+    }
+
+    Pass(const Token* pass_token)
+        : Stmt(Kind::Pass) {
         location = &pass_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -466,21 +548,25 @@ public:
  * Yield statements set the value to be yielded by a block expression.
  * They may also be used to break out of loops or return from functions.
  */
-class Stmt::Yield : public Stmt::IExecAllowed {
+class Stmt::Yield final : public Stmt::IExecAllowed {
 public:
     // The token representing the kind of yield (yield, break, return).
-    std::shared_ptr<Token> yield_token;
+    const Token* yield_token;
     // The expression to yield.
     std::shared_ptr<Expr> expression;
     // A weak pointer to the target block expression.
     std::weak_ptr<Expr::Block> target_block;
 
-    Yield(std::shared_ptr<Token> yield_token, std::shared_ptr<Expr> expression)
-        : yield_token(yield_token), expression(expression) {
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Yield;
+    }
+
+    Yield(const Token* yield_token, std::shared_ptr<Expr> expression)
+        : Stmt(Kind::Yield), yield_token(yield_token), expression(expression) {
         location = &yield_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -489,17 +575,21 @@ public:
  * Continue statements skip the current iteration of a loop and proceed to
  * the next iteration.
  */
-class Stmt::Continue : public Stmt::IExecAllowed {
+class Stmt::Continue final : public Stmt::IExecAllowed {
 public:
     // The token representing the continue statement.
-    std::shared_ptr<Token> continue_token;
+    const Token* continue_token;
+
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Continue;
+    }
 
-    Continue(std::shared_ptr<Token> continue_token)
-        : continue_token(continue_token) {
+    Continue(const Token* continue_token)
+        : Stmt(Kind::Continue), continue_token(continue_token) {
         location = &continue_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 /**
@@ -509,11 +599,18 @@ public:
  *
  * EOF is allowed in both declaration and execution spaces.
  */
-class Stmt::Eof : public Stmt::IDeclAllowed, public Stmt::IExecAllowed {
+class Stmt::Eof final : public Stmt::IDeclAllowed, public Stmt::IExecAllowed {
 public:
-    Eof(std::shared_ptr<Token> eof_token) { location = &eof_token->location; }
+    static bool classof(const Stmt* stmt) {
+        return stmt->kind == Kind::Eof;
+    }
+
+    Eof(const Token* eof_token)
+        : Stmt(Kind::Eof) {
+        location = &eof_token->location;
+    }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 };
 
 // MARK: Expressions
@@ -539,6 +636,14 @@ public:
     const Location* error_location = nullptr;
 
     virtual ~IPLValue() = default;
+
+    static bool classof(const Expr* expr) {
+        return expr->kind >= Kind::Deref && expr->kind <= Kind::NameRef;
+    }
+
+protected:
+    IPLValue(Kind kind)
+        : Expr(kind) {}
 };
 
 /**
@@ -553,21 +658,25 @@ public:
     // The left operand expression.
     std::shared_ptr<Expr> left;
     // The operator token.
-    std::shared_ptr<Token> op;
+    const Token* op;
     // The right operand expression.
     std::shared_ptr<Expr> right;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Assign;
+    }
+
     Assign(
         std::shared_ptr<Expr> left,
-        std::shared_ptr<Token> op,
+        const Token* op,
         std::shared_ptr<Expr> right
     )
-        : left(left), op(op), right(right) {
+        : Expr(Kind::Assign), left(left), op(op), right(right) {
         location = &op->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -586,21 +695,25 @@ public:
     // The left operand expression.
     std::shared_ptr<Expr> left;
     // The operator token.
-    std::shared_ptr<Token> op;
+    const Token* op;
     // The right operand expression.
     std::shared_ptr<Expr> right;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Logical;
+    }
+
     Logical(
         std::shared_ptr<Expr> left,
-        std::shared_ptr<Token> op,
+        const Token* op,
         std::shared_ptr<Expr> right
     )
-        : left(left), op(op), right(right) {
+        : Expr(Kind::Logical), left(left), op(op), right(right) {
         location = &op->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -676,24 +789,28 @@ public:
     // The left operand expression.
     std::shared_ptr<Expr> left;
     // The operator token.
-    std::shared_ptr<Token> op;
+    const Token* op;
     // The right operand expression.
     std::shared_ptr<Expr> right;
     // The binary operation to be performed; to be filled in by the type
     // checker.
     Operation operation = Operation::Null;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Binary;
+    }
+
     Binary(
         std::shared_ptr<Expr> left,
-        std::shared_ptr<Token> op,
+        const Token* op,
         std::shared_ptr<Expr> right
     )
-        : left(left), op(op), right(right) {
+        : Expr(Kind::Binary), left(left), op(op), right(right) {
         location = &op->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -706,17 +823,21 @@ public:
 class Expr::Unary : public Expr {
 public:
     // The operator token.
-    std::shared_ptr<Token> op;
+    const Token* op;
     // The operand expression.
     std::shared_ptr<Expr> right;
 
-    Unary(std::shared_ptr<Token> op, std::shared_ptr<Expr> right)
-        : op(op), right(right) {
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Unary;
+    }
+
+    Unary(const Token* op, std::shared_ptr<Expr> right)
+        : Expr(Kind::Unary), op(op), right(right) {
         location = &op->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -732,21 +853,25 @@ public:
 class Expr::Address : public Expr {
 public:
     // The operator token.
-    std::shared_ptr<Token> op;
+    const Token* op;
     // The operand expression.
     std::shared_ptr<Expr> right;
     // Whether the address is of a variable.
     bool has_var;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Address;
+    }
+
     Address(
-        std::shared_ptr<Token> op, std::shared_ptr<Expr> right, bool has_var
+        const Token* op, std::shared_ptr<Expr> right, bool has_var
     )
-        : op(op), right(right), has_var(has_var) {
+        : Expr(Kind::Address), op(op), right(right), has_var(has_var) {
         location = &op->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -759,17 +884,21 @@ public:
 class Expr::Deref : public Expr::IPLValue {
 public:
     // The operator token.
-    std::shared_ptr<Token> op;
+    const Token* op;
     // The operand expression.
     std::shared_ptr<Expr> right;
 
-    Deref(std::shared_ptr<Token> op, std::shared_ptr<Expr> right)
-        : op(op), right(right) {
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Deref;
+    }
+
+    Deref(const Token* op, std::shared_ptr<Expr> right)
+        : IPLValue(Kind::Deref), op(op), right(right) {
         location = &op->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -821,7 +950,7 @@ public:
     // The expression being cast.
     std::shared_ptr<Expr> expression;
     // The 'as' keyword token.
-    std::shared_ptr<Token> as_token;
+    const Token* as_token;
     // The target type annotation.
     std::shared_ptr<Annotation> annotation;
     // The target type in the expression; to be filled in by the type
@@ -831,17 +960,24 @@ public:
     // checker.
     Operation operation = Operation::Null;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Cast;
+    }
+
     Cast(
         std::shared_ptr<Expr> expression,
-        std::shared_ptr<Token> as_token,
+        const Token* as_token,
         std::shared_ptr<Annotation> annotation
     )
-        : expression(expression), as_token(as_token), annotation(annotation) {
+        : Expr(Kind::Cast),
+          expression(expression),
+          as_token(as_token),
+          annotation(annotation) {
         location = &as_token->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -862,21 +998,25 @@ public:
     // The base expression being accessed.
     std::shared_ptr<Expr> left;
     // The token representing the access operator (e.g., dot).
-    std::shared_ptr<Token> op;
+    const Token* op;
     // The token representing the member or index being accessed.
-    std::shared_ptr<Token> right_token;
+    const Token* right_token;
+
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Access;
+    }
 
     Access(
         std::shared_ptr<Expr> left,
-        std::shared_ptr<Token> op,
-        std::shared_ptr<Token> right_token
+        const Token* op,
+        const Token* right_token
     )
-        : left(left), op(op), right_token(right_token) {
+        : IPLValue(Kind::Access), left(left), op(op), right_token(right_token) {
         location = &op->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -894,21 +1034,28 @@ public:
     // The base expression being subscripted.
     std::shared_ptr<Expr> left;
     // The left bracket token.
-    std::shared_ptr<Token> lbracket;
+    const Token* lbracket;
     // The index expression.
     std::shared_ptr<Expr> index;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Subscript;
+    }
+
     Subscript(
         std::shared_ptr<Expr> left,
-        std::shared_ptr<Token> lbracket,
+        const Token* lbracket,
         std::shared_ptr<Expr> index
     )
-        : left(left), lbracket(lbracket), index(index) {
+        : IPLValue(Kind::Subscript),
+          left(left),
+          lbracket(lbracket),
+          index(index) {
         location = &lbracket->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -926,7 +1073,7 @@ public:
     // The callee expression, usually a NameRef for a function.
     std::shared_ptr<Expr> callee;
     // The opening parenthesis of the call.
-    std::shared_ptr<Token> l_paren;
+    const Token* l_paren;
     // The positional arguments that were provided for the call.
     std::vector<std::shared_ptr<Expr>> provided_pos_args;
     // The named arguments that were provided for the call.
@@ -936,21 +1083,26 @@ public:
     // type checker.
     Dictionary<std::string, std::weak_ptr<Expr>> actual_args;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Call;
+    }
+
     Call(
         std::shared_ptr<Expr> callee,
-        std::shared_ptr<Token> l_paren,
+        const Token* l_paren,
         std::vector<std::shared_ptr<Expr>>&& provided_pos_args,
         Dictionary<std::string, std::shared_ptr<Expr>>&& provided_named_args
     )
-        : callee(callee),
+        : Expr(Kind::Call),
+          callee(callee),
           l_paren(l_paren),
           provided_pos_args(std::move(provided_pos_args)),
           provided_named_args(std::move(provided_named_args)) {
         location = &l_paren->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -966,22 +1118,28 @@ public:
 class Expr::SizeOf : public Expr {
 public:
     // The 'sizeof' keyword token.
-    std::shared_ptr<Token> sizeof_token;
+    const Token* sizeof_token;
     // The type annotation whose size is to be determined.
     std::shared_ptr<Annotation> annotation;
     // The type in the expression; to be filled in by the type checker.
     std::shared_ptr<Type> inner_type;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::SizeOf;
+    }
+
     SizeOf(
-        std::shared_ptr<Token> sizeof_token,
+        const Token* sizeof_token,
         std::shared_ptr<Annotation> annotation
     )
-        : sizeof_token(sizeof_token), annotation(annotation) {
+        : Expr(Kind::SizeOf),
+          sizeof_token(sizeof_token),
+          annotation(annotation) {
         location = &sizeof_token->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -999,7 +1157,7 @@ public:
 class Expr::Alloc : public Expr {
 public:
     // The 'alloc' keyword token.
-    std::shared_ptr<Token> alloc_token;
+    const Token* alloc_token;
     // The type annotation for the allocation.
     std::optional<std::shared_ptr<Annotation>> type_annotation;
     // The optional expression to initialize the allocated memory.
@@ -1008,22 +1166,27 @@ public:
     // arrays).
     std::optional<std::shared_ptr<Expr>> amount_expr;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Alloc;
+    }
+
     Alloc(
-        std::shared_ptr<Token> alloc_token,
+        const Token* alloc_token,
         std::optional<std::shared_ptr<Annotation>> type_annotation =
             std::nullopt,
         std::optional<std::shared_ptr<Expr>> expression = std::nullopt,
         std::optional<std::shared_ptr<Expr>> amount_expr = std::nullopt
     )
-        : alloc_token(alloc_token),
+        : Expr(Kind::Alloc),
+          alloc_token(alloc_token),
           type_annotation(type_annotation),
           expression(expression),
           amount_expr(amount_expr) {
         location = &alloc_token->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -1037,7 +1200,7 @@ public:
 class Expr::NewInst : public Expr {
 public:
     // The 'new' keyword token.
-    std::shared_ptr<Token> new_token;
+    const Token* new_token;
     // The type annotation for the new instance.
     std::shared_ptr<Annotation::NameRef> annotation;
     // The named arguments that were provided for the new instance.
@@ -1046,19 +1209,24 @@ public:
     // the type checker.
     Dictionary<std::string, std::weak_ptr<Expr>> actual_args;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::NewInst;
+    }
+
     NewInst(
-        std::shared_ptr<Token> new_token,
+        const Token* new_token,
         std::shared_ptr<Annotation::NameRef> annotation,
         Dictionary<std::string, std::shared_ptr<Expr>>&& provided_args
     )
-        : new_token(new_token),
+        : Expr(Kind::NewInst),
+          new_token(new_token),
           annotation(annotation),
           provided_args(std::move(provided_args)) {
         location = &new_token->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 
     bool is_constant() const override {
@@ -1092,13 +1260,17 @@ public:
     // by the type checker.
     std::weak_ptr<Node::BindingEntry> binding_entry;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::NameRef;
+    }
+
     NameRef(std::shared_ptr<Name> name)
-        : name(name) {
+        : IPLValue(Kind::NameRef), name(name) {
         location = &name->identifier->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -1111,15 +1283,36 @@ public:
 class Expr::Literal : public Expr {
 public:
     // The token representing the literal value.
-    std::shared_ptr<Token> token;
+    const Token* token;
+    // The type of the literal. For number literals, this is resolved by the
+    // parser, e.g. IntDefault becomes Int32, so it may differ from the token's.
+    Tok tok_type;
+    // The value of the literal. For number literals, this is parsed by the
+    // parser, since the lexer does not store it on the token.
+    nico::Literal literal;
+
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Literal;
+    }
+
+    Literal(const Token* token)
+        : Expr(Kind::Literal),
+          token(token),
+          tok_type(token->tok_type),
+          literal(token->literal) {
+        location = &token->location;
+    }
 
-    Literal(std::shared_ptr<Token> token)
-        : token(token) {
+    Literal(const Token* token, Tok tok_type, nico::Literal literal)
+        : Expr(Kind::Literal),
+          token(token),
+          tok_type(tok_type),
+          literal(literal) {
         location = &token->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 
     bool is_constant() const override {
@@ -1139,20 +1332,22 @@ public:
 class Expr::Tuple : public Expr {
 public:
     // The opening parenthesis of the tuple.
-    std::shared_ptr<Token> lparen;
+    const Token* lparen;
     // The elements of the tuple.
     std::vector<std::shared_ptr<Expr>> elements;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind >= Kind::Tuple && expr->kind <= Kind::Unit;
+    }
+
     Tuple(
-        std::shared_ptr<Token> lparen,
+        const Token* lparen,
         std::vector<std::shared_ptr<Expr>>&& elements
     )
-        : lparen(lparen), elements(std::move(elements)) {
-        location = &lparen->location;
-    }
+        : Tuple(Kind::Tuple, lparen, std::move(elements)) {}
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 
     bool is_constant() const override {
@@ -1164,6 +1359,16 @@ public:
         }
         return true;
     }
+
+protected:
+    Tuple(
+        Kind kind,
+        const Token* lparen,
+        std::vector<std::shared_ptr<Expr>>&& elements
+    )
+        : Expr(kind), lparen(lparen), elements(std::move(elements)) {
+        location = &lparen->location;
+    }
 };
 
 /**
@@ -1172,12 +1377,16 @@ public:
  * Used to represent the unit value `()`.
  *
  * A subclass of `Expr::Tuple` with no elements. This class does not
- * override `Expr::Tuple::accept` and can thus be visited as a `Tuple`.
+ * override `Expr::Tuple::dispatch` and can thus be visited as a `Tuple`.
  */
 class Expr::Unit : public Expr::Tuple {
 public:
-    Unit(std::shared_ptr<Token> token)
-        : Tuple(token, {}) {}
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Unit;
+    }
+
+    Unit(const Token* token)
+        : Tuple(Kind::Unit, token, {}) {}
 
     bool is_constant() const override {
         // The unit value is always constant.
@@ -1194,20 +1403,24 @@ public:
 class Expr::Array : public Expr {
 public:
     // The opening square bracket of the array.
-    std::shared_ptr<Token> lsquare;
+    const Token* lsquare;
     // The elements of the array.
     std::vector<std::shared_ptr<Expr>> elements;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Array;
+    }
+
     Array(
-        std::shared_ptr<Token> lsquare,
+        const Token* lsquare,
         std::vector<std::shared_ptr<Expr>>&& elements
     )
-        : lsquare(lsquare), elements(std::move(elements)) {
+        : Expr(Kind::Array), lsquare(lsquare), elements(std::move(elements)) {
         location = &lsquare->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 
     bool is_constant() const override {
@@ -1235,12 +1448,12 @@ public:
      */
     struct Field {
         Binding::Mutability mutability;
-        std::shared_ptr<Token> identifier;
+        const Token* identifier;
         std::shared_ptr<Expr> expression;
 
         Field(
             Binding::Mutability mutability,
-            std::shared_ptr<Token> identifier,
+            const Token* identifier,
             std::shared_ptr<Expr> expression
         )
             : mutability(mutability),
@@ -1251,13 +1464,17 @@ public:
     // The fields of the object.
     std::vector<Field> fields;
 
-    Object(std::shared_ptr<Token> lbrace, std::vector<Field>&& fields)
-        : fields(std::move(fields)) {
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Object;
+    }
+
+    Object(const Token* lbrace, std::vector<Field>&& fields)
+        : Expr(Kind::Object), fields(std::move(fields)) {
         location = &lbrace->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 
     bool is_constant() const override {
@@ -1294,7 +1511,7 @@ public:
     enum class Kind { Plain, Loop, Function };
 
     // The token that opened this block.
-    std::shared_ptr<Token> opening_tok;
+    const Token* opening_tok;
     // The statements contained within the block.
     std::vector<std::shared_ptr<Stmt::IExecAllowed>> statements;
     // An optional label for the block.
@@ -1304,21 +1521,26 @@ public:
     // Whether this block is an unsafe block.
     bool is_unsafe;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Expr::Kind::Block;
+    }
+
     Block(
-        std::shared_ptr<Token> opening_tok,
+        const Token* opening_tok,
         std::vector<std::shared_ptr<Stmt::IExecAllowed>>&& statements,
         Kind kind,
         bool is_unsafe = false
     )
-        : opening_tok(opening_tok),
+        : Expr(Expr::Kind::Block),
+          opening_tok(opening_tok),
           statements(std::move(statements)),
           kind(kind),
           is_unsafe(is_unsafe) {
         location = &opening_tok->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -1330,7 +1552,7 @@ public:
 class Expr::Conditional : public Expr {
 public:
     // The 'if' keyword token.
-    std::shared_ptr<Token> if_kw;
+    const Token* if_kw;
     // The condition expression.
     std::shared_ptr<Expr> condition;
     // The 'then' branch expression.
@@ -1340,14 +1562,19 @@ public:
     // Whether the else branch was implicit (i.e., not explicitly provided).
     bool implicit_else = false;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Conditional;
+    }
+
     Conditional(
-        std::shared_ptr<Token> if_kw,
+        const Token* if_kw,
         std::shared_ptr<Expr> condition,
         std::shared_ptr<Expr> then_branch,
         std::shared_ptr<Expr> else_branch,
         bool implicit_else
     )
-        : if_kw(if_kw),
+        : Expr(Kind::Conditional),
+          if_kw(if_kw),
           condition(condition),
           then_branch(then_branch),
           else_branch(else_branch),
@@ -1355,8 +1582,8 @@ public:
         location = &if_kw->location;
     }
 
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -1369,7 +1596,7 @@ public:
 class Expr::Loop : public Expr {
 public:
     // The 'loop' keyword token.
-    std::shared_ptr<Token> loop_kw;
+    const Token* loop_kw;
     // The body of the loop.
     std::shared_ptr<Expr::Block> body;
     // The condition of the loop, if any.
@@ -1377,20 +1604,25 @@ public:
     // Whether this loop is guaranteed to execute at least once.
     bool loops_once;
 
+    static bool classof(const Expr* expr) {
+        return expr->kind == Kind::Loop;
+    }
+
     Loop(
-        std::shared_ptr<Token> loop_kw,
+        const Token* loop_kw,
         std::shared_ptr<Expr::Block> body,
         std::optional<std::shared_ptr<Expr>> condition,
         bool loops_once
     )
-        : loop_kw(loop_kw),
+        : Expr(Kind::Loop),
+          loop_kw(loop_kw),
           body(body),
           condition(condition),
           loops_once(loops_once) {
         location = &loop_kw->location;
     }
-    std::any accept(Visitor* visitor, bool as_lvalue) override {
-        return visitor->visit(this, as_lvalue);
+    void dispatch(Dispatcher* dispatcher, bool as_lvalue) override {
+        dispatcher->handle(this, as_lvalue);
     }
 };
 
@@ -1412,7 +1644,7 @@ public:
         location = &name->get_location();
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override { return name->to_string(); }
 };
@@ -1432,14 +1664,14 @@ public:
 
     Pointer(
         std::shared_ptr<Annotation> base,
-        std::shared_ptr<Token> at_token,
+        const Token* at_token,
         bool is_mutable = false
     )
         : base(std::move(base)), is_mutable(is_mutable) {
         location = &at_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override {
         return (is_mutable ? "var" : "") + std::string("@") + base->to_string();
@@ -1455,11 +1687,11 @@ public:
  */
 class Annotation::Nullptr : public Annotation {
 public:
-    Nullptr(std::shared_ptr<Token> nullptr_token) {
+    Nullptr(const Token* nullptr_token) {
         location = &nullptr_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override { return "nullptr"; }
 };
@@ -1472,11 +1704,11 @@ public:
  */
 class Annotation::Void : public Annotation {
 public:
-    Void(std::shared_ptr<Token> void_token) {
+    Void(const Token* void_token) {
         location = &void_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override { return "void"; }
 };
@@ -1496,14 +1728,14 @@ public:
 
     Reference(
         std::shared_ptr<Annotation> base,
-        std::shared_ptr<Token> amp_token,
+        const Token* amp_token,
         bool is_mutable = false
     )
         : base(std::move(base)), is_mutable(is_mutable) {
         location = &amp_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override {
         return (is_mutable ? "var" : "") + std::string("&") + base->to_string();
@@ -1524,7 +1756,7 @@ public:
     const std::optional<size_t> size;
 
     Array(
-        std::shared_ptr<Token> l_square_token,
+        const Token* l_square_token,
         std::optional<std::shared_ptr<Annotation>> base = std::nullopt,
         std::optional<size_t> size = std::nullopt
     )
@@ -1532,7 +1764,7 @@ public:
         location = &l_square_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override {
         if (!base.has_value()) {
@@ -1559,13 +1791,13 @@ public:
         // The mutability of the field.
         Binding::Mutability mutability;
         // The token representing the field identifier.
-        std::shared_ptr<Token> identifier;
+        const Token* identifier;
         // The annotation of the field.
         std::shared_ptr<Annotation> annotation;
 
         Field(
             Binding::Mutability mutability,
-            std::shared_ptr<Token> identifier,
+            const Token* identifier,
             std::shared_ptr<Annotation> annotation
         )
             : mutability(mutability),
@@ -1592,12 +1824,12 @@ public:
     // are pairs containing mutability and annotation information.
     const std::vector<Field> fields;
 
-    Object(std::shared_ptr<Token> l_brace_token, std::vector<Field>&& fields)
+    Object(const Token* l_brace_token, std::vector<Field>&& fields)
         : fields(std::move(fields)) {
         location = &l_brace_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override {
         std::string result = "{";
@@ -1626,14 +1858,14 @@ public:
     const std::vector<std::shared_ptr<Annotation>> elements;
 
     Tuple(
-        std::shared_ptr<Token> l_paren_token,
+        const Token* l_paren_token,
         std::vector<std::shared_ptr<Annotation>>&& elements
     )
         : elements(std::move(elements)) {
         location = &l_paren_token->location;
     }
 
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override {
         std::string result = "(";
@@ -1666,12 +1898,12 @@ public:
     const std::shared_ptr<Expr> expression;
 
     TypeOf(
-        std::shared_ptr<Token> typeof_token, std::shared_ptr<Expr> expression
+        const Token* typeof_token, std::shared_ptr<Expr> expression
     )
         : expression(std::move(expression)) {
         location = &typeof_token->location;
     }
-    std::any accept(Visitor* visitor) override { return visitor->visit(this); }
+    void dispatch(Dispatcher* dispatcher) override { dispatcher->handle(this); }
 
     std::string to_string() const override {
         auto [_, line, col] = expression->location->to_tuple();
@@ -0,0 +1,100 @@
+#ifndef NICO_CHAR_SCAN_H
+#define NICO_CHAR_SCAN_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace nico::char_scan {
+
+/**
+ * @brief An instruction set that the scanning functions can use.
+ */
+enum class Isa {
+    // Plain C++, one character at a time.
+    Scalar,
+    // 16 characters at a time using SSE2.
+    SSE2,
+    // 32 characters at a time using AVX2.
+    AVX2
+};
+
+/**
+ * @brief Gets the instruction set that the scanning functions currently use.
+ *
+ * By default, this is the best instruction set supported by the host.
+ *
+ * @return The instruction set in use.
+ */
+Isa get_isa();
+
+/**
+ * @brief Gets the best instruction set supported by the host.
+ *
+ * @return The best supported instruction set.
+ */
+Isa best_supported_isa();
+
+/**
+ * @brief Sets the instruction set that the scanning functions use.
+ *
+ * If the host does not support the instruction set, the best supported
+ * instruction set is used instead. Mainly useful for testing and benchmarking.
+ *
+ * @param isa The instruction set to use.
+ * @return The instruction set that will actually be used.
+ */
+Isa set_isa(Isa isa);
+
+/**
+ * @brief Finds the end of a run of identifier characters.
+ *
+ * Identifier characters are those in the class `[A-Za-z0-9_]`.
+ *
+ * @param src The string to scan.
+ * @param pos The index to start scanning from.
+ * @return The index of the first character at or after `pos` that is not an
+ * identifier character, or `src.size()` if there is none.
+ */
+size_t skip_identifier(std::string_view src, size_t pos);
+
+/**
+ * @brief Finds the end of a run of a repeated character.
+ *
+ * @param src The string to scan.
+ * @param pos The index to start scanning from.
+ * @param c The repeated character, e.g. a space or a tab.
+ * @return The index of the first character at or after `pos` that is not `c`,
+ * or `src.size()` if there is none.
+ */
+size_t skip_run(std::string_view src, size_t pos, char c);
+
+/**
+ * @brief Finds the next occurrence of a character.
+ *
+ * @param src The string to scan.
+ * @param pos The index to start scanning from.
+ * @param c The character to find.
+ * @return The index of the first `c` at or after `pos`, or `src.size()` if
+ * there is none.
+ */
+size_t find_char(std::string_view src, size_t pos, char c);
+
+/**
+ * @brief Finds the next occurrence of any of three characters.
+ *
+ * Used to skip the parts of string literals and comments that need no special
+ * handling, e.g. everything up to the next quote, backslash, or newline.
+ *
+ * @param src The string to scan.
+ * @param pos The index to start scanning from.
+ * @param a The first character to find.
+ * @param b The second character to find.
+ * @param c The third character to find.
+ * @return The index of the first `a`, `b`, or `c` at or after `pos`, or
+ * `src.size()` if there is none.
+ */
+size_t find_first_of(std::string_view src, size_t pos, char a, char b, char c);
+
+} // namespace nico::char_scan
+
+#endif // NICO_CHAR_SCAN_H
@@ -1,7 +1,6 @@
 #ifndef NICO_EXPRESSION_CHECKER_H
 #define NICO_EXPRESSION_CHECKER_H
 
-#include <any>
 #include <memory>
 #include <optional>
 #include <string>
@@ -9,6 +8,7 @@
 
 #include "nico/frontend/utils/ast_node.h"
 #include "nico/frontend/utils/symbol_tree.h"
+#include "nico/frontend/utils/token_store.h"
 #include "nico/frontend/utils/type_node.h"
 #include "nico/shared/dictionary.h"
 
@@ -22,18 +22,22 @@ class AnnotationChecker;
  * During expression checking, expressions are checked for type correctness and
  * other semantic errors.
  *
- * Visit functions in this class return shared pointers to type nodes.
+ * Visit functions in this class set the type of the visited expression, leaving
+ * it null if the expression is invalid.
  */
 class ExpressionChecker
-    : public Expr::Visitor,
+    : public Expr::Visitor<void>,
       public std::enable_shared_from_this<ExpressionChecker> {
     // The symbol tree used for type checking.
     std::shared_ptr<SymbolTree> symbol_tree;
+    // The store that tokens created during checking are added to, e.g. for
+    // implicit dereferences.
+    TokenStore* token_store;
     // The annotation checker used for checking annotations within expressions.
     std::shared_ptr<AnnotationChecker> annotation_checker;
     // The visitor for checking statements. This is used for checking
     // expressions that contain statements, such as blocks and loops.
-    Stmt::Visitor* stmt_visitor;
+    Stmt::Visitor<void>* stmt_visitor;
     // Whether or not the expression checker is currently in REPL mode.
     bool repl_mode;
 
@@ -117,30 +121,30 @@ class ExpressionChecker
     bool check_pointer_cast(
         std::shared_ptr<Type::IPointer> expr_type,
         std::shared_ptr<Type::IPointer> target_type,
-        std::shared_ptr<Token> as_token
+        const Token* as_token
     );
 
-    std::any visit(Expr::Assign* expr, bool as_lvalue) override;
-    std::any visit(Expr::Logical* expr, bool as_lvalue) override;
-    std::any visit(Expr::Binary* expr, bool as_lvalue) override;
-    std::any visit(Expr::Unary* expr, bool as_lvalue) override;
-    std::any visit(Expr::Address* expr, bool as_lvalue) override;
-    std::any visit(Expr::Deref* expr, bool as_lvalue) override;
-    std::any visit(Expr::Cast* expr, bool as_lvalue) override;
-    std::any visit(Expr::Access* expr, bool as_lvalue) override;
-    std::any visit(Expr::Subscript* expr, bool as_lvalue) override;
-    std::any visit(Expr::Call* expr, bool as_lvalue) override;
-    std::any visit(Expr::SizeOf* expr, bool as_lvalue) override;
-    std::any visit(Expr::Alloc* expr, bool as_lvalue) override;
-    std::any visit(Expr::NewInst* expr, bool as_lvalue) override;
-    std::any visit(Expr::NameRef* expr, bool as_lvalue) override;
-    std::any visit(Expr::Literal* expr, bool as_lvalue) override;
-    std::any visit(Expr::Tuple* expr, bool as_lvalue) override;
-    std::any visit(Expr::Array* expr, bool as_lvalue) override;
-    std::any visit(Expr::Object* expr, bool as_lvalue) override;
-    std::any visit(Expr::Block* expr, bool as_lvalue) override;
-    std::any visit(Expr::Conditional* expr, bool as_lvalue) override;
-    std::any visit(Expr::Loop* expr, bool as_lvalue) override;
+    void visit(Expr::Assign* expr, bool as_lvalue) override;
+    void visit(Expr::Logical* expr, bool as_lvalue) override;
+    void visit(Expr::Binary* expr, bool as_lvalue) override;
+    void visit(Expr::Unary* expr, bool as_lvalue) override;
+    void visit(Expr::Address* expr, bool as_lvalue) override;
+    void visit(Expr::Deref* expr, bool as_lvalue) override;
+    void visit(Expr::Cast* expr, bool as_lvalue) override;
+    void visit(Expr::Access* expr, bool as_lvalue) override;
+    void visit(Expr::Subscript* expr, bool as_lvalue) override;
+    void visit(Expr::Call* expr, bool as_lvalue) override;
+    void visit(Expr::SizeOf* expr, bool as_lvalue) override;
+    void visit(Expr::Alloc* expr, bool as_lvalue) override;
+    void visit(Expr::NewInst* expr, bool as_lvalue) override;
+    void visit(Expr::NameRef* expr, bool as_lvalue) override;
+    void visit(Expr::Literal* expr, bool as_lvalue) override;
+    void visit(Expr::Tuple* expr, bool as_lvalue) override;
+    void visit(Expr::Array* expr, bool as_lvalue) override;
+    void visit(Expr::Object* expr, bool as_lvalue) override;
+    void visit(Expr::Block* expr, bool as_lvalue) override;
+    void visit(Expr::Conditional* expr, bool as_lvalue) override;
+    void visit(Expr::Loop* expr, bool as_lvalue) override;
 
 public:
     virtual ~ExpressionChecker() = default;
@@ -154,6 +158,7 @@ public:
      * used for checking annotations within expressions.
      *
      * @param symbol_tree The symbol tree to use for type checking.
+     * @param token_store The store to add tokens created during checking to.
      * @param stmt_visitor The visitor to use for checking statements within
      * expressions.
      * @param repl_mode Whether or not the expression checker is being used in
@@ -166,7 +171,8 @@ public:
         std::shared_ptr<AnnotationChecker>>
     create(
         std::shared_ptr<SymbolTree> symbol_tree,
-        Stmt::Visitor* stmt_visitor,
+        TokenStore& token_store,
+        Stmt::Visitor<void>* stmt_visitor,
         bool repl_mode = false
     );
 
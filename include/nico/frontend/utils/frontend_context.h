@@ -2,6 +2,7 @@
 #define NICO_FRONTEND_CONTEXT_H
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -11,12 +12,41 @@
 #include "nico/frontend/utils/mir.h"
 #include "nico/frontend/utils/nodes.h"
 #include "nico/frontend/utils/symbol_tree.h"
+#include "nico/frontend/utils/token_store.h"
 #include "nico/shared/ir_module_context.h"
 #include "nico/shared/status.h"
+#include "nico/shared/target_spec.h"
 #include "nico/shared/token.h"
 
 namespace nico {
 
+/**
+ * @brief The lexer's state at the start of the last line of incomplete REPL
+ * input.
+ *
+ * When the REPL needs more input, it appends the next line and compiles the
+ * whole input again. Saving the lexer's state lets the next scan resume from
+ * the last line instead of scanning every earlier line again.
+ */
+struct LexerCheckpoint {
+    // The input the checkpoint was taken from.
+    std::shared_ptr<CodeFile> file;
+    // The tokens scanned before the checkpoint.
+    std::vector<Token> tokens;
+    // The index of the character to resume scanning from.
+    size_t position = 0;
+    // The line number at the checkpoint.
+    size_t line = 1;
+    // The lexer's stack of open grouping tokens.
+    std::vector<char> grouping_token_stack;
+    // The lexer's stack of left-spacing indentation levels.
+    std::vector<unsigned> left_spacing_stack;
+    // The left spacing of the line before the checkpoint.
+    unsigned prev_line_left_spacing = 0;
+    // The type of left spacing.
+    char left_spacing_type = '\0';
+};
+
 /**
  * @brief A front end context, which contains the current status, AST, and
  * symbol tree.
@@ -30,7 +60,14 @@ public:
     // The current status of the front end.
     VariantStatus status = Status::Ok();
     // The tokens scanned from the last input.
-    std::vector<std::shared_ptr<Token>> scanned_tokens;
+    std::vector<Token> scanned_tokens;
+    // Where the lexer can resume if the last REPL input was incomplete.
+    std::optional<LexerCheckpoint> lexer_checkpoint;
+    // The tokens, strings, and code files referred to by the AST.
+    TokenStore token_store;
+    // What the token store held after the last commit. Anything added since
+    // belongs to input that has not compiled yet.
+    TokenStore::Mark committed_tokens;
     // The AST containing all statements processed so far.
     std::vector<std::shared_ptr<Stmt>> stmts;
     // The MIR module generated from the AST.
@@ -44,6 +81,8 @@ public:
     IRModuleContext mod_ctx;
     // The name of the main function generated in the module.
     std::string main_fn_name;
+    // The target to generate code for. This is kept across resets.
+    TargetSpec target_spec;
 
     FrontendContext() { initialize(); }
 
@@ -56,10 +95,13 @@ public:
     void initialize() {
         status = Status::Ok();
         scanned_tokens.clear();
+        lexer_checkpoint.reset();
         stmts.clear();
+        token_store.clear();
+        committed_tokens = {};
         mir_module = MIRModule::create();
         stmts_processed = 0;
-        mod_ctx.initialize();
+        mod_ctx.initialize("main", target_spec);
         symbol_tree = std::make_shared<SymbolTree>(mod_ctx);
     }
 
@@ -69,14 +111,43 @@ public:
      * A statement is only considered processed if it has been visited by the
      * code generator.
      */
-    void commit() { stmts_processed = stmts.size(); }
+    void commit() {
+        stmts_processed = stmts.size();
+        keep_uncommitted_tokens();
+    }
 
     /**
      * @brief Rolls back the context to the last committed state.
      *
-     * This will discard any unprocessed statements in the AST.
+     * This will discard any unprocessed statements in the AST. Their tokens
+     * are kept until `release_uncommitted_tokens` is called, since diagnostics
+     * may still refer to them.
      */
     void rollback() { stmts.resize(stmts_processed); }
+
+    /**
+     * @brief Keeps the tokens added since the last commit for as long as the
+     * committed ones.
+     *
+     * Used when input that failed to compile still modified the symbol tree,
+     * which may refer to its tokens.
+     */
+    void keep_uncommitted_tokens() { committed_tokens = token_store.mark(); }
+
+    /**
+     * @brief Rolls back the context and frees the tokens, strings, and code
+     * files added since the last commit.
+     *
+     * Used before compiling the next REPL input, so that input that was rolled
+     * back or abandoned does not stay in memory for the rest of the session.
+     *
+     * @warning Diagnostics that refer to the freed files must not be used
+     * afterward.
+     */
+    void release_uncommitted_tokens() {
+        rollback();
+        token_store.release(committed_tokens);
+    }
 };
 
 } // namespace nico
@@ -1,7 +1,6 @@
 #ifndef NICO_MIR_H
 #define NICO_MIR_H
 
-#include <any>
 #include <memory>
 #include <optional>
 #include <string>
@@ -12,6 +11,7 @@
 
 #include "nico/frontend/utils/ast_node.h"
 #include "nico/frontend/utils/nodes.h"
+#include "nico/frontend/utils/visit_result.h"
 
 namespace nico {
 
@@ -33,14 +33,51 @@ public:
 
     virtual ~MIRValue() = default;
 
+    /**
+     * @brief The handlers that values dispatch to.
+     *
+     * Each value calls the handler for its own class. `Visitor` implements the
+     * handlers by calling its typed visit functions.
+     */
+    class Dispatcher {
+    public:
+        virtual ~Dispatcher() = default;
+
+        virtual void handle(Literal* value) = 0;
+        virtual void handle(Variable* value) = 0;
+        virtual void handle(Temporary* value) = 0;
+    };
+
     /**
      * @brief A visitor class for values.
+     *
+     * @tparam R The type returned by the visit functions.
      */
-    class Visitor {
+    template <typename R>
+    class Visitor : public Dispatcher {
+        friend class MIRValue;
+
+        // The return value of the most recent visit.
+        VisitResult<R> result;
+
+        /**
+         * @brief Visits a value and stores the return value.
+         */
+        template <typename T>
+        void store(T* value) {
+            result.store([&] { return visit(value); });
+        }
+
+        void handle(Literal* value) final { store(value); }
+        void handle(Variable* value) final { store(value); }
+        void handle(Temporary* value) final { store(value); }
+
     public:
-        virtual std::any visit(Literal* value) = 0;
-        virtual std::any visit(Variable* value) = 0;
-        virtual std::any visit(Temporary* value) = 0;
+        virtual ~Visitor() = default;
+
+        virtual R visit(Literal* value) = 0;
+        virtual R visit(Variable* value) = 0;
+        virtual R visit(Temporary* value) = 0;
     };
 
     // The type of this value.
@@ -65,13 +102,24 @@ public:
      */
     virtual std::string to_string() const = 0;
 
+    /**
+     * @brief Dispatch to the handler for this value's class.
+     *
+     * @param dispatcher The dispatcher to call.
+     */
+    virtual void dispatch(Dispatcher* dispatcher) = 0;
+
     /**
      * @brief Accept a visitor.
      *
      * @param visitor The visitor to accept.
      * @return The return value from the visitor.
      */
-    virtual std::any accept(Visitor* visitor) = 0;
+    template <typename R>
+    R accept(Visitor<R>* visitor) {
+        dispatch(visitor);
+        return visitor->result.take();
+    }
 };
 
 /**
@@ -101,22 +149,75 @@ public:
 
     virtual ~Instr() = default;
 
+    /**
+     * @brief The handlers that instructions dispatch to.
+     *
+     * Each instruction calls the handler for its own class. `Visitor`
+     * implements the handlers by calling its typed visit functions.
+     */
+    class Dispatcher {
+    public:
+        virtual ~Dispatcher() = default;
+
+        virtual void handle(Binary* instr) = 0;
+        virtual void handle(Unary* instr) = 0;
+        virtual void handle(Call* instr) = 0;
+        virtual void handle(Alloca* instr) = 0;
+        virtual void handle(Store* instr) = 0;
+        virtual void handle(Load* instr) = 0;
+        virtual void handle(Phi* instr) = 0;
+
+        virtual void handle(Jump* instr) = 0;
+        virtual void handle(Branch* instr) = 0;
+        virtual void handle(Return* instr) = 0;
+    };
+
     /**
      * @brief A visitor class for instructions.
+     *
+     * @tparam R The type returned by the visit functions.
      */
-    class Visitor {
+    template <typename R>
+    class Visitor : public Dispatcher {
+        friend class Instr;
+
+        // The return value of the most recent visit.
+        VisitResult<R> result;
+
+        /**
+         * @brief Visits an instruction and stores the return value.
+         */
+        template <typename T>
+        void store(T* instr) {
+            result.store([&] { return visit(instr); });
+        }
+
+        void handle(Binary* instr) final { store(instr); }
+        void handle(Unary* instr) final { store(instr); }
+        void handle(Call* instr) final { store(instr); }
+        void handle(Alloca* instr) final { store(instr); }
+        void handle(Store* instr) final { store(instr); }
+        void handle(Load* instr) final { store(instr); }
+        void handle(Phi* instr) final { store(instr); }
+
+        void handle(Jump* instr) final { store(instr); }
+        void handle(Branch* instr) final { store(instr); }
+        void handle(Return* instr) final { store(instr); }
+
     public:
-        virtual std::any visit(Binary* instr) = 0;
-        virtual std::any visit(Unary* instr) = 0;
-        virtual std::any visit(Call* instr) = 0;
-        virtual std::any visit(Alloca* instr) = 0;
-        virtual std::any visit(Store* instr) = 0;
-        virtual std::any visit(Load* instr) = 0;
-        virtual std::any visit(Phi* instr) = 0;
-
-        virtual std::any visit(Jump* instr) = 0;
-        virtual std::any visit(Branch* instr) = 0;
-        virtual std::any visit(Return* instr) = 0;
+        virtual ~Visitor() = default;
+
+        virtual R visit(Binary* instr) = 0;
+        virtual R visit(Unary* instr) = 0;
+        virtual R visit(Call* instr) = 0;
+        virtual R visit(Alloca* instr) = 0;
+        virtual R visit(Store* instr) = 0;
+        virtual R visit(Load* instr) = 0;
+        virtual R visit(Phi* instr) = 0;
+
+        virtual R visit(Jump* instr) = 0;
+        virtual R visit(Branch* instr) = 0;
+        virtual R visit(Return* instr) = 0;
     };
 
     /**
@@ -130,13 +231,24 @@ public:
      */
     virtual std::string to_string() const = 0;
 
+    /**
+     * @brief Dispatch to the handler for this instruction's class.
+     *
+     * @param dispatcher The dispatcher to call.
+     */
+    virtual void dispatch(Dispatcher* dispatcher) = 0;
+
     /**
      * @brief Accept a visitor.
      *
      * @param visitor The visitor to accept.
      * @return The return value from the visitor.
      */
-    virtual std::any accept(Visitor* visitor) = 0;
+    template <typename R>
+    R accept(Visitor<R>* visitor) {
+        dispatch(visitor);
+        return visitor->result.take();
+    }
 };
 
 class Function;
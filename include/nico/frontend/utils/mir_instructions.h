@@ -64,8 +64,8 @@ public:
 
     virtual ~Binary() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     /**
@@ -124,8 +124,8 @@ public:
 
     virtual ~Unary() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     /**
@@ -179,8 +179,8 @@ public:
 
     virtual ~Call() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     virtual std::string to_string() const override {
@@ -218,8 +218,8 @@ public:
 
     virtual ~Alloca() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     virtual std::string to_string() const override {
@@ -257,8 +257,8 @@ public:
 
     virtual ~Store() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     virtual std::string to_string() const override {
@@ -294,8 +294,8 @@ public:
 
     virtual ~Load() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     virtual std::string to_string() const override {
@@ -331,8 +331,8 @@ public:
 
     virtual ~Phi() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     virtual std::string to_string() const override {
@@ -380,8 +380,8 @@ public:
 
     virtual ~Jump() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     virtual std::string to_string() const override {
@@ -421,8 +421,8 @@ public:
 
     virtual ~Branch() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     virtual std::string to_string() const override {
@@ -451,8 +451,8 @@ public:
 
     virtual ~Return() = default;
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 
     virtual std::string to_string() const override { return "return"; }
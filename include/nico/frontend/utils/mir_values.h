@@ -3,7 +3,6 @@
 
 #include "nico/frontend/utils/mir.h"
 
-#include <any>
 #include <memory>
 #include <optional>
 #include <string>
@@ -36,8 +35,8 @@ public:
                std::string(literal_expr->token->lexeme) + ")";
     }
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 };
 
@@ -74,8 +73,8 @@ public:
         return "(" + type->to_string() + " " + name + ")";
     }
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 };
 
@@ -103,8 +102,8 @@ public:
         return "(" + type->to_string() + " " + name + ")";
     }
 
-    virtual std::any accept(Visitor* visitor) override {
-        return visitor->visit(this);
+    virtual void dispatch(Dispatcher* dispatcher) override {
+        dispatcher->handle(this);
     }
 };
 
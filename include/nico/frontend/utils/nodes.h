@@ -1,7 +1,7 @@
 #ifndef NICO_NODES_H
 #define NICO_NODES_H
 
-#include <any>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -12,6 +12,8 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Type.h>
 
+#include "nico/frontend/utils/visit_result.h"
+#include "nico/shared/casting.h"
 #include "nico/shared/token.h"
 #include "nico/shared/utils.h"
 
@@ -52,6 +54,29 @@ public:
 
     class UnresolvedType;
 
+    /**
+     * @brief The concrete class of a node.
+     *
+     * Checked by `isa` and `dyn_cast` in place of `dynamic_cast`. Scopes come
+     * first and type nodes are kept together, so that `classof` for most
+     * interfaces is a range check.
+     */
+    enum class Kind : uint8_t {
+        LocalScope,
+        RootScope,
+        Namespace,
+        ExternBlock,
+        StructDef,
+        TypeDef,
+        PrimitiveType,
+        UnresolvedType,
+        BindingEntry,
+        OverloadGroup
+    };
+
+    // The concrete class of this node.
+    const Kind kind;
+
     // This node's parent scope, if it exists.
     std::weak_ptr<Node::IScope> parent;
     // A short name for this node, used for adding this node to the parent
@@ -71,7 +96,8 @@ protected:
         explicit Private() = default;
     };
 
-    Node(Private) {}
+    Node(Private, Kind kind)
+        : kind(kind) {}
 
 public:
     /**
@@ -150,9 +176,43 @@ public:
     class Void;
     class Named;
 
-    Type() = default;
+    /**
+     * @brief The concrete class of a type object.
+     *
+     * Checked by `isa` and `dyn_cast` in place of `dynamic_cast`. Subclasses of
+     * an interface or of another type (e.g. `Unit` of `Tuple`) are listed
+     * together.
+     */
+    enum class Kind : uint8_t {
+        Int,
+        Float,
+        Bool,
+        Nullptr,
+        Anyptr,
+        RawTypedPtr,
+        Reference,
+        Str,
+        Array,
+        EmptyArray,
+        Tuple,
+        Unit,
+        Object,
+        Struct,
+        Function,
+        OverloadedFn,
+        Void,
+        Named
+    };
+
+    // The concrete class of this type object.
+    const Kind kind;
+
     virtual ~Type() = default;
 
+protected:
+    Type(Kind kind)
+        : kind(kind) {}
+
 public:
     /**
      * @brief Converts this type to a string.
@@ -351,8 +411,11 @@ public:
      */
     template <typename T>
     static std::optional<std::shared_ptr<T>> as_a(std::shared_ptr<Type> type) {
-        auto underlying_type =
-            std::dynamic_pointer_cast<T>(type->get_underlying_type());
+        // Only named types have a different underlying type.
+        if (type->kind == Kind::Named) {
+            type = type->get_underlying_type();
+        }
+        auto underlying_type = dyn_cast<T>(type);
         if (underlying_type != nullptr) {
             return underlying_type;
         }
@@ -375,7 +438,10 @@ public:
      */
     template <typename T>
     static bool is_a(std::shared_ptr<Type> type) {
-        return as_a<T>(type).has_value();
+        if (type->kind == Kind::Named) {
+            type = type->get_underlying_type();
+        }
+        return isa<T>(type);
     }
 };
 
@@ -391,13 +457,13 @@ public:
     // The string identifier for the modifier.
     std::string identifier;
     // The token arguments for the modifier, if any.
-    std::vector<std::shared_ptr<Token>> args;
+    std::vector<const Token*> args;
     // The location of the modifier.
     const Location* location;
 
     Modifier(
-        std::shared_ptr<Token> identifier,
-        std::vector<std::shared_ptr<Token>>&& args = {}
+        const Token* identifier,
+        std::vector<const Token*>&& args = {}
     )
         : identifier(std::string(identifier->lexeme)), args(std::move(args)) {
         location = &identifier->location;
@@ -443,40 +509,145 @@ public:
 
     class Eof;
 
+    /**
+     * @brief The concrete class of a statement.
+     *
+     * The order matters: each statement interface, such as `IDeclAllowed`,
+     * is a contiguous range of kinds. `Pass` and `Eof` sit where the
+     * declaration and execution ranges overlap.
+     */
+    enum class Kind : uint8_t {
+        Field,
+        Static,
+        Func,
+        Namespace,
+        ExternBlock,
+        TypeDef,
+        StructDef,
+        Pass,
+        Eof,
+        Expression,
+        Let,
+        Print,
+        Dealloc,
+        Yield,
+        Continue
+    };
+
     virtual ~Stmt() {}
 
+protected:
+    Stmt(Kind kind)
+        : kind(kind) {}
+
+public:
+
+    /**
+     * @brief The handlers that statements dispatch to.
+     *
+     * Each statement calls the handler for its own class. `Visitor` implements
+     * the handlers by calling its typed visit functions.
+     */
+    class Dispatcher {
+    public:
+        virtual ~Dispatcher() = default;
+
+        virtual void handle(Expression* stmt) = 0;
+        virtual void handle(Let* stmt) = 0;
+        virtual void handle(Static* stmt) = 0;
+        virtual void handle(Func* stmt) = 0;
+        virtual void handle(Print* stmt) = 0;
+        virtual void handle(Dealloc* stmt) = 0;
+        virtual void handle(Pass* stmt) = 0;
+        virtual void handle(Yield* stmt) = 0;
+        virtual void handle(Continue* stmt) = 0;
+        virtual void handle(Namespace* stmt) = 0;
+        virtual void handle(ExternBlock* stmt) = 0;
+        virtual void handle(TypeDef* stmt) = 0;
+        virtual void handle(StructDef* stmt) = 0;
+        virtual void handle(Field* stmt) = 0;
+        virtual void handle(Eof* stmt) = 0;
+    };
+
     /**
      * @brief A visitor class for statements.
+     *
+     * @tparam R The type returned by the visit functions.
      */
-    class Visitor {
+    template <typename R>
+    class Visitor : public Dispatcher {
+        friend class Stmt;
+
+        // The return value of the most recent visit.
+        VisitResult<R> result;
+
+        /**
+         * @brief Visits a statement and stores the return value.
+         */
+        template <typename T>
+        void store(T* stmt) {
+            result.store([&] { return visit(stmt); });
+        }
+
+        void handle(Expression* stmt) final { store(stmt); }
+        void handle(Let* stmt) final { store(stmt); }
+        void handle(Static* stmt) final { store(stmt); }
+        void handle(Func* stmt) final { store(stmt); }
+        void handle(Print* stmt) final { store(stmt); }
+        void handle(Dealloc* stmt) final { store(stmt); }
+        void handle(Pass* stmt) final { store(stmt); }
+        void handle(Yield* stmt) final { store(stmt); }
+        void handle(Continue* stmt) final { store(stmt); }
+        void handle(Namespace* stmt) final { store(stmt); }
+        void handle(ExternBlock* stmt) final { store(stmt); }
+        void handle(TypeDef* stmt) final { store(stmt); }
+        void handle(StructDef* stmt) final { store(stmt); }
+        void handle(Field* stmt) final { store(stmt); }
+        void handle(Eof* stmt) final { store(stmt); }
+
     public:
-        virtual std::any visit(Expression* stmt) = 0;
-        virtual std::any visit(Let* stmt) = 0;
-        virtual std::any visit(Static* stmt) = 0;
-        virtual std::any visit(Func* stmt) = 0;
-        virtual std::any visit(Print* stmt) = 0;
-        virtual std::any visit(Dealloc* stmt) = 0;
-        virtual std::any visit(Pass* stmt) = 0;
-        virtual std::any visit(Yield* stmt) = 0;
-        virtual std::any visit(Continue* stmt) = 0;
-        virtual std::any visit(Namespace* stmt) = 0;
-        virtual std::any visit(ExternBlock* stmt) = 0;
-        virtual std::any visit(TypeDef* stmt) = 0;
-        virtual std::any visit(StructDef* stmt) = 0;
-        virtual std::any visit(Field* stmt) = 0;
-        virtual std::any visit(Eof* stmt) = 0;
+        virtual ~Visitor() = default;
+
+        virtual R visit(Expression* stmt) = 0;
+        virtual R visit(Let* stmt) = 0;
+        virtual R visit(Static* stmt) = 0;
+        virtual R visit(Func* stmt) = 0;
+        virtual R visit(Print* stmt) = 0;
+        virtual R visit(Dealloc* stmt) = 0;
+        virtual R visit(Pass* stmt) = 0;
+        virtual R visit(Yield* stmt) = 0;
+        virtual R visit(Continue* stmt) = 0;
+        virtual R visit(Namespace* stmt) = 0;
+        virtual R visit(ExternBlock* stmt) = 0;
+        virtual R visit(TypeDef* stmt) = 0;
+        virtual R visit(StructDef* stmt) = 0;
+        virtual R visit(Field* stmt) = 0;
+        virtual R visit(Eof* stmt) = 0;
     };
 
+    // The concrete class of the statement.
+    const Kind kind;
     // The location of the statement.
     const Location* location;
 
+    /**
+     * @brief Dispatch to the handler for this statement's class.
+     *
+     * @param dispatcher The dispatcher to call.
+     */
+    virtual void dispatch(Dispatcher* dispatcher) = 0;
+
     /**
      * @brief Accept a visitor.
      *
      * @param visitor The visitor to accept.
      * @return The return value from the visitor.
      */
-    virtual std::any accept(Visitor* visitor) = 0;
+    template <typename R>
+    R accept(Visitor<R>* visitor) {
+        dispatch(visitor);
+        return visitor->result.take();
+    }
 
     /**
      * @brief Attempt to apply a modifier to this statement.
@@ -527,41 +698,203 @@ public:
     class Conditional;
     class Loop;
 
+    /**
+     * @brief The concrete class of an expression.
+     *
+     * Possible lvalues are listed last so that `IPLValue` is a range check.
+     */
+    enum class Kind : uint8_t {
+        Assign,
+        Logical,
+        Binary,
+        Unary,
+        Address,
+        Cast,
+        Call,
+        SizeOf,
+        Alloc,
+        NewInst,
+        Literal,
+        Tuple,
+        Unit,
+        Array,
+        Object,
+        Block,
+        Conditional,
+        Loop,
+        Deref,
+        Access,
+        Subscript,
+        NameRef
+    };
+
     virtual ~Expr() {}
 
+protected:
+    Expr(Kind kind)
+        : kind(kind) {}
+
+public:
+
+    /**
+     * @brief The handlers that expressions dispatch to.
+     *
+     * Each expression calls the handler for its own class. `Visitor` implements
+     * the handlers by calling its typed visit functions.
+     */
+    class Dispatcher {
+    public:
+        virtual ~Dispatcher() = default;
+
+        virtual void handle(Assign* expr, bool as_lvalue) = 0;
+        virtual void handle(Logical* expr, bool as_lvalue) = 0;
+        virtual void handle(Binary* expr, bool as_lvalue) = 0;
+        virtual void handle(Unary* expr, bool as_lvalue) = 0;
+        virtual void handle(Address* expr, bool as_lvalue) = 0;
+        virtual void handle(Deref* expr, bool as_lvalue) = 0;
+        virtual void handle(Cast* expr, bool as_lvalue) = 0;
+        virtual void handle(Access* expr, bool as_lvalue) = 0;
+        virtual void handle(Subscript* expr, bool as_lvalue) = 0;
+        virtual void handle(Call* expr, bool as_lvalue) = 0;
+        virtual void handle(SizeOf* expr, bool as_lvalue) = 0;
+        virtual void handle(Alloc* expr, bool as_lvalue) = 0;
+        virtual void handle(NewInst* expr, bool as_lvalue) = 0;
+        virtual void handle(NameRef* expr, bool as_lvalue) = 0;
+        virtual void handle(Literal* expr, bool as_lvalue) = 0;
+        virtual void handle(Tuple* expr, bool as_lvalue) = 0;
+        virtual void handle(Array* expr, bool as_lvalue) = 0;
+        virtual void handle(Object* expr, bool as_lvalue) = 0;
+        virtual void handle(Block* expr, bool as_lvalue) = 0;
+        virtual void handle(Conditional* expr, bool as_lvalue) = 0;
+        virtual void handle(Loop* expr, bool as_lvalue) = 0;
+    };
+
     /**
      * @brief A visitor class for expressions.
+     *
+     * @tparam R The type returned by the visit functions.
      */
-    class Visitor {
+    template <typename R>
+    class Visitor : public Dispatcher {
+        friend class Expr;
+
+        // The return value of the most recent visit.
+        VisitResult<R> result;
+
+        /**
+         * @brief Visits an expression and stores the return value.
+         */
+        template <typename T>
+        void store(T* expr, bool as_lvalue) {
+            result.store([&] { return visit(expr, as_lvalue); });
+        }
+
+        void handle(Assign* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Logical* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Binary* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Unary* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Address* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Deref* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Cast* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Access* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Subscript* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Call* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(SizeOf* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Alloc* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(NewInst* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(NameRef* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Literal* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Tuple* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Array* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Object* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Block* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Conditional* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+        void handle(Loop* expr, bool as_lvalue) final {
+            store(expr, as_lvalue);
+        }
+
     public:
-        virtual std::any visit(Assign* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Logical* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Binary* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Unary* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Address* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Deref* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Cast* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Access* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Subscript* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Call* expr, bool as_lvalue) = 0;
-        virtual std::any visit(SizeOf* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Alloc* expr, bool as_lvalue) = 0;
-        virtual std::any visit(NewInst* expr, bool as_lvalue) = 0;
-        virtual std::any visit(NameRef* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Literal* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Tuple* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Array* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Object* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Block* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Conditional* expr, bool as_lvalue) = 0;
-        virtual std::any visit(Loop* expr, bool as_lvalue) = 0;
+        virtual ~Visitor() = default;
+
+        virtual R visit(Assign* expr, bool as_lvalue) = 0;
+        virtual R visit(Logical* expr, bool as_lvalue) = 0;
+        virtual R visit(Binary* expr, bool as_lvalue) = 0;
+        virtual R visit(Unary* expr, bool as_lvalue) = 0;
+        virtual R visit(Address* expr, bool as_lvalue) = 0;
+        virtual R visit(Deref* expr, bool as_lvalue) = 0;
+        virtual R visit(Cast* expr, bool as_lvalue) = 0;
+        virtual R visit(Access* expr, bool as_lvalue) = 0;
+        virtual R visit(Subscript* expr, bool as_lvalue) = 0;
+        virtual R visit(Call* expr, bool as_lvalue) = 0;
+        virtual R visit(SizeOf* expr, bool as_lvalue) = 0;
+        virtual R visit(Alloc* expr, bool as_lvalue) = 0;
+        virtual R visit(NewInst* expr, bool as_lvalue) = 0;
+        virtual R visit(NameRef* expr, bool as_lvalue) = 0;
+        virtual R visit(Literal* expr, bool as_lvalue) = 0;
+        virtual R visit(Tuple* expr, bool as_lvalue) = 0;
+        virtual R visit(Array* expr, bool as_lvalue) = 0;
+        virtual R visit(Object* expr, bool as_lvalue) = 0;
+        virtual R visit(Block* expr, bool as_lvalue) = 0;
+        virtual R visit(Conditional* expr, bool as_lvalue) = 0;
+        virtual R visit(Loop* expr, bool as_lvalue) = 0;
     };
 
     // The type of the expression.
     std::shared_ptr<Type> type;
+    // The concrete class of the expression.
+    const Kind kind;
     // The location of the expression.
     const Location* location;
 
+    /**
+     * @brief Dispatch to the handler for this expression's class.
+     *
+     * @param dispatcher The dispatcher to call.
+     * @param as_lvalue Whether or not the expression should be treated as an
+     * lvalue.
+     */
+    virtual void dispatch(Dispatcher* dispatcher, bool as_lvalue) = 0;
+
     /**
      * @brief Accept a visitor.
      *
@@ -570,7 +903,11 @@ public:
      * lvalue.
      * @return The return value from the visitor.
      */
-    virtual std::any accept(Visitor* visitor, bool as_lvalue) = 0;
+    template <typename R>
+    R accept(Visitor<R>* visitor, bool as_lvalue) {
+        dispatch(visitor, as_lvalue);
+        return visitor->result.take();
+    }
 
     /**
      * @brief Check if the expression is a constant expression.
@@ -619,32 +956,92 @@ public:
 
     virtual ~Annotation() = default;
 
+    /**
+     * @brief The handlers that annotations dispatch to.
+     *
+     * Each annotation calls the handler for its own class. `Visitor` implements
+     * the handlers by calling its typed visit functions.
+     */
+    class Dispatcher {
+    public:
+        virtual ~Dispatcher() = default;
+
+        virtual void handle(NameRef* annotation) = 0;
+        virtual void handle(Pointer* annotation) = 0;
+        virtual void handle(Nullptr* annotation) = 0;
+        virtual void handle(Void* annotation) = 0;
+        virtual void handle(Reference* annotation) = 0;
+        virtual void handle(Array* annotation) = 0;
+        virtual void handle(Object* annotation) = 0;
+        virtual void handle(Tuple* annotation) = 0;
+        virtual void handle(TypeOf* annotation) = 0;
+    };
+
     /**
      * @brief A visitor class for annotations.
+     *
+     * @tparam R The type returned by the visit functions.
      */
-    class Visitor {
+    template <typename R>
+    class Visitor : public Dispatcher {
+        friend class Annotation;
+
+        // The return value of the most recent visit.
+        VisitResult<R> result;
+
+        /**
+         * @brief Visits an annotation and stores the return value.
+         */
+        template <typename T>
+        void store(T* annotation) {
+            result.store([&] { return visit(annotation); });
+        }
+
+        void handle(NameRef* annotation) final { store(annotation); }
+        void handle(Pointer* annotation) final { store(annotation); }
+        void handle(Nullptr* annotation) final { store(annotation); }
+        void handle(Void* annotation) final { store(annotation); }
+        void handle(Reference* annotation) final { store(annotation); }
+        void handle(Array* annotation) final { store(annotation); }
+        void handle(Object* annotation) final { store(annotation); }
+        void handle(Tuple* annotation) final { store(annotation); }
+        void handle(TypeOf* annotation) final { store(annotation); }
+
     public:
-        virtual std::any visit(NameRef* annotation) = 0;
-        virtual std::any visit(Pointer* annotation) = 0;
-        virtual std::any visit(Nullptr* annotation) = 0;
-        virtual std::any visit(Void* annotation) = 0;
-        virtual std::any visit(Reference* annotation) = 0;
-        virtual std::any visit(Array* annotation) = 0;
-        virtual std::any visit(Object* annotation) = 0;
-        virtual std::any visit(Tuple* annotation) = 0;
-        virtual std::any visit(TypeOf* annotation) = 0;
+        virtual ~Visitor() = default;
+
+        virtual R visit(NameRef* annotation) = 0;
+        virtual R visit(Pointer* annotation) = 0;
+        virtual R visit(Nullptr* annotation) = 0;
+        virtual R visit(Void* annotation) = 0;
+        virtual R visit(Reference* annotation) = 0;
+        virtual R visit(Array* annotation) = 0;
+        virtual R visit(Object* annotation) = 0;
+        virtual R visit(Tuple* annotation) = 0;
+        virtual R visit(TypeOf* annotation) = 0;
     };
 
     // The location of the expression.
     const Location* location;
 
+    /**
+     * @brief Dispatch to the handler for this annotation's class.
+     *
+     * @param dispatcher The dispatcher to call.
+     */
+    virtual void dispatch(Dispatcher* dispatcher) = 0;
+
     /**
      * @brief Accept a visitor.
      *
      * @param visitor The visitor to accept.
      * @return The return value from the visitor.
      */
-    virtual std::any accept(Visitor* visitor) = 0;
+    template <typename R>
+    R accept(Visitor<R>* visitor) {
+        dispatch(visitor);
+        return visitor->result.take();
+    }
 
     /**
      * @brief Convert the annotation to a string representation.
@@ -674,15 +1071,15 @@ public:
     std::optional<std::shared_ptr<Name>> base;
     // The identifier on the right side of the name. For example, in
     // `foo::bar::baz`, the identifier is `baz`.
-    std::shared_ptr<Token> identifier;
+    const Token* identifier;
     // A weak pointer to the node that this name resolves to. To be filled in by
     // the type checker.
     std::weak_ptr<Node> node;
 
-    Name(std::shared_ptr<Name> base, std::shared_ptr<Token> identifier)
+    Name(std::shared_ptr<Name> base, const Token* identifier)
         : base(base), identifier(identifier) {}
 
-    Name(std::shared_ptr<Token> identifier)
+    Name(const Token* identifier)
         : base(std::nullopt), identifier(identifier) {}
 
     std::string to_string() const {
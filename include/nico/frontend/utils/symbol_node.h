@@ -32,9 +32,12 @@ public:
 
     virtual ~IScope() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind >= Kind::LocalScope && node->kind <= Kind::StructDef;
+    }
+
 protected:
-    IScope(Private)
-        : Node(Private()) {}
+    IScope(Private) {}
 
 public:
     virtual std::string to_tree_string(size_t indent = 0) const override;
@@ -76,9 +79,12 @@ class Node::IGlobalScope : public virtual Node::IScope {
 public:
     virtual ~IGlobalScope() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind >= Kind::RootScope && node->kind <= Kind::StructDef;
+    }
+
 protected:
-    IGlobalScope(Private)
-        : Node(Private()) {}
+    IGlobalScope(Private) {}
 };
 
 /**
@@ -91,9 +97,13 @@ public:
 
     virtual ~ITypeNode() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind >= Kind::StructDef &&
+               node->kind <= Kind::UnresolvedType;
+    }
+
 protected:
-    ITypeNode(Private)
-        : Node(Private()) {}
+    ITypeNode(Private) {}
 };
 
 /**
@@ -113,12 +123,25 @@ public:
 
     virtual ~ILocatable() = default;
 
+    static bool classof(const Node* node) {
+        switch (node->kind) {
+        case Kind::Namespace:
+        case Kind::ExternBlock:
+        case Kind::StructDef:
+        case Kind::TypeDef:
+        case Kind::BindingEntry:
+        case Kind::OverloadGroup:
+            return true;
+        default:
+            return false;
+        }
+    }
+
 protected:
     ILocatable(Private, const Location* location)
-        : Node(Private()), location(location) {}
+        : location(location) {}
 
-    ILocatable(Private)
-        : Node(Private()) {}
+    ILocatable(Private) {}
 };
 
 /**
@@ -128,12 +151,16 @@ protected:
  * Its unique identifier is always "::" and the pointer to its parent scope is
  * empty.
  */
-class Node::RootScope : public virtual Node::IGlobalScope {
+class Node::RootScope final : public virtual Node::IGlobalScope {
 public:
     virtual ~RootScope() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind == Kind::RootScope;
+    }
+
     RootScope(Private)
-        : Node(Private()),
+        : Node(Private(), Kind::RootScope),
           Node::IScope(Private()),
           Node::IGlobalScope(Private()) {}
 
@@ -174,8 +201,12 @@ class Node::Namespace : public virtual Node::IGlobalScope,
 public:
     virtual ~Namespace() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind >= Kind::Namespace && node->kind <= Kind::ExternBlock;
+    }
+
     Namespace(Private)
-        : Node(Private()),
+        : Node(Private(), Kind::Namespace),
           Node::IScope(Private()),
           Node::IGlobalScope(Private()),
           Node::ILocatable(Private()) {}
@@ -188,7 +219,7 @@ public:
      * @return A shared pointer to the newly created namespace node.
      */
     static std::shared_ptr<Namespace>
-    create(std::shared_ptr<Node::IScope> parent, std::shared_ptr<Token> token);
+    create(std::shared_ptr<Node::IScope> parent, const Token* token);
 
     virtual std::string to_string() const override {
         return "NS \"" + symbol + "\"";
@@ -205,19 +236,23 @@ public:
  * An extern block may not be declared within a local scope or a struct
  * definition.
  */
-class Node::ExternBlock : public virtual Node::Namespace {
+class Node::ExternBlock final : public virtual Node::Namespace {
 public:
     virtual ~ExternBlock() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind == Kind::ExternBlock;
+    }
+
     ExternBlock(Private)
-        : Node(Private()),
+        : Node(Private(), Kind::ExternBlock),
           Node::IScope(Private()),
           Node::IGlobalScope(Private()),
           Node::ILocatable(Private()),
           Node::Namespace(Private()) {}
 
     static std::shared_ptr<ExternBlock>
-    create(std::shared_ptr<Node::IScope> parent, std::shared_ptr<Token> token);
+    create(std::shared_ptr<Node::IScope> parent, const Token* token);
 
     virtual std::string to_string() const override {
         return "EXTERN \"" + symbol + "\"";
@@ -244,12 +279,16 @@ public:
  * Ideally, the symbol tree should install primitive types in the root
  * scope.
  */
-class Node::PrimitiveType : public virtual Node::ITypeNode {
+class Node::PrimitiveType final : public virtual Node::ITypeNode {
 public:
     virtual ~PrimitiveType() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind == Kind::PrimitiveType;
+    }
+
     PrimitiveType(Private)
-        : Node(Private()), Node::ITypeNode(Private()) {}
+        : Node(Private(), Kind::PrimitiveType), Node::ITypeNode(Private()) {}
 
     /**
      * @brief Creates a new primitive type node and adds it to the parent scope.
@@ -279,19 +318,23 @@ public:
  * A type definition binds a name to a type, allowing the type to be referred
  * to by name. It is similar to type aliases in other languages.
  */
-class Node::TypeDef : public virtual Node::ITypeNode,
-                      public virtual Node::ILocatable {
+class Node::TypeDef final : public virtual Node::ITypeNode,
+                            public virtual Node::ILocatable {
 public:
     virtual ~TypeDef() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind == Kind::TypeDef;
+    }
+
     TypeDef(Private, const Location* location)
-        : Node(Private()),
+        : Node(Private(), Kind::TypeDef),
           Node::ITypeNode(Private()),
           Node::ILocatable(Private(), location) {}
 
     static std::shared_ptr<TypeDef> create(
         std::shared_ptr<Node::IScope> parent,
-        std::shared_ptr<Token> token,
+        const Token* token,
         std::shared_ptr<Type> type
     );
 
@@ -308,14 +351,18 @@ public:
  *
  * A struct may not be declared within a local scope.
  */
-class Node::StructDef : public virtual Node::IGlobalScope,
-                        public virtual Node::ITypeNode,
-                        public virtual Node::ILocatable {
+class Node::StructDef final : public virtual Node::IGlobalScope,
+                              public virtual Node::ITypeNode,
+                              public virtual Node::ILocatable {
 public:
     virtual ~StructDef() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind == Kind::StructDef;
+    }
+
     StructDef(Private)
-        : Node(Private()),
+        : Node(Private(), Kind::StructDef),
           Node::IScope(Private()),
           Node::IGlobalScope(Private()),
           Node::ITypeNode(Private()),
@@ -335,7 +382,7 @@ public:
      */
     static std::shared_ptr<StructDef> create(
         std::shared_ptr<Node::IScope> parent,
-        std::shared_ptr<Token> token,
+        const Token* token,
         bool is_class = false
     );
 
@@ -363,7 +410,7 @@ public:
  * to reference a variable declared in a local scope from outside that scope
  * (since an identifier expression cannot start with a number).
  */
-class Node::LocalScope : public virtual Node::IScope {
+class Node::LocalScope final : public virtual Node::IScope {
 public:
     // A static counter to generate unique identifiers for local scopes.
     static int next_scope_id;
@@ -375,8 +422,12 @@ public:
 
     virtual ~LocalScope() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind == Kind::LocalScope;
+    }
+
     LocalScope(Private)
-        : Node(Private()), Node::IScope(Private()) {}
+        : Node(Private(), Kind::LocalScope), Node::IScope(Private()) {}
 
     /**
      * @brief Creates a new local scope and adds it to the current scope's list
@@ -436,8 +487,13 @@ public:
 
     virtual ~BindingEntry() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind >= Kind::BindingEntry &&
+               node->kind <= Kind::OverloadGroup;
+    }
+
     BindingEntry(Private, const Binding& binding, Linkage linkage)
-        : Node(Private()),
+        : Node(Private(), Kind::BindingEntry),
           Node::ILocatable(Private()),
           binding(binding),
           linkage(linkage) {}
@@ -511,13 +567,17 @@ public:
  * Since they are binding entries, they are also locatable nodes.
  * The location token should be set to the first overload's token.
  */
-class Node::OverloadGroup : public virtual Node::BindingEntry {
+class Node::OverloadGroup final : public virtual Node::BindingEntry {
 public:
     // A list of overloads in this group.
     std::vector<std::shared_ptr<Node::BindingEntry>> overloads;
 
     virtual ~OverloadGroup() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind == Kind::OverloadGroup;
+    }
+
     OverloadGroup(
         Private,
         std::string_view overload_name,
@@ -587,7 +647,7 @@ public:
  * symbol, parent scope, or any other information that a normal node would have.
  *
  */
-class Node::UnresolvedType : public virtual Node::ITypeNode {
+class Node::UnresolvedType final : public virtual Node::ITypeNode {
 public:
     // The name associated with this unresolved type.
     std::weak_ptr<Name> name;
@@ -599,8 +659,12 @@ public:
 
     virtual ~UnresolvedType() = default;
 
+    static bool classof(const Node* node) {
+        return node->kind == Kind::UnresolvedType;
+    }
+
     UnresolvedType(Private)
-        : Node(Private()), Node::ITypeNode(Private()) {}
+        : Node(Private(), Kind::UnresolvedType), Node::ITypeNode(Private()) {}
 
     /**
      * @brief Creates a new unresolved type node from a name reference
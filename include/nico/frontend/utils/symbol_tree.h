@@ -178,7 +178,7 @@ public:
      * namespace node if successful, or nullopt if not.
      */
     std::optional<std::shared_ptr<Node::Namespace>>
-    add_namespace(std::shared_ptr<Token> token);
+    add_namespace(const Token* token);
 
     /**
      * @brief Adds a new extern block to the symbol tree, then enters the extern
@@ -197,7 +197,7 @@ public:
      * created extern block node if successful, or nullopt if not.
      */
     std::optional<std::shared_ptr<Node::ExternBlock>>
-    add_extern_block(std::shared_ptr<Token> token);
+    add_extern_block(const Token* token);
 
     /**
      * @brief Adds a type definition to the symbol tree.
@@ -213,7 +213,7 @@ public:
      * type definition node if successful, or nullopt if not.
      */
     std::optional<std::shared_ptr<Node::TypeDef>>
-    add_type_def(std::shared_ptr<Token> token, std::shared_ptr<Type> type);
+    add_type_def(const Token* token, std::shared_ptr<Type> type);
 
     /**
      * @brief Adds a struct definition to the symbol tree, then enters the
@@ -227,7 +227,7 @@ public:
      * definition if added successfully, or nullopt if not.
      */
     std::optional<std::shared_ptr<Node::StructDef>>
-    add_struct_def(std::shared_ptr<Token> token, bool is_class = false);
+    add_struct_def(const Token* token, bool is_class = false);
 
     /**
      * @brief Adds a new local scope to the symbol tree, then enters the local
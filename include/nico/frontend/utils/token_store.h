@@ -0,0 +1,166 @@
+#ifndef NICO_TOKEN_STORE_H
+#define NICO_TOKEN_STORE_H
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nico/shared/code_file.h"
+#include "nico/shared/token.h"
+
+namespace nico {
+
+/**
+ * @brief Owns the tokens, strings, and code files that the AST refers to.
+ *
+ * Tokens are stored in one contiguous vector per scan, and the AST refers to
+ * them by pointer. Nothing is removed until the store is cleared or released
+ * back to a mark, so pointers stay valid for as long as the AST that holds
+ * them.
+ *
+ * A mark records what the store held at some point, e.g. after each REPL input
+ * that compiled. Releasing back to it frees everything added since, e.g. the
+ * tokens and files of REPL inputs that were rolled back.
+ *
+ * String literal values are stored here rather than in the tokens, which keeps
+ * tokens small and trivially copyable.
+ */
+class TokenStore {
+public:
+    /**
+     * @brief The number of items in each part of a store at some point.
+     */
+    struct Mark {
+        size_t scans = 0;
+        size_t synthetic_tokens = 0;
+        size_t strings = 0;
+        size_t files = 0;
+        size_t nested_stores = 0;
+    };
+
+private:
+    // The token arrays from each scan. A deque is used so that adding an array
+    // does not move the others.
+    std::deque<std::vector<Token>> scans;
+    // Tokens created after scanning, e.g. by the parser for desugaring.
+    std::deque<Token> synthetic_tokens;
+    // The values of string literals.
+    std::deque<std::string> strings;
+    // The code files that the tokens' locations refer to.
+    std::vector<std::shared_ptr<CodeFile>> files;
+    // Stores owned by this one, e.g. one per thread when scanning in parallel.
+    std::vector<std::unique_ptr<TokenStore>> nested_stores;
+
+public:
+    /**
+     * @brief Takes ownership of the tokens from a scan.
+     *
+     * @param tokens (Requires move) The tokens to store.
+     * @return A reference to the stored tokens. The reference is valid until
+     * the store is cleared.
+     */
+    std::vector<Token>& add_tokens(std::vector<Token>&& tokens) {
+        return scans.emplace_back(std::move(tokens));
+    }
+
+    /**
+     * @brief Stores a single token that was not produced by the lexer.
+     *
+     * @param token The token to store.
+     * @return A pointer to the stored token. The pointer is valid until the
+     * store is cleared.
+     */
+    const Token* add_token(const Token& token) {
+        return &synthetic_tokens.emplace_back(token);
+    }
+
+    /**
+     * @brief Stores the value of a string literal.
+     *
+     * @param str (Requires move) The string to store.
+     * @return A reference to the stored string. The reference is valid until
+     * the store is cleared.
+     */
+    const std::string& add_string(std::string&& str) {
+        return strings.emplace_back(std::move(str));
+    }
+
+    /**
+     * @brief Keeps a code file alive for as long as tokens may refer to it.
+     *
+     * @param file The code file to keep alive.
+     */
+    void add_file(const std::shared_ptr<CodeFile>& file) {
+        files.push_back(file);
+    }
+
+    /**
+     * @brief Adds a store that is owned by this one.
+     *
+     * Stores are not thread-safe, so each thread that adds to a store needs
+     * its own. A nested store lets a thread do so while its contents live as
+     * long as this store.
+     *
+     * @return A reference to the nested store. The reference is valid until
+     * this store is cleared.
+     */
+    TokenStore& add_nested_store() {
+        return *nested_stores.emplace_back(std::make_unique<TokenStore>());
+    }
+
+    /**
+     * @brief Marks what the store currently holds.
+     *
+     * @return The mark, which can be passed to `release`.
+     */
+    Mark mark() const {
+        return Mark{
+            scans.size(),
+            synthetic_tokens.size(),
+            strings.size(),
+            files.size(),
+            nested_stores.size()
+        };
+    }
+
+    /**
+     * @brief Removes everything added to the store since a mark was taken.
+     *
+     * Items added before the mark are not moved, so pointers to them stay
+     * valid.
+     *
+     * @param mark A mark taken from this store since it was last cleared.
+     * @warning All pointers to tokens added since the mark are invalidated.
+     */
+    void release(const Mark& mark) {
+        scans.erase(scans.begin() + mark.scans, scans.end());
+        synthetic_tokens.erase(
+            synthetic_tokens.begin() + mark.synthetic_tokens,
+            synthetic_tokens.end()
+        );
+        strings.erase(strings.begin() + mark.strings, strings.end());
+        files.erase(files.begin() + mark.files, files.end());
+        nested_stores.erase(
+            nested_stores.begin() + mark.nested_stores,
+            nested_stores.end()
+        );
+    }
+
+    /**
+     * @brief Removes all tokens, strings, and code files from the store.
+     *
+     * @warning All pointers to tokens in this store are invalidated.
+     */
+    void clear() {
+        scans.clear();
+        synthetic_tokens.clear();
+        strings.clear();
+        files.clear();
+        nested_stores.clear();
+    }
+};
+
+} // namespace nico
+
+#endif // NICO_TOKEN_STORE_H
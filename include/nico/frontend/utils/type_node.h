@@ -24,11 +24,19 @@ namespace nico {
  *
  * Includes `Type::Int` and `Type::Float`.
  */
-class Type::INumeric : virtual public Type {
+class Type::INumeric : public Type {
 public:
     virtual ~INumeric() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind >= Kind::Int && type->kind <= Kind::Float;
+    }
+
     virtual std::string to_string() const = 0;
+
+protected:
+    INumeric(Kind kind)
+        : Type(kind) {}
 };
 
 /**
@@ -51,8 +59,15 @@ public:
 
     virtual ~Int() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Int;
+    }
+
     Int(bool is_signed, uint8_t width, bool is_ptr_sized = false)
-        : is_signed(is_signed), width(width), is_ptr_sized(is_ptr_sized) {}
+        : INumeric(Kind::Int),
+          is_signed(is_signed),
+          width(width),
+          is_ptr_sized(is_ptr_sized) {}
 
     std::string to_string() const override {
         if (is_ptr_sized) {
@@ -62,7 +77,7 @@ public:
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_int = dynamic_cast<const Int*>(&other)) {
+        if (const auto* other_int = dyn_cast<Int>(&other)) {
             return is_signed == other_int->is_signed &&
                    width == other_int->width &&
                    is_ptr_sized == other_int->is_ptr_sized;
@@ -220,8 +235,12 @@ public:
 
     virtual ~Float() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Float;
+    }
+
     Float(uint8_t width)
-        : width(width) {
+        : INumeric(Kind::Float), width(width) {
         if (width != 32 && width != 64) {
             panic(
                 "Type::Float: Invalid width " + std::to_string(width) +
@@ -235,7 +254,7 @@ public:
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_float = dynamic_cast<const Float*>(&other)) {
+        if (const auto* other_float = dyn_cast<Float>(&other)) {
             return width == other_float->width;
         }
         return false;
@@ -285,10 +304,17 @@ class Type::Bool : public Type {
 public:
     virtual ~Bool() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Bool;
+    }
+
+    Bool()
+        : Type(Kind::Bool) {}
+
     std::string to_string() const override { return "bool"; }
 
     bool operator==(const Type& other) const override {
-        return dynamic_cast<const Bool*>(&other) != nullptr;
+        return isa<Bool>(&other);
     }
 
     virtual llvm::Type*
@@ -325,8 +351,12 @@ public:
 
     virtual ~IPointer() = default;
 
-    IPointer(bool is_mutable)
-        : is_mutable(is_mutable) {}
+    static bool classof(const Type* type) {
+        return type->kind >= Kind::Nullptr && type->kind <= Kind::Reference;
+    }
+
+    IPointer(Kind kind, bool is_mutable)
+        : Type(kind), is_mutable(is_mutable) {}
 
     virtual llvm::Type*
     get_llvm_type(std::unique_ptr<llvm::IRBuilder<>>& builder) const override {
@@ -347,8 +377,12 @@ class Type::IRawPtr : virtual public IPointer {
 public:
     virtual ~IRawPtr() = default;
 
-    IRawPtr(bool is_mutable)
-        : IPointer(is_mutable) {}
+    static bool classof(const Type* type) {
+        return type->kind >= Kind::Nullptr && type->kind <= Kind::RawTypedPtr;
+    }
+
+    IRawPtr(Kind kind, bool is_mutable)
+        : IPointer(kind, is_mutable) {}
 };
 
 /**
@@ -363,17 +397,22 @@ public:
  * For type compatibility purposes, a nullptr is considered mutable, even though
  * it cannot be used to modify any data (it cannot be dereferenced).
  */
-class Type::Nullptr : public Type::IRawPtr {
+class Type::Nullptr final : public Type::IRawPtr {
 public:
     virtual ~Nullptr() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Nullptr;
+    }
+
     Nullptr()
-        : Type::IPointer(true), Type::IRawPtr(true) {}
+        : Type::IPointer(Kind::Nullptr, true),
+          Type::IRawPtr(Kind::Nullptr, true) {}
 
     std::string to_string() const override { return "nullptr"; }
 
     bool operator==(const Type& other) const override {
-        return dynamic_cast<const Nullptr*>(&other) != nullptr;
+        return isa<Nullptr>(&other);
     }
 
     virtual bool is_assignable_to(std::shared_ptr<Type> other) override {
@@ -394,17 +433,22 @@ public:
  * For type compatibility purposes, an any-pointer is considered mutable, even
  * though it cannot be used to modify any data (it cannot be dereferenced).
  */
-class Type::Anyptr : public Type::IRawPtr {
+class Type::Anyptr final : public Type::IRawPtr {
 public:
     virtual ~Anyptr() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Anyptr;
+    }
+
     Anyptr()
-        : Type::IPointer(true), Type::IRawPtr(true) {}
+        : Type::IPointer(Kind::Anyptr, true),
+          Type::IRawPtr(Kind::Anyptr, true) {}
 
     std::string to_string() const override { return "anyptr"; }
 
     bool operator==(const Type& other) const override {
-        return dynamic_cast<const Anyptr*>(&other) != nullptr;
+        return isa<Anyptr>(&other);
     }
 };
 
@@ -421,8 +465,12 @@ public:
 
     virtual ~ITypedPtr() = default;
 
-    ITypedPtr(std::shared_ptr<Type> base, bool is_mutable)
-        : IPointer(is_mutable), base(base) {}
+    static bool classof(const Type* type) {
+        return type->kind >= Kind::RawTypedPtr && type->kind <= Kind::Reference;
+    }
+
+    ITypedPtr(Kind kind, std::shared_ptr<Type> base, bool is_mutable)
+        : IPointer(kind, is_mutable), base(base) {}
 };
 
 /**
@@ -431,22 +479,26 @@ public:
  * Raw typed pointers are raw pointers that also have a base type.
  * They are usually the most common raw pointer type used.
  */
-class Type::RawTypedPtr : public Type::IRawPtr, public Type::ITypedPtr {
+class Type::RawTypedPtr final : public Type::IRawPtr,
+                                 public Type::ITypedPtr {
 public:
     virtual ~RawTypedPtr() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::RawTypedPtr;
+    }
+
     RawTypedPtr(std::shared_ptr<Type> base, bool is_mutable)
-        : IPointer(is_mutable),
-          IRawPtr(is_mutable),
-          ITypedPtr(base, is_mutable) {}
+        : IPointer(Kind::RawTypedPtr, is_mutable),
+          IRawPtr(Kind::RawTypedPtr, is_mutable),
+          ITypedPtr(Kind::RawTypedPtr, base, is_mutable) {}
 
     std::string to_string() const override {
         return std::string(is_mutable ? "var" : "") + "@" + base->to_string();
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_pointer =
-                dynamic_cast<const RawTypedPtr*>(&other)) {
+        if (const auto* other_pointer = dyn_cast<RawTypedPtr>(&other)) {
             return *base == *other_pointer->base &&
                    is_mutable == other_pointer->is_mutable;
         }
@@ -488,20 +540,24 @@ public:
  *
  * References are pointers with special semantics.
  */
-class Type::Reference : public Type::ITypedPtr {
+class Type::Reference final : public Type::ITypedPtr {
 public:
     virtual ~Reference() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Reference;
+    }
+
     Reference(std::shared_ptr<Type> base, bool is_mutable)
-        : IPointer(is_mutable), ITypedPtr(base, is_mutable) {}
+        : IPointer(Kind::Reference, is_mutable),
+          ITypedPtr(Kind::Reference, base, is_mutable) {}
 
     std::string to_string() const override {
         return std::string(is_mutable ? "var" : "") + "&" + base->to_string();
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_reference =
-                dynamic_cast<const Reference*>(&other)) {
+        if (const auto* other_reference = dyn_cast<Reference>(&other)) {
             return *base == *other_reference->base &&
                    is_mutable == other_reference->is_mutable;
         }
@@ -541,10 +597,17 @@ class Type::Str : public Type {
 public:
     virtual ~Str() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Str;
+    }
+
+    Str()
+        : Type(Kind::Str) {}
+
     std::string to_string() const override { return "str"; }
 
     bool operator==(const Type& other) const override {
-        return dynamic_cast<const Str*>(&other) != nullptr;
+        return isa<Str>(&other);
     }
 
     virtual llvm::Type*
@@ -582,11 +645,20 @@ public:
 
     virtual ~Array() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind >= Kind::Array && type->kind <= Kind::EmptyArray;
+    }
+
     Array(std::shared_ptr<Type> base)
-        : base(base), size(std::nullopt) {}
+        : Type(Kind::Array), base(base), size(std::nullopt) {}
 
     Array(std::shared_ptr<Type> base, size_t size)
-        : base(
+        : Array(Kind::Array, base, size) {}
+
+protected:
+    Array(Kind kind, std::shared_ptr<Type> base, size_t size)
+        : Type(kind),
+          base(
               size == 0 ? std::dynamic_pointer_cast<Type>(
                               std::make_shared<Type::Unit>()
                           )
@@ -594,6 +666,7 @@ public:
           ),
           size(size) {}
 
+public:
     std::string to_string() const override {
         if (size.has_value() && size.value() == 0) {
             return "[]";
@@ -603,7 +676,7 @@ public:
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_array = dynamic_cast<const Array*>(&other)) {
+        if (const auto* other_array = dyn_cast<Array>(&other)) {
             return *base == *other_array->base && size == other_array->size;
         }
         return false;
@@ -695,13 +768,17 @@ class Type::EmptyArray : public Type::Array {
 public:
     virtual ~EmptyArray() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::EmptyArray;
+    }
+
     EmptyArray()
-        : Type::Array(nullptr, 0) {}
+        : Type::Array(Kind::EmptyArray, nullptr, 0) {}
 
     std::string to_string() const override { return "[]"; }
 
     bool operator==(const Type& other) const override {
-        return dynamic_cast<const EmptyArray*>(&other) != nullptr;
+        return isa<EmptyArray>(&other);
     }
 
     virtual llvm::Type*
@@ -734,9 +811,18 @@ public:
 
     virtual ~Tuple() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind >= Kind::Tuple && type->kind <= Kind::Unit;
+    }
+
     Tuple(std::vector<std::shared_ptr<Type>> elements)
-        : elements(std::move(elements)) {}
+        : Tuple(Kind::Tuple, std::move(elements)) {}
 
+protected:
+    Tuple(Kind kind, std::vector<std::shared_ptr<Type>> elements)
+        : Type(kind), elements(std::move(elements)) {}
+
+public:
     std::string to_string() const override {
         std::string result = "(";
         for (const auto& element : elements) {
@@ -764,7 +850,7 @@ public:
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_tuple = dynamic_cast<const Tuple*>(&other)) {
+        if (const auto* other_tuple = dyn_cast<Tuple>(&other)) {
             if (elements.size() != other_tuple->elements.size()) {
                 return false;
             }
@@ -829,8 +915,12 @@ class Type::Unit : public Type::Tuple {
 public:
     virtual ~Unit() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Unit;
+    }
+
     Unit()
-        : Tuple({}) {}
+        : Tuple(Kind::Unit, {}) {}
 
     std::string to_string() const override { return "()"; }
 
@@ -860,8 +950,12 @@ public:
 
     virtual ~Object() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Object;
+    }
+
     Object(Dictionary<std::string, Binding>&& fields)
-        : fields(std::move(fields)) {}
+        : Type(Kind::Object), fields(std::move(fields)) {}
 
     std::string to_string() const override {
         std::string result = "{";
@@ -877,7 +971,7 @@ public:
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_object = dynamic_cast<const Object*>(&other)) {
+        if (const auto* other_object = dyn_cast<Object>(&other)) {
             return fields == other_object->fields;
         }
         return false;
@@ -971,8 +1065,12 @@ public:
 
     virtual ~Struct() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Struct;
+    }
+
     Struct(std::weak_ptr<Node::StructDef> node)
-        : node(node) {
+        : Type(Kind::Struct), node(node) {
         if (node.expired()) {
             panic("Type::Struct: Node is expired");
         }
@@ -988,7 +1086,7 @@ public:
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_named = dynamic_cast<const Struct*>(&other)) {
+        if (const auto* other_named = dyn_cast<Struct>(&other)) {
             return node.lock() == other_named->node.lock();
         }
         return false;
@@ -1059,6 +1157,10 @@ class Type::ICallable : public Type {
 public:
     virtual ~ICallable() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind >= Kind::Function && type->kind <= Kind::OverloadedFn;
+    }
+
     virtual std::pair<std::string, std::vector<llvm::Value*>> to_print_args(
         std::unique_ptr<llvm::IRBuilder<>>& builder,
         llvm::Value* value,
@@ -1071,6 +1173,10 @@ public:
     get_llvm_type(std::unique_ptr<llvm::IRBuilder<>>& builder) const override {
         return llvm::PointerType::get(builder->getContext(), 0);
     }
+
+protected:
+    ICallable(Kind kind)
+        : Type(kind) {}
 };
 
 /**
@@ -1101,12 +1207,17 @@ public:
 
     virtual ~Function() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Function;
+    }
+
     Function(
         Dictionary<std::string, Binding> parameters,
         std::shared_ptr<Type> return_type,
         bool is_variadic = false
     )
-        : parameters(std::move(parameters)),
+        : ICallable(Kind::Function),
+          parameters(std::move(parameters)),
           return_type(std::move(return_type)),
           is_variadic(is_variadic) {}
 
@@ -1127,8 +1238,7 @@ public:
     }
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_function =
-                dynamic_cast<const Function*>(&other)) {
+        if (const auto* other_function = dyn_cast<Function>(&other)) {
             return parameters == other_function->parameters &&
                    *return_type == *other_function->return_type &&
                    is_variadic == other_function->is_variadic;
@@ -1186,7 +1296,12 @@ public:
 
     virtual ~OverloadedFn() = default;
 
-    OverloadedFn() = default;
+    static bool classof(const Type* type) {
+        return type->kind == Kind::OverloadedFn;
+    }
+
+    OverloadedFn()
+        : ICallable(Kind::OverloadedFn) {}
 
     std::string to_string() const override { return "overloadedfn"; }
 
@@ -1210,6 +1325,13 @@ class Type::Void : public Type {
 public:
     virtual ~Void() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Void;
+    }
+
+    Void()
+        : Type(Kind::Void) {}
+
     std::string to_string() const override { return "void"; }
 
     virtual llvm::Type*
@@ -1226,7 +1348,7 @@ public:
     }
 
     virtual bool operator==(const Type& other) const override {
-        return dynamic_cast<const Void*>(&other) != nullptr;
+        return isa<Void>(&other);
     }
 
     virtual bool is_assignable_to(std::shared_ptr<Type> other) override {
@@ -1263,8 +1385,12 @@ public:
 
     virtual ~Named() = default;
 
+    static bool classof(const Type* type) {
+        return type->kind == Kind::Named;
+    }
+
     Named(std::weak_ptr<Node::ITypeNode> node)
-        : node(node) {
+        : Type(Kind::Named), node(node) {
         if (node.expired()) {
             panic("Type::Named: Node is expired.");
         }
@@ -1303,14 +1429,13 @@ private:
         if (!node_ptr) {
             panic("Type::Named: Node has expired.");
         }
-        if (PTR_INSTANCEOF(node_ptr, Node::UnresolvedType)) {
+        if (isa<Node::UnresolvedType>(node_ptr)) {
             panic(
                 "Type::Named: Cannot access inner type of unresolved named "
                 "type."
             );
         }
-        if (auto inner_named =
-                std::dynamic_pointer_cast<Type::Named>(node_ptr->type)) {
+        if (auto inner_named = dyn_cast<Type::Named>(node_ptr->type)) {
             return inner_named->get_inner_type(recursion_level + 1);
         }
         cached_inner_type = node_ptr->type;
@@ -1321,7 +1446,7 @@ public:
     std::string to_string() const override;
 
     bool operator==(const Type& other) const override {
-        if (const auto* other_named = dynamic_cast<const Named*>(&other)) {
+        if (const auto* other_named = dyn_cast<Named>(&other)) {
             return node.lock() == other_named->node.lock();
         }
         return false;
@@ -1335,7 +1460,7 @@ public:
         if (!node_ptr) {
             panic("Type::Named: Node has expired.");
         }
-        if (PTR_INSTANCEOF(node_ptr, Node::UnresolvedType)) {
+        if (isa<Node::UnresolvedType>(node_ptr)) {
             // Size is indeterminate until the type is resolved.
             return false;
         }
@@ -0,0 +1,67 @@
+#ifndef NICO_VISIT_RESULT_H
+#define NICO_VISIT_RESULT_H
+
+#include <optional>
+#include <utility>
+
+namespace nico {
+
+/**
+ * @brief Holds the return value of a visit function until `accept` returns it.
+ *
+ * Nodes dispatch to their visitor's handler through a virtual call, which
+ * cannot return a templated type. The handler calls the typed visit function
+ * and stores its return value here instead, in place, without boxing it.
+ *
+ * @tparam R The type returned by the visit functions.
+ */
+template <typename R>
+class VisitResult {
+    // The stored return value; nullopt if none has been stored since the last
+    // take.
+    std::optional<R> value;
+
+public:
+    /**
+     * @brief Calls a visit function and stores its return value.
+     *
+     * @param visit A callable that calls the visit function.
+     */
+    template <typename F>
+    void store(F&& visit) {
+        value.emplace(visit());
+    }
+
+    /**
+     * @brief Moves the stored return value out.
+     *
+     * Nested visits store and take their own values before the outer visit
+     * function returns, so the stored value always belongs to the most recent
+     * visit.
+     *
+     * @return The stored return value.
+     */
+    R take() {
+        R result = std::move(*value);
+        value.reset();
+        return result;
+    }
+};
+
+/**
+ * @brief A visit result for visit functions that return nothing.
+ */
+template <>
+class VisitResult<void> {
+public:
+    template <typename F>
+    void store(F&& visit) {
+        visit();
+    }
+
+    void take() {}
+};
+
+} // namespace nico
+
+#endif // NICO_VISIT_RESULT_H
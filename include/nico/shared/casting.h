@@ -0,0 +1,111 @@
+#ifndef NICO_CASTING_H
+#define NICO_CASTING_H
+
+#include <memory>
+#include <type_traits>
+
+namespace nico {
+
+/**
+ * @brief Checks if a pointer can be converted to a derived class pointer with
+ * `static_cast`.
+ *
+ * This is not the case when the derived class inherits from the base class
+ * virtually.
+ */
+template <typename To, typename From, typename = void>
+struct is_static_castable : std::false_type {};
+
+template <typename To, typename From>
+struct is_static_castable<
+    To,
+    From,
+    std::void_t<decltype(static_cast<To*>(std::declval<From*>()))>>
+    : std::true_type {};
+
+/**
+ * @brief Checks if an object is an instance of a class.
+ *
+ * Unlike `dynamic_cast`, this only compares the object's kind tag, using the
+ * target class's `classof` function.
+ *
+ * @tparam To The class to check against. Must define
+ * `static bool classof(const Base*)`, where `Base` is the root of its
+ * hierarchy.
+ * @param from The object to check. May be null.
+ * @return True if `from` is not null and is an instance of `To`. False
+ * otherwise.
+ */
+template <typename To, typename From>
+bool isa(const From* from) {
+    if constexpr (std::is_base_of_v<To, From>) {
+        return from != nullptr;
+    }
+    else {
+        return from != nullptr && To::classof(from);
+    }
+}
+
+template <typename To, typename From>
+bool isa(const std::shared_ptr<From>& from) {
+    return isa<To>(from.get());
+}
+
+/**
+ * @brief Converts an object to a class it is known to be an instance of.
+ *
+ * The conversion uses `static_cast` where the class hierarchy allows it.
+ * For classes that inherit their root virtually, final classes are reached
+ * through the complete object pointer, and only other classes fall back to
+ * `dynamic_cast`.
+ *
+ * @tparam To The class to convert to.
+ * @param from The object to convert. Must be an instance of `To`.
+ * @return `from` as a pointer to `To`.
+ */
+template <typename To, typename From>
+auto cast(From* from) {
+    using Result = std::conditional_t<std::is_const_v<From>, const To, To>;
+    using Complete =
+        std::conditional_t<std::is_const_v<From>, const void, void>;
+    if constexpr (std::is_base_of_v<To, From> ||
+                  is_static_castable<Result, From>::value) {
+        return static_cast<Result*>(from);
+    }
+    else if constexpr (std::is_final_v<To>) {
+        return static_cast<Result*>(dynamic_cast<Complete*>(from));
+    }
+    else {
+        return dynamic_cast<Result*>(from);
+    }
+}
+
+template <typename To, typename From>
+std::shared_ptr<To> cast(const std::shared_ptr<From>& from) {
+    return std::shared_ptr<To>(from, cast<To>(from.get()));
+}
+
+/**
+ * @brief Converts an object to a class if it is an instance of it.
+ *
+ * A drop-in replacement for `dynamic_cast` and `std::dynamic_pointer_cast`
+ * that checks the object's kind tag first.
+ *
+ * @tparam To The class to convert to.
+ * @param from The object to convert. May be null.
+ * @return `from` as a pointer to `To` if it is an instance of `To`. Null
+ * otherwise.
+ */
+template <typename To, typename From>
+auto dyn_cast(From* from) -> decltype(cast<To>(from)) {
+    return isa<To>(from) ? cast<To>(from) : nullptr;
+}
+
+template <typename To, typename From>
+std::shared_ptr<To> dyn_cast(const std::shared_ptr<From>& from) {
+    return isa<To>(from) ? cast<To>(from) : nullptr;
+}
+
+} // namespace nico
+
+#endif // NICO_CASTING_H
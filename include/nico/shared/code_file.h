@@ -1,33 +1,139 @@
 #ifndef NICO_CODE_FILE_H
 #define NICO_CODE_FILE_H
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace nico {
 
 /**
  * @brief A struct to hold the path and source code of a file.
+ *
+ * The source code is either owned by the CodeFile as a string or, for files
+ * read with `read_code_file`, a read-only memory mapping of the file. Either
+ * way, it is accessed through `src_code`.
+ *
+ * Every live CodeFile has a unique ID, which tokens and locations use to refer
+ * to the file without holding a pointer to it. A file can be found from its ID
+ * with `CodeFile::get` for as long as the file is alive.
  */
 struct CodeFile {
+private:
+    // Ensures the line start table is built once.
+    mutable std::once_flag line_starts_flag;
+    // The index of the first character of each line, in increasing order.
+    // Built on first use by `get_line_bounds`.
+    mutable std::vector<uint32_t> line_starts;
+    // The source code, if it is owned rather than mapped.
+    std::string owned_code;
+    // The start of the mapping of the file, or nullptr if the source code is
+    // owned.
+    void* mapping = nullptr;
+    // The source code, in either `owned_code` or the mapping.
+    std::string_view code;
+
+    /**
+     * @brief Construct a new CodeFile object for a mapped file.
+     *
+     * @param mapping The start of the read-only mapping of the file. It will be
+     * unmapped when the CodeFile is destroyed.
+     * @param length The length of the file in bytes.
+     * @param path_string The absolute path of the file.
+     */
+    CodeFile(void* mapping, size_t length, const std::string& path_string);
+
+    friend std::optional<std::shared_ptr<CodeFile>>
+    read_code_file(std::string_view file_name);
+
+public:
+    // The largest source a CodeFile can hold, in bytes. Token locations store
+    // offsets and lengths in 32 bits.
+    static constexpr size_t max_size = UINT32_MAX;
+
+    // The unique ID of this file. The ID of a destroyed file may be given to
+    // a new one.
+    const uint32_t id;
     // The location of the file. If the code came from a file, this should be
     // the absolute path.
     const std::string path_string;
-    // The source code from the file.
-    const std::string src_code;
 
     /**
      * @brief Construct a new CodeFile object.
      *
      * A CodeFile is a wrapper for a source code string and a path string.
      *
-     * @param src_code (Requires move) The source code from the file.
+     * @param src_code (Requires move) The source code from the file. Must be
+     * at most `max_size` bytes.
      * @param path_string The location where the file was read from. If the code
      * came from a file, this should be the absolute path.
+     * @warning If the source code is larger than `max_size`, the program will
+     * panic.
      */
-    CodeFile(const std::string&& src_code, const std::string& path_string)
-        : path_string(path_string), src_code(std::move(src_code)) {}
+    CodeFile(std::string&& src_code, const std::string& path_string);
+
+    ~CodeFile();
+
+    CodeFile(const CodeFile&) = delete;
+    CodeFile& operator=(const CodeFile&) = delete;
+
+    /**
+     * @brief Gets the live CodeFile with the given ID.
+     *
+     * This function does not lock, so it is cheap to call from any thread.
+     *
+     * @param id The ID of the file.
+     * @return A reference to the file.
+     *
+     * @warning If no live file has the ID, the program will panic.
+     */
+    static const CodeFile& get(uint32_t id);
+
+    /**
+     * @brief Gets the source code from the file.
+     *
+     * @return A view of the source code, valid for as long as the file is
+     * alive.
+     */
+    std::string_view src_code() const { return code; }
+
+    /**
+     * @brief Gets the bounds of the line containing a character.
+     *
+     * The first call builds a table of line starts, which takes time linear in
+     * the length of the source code. Later calls search the table in
+     * logarithmic time. This function is thread-safe.
+     *
+     * @param offset The index of the character. May be equal to the length of
+     * the source code.
+     * @return A pair of the index of the first character of the line and the
+     * index just past its last character, not counting the newline.
+     */
+    std::pair<size_t, size_t> get_line_bounds(size_t offset) const;
 };
 
+/**
+ * @brief Reads the file at the given path into a new CodeFile.
+ *
+ * Regular files are mapped into memory rather than copied, so pages of the
+ * file are only read when they are first accessed. Other files, e.g. pipes,
+ * are read into a string in chunks until EOF.
+ *
+ * The path of the resulting CodeFile is set to the absolute path of the file.
+ *
+ * @param file_name The path to the file to read. Paths are relative to CWD.
+ * @return A shared pointer to the new CodeFile, or std::nullopt if the file
+ * could not be opened or is larger than `CodeFile::max_size`.
+ * @warning A mapped file must not be truncated while the CodeFile is alive.
+ */
+std::optional<std::shared_ptr<CodeFile>>
+read_code_file(std::string_view file_name);
+
 } // namespace nico
 
 #endif // NICO_CODE_FILE_H
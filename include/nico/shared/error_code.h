@@ -358,6 +358,8 @@ enum class Err {
     FileIO,
     // The emitter failed to emit the intended file.
     EmitterCannotEmitFile,
+    // The system linker failed to link the emitted object file.
+    LinkerFailed,
 
     // Post-processing error
     PostProcessingError = 8000,
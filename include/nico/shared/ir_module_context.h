@@ -8,15 +8,13 @@
 
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
-#include <llvm/MC/TargetRegistry.h>
-#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Error.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
-#include <llvm/Target/TargetOptions.h>
-#include <llvm/TargetParser/Host.h>
 
 #include "nico/shared/diagnostics.h"
 #include "nico/shared/error_code.h"
+#include "nico/shared/target_spec.h"
 
 namespace nico {
 
@@ -71,9 +69,16 @@ public:
     /**
      * @brief Initialize an IRModuleContext with a new LLVM context and module.
      *
+     * The target machine is created from the provided target spec, and the
+     * module's target triple and data layout are set to match it.
+     *
      * @param module_name The name of the module. Defaults to "main".
+     * @param target_spec The target to generate code for. Defaults to the host.
      */
-    void initialize(std::string_view module_name = "main") {
+    void initialize(
+        std::string_view module_name = "main",
+        const TargetSpec& target_spec = TargetSpec()
+    ) {
         // The module must be destroyed before the context, so we set it to
         // nullptr first to ensure the correct destruction order in case of an
         // exception.
@@ -84,44 +89,46 @@ public:
             *llvm_context
         );
 
-        auto target_triple = llvm::sys::getDefaultTargetTriple();
         llvm::InitializeNativeTarget();
         llvm::InitializeNativeTargetAsmParser();
         llvm::InitializeNativeTargetAsmPrinter();
 
-        std::string error;
-        auto target = llvm::TargetRegistry::lookupTarget(target_triple, error);
-        if (!target) {
+        auto jtmb = target_spec.create_target_machine_builder();
+        if (!jtmb) {
             Diagnostics::inst().emit_error(
                 Err::CannotLookupTarget,
-                "Failed to lookup target: " + error
+                "Failed to lookup target: " + llvm::toString(jtmb.takeError())
             );
             return;
         }
 
-        auto cpu = "generic";
-        auto features = "";
-        llvm::TargetOptions options;
-        target_machine =
-            std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
-                target_triple,
-                cpu,
-                features,
-                options,
-                llvm::Reloc::PIC_
-            ));
-
-        if (!target_machine) {
+        auto target_triple = jtmb->getTargetTriple().str();
+        auto tm_or_err = jtmb->createTargetMachine();
+        if (!tm_or_err) {
             Diagnostics::inst().emit_error(
                 Err::CannotCreateTargetMachine,
-                "Failed to create target machine for triple: " + target_triple
+                "Failed to create target machine for triple: " + target_triple +
+                    ": " + llvm::toString(tm_or_err.takeError())
             );
             return;
         }
+        target_machine = std::move(*tm_or_err);
 
+        ir_module->setTargetTriple(target_triple);
         ir_module->setDataLayout(target_machine->createDataLayout());
     }
 
+    /**
+     * @brief Checks if the context has been initialized and nothing has been
+     * added to its module yet.
+     *
+     * @return True if the module is initialized and empty, false otherwise.
+     */
+    bool is_fresh() const {
+        return ir_module != nullptr && target_machine != nullptr &&
+               ir_module->empty() && ir_module->global_empty();
+    }
+
     /**
      * @brief Get the width of a pointer in bits based on the data layout of the
      * IR module.
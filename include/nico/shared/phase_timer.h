@@ -0,0 +1,149 @@
+#ifndef NICO_PHASE_TIMER_H
+#define NICO_PHASE_TIMER_H
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nico {
+
+/**
+ * @brief Phase timer singleton for measuring where compile time goes.
+ *
+ * Each phase of compilation (lexing, parsing, optimization, and so on) opens a
+ * `Scope` for its duration. When timing is enabled, the scope records the wall
+ * time, CPU time, and peak RSS delta of the phase. When timing is disabled,
+ * scopes do nothing.
+ *
+ * Phases may be nested. A nested phase is reported beneath the phase it ran
+ * within, and its time is included in that phase's time.
+ */
+class PhaseTimer {
+public:
+    /**
+     * @brief The measurements of a single phase.
+     */
+    struct Record {
+        // The name of the phase.
+        std::string name;
+        // The number of phases this phase was nested in on its thread.
+        size_t depth = 0;
+        // The wall time of the phase, in milliseconds.
+        double wall_ms = 0.0;
+        // The CPU time used by the process during the phase, in milliseconds.
+        double cpu_ms = 0.0;
+        // The growth of the process's peak resident set size during the phase,
+        // in kilobytes. 0 if the platform does not report it.
+        long peak_rss_delta_kb = 0;
+    };
+
+    /**
+     * @brief An RAII object that times a phase from its construction to its
+     * destruction.
+     */
+    class Scope {
+        // The timer to record to, or nullptr if timing was disabled.
+        PhaseTimer* timer;
+        // The index of this phase's record.
+        size_t index = 0;
+        // The wall clock time when the phase started.
+        std::chrono::steady_clock::time_point wall_start;
+        // The CPU time when the phase started, in milliseconds.
+        double cpu_start_ms = 0.0;
+        // The peak RSS when the phase started, in kilobytes.
+        long peak_rss_start_kb = 0;
+
+    public:
+        Scope(PhaseTimer* timer, std::string_view name);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    // Whether phases are being timed.
+    bool enabled = false;
+    // Guards `records`, since phases may run on JIT compile threads.
+    std::mutex mutex;
+    // The records of all timed phases, in the order the phases started.
+    std::vector<Record> records;
+
+    PhaseTimer() = default;
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+public:
+    /**
+     * @brief Get the instance of the PhaseTimer singleton.
+     *
+     * If the instance does not exist, it will be created.
+     *
+     * @return A reference to the PhaseTimer singleton instance.
+     */
+    static PhaseTimer& inst() {
+        static PhaseTimer instance;
+        return instance;
+    }
+
+    /**
+     * @brief Sets whether phases should be timed.
+     *
+     * Only scopes opened after this call are affected.
+     *
+     * @param value True to enable timing, false to disable it.
+     */
+    void set_enabled(bool value) { enabled = value; }
+
+    /**
+     * @brief Starts timing a phase. The phase ends when the returned scope is
+     * destroyed.
+     *
+     * @param name The name of the phase.
+     * @return The scope of the phase.
+     */
+    Scope scope(std::string_view name) {
+        return Scope(enabled ? this : nullptr, name);
+    }
+
+    /**
+     * @brief Resets the timer, clearing all records.
+     *
+     * Scopes must not be open while the timer is reset.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the records of all timed phases.
+     *
+     * @return A copy of the records, in the order the phases started.
+     */
+    std::vector<Record> get_records();
+
+    /**
+     * @brief Prints the records as a human-readable table.
+     *
+     * Nested phases are indented beneath their parent phase.
+     *
+     * @param out The stream to print to.
+     */
+    void print_report(std::ostream& out);
+
+    /**
+     * @brief Prints the records as a JSON object.
+     *
+     * The object has a single key, "phases", mapping to an array of objects
+     * with the keys "name", "depth", "wall_ms", "cpu_ms", and
+     * "peak_rss_delta_kb".
+     *
+     * @param out The stream to print to.
+     */
+    void print_json(std::ostream& out);
+};
+
+} // namespace nico
+
+#endif // NICO_PHASE_TIMER_H
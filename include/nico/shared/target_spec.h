@@ -0,0 +1,48 @@
+#ifndef NICO_TARGET_SPEC_H
+#define NICO_TARGET_SPEC_H
+
+#include <string>
+
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/Support/Error.h>
+
+namespace nico {
+
+/**
+ * @brief A description of the machine that code should be generated for.
+ *
+ * The JIT and the IR module context both create their target machines from
+ * the same spec, so IR that is generated and optimized for a target is also
+ * compiled for that target.
+ *
+ * By default, the spec describes the host machine, including all CPU
+ * features that the host supports (e.g., AVX2, BMI, FMA).
+ */
+struct TargetSpec {
+    // The name of the CPU to generate code for, as accepted by LLVM
+    // (e.g., "skylake", "znver3", "generic"). "native" selects the host CPU.
+    std::string cpu = "native";
+    // A comma-separated list of features to enable or disable on top of the
+    // CPU's features (e.g., "+avx2,-avx512f").
+    std::string features;
+
+    /**
+     * @brief Creates a JIT target machine builder matching this spec.
+     *
+     * When the CPU is "native", the host CPU and all of its features are
+     * detected. Otherwise, only the features of the named CPU are used.
+     * Extra features from `features` are applied in both cases.
+     *
+     * The relocation model is always PIC so that generated objects can be
+     * linked into position-independent executables.
+     *
+     * @return A target machine builder, or an error if the host could not be
+     * detected.
+     */
+    llvm::Expected<llvm::orc::JITTargetMachineBuilder>
+    create_target_machine_builder() const;
+};
+
+} // namespace nico
+
+#endif // NICO_TARGET_SPEC_H
@@ -1,12 +1,14 @@
 #ifndef NICO_TOKEN_H
 #define NICO_TOKEN_H
 
-#include <any>
-#include <memory>
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
 
 #include "nico/shared/code_file.h"
+#include "nico/shared/utils.h"
 
 namespace nico {
 
@@ -308,29 +310,39 @@ inline bool is_stmt_starting_keyword(Tok tok) {
 /**
  * @brief A location of a token within a code file.
  *
- * Includes a pointer to the code file containing the source code string.
+ * Refers to the code file by ID, so locations are small and cheap to copy.
+ * The code file must be alive when the file is accessed.
  */
 struct Location {
-    // The file where the token is located.
-    std::shared_ptr<CodeFile> file;
+    // The ID of the file where the token is located.
+    uint32_t file_id;
     // The start index of the token.
-    size_t start;
+    uint32_t start;
     // The length of the token.
-    size_t length;
+    uint32_t length;
     // The line number of the token.
-    size_t line;
+    uint32_t line;
 
     /**
      * @brief Constructs a new Location object.
      *
-     * @param file A pointer to the code file.
+     * @param file_id The ID of the code file.
      * @param start The start index of the token.
      * @param length The length of the token.
+     * @param line The line number of the token.
      */
-    Location(
-        std::shared_ptr<CodeFile> file, size_t start, size_t length, size_t line
-    )
-        : file(file), start(start), length(length), line(line) {}
+    Location(uint32_t file_id, size_t start, size_t length, size_t line)
+        : file_id(file_id),
+          start(static_cast<uint32_t>(start)),
+          length(static_cast<uint32_t>(length)),
+          line(static_cast<uint32_t>(line)) {}
+
+    /**
+     * @brief Gets the code file containing this location.
+     *
+     * @return A reference to the code file.
+     */
+    const CodeFile& file() const { return CodeFile::get(file_id); }
 
     /**
      * @brief Convert the location to a 3-tuple of (file path, line number,
@@ -339,11 +351,9 @@ struct Location {
      * number.
      */
     std::tuple<std::string, size_t, size_t> to_tuple() const {
-        size_t line_start = file->src_code.rfind('\n', start);
-        if (line_start == std::string::npos) {
-            line_start = 0;
-        }
-        return {file->path_string, line, start - line_start + 1};
+        const CodeFile& code_file = file();
+        size_t line_start = code_file.get_line_bounds(start).first;
+        return {code_file.path_string, line, start - line_start + 1};
     }
 
     /**
@@ -358,37 +368,232 @@ struct Location {
     }
 };
 
+/**
+ * @brief The literal value of a token, stored as a tag and an 8-byte payload.
+ *
+ * Numbers are stored in the payload directly. Strings are stored elsewhere
+ * (see `TokenStore`), and the payload points to them.
+ *
+ * Values are read with `get<T>()`, where T must be the type the value was
+ * stored as.
+ */
+class Literal {
+public:
+    /**
+     * @brief The type of value stored in a literal.
+     */
+    enum class Kind : uint8_t {
+        None,
+        Int8,
+        Int16,
+        Int32,
+        Int64,
+        UInt8,
+        UInt16,
+        UInt32,
+        UInt64,
+        Float32,
+        Float64,
+        Bool,
+        Str
+    };
+
+private:
+    // The type of value stored.
+    Kind kind = Kind::None;
+    // The value stored.
+    union {
+        int64_t int_value;
+        uint64_t uint_value;
+        float float32_value;
+        double float64_value;
+        bool bool_value;
+        const std::string* str_value;
+    };
+
+    template <typename T>
+    static constexpr bool always_false = false;
+
+public:
+    Literal()
+        : uint_value(0) {}
+
+    /**
+     * @brief Gets the kind that values of type T are stored as.
+     *
+     * Integers are stored by size and signedness, so e.g. `size_t` is stored as
+     * `UInt64` on 64-bit platforms.
+     *
+     * @tparam T The type of the value.
+     * @return The kind for the type.
+     */
+    template <typename T>
+    static constexpr Kind kind_of() {
+        if constexpr (std::is_same_v<T, bool>)
+            return Kind::Bool;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            return sizeof(T) == 1   ? Kind::Int8
+                   : sizeof(T) == 2 ? Kind::Int16
+                   : sizeof(T) == 4 ? Kind::Int32
+                                    : Kind::Int64;
+        else if constexpr (std::is_integral_v<T>)
+            return sizeof(T) == 1   ? Kind::UInt8
+                   : sizeof(T) == 2 ? Kind::UInt16
+                   : sizeof(T) == 4 ? Kind::UInt32
+                                    : Kind::UInt64;
+        else if constexpr (std::is_same_v<T, float>)
+            return Kind::Float32;
+        else if constexpr (std::is_same_v<T, double>)
+            return Kind::Float64;
+        else if constexpr (std::is_same_v<T, std::string>)
+            return Kind::Str;
+        else
+            static_assert(always_false<T>, "Unsupported literal type.");
+    }
+
+    /**
+     * @brief Creates a literal holding a number or a boolean.
+     *
+     * @tparam T The type of the value.
+     * @param value The value to store.
+     * @return The new literal.
+     */
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    static Literal of(T value) {
+        Literal literal;
+        literal.kind = kind_of<T>();
+        if constexpr (std::is_same_v<T, bool>)
+            literal.bool_value = value;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            literal.int_value = value;
+        else if constexpr (std::is_integral_v<T>)
+            literal.uint_value = value;
+        else if constexpr (std::is_same_v<T, float>)
+            literal.float32_value = value;
+        else
+            literal.float64_value = value;
+        return literal;
+    }
+
+    /**
+     * @brief Creates a literal referring to a string.
+     *
+     * @param value The string. It must outlive the literal.
+     * @return The new literal.
+     */
+    static Literal of_str(const std::string& value) {
+        Literal literal;
+        literal.kind = Kind::Str;
+        literal.str_value = &value;
+        return literal;
+    }
+
+    /**
+     * @brief Gets the kind of value stored in this literal.
+     *
+     * @return The kind of value stored.
+     */
+    Kind get_kind() const { return kind; }
+
+    /**
+     * @brief Checks if this literal holds a value.
+     *
+     * @return True if a value is stored, false otherwise.
+     */
+    bool has_value() const { return kind != Kind::None; }
+
+    /**
+     * @brief Gets the value stored in this literal.
+     *
+     * @tparam T The type the value was stored as.
+     * @return The value.
+     *
+     * @warning If the literal does not hold a value of type T, the program will
+     * panic.
+     */
+    template <typename T>
+    T get() const {
+        if (kind != kind_of<T>()) {
+            panic("Literal::get: Literal does not hold the requested type.");
+        }
+        if constexpr (std::is_same_v<T, bool>)
+            return bool_value;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            return static_cast<T>(int_value);
+        else if constexpr (std::is_integral_v<T>)
+            return static_cast<T>(uint_value);
+        else if constexpr (std::is_same_v<T, float>)
+            return float32_value;
+        else if constexpr (std::is_same_v<T, double>)
+            return float64_value;
+        else
+            return *str_value;
+    }
+};
+
+// Every token holds a literal, so it is kept to a one-byte kind and an
+// eight-byte payload, with no heap allocation.
+static_assert(sizeof(Literal) == 16, "Literal should fit in 128 bits.");
+
 /**
  * @brief A token scanned from the source code.
+ *
+ * Tokens are plain values. They are stored contiguously in the vector produced
+ * by the lexer, and the AST refers to them by pointer into a `TokenStore`.
  */
 class Token {
 public:
     // The type of this token.
     Tok tok_type;
     // The location of this token.
-    const Location location;
+    Location location;
     // A string view of the lexeme of this token.
-    const std::string_view lexeme;
-    // The literal value of this token, if any; primarily used for string
-    // literals
-    std::any literal;
+    std::string_view lexeme;
+    // The literal value of this token, if any; used for string literals and
+    // parsed numbers.
+    Literal literal;
 
     /**
      * @brief Constructs a new Token object.
      *
      * @param tok_type The type of the token.
      * @param location The location of the token.
+     * @param lexeme The lexeme of the token. Must view the source code of the
+     * file at the location.
      * @param literal The literal value of the token, if any. Default is an
-     * empty std::any value.
+     * empty literal.
      */
-    Token(Tok tok_type, const Location& location, std::any literal = std::any())
+    Token(
+        Tok tok_type,
+        const Location& location,
+        std::string_view lexeme,
+        Literal literal = Literal()
+    )
         : tok_type(tok_type),
           location(location),
-          lexeme(
-              std::string_view(location.file->src_code)
-                  .substr(location.start, location.length)
-          ),
+          lexeme(lexeme),
           literal(literal) {}
+
+    /**
+     * @brief Constructs a new Token object, finding the lexeme from the code
+     * file at the location.
+     *
+     * @param tok_type The type of the token.
+     * @param location The location of the token.
+     * @param literal The literal value of the token, if any. Default is an
+     * empty literal.
+     */
+    Token(Tok tok_type, const Location& location, Literal literal = Literal())
+        : Token(
+              tok_type,
+              location,
+              location.file().src_code().substr(
+                  location.start,
+                  location.length
+              ),
+              literal
+          ) {}
 };
 
 } // namespace nico
@@ -1,9 +1,14 @@
 #include "nico/backend/emitter.h"
 
+#include <filesystem>
+#include <memory>
 #include <string_view>
 #include <system_error>
 
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/CodeGen/ParallelCG.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/MC/TargetRegistry.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Target/TargetMachine.h>
@@ -12,7 +17,30 @@
 
 namespace nico {
 
-void Emitter::emit(
+/**
+ * @brief Closes and removes the object files written so far by a failed split
+ * emission, so that no partial output is left on disk.
+ *
+ * @param streams The output streams that were opened.
+ * @param paths The paths of the object files that were created.
+ */
+static void remove_outputs(
+    std::vector<std::unique_ptr<llvm::raw_fd_ostream>>& streams,
+    const std::vector<std::string>& paths
+) {
+    for (auto& stream : streams) {
+        // A stream with an error reports it fatally on destruction unless it
+        // is cleared first.
+        stream->clear_error();
+    }
+    streams.clear();
+    for (const auto& path : paths) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+}
+
+bool Emitter::emit(
     const IRModuleContext& mod_ctx, std::string_view target_destination
 ) {
     // Create an output stream for the object file
@@ -23,7 +51,7 @@ void Emitter::emit(
             Err::FileIO,
             "Error opening output file: " + err.message()
         );
-        return;
+        return false;
     }
 
     // Emit the module to the object file
@@ -35,11 +63,115 @@ void Emitter::emit(
             Err::EmitterCannotEmitFile,
             "Target machine cannot emit a file of this type."
         );
-        return;
+        return false;
     }
 
     pass.run(*mod_ctx.ir_module);
     dest.flush();
+    return true;
+}
+
+std::optional<std::vector<std::string>> Emitter::emit_split(
+    const IRModuleContext& mod_ctx,
+    std::string_view target_destination,
+    unsigned num_parts
+) {
+    if (num_parts <= 1) {
+        if (!emit(mod_ctx, target_destination)) {
+            return std::nullopt;
+        }
+        return std::vector<std::string>{std::string(target_destination)};
+    }
+
+    // Check up front that the target can emit object files; splitCodeGen
+    // treats this as a fatal error.
+    {
+        llvm::legacy::PassManager pass;
+        llvm::raw_null_ostream null_stream;
+        if (mod_ctx.target_machine->addPassesToEmitFile(
+                pass,
+                null_stream,
+                nullptr,
+                llvm::CodeGenFileType::ObjectFile
+            )) {
+            Diagnostics::inst().emit_error(
+                Err::EmitterCannotEmitFile,
+                "Target machine cannot emit a file of this type."
+            );
+            return std::nullopt;
+        }
+    }
+
+    std::filesystem::path destination(target_destination);
+    std::vector<std::string> paths;
+    std::vector<std::unique_ptr<llvm::raw_fd_ostream>> streams;
+    for (unsigned i = 0; i < num_parts; i++) {
+        std::filesystem::path path = destination;
+        if (i > 0) {
+            path.replace_filename(
+                destination.stem().string() + "." + std::to_string(i) +
+                destination.extension().string()
+            );
+        }
+        std::error_code err;
+        streams.push_back(
+            std::make_unique<llvm::raw_fd_ostream>(
+                path.string(),
+                err,
+                llvm::sys::fs::OF_None
+            )
+        );
+        if (err) {
+            Diagnostics::inst().emit_error(
+                Err::FileIO,
+                "Error opening output file: " + err.message()
+            );
+            remove_outputs(streams, paths);
+            return std::nullopt;
+        }
+        paths.push_back(path.string());
+    }
+
+    // Target machines are not thread-safe, so each thread gets its own, set
+    // up the same way as the module's target machine.
+    const llvm::TargetMachine& tm = *mod_ctx.target_machine;
+    auto make_target_machine = [&tm]() {
+        return std::unique_ptr<llvm::TargetMachine>(
+            tm.getTarget().createTargetMachine(
+                tm.getTargetTriple().str(),
+                tm.getTargetCPU(),
+                tm.getTargetFeatureString(),
+                tm.Options,
+                tm.getRelocationModel(),
+                tm.getCodeModel(),
+                tm.getOptLevel()
+            )
+        );
+    };
+
+    std::vector<llvm::raw_pwrite_stream*> stream_ptrs;
+    for (auto& stream : streams) {
+        stream_ptrs.push_back(stream.get());
+    }
+    llvm::splitCodeGen(
+        *mod_ctx.ir_module,
+        stream_ptrs,
+        {},
+        make_target_machine,
+        llvm::CodeGenFileType::ObjectFile
+    );
+    for (auto& stream : streams) {
+        stream->flush();
+        if (stream->has_error()) {
+            Diagnostics::inst().emit_error(
+                Err::FileIO,
+                "Error writing output file: " + stream->error().message()
+            );
+            remove_outputs(streams, paths);
+            return std::nullopt;
+        }
+    }
+    return paths;
 }
 
 } // namespace nico
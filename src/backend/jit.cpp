@@ -1,10 +1,25 @@
 #include "nico/backend/jit.h"
 
+#include <algorithm>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/IRCompileLayer.h>
+#include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
+#include <llvm/ExecutionEngine/SectionMemoryManager.h>
 #include <llvm/Support/InitLLVM.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
 
+#include "nico/backend/optimizer.h"
 #include "nico/shared/diagnostics.h"
 #include "nico/shared/error_code.h"
+#include "nico/shared/phase_timer.h"
 #include "nico/shared/utils.h"
 
 namespace nico {
@@ -38,40 +53,318 @@ IJIT::run_main_func(int argc, char** argv, std::string_view main_fn_name) {
     return func(argc, argv);
 }
 
-SimpleJIT::SimpleJIT() {
+SimpleJIT::SimpleJIT(const JITOptions& options)
+    : SimpleJIT(options, DeferCreation()) {
+    create_jit();
+}
+
+SimpleJIT::SimpleJIT(const JITOptions& options, DeferCreation)
+    : options(options) {
+    if (options.cache_dir.has_value()) {
+        object_cache = std::make_unique<ObjectFileCache>(*options.cache_dir);
+    }
+    if (options.enable_profiling) {
+        perf_map_listener = std::make_unique<PerfMapListener>();
+    }
+
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmParser();
     llvm::InitializeNativeTargetAsmPrinter();
+}
+
+void SimpleJIT::create_jit() {
+    jit.reset(); // Destroys the current LLJIT instance, if any
+
+    pending_functions.clear();
+
+    auto jtmb = options.target_spec.create_target_machine_builder();
+    if (!jtmb) {
+        panic(
+            "SimpleJIT::create_jit: Failed to detect target: " +
+            llvm::toString(jtmb.takeError())
+        );
+    }
+    target_machine_builder = *jtmb;
 
-    auto jit_or_err = llvm::orc::LLJITBuilder().create();
+    auto jit_or_err = build_jit(std::move(*jtmb));
     if (!jit_or_err) {
         panic(
-            "SimpleJIT::SimpleJIT: Failed to create LLJIT: " +
+            "SimpleJIT::create_jit: Failed to create LLJIT: " +
             llvm::toString(jit_or_err.takeError())
         );
     }
     jit = std::move(jit_or_err.get());
+    set_opt_level(options.opt_level);
+}
+
+llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>>
+SimpleJIT::build_jit(llvm::orc::JITTargetMachineBuilder jtmb) {
+    llvm::orc::LLJITBuilder builder;
+    builder.setJITTargetMachineBuilder(std::move(jtmb));
+    builder.setNumCompileThreads(options.num_compile_threads);
+    if (object_cache) {
+        builder.setCompileFunctionCreator(
+            make_cached_compile_function_creator()
+        );
+    }
+    if (perf_map_listener) {
+        builder.setObjectLinkingLayerCreator(
+            make_profiling_object_linking_layer_creator()
+        );
+    }
+    return builder.create();
+}
+
+llvm::orc::LLJITBuilderState::CompileFunctionCreator
+SimpleJIT::make_cached_compile_function_creator() {
+    if (!object_cache) {
+        panic(
+            "SimpleJIT::make_cached_compile_function_creator: Object cache is "
+            "not enabled."
+        );
+    }
+    return [cache = object_cache.get(),
+            concurrent = options.num_compile_threads > 0](
+               llvm::orc::JITTargetMachineBuilder jtmb
+           )
+               -> llvm::Expected<
+                   std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+        if (concurrent) {
+            return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+                std::move(jtmb),
+                cache
+            );
+        }
+        auto tm_or_err = jtmb.createTargetMachine();
+        if (!tm_or_err) {
+            return tm_or_err.takeError();
+        }
+        return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(
+            std::move(*tm_or_err),
+            cache
+        );
+    };
+}
+
+llvm::orc::LLJITBuilderState::ObjectLinkingLayerCreator
+SimpleJIT::make_profiling_object_linking_layer_creator() {
+    if (!perf_map_listener) {
+        panic(
+            "SimpleJIT::make_profiling_object_linking_layer_creator: "
+            "Profiling is not enabled."
+        );
+    }
+    return [perf_map = perf_map_listener.get()](
+               llvm::orc::ExecutionSession& es,
+               const llvm::Triple& triple
+           ) -> llvm::Expected<std::unique_ptr<llvm::orc::ObjectLayer>> {
+        auto layer = std::make_unique<llvm::orc::RTDyldObjectLinkingLayer>(
+            es,
+            []() { return std::make_unique<llvm::SectionMemoryManager>(); }
+        );
+        // Same as LLJIT's default RuntimeDyld layer.
+        if (triple.isOSBinFormatCOFF()) {
+            layer->setOverrideObjectFlagsWithResponsibilityFlags(true);
+            layer->setAutoClaimResponsibilityForObjectSymbols(true);
+        }
+
+        layer->registerJITEventListener(*perf_map);
+        layer->registerJITEventListener(
+            *llvm::JITEventListener::createGDBRegistrationListener()
+        );
+        // Null unless LLVM was built with LLVM_USE_PERF.
+        if (auto* perf = llvm::JITEventListener::createPerfJITEventListener()) {
+            layer->registerJITEventListener(*perf);
+        }
+        return layer;
+    };
 }
 
 llvm::Error SimpleJIT::add_module(llvm::orc::ThreadSafeModule tsm) {
-    return jit->addIRModule(std::move(tsm));
+    if (options.num_compile_threads < 2) {
+        return jit->addIRModule(std::move(tsm));
+    }
+
+    // Modules with a cache key are compiled and loaded whole, since the
+    // cache stores one object per key and the parts would have none.
+    size_t num_instructions = 0;
+    bool is_cacheable = false;
+    tsm.withModuleDo([&](llvm::Module& ir_module) {
+        is_cacheable = object_cache && ObjectFileCache::has_key(&ir_module);
+        for (auto& function : ir_module) {
+            num_instructions += function.getInstructionCount();
+        }
+    });
+    size_t num_parts = std::min<size_t>(
+        options.num_compile_threads,
+        num_instructions / MIN_INSTRUCTIONS_PER_PART
+    );
+    if (is_cacheable || num_parts < 2) {
+        return jit->addIRModule(std::move(tsm));
+    }
+
+    auto parts = split_module(std::move(tsm), num_parts);
+    if (!parts) {
+        return parts.takeError();
+    }
+    for (auto& part : *parts) {
+        if (auto err = jit->addIRModule(std::move(part))) {
+            return err;
+        }
+    }
+    return llvm::Error::success();
 }
 
 llvm::Expected<llvm::orc::ExecutorAddr>
 SimpleJIT::lookup(std::string_view name) {
+    // Looking up a symbol materializes it, and everything it depends on.
+    auto phase = PhaseTimer::inst().scope("JIT materialization");
+    if (auto err = compile_pending_functions()) {
+        return std::move(err);
+    }
     return jit->lookup(name);
 }
 
+llvm::Expected<std::vector<llvm::orc::ThreadSafeModule>>
+SimpleJIT::split_module(llvm::orc::ThreadSafeModule tsm, unsigned num_parts) {
+    std::vector<llvm::orc::ThreadSafeModule> parts;
+    std::string local_prefix = "$split" + std::to_string(split_count++) + ".";
+
+    auto err = tsm.withModuleDo([&](llvm::Module& ir_module) -> llvm::Error {
+        // Splitting makes local symbols external. Without a unique prefix,
+        // they could clash with local symbols of other modules in the JIT.
+        for (auto& global_value : ir_module.global_values()) {
+            if (global_value.hasLocalLinkage() && global_value.hasName()) {
+                global_value.setName(local_prefix + global_value.getName());
+            }
+        }
+
+        llvm::Error part_err = llvm::Error::success();
+        llvm::SplitModule(
+            ir_module,
+            num_parts,
+            [&](std::unique_ptr<llvm::Module> part) {
+                if (part_err) {
+                    return;
+                }
+                for (auto& function : *part) {
+                    if (!function.isDeclaration()) {
+                        pending_functions.push_back(function.getName().str());
+                    }
+                }
+
+                // Move the part to its own context by round-tripping it
+                // through bitcode.
+                llvm::SmallVector<char, 0> buffer;
+                llvm::raw_svector_ostream stream(buffer);
+                llvm::WriteBitcodeToFile(*part, stream);
+
+                auto context = std::make_unique<llvm::LLVMContext>();
+                auto part_or_err = llvm::parseBitcodeFile(
+                    llvm::MemoryBufferRef(
+                        llvm::StringRef(buffer.data(), buffer.size()),
+                        part->getModuleIdentifier()
+                    ),
+                    *context
+                );
+                if (!part_or_err) {
+                    part_err = part_or_err.takeError();
+                    return;
+                }
+                // Parts must not share the whole module's cache key.
+                (*part_or_err)
+                    ->setModuleIdentifier(
+                        part->getModuleIdentifier() + ".part" +
+                        std::to_string(parts.size())
+                    );
+                parts.emplace_back(std::move(*part_or_err), std::move(context));
+            }
+        );
+        return part_err;
+    });
+    if (err) {
+        return std::move(err);
+    }
+    return parts;
+}
+
+llvm::Error SimpleJIT::compile_pending_functions() {
+    if (pending_functions.empty()) {
+        return llvm::Error::success();
+    }
+
+    llvm::orc::SymbolLookupSet symbols;
+    for (const auto& name : pending_functions) {
+        symbols.add(
+            jit->mangleAndIntern(name),
+            llvm::orc::SymbolLookupFlags::WeaklyReferencedSymbol
+        );
+    }
+    pending_functions.clear();
+
+    // Local symbols made external by splitting are hidden, so we match all
+    // symbols rather than only exported ones.
+    auto result = jit->getExecutionSession().lookup(
+        llvm::orc::makeJITDylibSearchOrder(
+            &jit->getMainJITDylib(),
+            llvm::orc::JITDylibLookupFlags::MatchAllSymbols
+        ),
+        std::move(symbols)
+    );
+    if (!result) {
+        return result.takeError();
+    }
+    return llvm::Error::success();
+}
+
 void SimpleJIT::reset() {
-    jit.reset(); // Destroys the current LLJIT instance
-    auto jit_or_err = llvm::orc::LLJITBuilder().create();
-    if (!jit_or_err) {
-        panic(
-            "SimpleJIT::reset: Failed to create LLJIT: " +
-            llvm::toString(jit_or_err.takeError())
+    create_jit();
+}
+
+void SimpleJIT::set_opt_level(llvm::OptimizationLevel opt_level) {
+    options.opt_level = opt_level;
+
+    // At O0, we skip the pass pipeline entirely to keep startup latency low.
+    if (opt_level == llvm::OptimizationLevel::O0) {
+        jit->getIRTransformLayer().setTransform(
+            [](llvm::orc::ThreadSafeModule tsm,
+               const llvm::orc::MaterializationResponsibility&)
+                -> llvm::Expected<llvm::orc::ThreadSafeModule> { return tsm; }
         );
+        return;
     }
-    jit = std::move(jit_or_err.get());
+
+    jit->getIRTransformLayer().setTransform(
+        [opt_level,
+         jtmb = *target_machine_builder,
+         cache = object_cache.get()](
+            llvm::orc::ThreadSafeModule tsm,
+            const llvm::orc::MaterializationResponsibility&
+        ) -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+            auto err = tsm.withModuleDo([&](llvm::Module& ir_module
+                                        ) -> llvm::Error {
+                // A cached object was optimized before it was stored, so
+                // there is nothing to gain from optimizing the IR again.
+                if (cache && cache->contains(&ir_module)) {
+                    return llvm::Error::success();
+                }
+                // Modules may be optimized concurrently, and target machines
+                // are not thread-safe, so each module gets its own.
+                auto module_jtmb = jtmb;
+                auto tm_or_err = module_jtmb.createTargetMachine();
+                if (!tm_or_err) {
+                    return tm_or_err.takeError();
+                }
+                Optimizer optimizer(tm_or_err->get());
+                optimizer.optimize(ir_module, opt_level);
+                return llvm::Error::success();
+            });
+            if (err) {
+                return std::move(err);
+            }
+            return std::move(tsm);
+        }
+    );
 }
 
 llvm::Error SimpleJIT::add_static_library(const std::string& lib_path) {
@@ -91,4 +384,45 @@ llvm::Error SimpleJIT::add_static_library(const std::string& lib_path) {
     return llvm::Error::success();
 }
 
+LazyJIT::LazyJIT(const JITOptions& options)
+    : SimpleJIT(options, DeferCreation()) {
+    create_jit();
+}
+
+llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>>
+LazyJIT::build_jit(llvm::orc::JITTargetMachineBuilder jtmb) {
+    llvm::orc::LLLazyJITBuilder builder;
+    builder.setJITTargetMachineBuilder(std::move(jtmb));
+    builder.setNumCompileThreads(options.num_compile_threads);
+    if (object_cache) {
+        builder.setCompileFunctionCreator(
+            make_cached_compile_function_creator()
+        );
+    }
+    if (perf_map_listener) {
+        builder.setObjectLinkingLayerCreator(
+            make_profiling_object_linking_layer_creator()
+        );
+    }
+    auto lazy_jit_or_err = builder.create();
+    if (!lazy_jit_or_err) {
+        return lazy_jit_or_err.takeError();
+    }
+
+    // Partition modules so that each stub compiles only the function that was
+    // called, rather than the whole module.
+    std::unique_ptr<llvm::orc::LLLazyJIT> lazy_jit =
+        std::move(*lazy_jit_or_err);
+    lazy_jit->setPartitionFunction(
+        llvm::orc::CompileOnDemandLayer::compileRequested
+    );
+    return std::unique_ptr<llvm::orc::LLJIT>(std::move(lazy_jit));
+}
+
+llvm::Error LazyJIT::add_module(llvm::orc::ThreadSafeModule tsm) {
+    // `build_jit` always builds an LLLazyJIT, so this cast is safe.
+    auto& lazy_jit = static_cast<llvm::orc::LLLazyJIT&>(*jit);
+    return lazy_jit.addLazyIRModule(std::move(tsm));
+}
+
 } // namespace nico
@@ -0,0 +1,172 @@
+#include "nico/backend/object_cache.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SHA256.h>
+
+#include "nico/shared/utils.h"
+
+#if defined(__unix__) || defined(__unix) ||                                    \
+    (defined(__APPLE__) && defined(__MACH__))
+#include <unistd.h>
+#endif
+
+namespace nico {
+
+/**
+ * @brief Identifies the build of the running compiler.
+ *
+ * The project version does not change between builds, so it cannot tell apart
+ * a compiler whose code generation or optimizer has changed. The identifier is
+ * made of the LLVM version and the size and modification time of the running
+ * executable, which change whenever the compiler is rebuilt. Hashing the
+ * executable would be more precise, but it would cost more than a cache hit
+ * saves.
+ *
+ * @return The build identifier. Computed once per process.
+ */
+static const std::string& build_identifier() {
+    static const std::string id = []() {
+        std::string id = LLVM_VERSION_STRING;
+        std::string exe_path = llvm::sys::fs::getMainExecutable(
+            nullptr,
+            reinterpret_cast<void*>(&build_identifier)
+        );
+        std::error_code ec;
+        auto size = std::filesystem::file_size(exe_path, ec);
+        if (ec) {
+            return id;
+        }
+        auto mtime = std::filesystem::last_write_time(exe_path, ec);
+        if (ec) {
+            return id;
+        }
+        id += ":" + std::to_string(size) + ":" +
+              std::to_string(mtime.time_since_epoch().count());
+        return id;
+    }();
+    return id;
+}
+
+std::string ObjectFileCache::make_key(
+    const CodeFile& code_file,
+    bool panic_recoverable,
+    llvm::OptimizationLevel opt_level,
+    const llvm::TargetMachine& target_machine
+) {
+    llvm::SHA256 hasher;
+    // Each field is terminated by a null character so that fields cannot run
+    // into each other.
+    auto add_field = [&hasher](std::string_view field) {
+        hasher.update(llvm::StringRef(field.data(), field.size()));
+        hasher.update(llvm::StringRef("\0", 1));
+    };
+
+    add_field(project_version());
+    add_field(build_identifier());
+    add_field(code_file.src_code());
+    add_field(code_file.path_string);
+    add_field(panic_recoverable ? "1" : "0");
+    add_field(std::to_string(opt_level.getSpeedupLevel()));
+    add_field(std::to_string(opt_level.getSizeLevel()));
+    add_field(target_machine.getTargetTriple().str());
+    add_field(target_machine.getTargetCPU());
+    add_field(target_machine.getTargetFeatureString());
+
+    return std::string(KEY_PREFIX) + llvm::toHex(hasher.final(), true);
+}
+
+std::string ObjectFileCache::default_cache_dir() {
+    if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME")) {
+        return (std::filesystem::path(xdg_cache) / "nico").string();
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return (std::filesystem::path(home) / ".cache" / "nico").string();
+    }
+    return ".nico_cache";
+}
+
+bool ObjectFileCache::has_key(const llvm::Module* module) {
+    const std::string& key = module->getModuleIdentifier();
+    return key.size() == KEY_LENGTH && key.starts_with(KEY_PREFIX);
+}
+
+std::string ObjectFileCache::get_object_path(const llvm::Module* module
+) const {
+    if (!has_key(module)) {
+        return "";
+    }
+    const std::string& key = module->getModuleIdentifier();
+    return (std::filesystem::path(cache_dir) / (key + ".o")).string();
+}
+
+bool ObjectFileCache::contains(const llvm::Module* module) const {
+    std::string path = get_object_path(module);
+    std::error_code ec;
+    return !path.empty() && std::filesystem::exists(path, ec);
+}
+
+void ObjectFileCache::notifyObjectCompiled(
+    const llvm::Module* module, llvm::MemoryBufferRef object
+) {
+    std::string path = get_object_path(module);
+    if (path.empty()) {
+        return;
+    }
+
+    // Failing to write to the cache is not an error; the object will simply
+    // be compiled again next time.
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+    if (ec) {
+        return;
+    }
+
+    // Write to a temporary file first, then rename it, so that other processes
+    // never see a partially written object.
+    std::string pid;
+#if defined(__unix__) || defined(__unix) ||                                    \
+    (defined(__APPLE__) && defined(__MACH__))
+    pid = std::to_string(getpid());
+#endif
+    std::string tmp_path = path + ".tmp" + pid;
+    {
+        std::ofstream file(tmp_path, std::ios::binary);
+        if (!file.is_open()) {
+            return;
+        }
+        file.write(object.getBufferStart(), object.getBufferSize());
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+    }
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+ObjectFileCache::getObject(const llvm::Module* module) {
+    std::string path = get_object_path(module);
+    if (path.empty()) {
+        return nullptr;
+    }
+
+    auto buffer_or_err = llvm::MemoryBuffer::getFile(path);
+    if (!buffer_or_err) {
+        // A null buffer tells the compiler that the object is not cached.
+        return nullptr;
+    }
+    return std::move(*buffer_or_err);
+}
+
+} // namespace nico
@@ -3,17 +3,27 @@
 #include <llvm/IR/PassManager.h>
 #include <llvm/Passes/PassBuilder.h>
 
+#include "nico/shared/phase_timer.h"
+
 namespace nico {
 
 void Optimizer::optimize(
     std::unique_ptr<llvm::Module>& ir_module, llvm::OptimizationLevel opt_level
 ) {
+    optimize(*ir_module, opt_level);
+}
+
+void Optimizer::optimize(
+    llvm::Module& ir_module, llvm::OptimizationLevel opt_level
+) {
+    auto phase = PhaseTimer::inst().scope("Optimizer");
+
     llvm::LoopAnalysisManager lam;
     llvm::FunctionAnalysisManager fam;
     llvm::CGSCCAnalysisManager cgam;
     llvm::ModuleAnalysisManager mam;
 
-    llvm::PassBuilder pass_builder;
+    llvm::PassBuilder pass_builder(target_machine);
 
     pass_builder.registerModuleAnalyses(mam);
     pass_builder.registerCGSCCAnalyses(cgam);
@@ -24,7 +34,7 @@ void Optimizer::optimize(
     llvm::ModulePassManager mpm =
         pass_builder.buildPerModuleDefaultPipeline(opt_level);
 
-    mpm.run(*ir_module, mam);
+    mpm.run(ir_module, mam);
 }
 
 } // namespace nico
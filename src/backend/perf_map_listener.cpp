@@ -0,0 +1,57 @@
+#include "nico/backend/perf_map_listener.h"
+
+#include <llvm/Object/SymbolSize.h>
+#include <llvm/Support/Process.h>
+
+namespace nico {
+
+PerfMapListener::PerfMapListener(const std::string& path)
+    : path(path), map_file(path, std::ios::app) {}
+
+std::string PerfMapListener::default_map_path() {
+    return "/tmp/perf-" + std::to_string(llvm::sys::Process::getProcessId()) +
+           ".map";
+}
+
+void PerfMapListener::notifyObjectLoaded(
+    ObjectKey, const llvm::object::ObjectFile& obj,
+    const llvm::RuntimeDyld::LoadedObjectInfo& info
+) {
+    // The debug object has its sections moved to their load addresses, so its
+    // symbol addresses are the addresses the code runs at.
+    llvm::object::OwningBinary<llvm::object::ObjectFile> debug_obj =
+        info.getObjectForDebug(obj);
+    if (!debug_obj.getBinary()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!map_file) {
+        return;
+    }
+    for (const auto& [symbol, size] :
+         llvm::object::computeSymbolSizes(*debug_obj.getBinary())) {
+        auto type = symbol.getType();
+        if (!type || *type != llvm::object::SymbolRef::ST_Function) {
+            llvm::consumeError(type.takeError());
+            continue;
+        }
+        auto name = symbol.getName();
+        if (!name) {
+            llvm::consumeError(name.takeError());
+            continue;
+        }
+        auto address = symbol.getAddress();
+        if (!address) {
+            llvm::consumeError(address.takeError());
+            continue;
+        }
+        // Each line is "<start> <size> <name>", with numbers in hex.
+        map_file << std::hex << *address << " " << size << std::dec << " "
+                 << name->str() << "\n";
+    }
+    // Flush now so that the entries survive the process being killed.
+    map_file.flush();
+}
+
+} // namespace nico
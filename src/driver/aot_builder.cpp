@@ -0,0 +1,183 @@
+#include "nico/driver/aot_builder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "nico/backend/emitter.h"
+#include "nico/backend/optimizer.h"
+#include "nico/frontend/frontend.h"
+#include "nico/shared/code_file.h"
+#include "nico/shared/diagnostics.h"
+#include "nico/shared/error_code.h"
+#include "nico/shared/phase_timer.h"
+#include "nico/shared/status.h"
+
+#if defined(__unix__) || defined(__unix) ||                                    \
+    (defined(__APPLE__) && defined(__MACH__))
+#include <cerrno>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define NICO_HAS_POSIX_SPAWN 1
+extern char** environ;
+#endif
+
+namespace nico {
+
+/**
+ * @brief Splits a command into words at spaces and tabs.
+ *
+ * This allows a command such as `CC="ccache cc"`. Quotes are not interpreted.
+ *
+ * @param command The command to split.
+ * @return The words of the command.
+ */
+static std::vector<std::string> split_command(std::string_view command) {
+    std::vector<std::string> words;
+    size_t start = 0;
+    while (start < command.size()) {
+        size_t end = command.find_first_of(" \t", start);
+        if (end == std::string_view::npos) {
+            end = command.size();
+        }
+        if (end > start) {
+            words.emplace_back(command.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return words;
+}
+
+/**
+ * @brief Runs a program and waits for it to finish.
+ *
+ * The program is found on the PATH and given its arguments directly rather
+ * than through the shell, so no character in an argument is interpreted.
+ *
+ * @param args The program followed by its arguments.
+ * @return The exit code of the program, or -1 if it could not be run or did
+ * not exit normally.
+ */
+static int run_program(const std::vector<std::string>& args) {
+    std::cout.flush();
+    std::cerr.flush();
+#ifdef NICO_HAS_POSIX_SPAWN
+    std::vector<char*> argv;
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    if (posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ) !=
+        0) {
+        return -1;
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#else
+    // Without posix_spawn, fall back to the shell, with each argument quoted.
+    std::string command;
+    for (const auto& arg : args) {
+        command += command.empty() ? "\"" : " \"";
+        for (char c : arg) {
+            if (c == '"' || c == '\\') {
+                command += '\\';
+            }
+            command += c;
+        }
+        command += "\"";
+    }
+    return std::system(command.c_str());
+#endif
+}
+
+void compile_and_build(const DriverOptions& options) {
+    auto code_file = read_code_file(options.input_file);
+    if (!code_file.has_value()) {
+        std::cerr << "Could not open file: " << options.input_file << std::endl;
+        std::exit(66);
+    }
+
+    Frontend frontend;
+    frontend.set_target_spec(options.target_spec);
+    frontend.set_num_lexer_threads(options.num_lexer_threads);
+    frontend.set_num_parser_threads(options.num_parser_threads);
+    std::unique_ptr<FrontendContext>& context =
+        frontend.compile(*code_file, false);
+    if (!IS_VARIANT(context->status, Status::Ok)) {
+        std::cerr << "Compilation failed; exiting...";
+        std::exit(1);
+    }
+
+    // O0 still runs a (mostly empty) pipeline, so we skip it entirely.
+    if (options.opt_level != llvm::OptimizationLevel::O0) {
+        Optimizer optimizer(context->mod_ctx.target_machine.get());
+        optimizer.optimize(context->mod_ctx.ir_module, options.opt_level);
+    }
+
+    std::optional<std::vector<std::string>> object_names;
+    {
+        auto phase = PhaseTimer::inst().scope("Emitter");
+        Emitter emitter;
+        object_names = emitter.emit_split(
+            context->mod_ctx,
+            options.output_file + ".o",
+            std::max(options.num_compile_threads, 1u)
+        );
+    }
+    if (!object_names.has_value()) {
+        std::cerr << "Object emission failed; exiting...";
+        std::exit(1);
+    }
+
+    const char* cc = std::getenv("CC");
+    std::vector<std::string> link_args = split_command(cc ? cc : "");
+    if (link_args.empty()) {
+        link_args.push_back("cc");
+    }
+    link_args.insert(
+        link_args.end(),
+        object_names->begin(),
+        object_names->end()
+    );
+    link_args.push_back("-o");
+    link_args.push_back(options.output_file);
+    int link_result;
+    {
+        auto phase = PhaseTimer::inst().scope("Linker");
+        link_result = run_program(link_args);
+    }
+
+    for (const auto& object_name : *object_names) {
+        std::error_code ec;
+        std::filesystem::remove(object_name, ec);
+    }
+
+    if (link_result != 0) {
+        std::string link_command;
+        for (const auto& arg : link_args) {
+            link_command += (link_command.empty() ? "" : " ") + arg;
+        }
+        Diagnostics::inst().emit_error(
+            Err::LinkerFailed,
+            "Linker command failed: " + link_command
+        );
+        std::exit(1);
+    }
+}
+
+} // namespace nico
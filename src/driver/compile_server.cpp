@@ -0,0 +1,590 @@
+#include "nico/driver/compile_server.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "nico/backend/jit.h"
+#include "nico/driver/jit_runner.h"
+#include "nico/frontend/frontend.h"
+
+#if defined(__unix__) || defined(__unix) ||                                    \
+    (defined(__APPLE__) && defined(__MACH__))
+#include <cerrno>
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define NICO_HAS_UNIX_SOCKETS 1
+#endif
+
+namespace nico {
+
+std::string default_socket_path() {
+#ifdef NICO_HAS_UNIX_SOCKETS
+    std::string name = "nico-" + std::to_string(getuid()) + ".sock";
+#else
+    std::string name = "nico.sock";
+#endif
+    if (const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR")) {
+        return (std::filesystem::path(runtime_dir) / name).string();
+    }
+    return (std::filesystem::path("/tmp") / name).string();
+}
+
+#ifdef NICO_HAS_UNIX_SOCKETS
+
+// The maximum number of arguments in a request.
+static constexpr uint32_t MAX_REQUEST_ARGS = 4096;
+// The maximum length of a single argument in a request.
+static constexpr uint32_t MAX_REQUEST_ARG_LENGTH = 1 << 20;
+// The number of file descriptors sent with a request: stdin, stdout, stderr.
+static constexpr int NUM_REQUEST_FDS = 3;
+
+/**
+ * @brief A request to compile and run a file.
+ *
+ * On the wire, a request is a 32-bit argument count followed by each argument
+ * as a 32-bit length and its bytes. The first argument is the client's working
+ * directory. The client's standard streams are attached to the argument count
+ * as SCM_RIGHTS ancillary data.
+ *
+ * The response is the request's 32-bit exit code.
+ */
+struct ServerRequest {
+    // The client's working directory.
+    std::string cwd;
+    // The client's arguments, excluding the program name.
+    std::vector<std::string> args;
+    // The client's stdin, stdout, and stderr.
+    int fds[NUM_REQUEST_FDS] = {-1, -1, -1};
+};
+
+/**
+ * @brief Writes all bytes of a buffer to a file descriptor.
+ *
+ * @return True if all bytes were written, false otherwise.
+ */
+static bool write_all(int fd, const void* data, size_t size) {
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads exactly `size` bytes from a file descriptor.
+ *
+ * @return True if all bytes were read, false otherwise.
+ */
+static bool read_all(int fd, void* data, size_t size) {
+    auto bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+        bytes += got;
+        size -= got;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a string as a 32-bit length followed by its bytes.
+ *
+ * @return True if the string was written, false otherwise.
+ */
+static bool write_string(int fd, const std::string& str) {
+    uint32_t length = static_cast<uint32_t>(str.size());
+    return write_all(fd, &length, sizeof(length)) &&
+           write_all(fd, str.data(), str.size());
+}
+
+/**
+ * @brief Reads a string written by `write_string`.
+ *
+ * @return True if the string was read, false otherwise.
+ */
+static bool read_string(int fd, std::string& str) {
+    uint32_t length;
+    if (!read_all(fd, &length, sizeof(length)) ||
+        length > MAX_REQUEST_ARG_LENGTH) {
+        return false;
+    }
+    str.resize(length);
+    return read_all(fd, str.data(), length);
+}
+
+/**
+ * @brief Sends a request to the server.
+ *
+ * @param sock The connected socket.
+ * @param args The arguments to send. The first is the working directory.
+ * @return True if the request was sent, false otherwise.
+ */
+static bool send_request(int sock, const std::vector<std::string>& args) {
+    uint32_t count = static_cast<uint32_t>(args.size());
+    int fds[NUM_REQUEST_FDS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+
+    iovec iov{&count, sizeof(count)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    ssize_t sent;
+    do {
+        sent = sendmsg(sock, &msg, 0);
+    } while (sent < 0 && errno == EINTR);
+    if (sent <= 0) {
+        return false;
+    }
+    // The ancillary data travels with the first byte; the rest of the count,
+    // if any, can be written normally.
+    if (!write_all(
+            sock,
+            reinterpret_cast<char*>(&count) + sent,
+            sizeof(count) - sent
+        )) {
+        return false;
+    }
+
+    for (const auto& arg : args) {
+        if (!write_string(sock, arg)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Receives a request from a client.
+ *
+ * @param sock The connected socket.
+ * @return The request, or std::nullopt if it was malformed.
+ */
+static std::optional<ServerRequest> receive_request(int sock) {
+    ServerRequest request;
+    uint32_t count;
+
+    iovec iov{&count, sizeof(count)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(request.fds))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t got;
+    do {
+        got = recvmsg(sock, &msg, 0);
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        return std::nullopt;
+    }
+
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET ||
+        cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(sizeof(request.fds))) {
+        return std::nullopt;
+    }
+    std::memcpy(request.fds, CMSG_DATA(cmsg), sizeof(request.fds));
+
+    auto close_fds = [&request]() {
+        for (int fd : request.fds) {
+            close(fd);
+        }
+    };
+    if (!read_all(
+            sock,
+            reinterpret_cast<char*>(&count) + got,
+            sizeof(count) - got
+        ) ||
+        count == 0 || count > MAX_REQUEST_ARGS ||
+        !read_string(sock, request.cwd)) {
+        close_fds();
+        return std::nullopt;
+    }
+    request.args.resize(count - 1);
+    for (auto& arg : request.args) {
+        if (!read_string(sock, arg)) {
+            close_fds();
+            return std::nullopt;
+        }
+    }
+    return request;
+}
+
+/**
+ * @brief Checks whether a warm JIT created for the server's options can run a
+ * request with the given options.
+ *
+ * The optimization level is not compared, since it can be changed on an
+ * existing JIT.
+ */
+static bool
+can_reuse_jit(const DriverOptions& server, const DriverOptions& request) {
+    return server.target_spec.cpu == request.target_spec.cpu &&
+           server.target_spec.features == request.target_spec.features &&
+           server.cache_dir == request.cache_dir &&
+           server.lazy_jit == request.lazy_jit &&
+           server.num_compile_threads == request.num_compile_threads &&
+           server.enable_profiling == request.enable_profiling;
+}
+
+/**
+ * @brief Runs a request. Called in the forked runner process, with the
+ * client's standard streams in place.
+ *
+ * @return This function never returns; it exits with the request's exit code.
+ */
+[[noreturn]] static void run_request(
+    const ServerRequest& request,
+    const DriverOptions& server_options,
+    Frontend& frontend,
+    IJIT* jit
+) {
+    std::error_code ec;
+    std::filesystem::current_path(request.cwd, ec);
+    if (ec) {
+        std::cerr << "Could not enter directory: " << request.cwd << std::endl;
+        std::exit(66);
+    }
+
+    std::vector<const char*> argv = {"nico"};
+    for (const auto& arg : request.args) {
+        argv.push_back(arg.c_str());
+    }
+    auto options = parse_driver_options(
+        static_cast<int>(argv.size()),
+        argv.data(),
+        std::cerr
+    );
+    if (!options.has_value()) {
+        std::exit(64);
+    }
+    if (options->mode != DriverMode::Run) {
+        std::cerr << "The compile server can only run files." << std::endl;
+        std::exit(64);
+    }
+
+    // The runner's stderr is the client's, so the report goes to the client.
+    report_phases_at_exit(options->time_phases);
+
+    if (jit && can_reuse_jit(server_options, *options)) {
+        jit->set_opt_level(options->opt_level);
+        compile_and_run(*options, frontend, *jit);
+    }
+    else {
+        compile_and_run(*options);
+    }
+    std::exit(0);
+}
+
+/**
+ * @brief Handles a connection. Called in the forked handler process.
+ *
+ * The request is run in a further forked process, so that the handler can
+ * report the exit code even if the request's program crashes.
+ */
+static void handle_connection(
+    int conn,
+    const DriverOptions& server_options,
+    Frontend& frontend,
+    IJIT* jit
+) {
+    auto request = receive_request(conn);
+    if (!request.has_value()) {
+        return;
+    }
+
+    pid_t runner = fork();
+    if (runner == 0) {
+        close(conn);
+        for (int i = 0; i < NUM_REQUEST_FDS; i++) {
+            dup2(request->fds[i], i);
+            close(request->fds[i]);
+        }
+        run_request(*request, server_options, frontend, jit);
+    }
+    for (int fd : request->fds) {
+        close(fd);
+    }
+
+    int32_t exit_code = 1;
+    int status;
+    if (runner > 0 && waitpid(runner, &status, 0) == runner) {
+        if (WIFEXITED(status)) {
+            exit_code = WEXITSTATUS(status);
+        }
+        else if (WIFSIGNALED(status)) {
+            // Same convention as the shell.
+            exit_code = 128 + WTERMSIG(status);
+        }
+    }
+    write_all(conn, &exit_code, sizeof(exit_code));
+}
+
+/**
+ * @brief Checks whether the process on the other end of a connected socket
+ * runs as the current user.
+ *
+ * @return True if the peer's user ID is the current user's, false otherwise or
+ * if it could not be determined.
+ */
+static bool peer_is_current_user(int sock) {
+#ifdef SO_PEERCRED
+    ucred cred{};
+    socklen_t length = sizeof(cred);
+    if (getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &length) < 0 ||
+        length != sizeof(cred)) {
+        return false;
+    }
+    return cred.uid == getuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(sock, &uid, &gid) < 0) {
+        return false;
+    }
+    return uid == getuid();
+#endif
+}
+
+/**
+ * @brief Checks whether the file at a path is a socket owned by the current
+ * user that no other user can access.
+ *
+ * @return True if the file is a socket owned by the current user with mode
+ * 0600, false otherwise.
+ */
+static bool is_private_socket(const std::string& path) {
+    struct stat info;
+    if (lstat(path.c_str(), &info) < 0) {
+        return false;
+    }
+    return S_ISSOCK(info.st_mode) && info.st_uid == getuid() &&
+           (info.st_mode & 0777) == 0600;
+}
+
+/**
+ * @brief Fills a Unix socket address with a path.
+ *
+ * @return True if the path fits in the address, false otherwise.
+ */
+static bool make_address(const std::string& path, sockaddr_un& addr) {
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+/**
+ * @brief Connects to the socket at a path.
+ *
+ * @return The connected socket, or -1 if no server is listening.
+ */
+static int connect_to(const std::string& path) {
+    sockaddr_un addr;
+    if (!make_address(path, addr)) {
+        return -1;
+    }
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return -1;
+    }
+    if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+int serve(const DriverOptions& options) {
+    std::string path = options.socket_path.empty() ? default_socket_path()
+                                                   : options.socket_path;
+    sockaddr_un addr;
+    if (!make_address(path, addr)) {
+        std::cerr << "Socket path is too long: " << path << std::endl;
+        return 1;
+    }
+
+    int existing = connect_to(path);
+    if (existing >= 0) {
+        close(existing);
+        std::cerr << "A compile server is already listening on " << path
+                  << std::endl;
+        return 1;
+    }
+    // Nothing is listening, so any file at the path is a stale socket. A file
+    // owned by another user is left alone, since that user could be waiting
+    // for it to be replaced.
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0) {
+        if (info.st_uid != getuid()) {
+            std::cerr << "Socket path is owned by another user: " << path
+                      << std::endl;
+            return 1;
+        }
+        unlink(path.c_str());
+    }
+
+    // Warm up before listening, so that no request pays for it.
+    Frontend frontend;
+    frontend.set_target_spec(options.target_spec);
+    // Only the forking thread survives a fork, so a JIT with compile threads
+    // could be copied while one of them holds a lock, deadlocking the request.
+    // Such a JIT is instead created by each request, after the fork.
+    std::unique_ptr<IJIT> jit;
+    if (options.num_compile_threads == 0) {
+        jit = create_jit(options);
+    }
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        std::cerr << "Could not create socket: " << std::strerror(errno)
+                  << std::endl;
+        return 1;
+    }
+    // Only the current user may connect. Clients check for this mode.
+    mode_t old_umask = umask(0177);
+    int bind_result =
+        bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    umask(old_umask);
+    if (bind_result < 0 || listen(listen_fd, SOMAXCONN) < 0) {
+        std::cerr << "Could not listen on " << path << ": "
+                  << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        return 1;
+    }
+
+    // Handlers are never waited on, so let the system reap them.
+    std::signal(SIGCHLD, SIG_IGN);
+    std::cerr << "Listening on " << path << std::endl;
+
+    while (true) {
+        int conn = accept(listen_fd, nullptr, nullptr);
+        if (conn < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            std::cerr << "Could not accept connection: "
+                      << std::strerror(errno) << std::endl;
+            break;
+        }
+        // The socket's mode should keep other users out, but a request runs
+        // arbitrary code, so check who sent it as well.
+        if (!peer_is_current_user(conn)) {
+            close(conn);
+            continue;
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        pid_t handler = fork();
+        if (handler == 0) {
+            close(listen_fd);
+            // The handler waits on its runner, so it must not ignore SIGCHLD.
+            std::signal(SIGCHLD, SIG_DFL);
+            handle_connection(conn, options, frontend, jit.get());
+            close(conn);
+            _exit(0);
+        }
+        if (handler < 0) {
+            std::cerr << "Could not fork: " << std::strerror(errno)
+                      << std::endl;
+        }
+        close(conn);
+    }
+
+    close(listen_fd);
+    unlink(path.c_str());
+    return 1;
+}
+
+std::optional<int>
+run_on_server(const DriverOptions& options, int argc, const char* const* argv) {
+    std::string path = options.socket_path.empty() ? default_socket_path()
+                                                   : options.socket_path;
+    int sock = connect_to(path);
+    if (sock < 0) {
+        return std::nullopt;
+    }
+    // The client's standard streams are handed to the server, so only a
+    // server run by the same user, on a socket nobody else could have
+    // created or replaced, is trusted with them.
+    if (!is_private_socket(path) || !peer_is_current_user(sock)) {
+        close(sock);
+        std::cerr << "Ignoring compile server on " << path
+                  << ": the socket is not private to the current user."
+                  << std::endl;
+        return std::nullopt;
+    }
+    // A server that goes away should be reported, not kill the client.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::error_code ec;
+    std::vector<std::string> args = {
+        std::filesystem::current_path(ec).string()
+    };
+    args.insert(args.end(), argv + 1, argv + argc);
+
+    if (!send_request(sock, args)) {
+        close(sock);
+        return std::nullopt;
+    }
+
+    // Once the request is sent, the server may have started running it, so
+    // falling back to running locally could run the program twice.
+    int32_t exit_code;
+    bool received = read_all(sock, &exit_code, sizeof(exit_code));
+    close(sock);
+    if (!received) {
+        std::cerr << "Lost connection to the compile server." << std::endl;
+        return 1;
+    }
+    return exit_code;
+}
+
+#else
+
+int serve(const DriverOptions&) {
+    std::cerr << "The compile server is not supported on this platform."
+              << std::endl;
+    return 1;
+}
+
+std::optional<int>
+run_on_server(const DriverOptions&, int, const char* const*) {
+    return std::nullopt;
+}
+
+#endif
+
+} // namespace nico
@@ -0,0 +1,260 @@
+#include "nico/driver/driver_options.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <vector>
+
+#include "nico/backend/object_cache.h"
+#include "nico/shared/phase_timer.h"
+
+namespace nico {
+
+std::optional<llvm::OptimizationLevel> parse_opt_level(std::string_view flag) {
+    if (flag == "-O0")
+        return llvm::OptimizationLevel::O0;
+    if (flag == "-O1")
+        return llvm::OptimizationLevel::O1;
+    if (flag == "-O2")
+        return llvm::OptimizationLevel::O2;
+    if (flag == "-O3")
+        return llvm::OptimizationLevel::O3;
+    if (flag == "-Os")
+        return llvm::OptimizationLevel::Os;
+    if (flag == "-Oz")
+        return llvm::OptimizationLevel::Oz;
+    return std::nullopt;
+}
+
+std::optional<DriverOptions>
+parse_driver_options(int argc, const char* const* argv, std::ostream& err) {
+    DriverOptions options;
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    size_t i = 0;
+    if (!args.empty() && args[0] == "build") {
+        options.mode = DriverMode::Build;
+        i++;
+    }
+
+    bool output_given = false;
+    bool serve_given = false;
+    for (; i < args.size(); i++) {
+        std::string_view arg = args[i];
+
+        if (arg == "-h" || arg == "--help") {
+            options.mode = DriverMode::Help;
+            return options;
+        }
+        else if (arg == "--version") {
+            options.mode = DriverMode::Version;
+            return options;
+        }
+        else if (arg == "-o") {
+            if (i + 1 >= args.size()) {
+                err << "Missing file name after '-o'.\n";
+                return std::nullopt;
+            }
+            options.output_file = std::string(args[++i]);
+            output_given = true;
+        }
+        else if (arg.starts_with("-mcpu=")) {
+            options.target_spec.cpu = std::string(arg.substr(6));
+            if (options.target_spec.cpu.empty()) {
+                err << "Missing CPU name after '-mcpu='.\n";
+                return std::nullopt;
+            }
+        }
+        else if (arg.starts_with("-mattr=")) {
+            options.target_spec.features = std::string(arg.substr(7));
+        }
+        else if (arg == "--lazy") {
+            options.lazy_jit = true;
+        }
+        else if (arg.starts_with("--compile-threads=")) {
+            std::string_view count = arg.substr(18);
+            auto [end, ec] = std::from_chars(
+                count.data(),
+                count.data() + count.size(),
+                options.num_compile_threads
+            );
+            if (count.empty() || ec != std::errc() ||
+                end != count.data() + count.size()) {
+                err << "Invalid thread count '" << count << "'.\n";
+                return std::nullopt;
+            }
+        }
+        else if (arg.starts_with("--lex-threads=")) {
+            std::string_view count = arg.substr(14);
+            auto [end, ec] = std::from_chars(
+                count.data(),
+                count.data() + count.size(),
+                options.num_lexer_threads
+            );
+            if (count.empty() || ec != std::errc() ||
+                end != count.data() + count.size()) {
+                err << "Invalid thread count '" << count << "'.\n";
+                return std::nullopt;
+            }
+        }
+        else if (arg.starts_with("--parse-threads=")) {
+            std::string_view count = arg.substr(16);
+            auto [end, ec] = std::from_chars(
+                count.data(),
+                count.data() + count.size(),
+                options.num_parser_threads
+            );
+            if (count.empty() || ec != std::errc() ||
+                end != count.data() + count.size()) {
+                err << "Invalid thread count '" << count << "'.\n";
+                return std::nullopt;
+            }
+        }
+        else if (arg == "--time-phases") {
+            options.time_phases = PhaseTiming::Text;
+        }
+        else if (arg == "--time-phases=json") {
+            options.time_phases = PhaseTiming::Json;
+        }
+        else if (arg == "--serve") {
+            serve_given = true;
+        }
+        else if (arg == "--client") {
+            options.use_server = true;
+        }
+        else if (arg.starts_with("--socket=")) {
+            options.socket_path = std::string(arg.substr(9));
+            if (options.socket_path.empty()) {
+                err << "Missing path after '--socket='.\n";
+                return std::nullopt;
+            }
+        }
+        else if (arg == "--profile") {
+            options.enable_profiling = true;
+        }
+        else if (arg == "--cache") {
+            options.cache_dir = ObjectFileCache::default_cache_dir();
+        }
+        else if (arg.starts_with("--cache-dir=")) {
+            options.cache_dir = std::string(arg.substr(12));
+            if (options.cache_dir->empty()) {
+                err << "Missing directory after '--cache-dir='.\n";
+                return std::nullopt;
+            }
+        }
+        else if (arg.starts_with("-O")) {
+            auto opt_level = parse_opt_level(arg);
+            if (!opt_level.has_value()) {
+                err << "Unknown optimization level '" << arg << "'.\n";
+                return std::nullopt;
+            }
+            options.opt_level = *opt_level;
+        }
+        else if (arg.starts_with("-")) {
+            err << "Unknown option '" << arg << "'.\n";
+            return std::nullopt;
+        }
+        else if (options.input_file.empty()) {
+            options.input_file = std::string(arg);
+        }
+        else {
+            err << "Unexpected argument '" << arg << "'.\n";
+            return std::nullopt;
+        }
+    }
+
+    if (options.mode == DriverMode::Build) {
+        if (options.input_file.empty()) {
+            err << "No source file given to 'build'.\n";
+            return std::nullopt;
+        }
+        if (serve_given) {
+            err << "Option '--serve' is not allowed with 'build'.\n";
+            return std::nullopt;
+        }
+    }
+    else {
+        if (output_given) {
+            err << "Option '-o' is only allowed with 'build'.\n";
+            return std::nullopt;
+        }
+        if (serve_given) {
+            if (!options.input_file.empty()) {
+                err << "Option '--serve' does not take a file.\n";
+                return std::nullopt;
+            }
+            options.mode = DriverMode::Serve;
+        }
+        else if (!options.input_file.empty()) {
+            options.mode = DriverMode::Run;
+        }
+    }
+
+    if (options.use_server && options.mode != DriverMode::Run) {
+        err << "Option '--client' requires a file to run.\n";
+        return std::nullopt;
+    }
+
+    return options;
+}
+
+// The format of the phase report printed at exit.
+static PhaseTiming phase_report_format = PhaseTiming::Off;
+
+/**
+ * @brief Prints the phase report to stderr in `phase_report_format`.
+ */
+static void print_phase_report() {
+    if (phase_report_format == PhaseTiming::Text) {
+        PhaseTimer::inst().print_report(std::cerr);
+    }
+    else if (phase_report_format == PhaseTiming::Json) {
+        PhaseTimer::inst().print_json(std::cerr);
+    }
+}
+
+void report_phases_at_exit(PhaseTiming format) {
+    if (format == PhaseTiming::Off) {
+        return;
+    }
+    PhaseTimer::inst().set_enabled(true);
+    phase_report_format = format;
+    std::atexit(print_phase_report);
+}
+
+void print_usage(std::ostream& out) {
+    out << R"(Usage:
+  nico [options]                          Start the REPL.
+  nico [options] <file>                   Compile and run a file.
+  nico build [options] <file> [-o <out>]  Build an executable from a file.
+  nico --serve [options]                  Start a compile server.
+
+Options:
+  -O0, -O1, -O2, -O3, -Os, -Oz  Set the optimization level. (Default: -O0)
+  -mcpu=<cpu>                   Generate code for a CPU, e.g. skylake.
+                                Use 'native' for the host. (Default: native)
+  -mattr=<+f1,-f2,...>          Enable (+) or disable (-) CPU features.
+  --lazy                        Compile each function on its first call
+                                instead of before running.
+  --compile-threads=<n>         Generate machine code on <n> threads.
+                                (Default: 0, the main thread)
+  --lex-threads=<n>             Scan large files on <n> threads.
+                                (Default: 0, the main thread)
+  --parse-threads=<n>           Parse large files on <n> threads.
+                                (Default: 0, the main thread)
+  --profile                     Register JIT-compiled code with GDB and write
+                                /tmp/perf-<pid>.map for perf.
+  --time-phases[=json]          Print the wall time, CPU time, and peak RSS
+                                growth of each compile phase to stderr.
+  --cache                       Cache compiled objects in the default cache
+                                directory when running a file.
+  --cache-dir=<dir>             Cache compiled objects in <dir>.
+  --client                      Run the file on a compile server, if one is
+                                running.
+  --socket=<path>               Set the compile server's socket path.
+  -o <out>                      Set the executable name. (Default: a.out)
+  -h, --help                    Show this help message.
+  --version                     Show the version.
+)";
+}
+
+} // namespace nico
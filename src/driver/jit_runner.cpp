@@ -1,59 +1,72 @@
 #include "nico/driver/jit_runner.h"
 
 #include <cstdlib>
-#include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <memory>
-#include <string>
 #include <utility>
 
 #include "nico/backend/jit.h"
+#include "nico/backend/object_cache.h"
 #include "nico/frontend/frontend.h"
 #include "nico/shared/code_file.h"
 #include "nico/shared/status.h"
 
 namespace nico {
 
-void compile_and_run(std::string_view file_name) {
-    // Open the file.
-    std::ifstream file(file_name.data());
-    if (!file.is_open()) {
-        std::cerr << "Could not open file: " << file_name << std::endl;
-        std::exit(66);
+std::unique_ptr<IJIT> create_jit(const DriverOptions& options) {
+    JITOptions jit_options{
+        .opt_level = options.opt_level,
+        .target_spec = options.target_spec,
+        .cache_dir = options.cache_dir,
+        .num_compile_threads = options.num_compile_threads,
+        .enable_profiling = options.enable_profiling
+    };
+    if (options.lazy_jit) {
+        return std::make_unique<LazyJIT>(jit_options);
     }
+    return std::make_unique<SimpleJIT>(jit_options);
+}
 
-    // Read the file's path.
-    std::filesystem::path path = file_name;
-
-    // Read the entire file.
-    file.seekg(0, std::ios::end);
-    size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    std::string src_code;
-    src_code.resize(size);
-    file.read(&src_code[0], size);
-
-    std::shared_ptr<CodeFile> code_file = std::make_shared<CodeFile>(
-        std::move(src_code),
-        std::filesystem::absolute(path).string()
-    );
+void compile_and_run(const DriverOptions& options) {
+    Frontend frontend;
+    frontend.set_target_spec(options.target_spec);
+    std::unique_ptr<IJIT> jit = create_jit(options);
+    compile_and_run(options, frontend, *jit);
+}
 
-    file.close();
+void compile_and_run(
+    const DriverOptions& options, Frontend& frontend, IJIT& jit
+) {
+    auto code_file = read_code_file(options.input_file);
+    if (!code_file.has_value()) {
+        std::cerr << "Could not open file: " << options.input_file << std::endl;
+        std::exit(66);
+    }
 
-    Frontend frontend;
+    frontend.set_num_lexer_threads(options.num_lexer_threads);
+    frontend.set_num_parser_threads(options.num_parser_threads);
     std::unique_ptr<FrontendContext>& context =
-        frontend.compile(code_file, false);
+        frontend.compile(*code_file, false);
     if (!IS_VARIANT(context->status, Status::Ok)) {
         std::cerr << "Compilation failed; exiting...";
         std::exit(1);
     }
 
-    std::unique_ptr<IJIT> jit = std::make_unique<SimpleJIT>();
-    auto err = jit->add_module_and_context(std::move(context->mod_ctx));
+    // Giving the module a cache key opts it in to the object cache.
+    if (options.cache_dir.has_value()) {
+        context->mod_ctx.ir_module->setModuleIdentifier(
+            ObjectFileCache::make_key(
+                **code_file,
+                frontend.is_panic_recoverable(),
+                options.opt_level,
+                *context->mod_ctx.target_machine
+            )
+        );
+    }
+
+    auto err = jit.add_module_and_context(std::move(context->mod_ctx));
 
-    auto result = jit->run_main_func(0, nullptr, context->main_fn_name);
+    auto result = jit.run_main_func(0, nullptr, context->main_fn_name);
 }
 
 } // namespace nico
@@ -14,6 +14,10 @@ const std::unordered_map<std::string, REPL::Command> REPL::commands = {
     {":license", Command::License},
     {":discard", Command::Discard},
     {":reset", Command::Reset},
+    {":O0", Command::OptO0},
+    {":O1", Command::OptO1},
+    {":O2", Command::OptO2},
+    {":O3", Command::OptO3},
     {":exit", Command::Exit},
     {":quit", Command::Exit},
     {":q", Command::Exit}
@@ -42,6 +46,12 @@ void REPL::reset() {
     use_caution = false;
 }
 
+void REPL::set_opt_level(llvm::OptimizationLevel opt_level) {
+    jit->set_opt_level(opt_level);
+    *out << "Optimization level set to O" << opt_level.getSpeedupLevel()
+         << ".\n";
+}
+
 void REPL::print_version() {
     *out << project_version() << "\n";
 }
@@ -60,6 +70,7 @@ Available commands:
 :license    Show the LICENSE file.
 :reset      Reset the REPL state, clearing all variables and definitions. 
 :discard    Discard the current input.
+:O0 - :O3   Set the optimization level for subsequent inputs.
 :exit       Exit the REPL. (Also :quit or :q)
 )";
 }
@@ -102,8 +113,10 @@ void REPL::print_prompt() {
     }
 }
 
-void REPL::run(std::istream& in, std::ostream& out) {
-    REPL repl(in, out);
+void REPL::run(
+    std::istream& in, std::ostream& out, const DriverOptions& options
+) {
+    REPL repl(in, out, options);
     repl.run_repl();
 }
 
@@ -124,6 +137,18 @@ void REPL::handle_command(Command cmd) {
     case Command::Reset:
         reset();
         break;
+    case Command::OptO0:
+        set_opt_level(llvm::OptimizationLevel::O0);
+        break;
+    case Command::OptO1:
+        set_opt_level(llvm::OptimizationLevel::O1);
+        break;
+    case Command::OptO2:
+        set_opt_level(llvm::OptimizationLevel::O2);
+        break;
+    case Command::OptO3:
+        set_opt_level(llvm::OptimizationLevel::O3);
+        break;
     case Command::Exit:
         *out << "Exiting REPL..." << std::endl;
         exit(0);
@@ -151,9 +176,10 @@ void REPL::run_repl() {
         }
         // If the input is not a command, append it to the current input.
         input += line;
-        // Put the input in a CodeFile.
+        // Put a copy of the input in a CodeFile, since the input is kept if
+        // more is needed.
         std::shared_ptr<CodeFile> code_file =
-            std::make_shared<CodeFile>(std::move(input), "<stdin>");
+            std::make_shared<CodeFile>(std::string(input), "<stdin>");
         // Compile the CodeFile.
         std::unique_ptr<FrontendContext>& context =
             frontend.compile(code_file, true);
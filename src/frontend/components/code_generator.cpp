@@ -7,6 +7,7 @@
 #include <llvm/IR/Verifier.h>
 
 #include "nico/frontend/utils/type_node.h"
+#include "nico/shared/phase_timer.h"
 #include "nico/shared/status.h"
 #include "nico/shared/utils.h"
 
@@ -29,12 +30,11 @@ CodeGenerator::CodeGenerator(
 
 // MARK: Statements
 
-std::any CodeGenerator::visit(Stmt::Expression* stmt) {
+void CodeGenerator::visit(Stmt::Expression* stmt) {
     stmt->expression->accept(this, false);
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Let* stmt) {
+void CodeGenerator::visit(Stmt::Let* stmt) {
     auto binding_entry = stmt->binding_entry.lock();
     auto llvm_type = binding_entry->binding.type->get_llvm_type(builder);
     auto symbol = binding_entry->symbol;
@@ -54,34 +54,27 @@ std::any CodeGenerator::visit(Stmt::Let* stmt) {
     if (stmt->expression.has_value()) {
         // Here, storing a non-constant is okay.
         builder->CreateStore(
-            std::any_cast<llvm::Value*>(
-                stmt->expression.value()->accept(this, false)
-            ),
+            stmt->expression.value()->accept(this, false),
             allocation
         );
     }
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Static* stmt) {
+void CodeGenerator::visit(Stmt::Static* stmt) {
 
     llvm::GlobalVariable* llvm_global = llvm::cast<llvm::GlobalVariable>(
         stmt->binding_entry.lock()->get_llvm_allocation(builder)
     );
 
     if (stmt->expression.has_value()) {
-        auto initializer = std::any_cast<llvm::Value*>(
-            stmt->expression.value()->accept(this, false)
-        );
+        auto initializer = stmt->expression.value()->accept(this, false);
         auto const_initializer = llvm::cast<llvm::Constant>(initializer);
         // The initializer is a constant expression. The parser enforces this.
         llvm_global->setInitializer(const_initializer);
     }
-
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Func* stmt) {
+void CodeGenerator::visit(Stmt::Func* stmt) {
     auto script_block = builder->GetInsertBlock();
 
     auto binding_entry = stmt->binding_entry.lock();
@@ -178,16 +171,14 @@ std::any CodeGenerator::visit(Stmt::Func* stmt) {
     // We set the initializer to the function.
 
     builder->SetInsertPoint(script_block);
-
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Print* stmt) {
+void CodeGenerator::visit(Stmt::Print* stmt) {
     llvm::Function* printf_fn = mod_ctx.ir_module->getFunction("printf");
 
     llvm::Value* format_str = nullptr;
     for (const auto& expr : stmt->expressions) {
-        auto value = std::any_cast<llvm::Value*>(expr->accept(this, false));
+        auto value = expr->accept(this, false);
         auto [fmt, fmt_args] = expr->type->to_print_args(builder, value);
         auto args =
             std::vector<llvm::Value*>{builder->CreateGlobalStringPtr(fmt)};
@@ -202,28 +193,22 @@ std::any CodeGenerator::visit(Stmt::Print* stmt) {
     }
 
     // Generate code for the print statement
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Dealloc* stmt) {
-    auto expr_value =
-        std::any_cast<llvm::Value*>(stmt->expression->accept(this, false));
+void CodeGenerator::visit(Stmt::Dealloc* stmt) {
+    auto expr_value = stmt->expression->accept(this, false);
     llvm::Function* free_fn = mod_ctx.ir_module->getFunction("free");
 
     builder->CreateCall(free_fn, {expr_value});
-
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Pass* /*stmt*/) {
+void CodeGenerator::visit(Stmt::Pass* /*stmt*/) {
     // A pass statement does nothing.
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Yield* stmt) {
+void CodeGenerator::visit(Stmt::Yield* stmt) {
     // Evaluate the expression to yield.
-    auto yield_value =
-        std::any_cast<llvm::Value*>(stmt->expression->accept(this, false));
+    auto yield_value = stmt->expression->accept(this, false);
 
     // Determine if this yield statement requires an unreachable block after it.
     bool require_unreachable_block = false;
@@ -259,7 +244,7 @@ std::any CodeGenerator::visit(Stmt::Yield* stmt) {
     }
     else {
         panic("CodeGenerator::visit(Stmt::Yield*): Unknown yield type.");
-        return std::any();
+        return;
     }
 
     if (require_unreachable_block) {
@@ -277,11 +262,9 @@ std::any CodeGenerator::visit(Stmt::Yield* stmt) {
         // In the future, we can change prevent code generation after a break or
         // return.
     }
-
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Continue* /*stmt*/) {
+void CodeGenerator::visit(Stmt::Continue* /*stmt*/) {
     // Generate code for the continue statement
     builder->CreateBr(control_stack.get_continue_block());
     auto unreachable_block = llvm::BasicBlock::Create(
@@ -290,59 +273,52 @@ std::any CodeGenerator::visit(Stmt::Continue* /*stmt*/) {
         builder->GetInsertBlock()->getParent()
     );
     builder->SetInsertPoint(unreachable_block);
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Namespace* stmt) {
+void CodeGenerator::visit(Stmt::Namespace* stmt) {
     // Visit each statement in the namespace block.
     for (const auto& decl : stmt->stmts) {
         decl->accept(this);
     }
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::ExternBlock* stmt) {
+void CodeGenerator::visit(Stmt::ExternBlock* stmt) {
     // Visit each statement in the extern block.
     for (const auto& decl : stmt->stmts) {
         decl->accept(this);
     }
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::TypeDef* /*stmt*/) {
+void CodeGenerator::visit(Stmt::TypeDef* /*stmt*/) {
     // Typedef declarations do not generate any code.
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::StructDef* stmt) {
+void CodeGenerator::visit(Stmt::StructDef* stmt) {
     // Visit each statement in the struct definition block.
     for (const auto& decl : stmt->stmts) {
         decl->accept(this);
     }
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Field* /*stmt*/) {
+void CodeGenerator::visit(Stmt::Field* /*stmt*/) {
     // Field definitions do not generate any code.
-    return std::any();
 }
 
-std::any CodeGenerator::visit(Stmt::Eof* stmt) {
+void CodeGenerator::visit(Stmt::Eof* stmt) {
     // Generate code for the end-of-file (EOF) statement
-    return std::any();
 }
 
 // MARK: Expressions
 
-std::any CodeGenerator::visit(Expr::Assign* expr, bool as_lvalue) {
-    auto left_ptr = std::any_cast<llvm::Value*>(expr->left->accept(this, true));
-    auto right = std::any_cast<llvm::Value*>(expr->right->accept(this, false));
+llvm::Value* CodeGenerator::visit(Expr::Assign* expr, bool as_lvalue) {
+    auto left_ptr = expr->left->accept(this, true);
+    auto right = expr->right->accept(this, false);
 
     builder->CreateStore(right, left_ptr);
     return right;
 }
 
-std::any CodeGenerator::visit(Expr::Logical* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Logical* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
     llvm::BasicBlock* current_block = builder->GetInsertBlock();
     llvm::Function* current_function = current_block->getParent();
@@ -363,7 +339,7 @@ std::any CodeGenerator::visit(Expr::Logical* expr, bool as_lvalue) {
         current_function
     );
 
-    auto left = std::any_cast<llvm::Value*>(expr->left->accept(this, false));
+    auto left = expr->left->accept(this, false);
 
     // This will store the value to use when skipping the right side; either
     // true or false
@@ -381,13 +357,12 @@ std::any CodeGenerator::visit(Expr::Logical* expr, bool as_lvalue) {
         panic(
             "CodeGenerator::visit(Expr::Logical*): Unknown logical operator."
         );
-        return std::any();
+        return nullptr;
     }
 
     // then_block: evaluate right
     builder->SetInsertPoint(then_block);
-    auto right_val =
-        std::any_cast<llvm::Value*>(expr->right->accept(this, false));
+    auto right_val = expr->right->accept(this, false);
     llvm::BasicBlock* right_block = builder->GetInsertBlock();
     builder->CreateBr(merge_block);
 
@@ -405,10 +380,10 @@ std::any CodeGenerator::visit(Expr::Logical* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Binary* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Binary* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
-    auto left = std::any_cast<llvm::Value*>(expr->left->accept(this, false));
-    auto right = std::any_cast<llvm::Value*>(expr->right->accept(this, false));
+    auto left = expr->left->accept(this, false);
+    auto right = expr->right->accept(this, false);
 
     switch (expr->operation) {
     case Expr::Binary::Operation::Null:
@@ -509,9 +484,9 @@ std::any CodeGenerator::visit(Expr::Binary* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Unary* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Unary* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
-    auto right = std::any_cast<llvm::Value*>(expr->right->accept(this, false));
+    auto right = expr->right->accept(this, false);
     if (Type::is_a<Type::Float>(expr->right->type)) {
         switch (expr->op->tok_type) {
         case Tok::Negative:
@@ -559,13 +534,12 @@ std::any CodeGenerator::visit(Expr::Unary* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Address* expr, bool as_lvalue) {
-    return std::any_cast<llvm::Value*>(expr->right->accept(this, true));
+llvm::Value* CodeGenerator::visit(Expr::Address* expr, bool as_lvalue) {
+    return expr->right->accept(this, true);
 }
 
-std::any CodeGenerator::visit(Expr::Deref* expr, bool as_lvalue) {
-    llvm::Value* result =
-        std::any_cast<llvm::Value*>(expr->right->accept(this, false));
+llvm::Value* CodeGenerator::visit(Expr::Deref* expr, bool as_lvalue) {
+    llvm::Value* result = expr->right->accept(this, false);
 
     if (as_lvalue) {
         return result;
@@ -577,10 +551,9 @@ std::any CodeGenerator::visit(Expr::Deref* expr, bool as_lvalue) {
     }
 }
 
-std::any CodeGenerator::visit(Expr::Cast* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Cast* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
-    auto inner_expr =
-        std::any_cast<llvm::Value*>(expr->expression->accept(this, false));
+    auto inner_expr = expr->expression->accept(this, false);
 
     switch (expr->operation) {
     case Expr::Cast::Operation::Null:
@@ -703,10 +676,10 @@ std::any CodeGenerator::visit(Expr::Cast* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Access* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Access* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
 
-    auto left = std::any_cast<llvm::Value*>(expr->left->accept(this, true));
+    auto left = expr->left->accept(this, true);
     auto struct_type =
         llvm::cast<llvm::StructType>(expr->left->type->get_llvm_type(builder));
 
@@ -714,7 +687,7 @@ std::any CodeGenerator::visit(Expr::Access* expr, bool as_lvalue) {
         llvm::Value* element_ptr = builder->CreateStructGEP(
             struct_type,
             left,
-            std::any_cast<size_t>(expr->right_token->literal),
+            expr->right_token->literal.get<size_t>(),
             "tuple_element"
         );
 
@@ -800,12 +773,11 @@ std::any CodeGenerator::visit(Expr::Access* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Subscript* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Subscript* expr, bool as_lvalue) {
     // Get the array pointer
-    auto array_ptr =
-        std::any_cast<llvm::Value*>(expr->left->accept(this, true));
+    auto array_ptr = expr->left->accept(this, true);
     // Get the index
-    auto index = std::any_cast<llvm::Value*>(expr->index->accept(this, false));
+    auto index = expr->index->accept(this, false);
 
     // Handle array types
     if (auto array_type =
@@ -842,13 +814,12 @@ std::any CodeGenerator::visit(Expr::Subscript* expr, bool as_lvalue) {
         "CodeGenerator::visit(Expr::Subscript*): Left expression is not "
         "an array type."
     );
-    return std::any();
+    return nullptr;
 }
 
-std::any CodeGenerator::visit(Expr::Call* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Call* expr, bool as_lvalue) {
     // Visit the callee.
-    auto callee =
-        std::any_cast<llvm::Value*>(expr->callee->accept(this, false));
+    auto callee = expr->callee->accept(this, false);
     auto callee_fn_type =
         Type::as_a<Type::Function>(expr->callee->type).value();
     if (!callee_fn_type) {
@@ -863,11 +834,7 @@ std::any CodeGenerator::visit(Expr::Call* expr, bool as_lvalue) {
     // Visit each argument.
     std::vector<llvm::Value*> args;
     for (const auto& [_, arg_weak_ptr] : expr->actual_args) {
-        args.push_back(
-            std::any_cast<llvm::Value*>(
-                arg_weak_ptr.lock()->accept(this, false)
-            )
-        );
+        args.push_back(arg_weak_ptr.lock()->accept(this, false));
     }
 
     // Make the call.
@@ -887,7 +854,7 @@ std::any CodeGenerator::visit(Expr::Call* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::SizeOf* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::SizeOf* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
     size_t type_size = expr->inner_type->get_llvm_type_size(builder);
 
@@ -899,7 +866,7 @@ std::any CodeGenerator::visit(Expr::SizeOf* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Alloc* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Alloc* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
     llvm::Value* alloc_size = nullptr;
 
@@ -915,9 +882,7 @@ std::any CodeGenerator::visit(Expr::Alloc* expr, bool as_lvalue) {
             llvm::Type::getInt64Ty(*mod_ctx.llvm_context),
             type_size
         );
-        auto amount_value = std::any_cast<llvm::Value*>(
-            expr->amount_expr.value()->accept(this, false)
-        );
+        auto amount_value = expr->amount_expr.value()->accept(this, false);
         // amount_value is definitely an integer, but may not be a u64.
         // Use SExt to convert it.
         if (amount_value->getType()->isIntegerTy(64) == false) {
@@ -949,16 +914,14 @@ std::any CodeGenerator::visit(Expr::Alloc* expr, bool as_lvalue) {
     add_alloc_nullptr_check(result, expr->location);
 
     if (expr->expression.has_value()) {
-        auto expr_value = std::any_cast<llvm::Value*>(
-            expr->expression.value()->accept(this, false)
-        );
+        auto expr_value = expr->expression.value()->accept(this, false);
         builder->CreateStore(expr_value, result);
     }
 
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::NewInst* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::NewInst* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
 
     auto struct_type = Type::as_a<Type::Struct>(expr->type).value();
@@ -968,9 +931,7 @@ std::any CodeGenerator::visit(Expr::NewInst* expr, bool as_lvalue) {
     if (expr->is_constant()) {
         std::vector<llvm::Constant*> field_constants;
         for (auto& [name, expression] : expr->actual_args) {
-            auto value = std::any_cast<llvm::Value*>(
-                expression.lock()->accept(this, false)
-            );
+            auto value = expression.lock()->accept(this, false);
             field_constants.push_back(llvm::cast<llvm::Constant>(value));
         }
         result = llvm::ConstantStruct::get(llvm_struct_type, field_constants);
@@ -990,9 +951,8 @@ std::any CodeGenerator::visit(Expr::NewInst* expr, bool as_lvalue) {
                 "field"
             );
 
-            auto field_value = std::any_cast<llvm::Value*>(
-                expr->actual_args.at(field_name)->lock()->accept(this, false)
-            );
+            auto field_value =
+                expr->actual_args.at(field_name)->lock()->accept(this, false);
 
             builder->CreateStore(field_value, field_ptr);
             ++field_index;
@@ -1005,7 +965,7 @@ std::any CodeGenerator::visit(Expr::NewInst* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::NameRef* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::NameRef* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
     llvm::Value* ptr = expr->binding_entry.lock()->get_llvm_allocation(builder);
 
@@ -1021,56 +981,56 @@ std::any CodeGenerator::visit(Expr::NameRef* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Literal* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Literal* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
 
-    switch (expr->token->tok_type) {
+    switch (expr->tok_type) {
     case Tok::Int8:
         result = llvm::ConstantInt::get(
             llvm::Type::getInt8Ty(*mod_ctx.llvm_context),
-            std::any_cast<int8_t>(expr->token->literal)
+            expr->literal.get<int8_t>()
         );
         break;
     case Tok::Int16:
         result = llvm::ConstantInt::get(
             llvm::Type::getInt16Ty(*mod_ctx.llvm_context),
-            std::any_cast<int16_t>(expr->token->literal)
+            expr->literal.get<int16_t>()
         );
         break;
     case Tok::Int32:
         result = llvm::ConstantInt::get(
             llvm::Type::getInt32Ty(*mod_ctx.llvm_context),
-            std::any_cast<int32_t>(expr->token->literal)
+            expr->literal.get<int32_t>()
         );
         break;
     case Tok::Int64:
         result = llvm::ConstantInt::get(
             llvm::Type::getInt64Ty(*mod_ctx.llvm_context),
-            std::any_cast<int64_t>(expr->token->literal)
+            expr->literal.get<int64_t>()
         );
         break;
     case Tok::UInt8:
         result = llvm::ConstantInt::get(
             llvm::Type::getInt8Ty(*mod_ctx.llvm_context),
-            std::any_cast<uint8_t>(expr->token->literal)
+            expr->literal.get<uint8_t>()
         );
         break;
     case Tok::UInt16:
         result = llvm::ConstantInt::get(
             llvm::Type::getInt16Ty(*mod_ctx.llvm_context),
-            std::any_cast<uint16_t>(expr->token->literal)
+            expr->literal.get<uint16_t>()
         );
         break;
     case Tok::UInt32:
         result = llvm::ConstantInt::get(
             llvm::Type::getInt32Ty(*mod_ctx.llvm_context),
-            std::any_cast<uint32_t>(expr->token->literal)
+            expr->literal.get<uint32_t>()
         );
         break;
     case Tok::UInt64:
         result = llvm::ConstantInt::get(
             llvm::Type::getInt64Ty(*mod_ctx.llvm_context),
-            std::any_cast<uint64_t>(expr->token->literal)
+            expr->literal.get<uint64_t>()
         );
         break;
     case Tok::Float32:
@@ -1087,7 +1047,7 @@ std::any CodeGenerator::visit(Expr::Literal* expr, bool as_lvalue) {
         else {
             result = llvm::ConstantFP::get(
                 llvm::Type::getFloatTy(*mod_ctx.llvm_context),
-                std::any_cast<float>(expr->token->literal)
+                expr->literal.get<float>()
             );
         }
         break;
@@ -1107,7 +1067,7 @@ std::any CodeGenerator::visit(Expr::Literal* expr, bool as_lvalue) {
         else {
             result = llvm::ConstantFP::get(
                 llvm::Type::getDoubleTy(*mod_ctx.llvm_context),
-                std::any_cast<double>(expr->token->literal)
+                expr->literal.get<double>()
             );
         }
         break;
@@ -1119,7 +1079,7 @@ std::any CodeGenerator::visit(Expr::Literal* expr, bool as_lvalue) {
         break;
     case Tok::Str:
         result = builder->CreateGlobalStringPtr(
-            std::any_cast<std::string>(expr->token->literal)
+            expr->literal.get<std::string>()
         );
         break;
     case Tok::Void:
@@ -1139,7 +1099,7 @@ std::any CodeGenerator::visit(Expr::Literal* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Tuple* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Tuple* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
     llvm::StructType* tuple_type =
         llvm::cast<llvm::StructType>(expr->type->get_llvm_type(builder));
@@ -1147,8 +1107,7 @@ std::any CodeGenerator::visit(Expr::Tuple* expr, bool as_lvalue) {
     if (expr->is_constant()) {
         std::vector<llvm::Constant*> element_constants;
         for (const auto& element : expr->elements) {
-            auto value =
-                std::any_cast<llvm::Value*>(element->accept(this, false));
+            auto value = element->accept(this, false);
             element_constants.push_back(llvm::cast<llvm::Constant>(value));
         }
         result = llvm::ConstantStruct::get(tuple_type, element_constants);
@@ -1156,9 +1115,7 @@ std::any CodeGenerator::visit(Expr::Tuple* expr, bool as_lvalue) {
     else {
         std::vector<llvm::Value*> element_values;
         for (const auto& element : expr->elements) {
-            element_values.push_back(
-                std::any_cast<llvm::Value*>(element->accept(this, false))
-            );
+            element_values.push_back(element->accept(this, false));
         }
         llvm::Value* tuple_alloc =
             builder->CreateAlloca(tuple_type, nullptr, "tuple");
@@ -1175,7 +1132,7 @@ std::any CodeGenerator::visit(Expr::Tuple* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Array* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Array* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
     llvm::ArrayType* array_type =
         llvm::cast<llvm::ArrayType>(expr->type->get_llvm_type(builder));
@@ -1183,8 +1140,7 @@ std::any CodeGenerator::visit(Expr::Array* expr, bool as_lvalue) {
     if (expr->is_constant()) {
         std::vector<llvm::Constant*> element_constants;
         for (const auto& element : expr->elements) {
-            auto value =
-                std::any_cast<llvm::Value*>(element->accept(this, false));
+            auto value = element->accept(this, false);
             element_constants.push_back(llvm::cast<llvm::Constant>(value));
         }
         result = llvm::ConstantArray::get(array_type, element_constants);
@@ -1193,9 +1149,7 @@ std::any CodeGenerator::visit(Expr::Array* expr, bool as_lvalue) {
 
         std::vector<llvm::Value*> element_values;
         for (const auto& element : expr->elements) {
-            element_values.push_back(
-                std::any_cast<llvm::Value*>(element->accept(this, false))
-            );
+            element_values.push_back(element->accept(this, false));
         }
         llvm::Value* array_alloc =
             builder->CreateAlloca(array_type, nullptr, "array");
@@ -1222,7 +1176,7 @@ std::any CodeGenerator::visit(Expr::Array* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Object* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Object* expr, bool as_lvalue) {
     llvm::Value* result = nullptr;
     llvm::StructType* struct_type =
         llvm::cast<llvm::StructType>(expr->type->get_llvm_type(builder));
@@ -1230,9 +1184,7 @@ std::any CodeGenerator::visit(Expr::Object* expr, bool as_lvalue) {
     if (expr->is_constant()) {
         std::vector<llvm::Constant*> field_constants;
         for (auto& field : expr->fields) {
-            auto value = std::any_cast<llvm::Value*>(
-                field.expression->accept(this, false)
-            );
+            auto value = field.expression->accept(this, false);
             field_constants.push_back(llvm::cast<llvm::Constant>(value));
         }
         result = llvm::ConstantStruct::get(struct_type, field_constants);
@@ -1240,11 +1192,7 @@ std::any CodeGenerator::visit(Expr::Object* expr, bool as_lvalue) {
     else {
         std::vector<llvm::Value*> field_values;
         for (auto& field : expr->fields) {
-            field_values.push_back(
-                std::any_cast<llvm::Value*>(
-                    field.expression->accept(this, false)
-                )
-            );
+            field_values.push_back(field.expression->accept(this, false));
         }
         llvm::Value* struct_alloc =
             builder->CreateAlloca(struct_type, nullptr, "struct");
@@ -1261,7 +1209,7 @@ std::any CodeGenerator::visit(Expr::Object* expr, bool as_lvalue) {
     return result;
 }
 
-std::any CodeGenerator::visit(Expr::Block* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Block* expr, bool as_lvalue) {
     // Blocks get their own yield allocation.
     llvm::AllocaInst* yield_allocation = builder->CreateAlloca(
         expr->type->get_llvm_type(builder),
@@ -1286,7 +1234,7 @@ std::any CodeGenerator::visit(Expr::Block* expr, bool as_lvalue) {
     return yield_value;
 }
 
-std::any CodeGenerator::visit(Expr::Conditional* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Conditional* expr, bool as_lvalue) {
     llvm::Function* current_function = builder->GetInsertBlock()->getParent();
 
     llvm::BasicBlock* then_block = llvm::BasicBlock::Create(
@@ -1305,21 +1253,18 @@ std::any CodeGenerator::visit(Expr::Conditional* expr, bool as_lvalue) {
         current_function
     );
 
-    auto condition =
-        std::any_cast<llvm::Value*>(expr->condition->accept(this, false));
+    auto condition = expr->condition->accept(this, false);
     builder->CreateCondBr(condition, then_block, else_block);
 
     // Then block
     builder->SetInsertPoint(then_block);
-    auto then_value =
-        std::any_cast<llvm::Value*>(expr->then_branch->accept(this, false));
+    auto then_value = expr->then_branch->accept(this, false);
     then_block = builder->GetInsertBlock();
     builder->CreateBr(merge_block);
 
     // Else block
     builder->SetInsertPoint(else_block);
-    auto else_value =
-        std::any_cast<llvm::Value*>(expr->else_branch->accept(this, false));
+    auto else_value = expr->else_branch->accept(this, false);
     else_block = builder->GetInsertBlock();
     builder->CreateBr(merge_block);
 
@@ -1343,7 +1288,7 @@ std::any CodeGenerator::visit(Expr::Conditional* expr, bool as_lvalue) {
     return yield_value;
 }
 
-std::any CodeGenerator::visit(Expr::Loop* expr, bool as_lvalue) {
+llvm::Value* CodeGenerator::visit(Expr::Loop* expr, bool as_lvalue) {
     llvm::AllocaInst* yield_allocation = builder->CreateAlloca(
         expr->type->get_llvm_type(builder),
         nullptr,
@@ -1394,9 +1339,7 @@ std::any CodeGenerator::visit(Expr::Loop* expr, bool as_lvalue) {
 
         // Setup the condition block.
         builder->SetInsertPoint(condition_block);
-        auto condition = std::any_cast<llvm::Value*>(
-            expr->condition.value()->accept(this, false)
-        );
+        auto condition = expr->condition.value()->accept(this, false);
         builder->CreateCondBr(condition, do_block, merge_block);
 
         builder->SetInsertPoint(do_block);
@@ -1787,6 +1730,8 @@ void CodeGenerator::add_panic(
 }
 
 bool CodeGenerator::verify_ir() {
+    auto phase = PhaseTimer::inst().scope("verify_ir");
+
     if (ir_printing_enabled) {
         mod_ctx.ir_module->print(llvm::outs(), nullptr);
     }
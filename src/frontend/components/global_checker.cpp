@@ -6,17 +6,15 @@
 
 namespace nico {
 
-std::any GlobalChecker::visit(Stmt::Expression*) {
+void GlobalChecker::visit(Stmt::Expression*) {
     // Do nothing.
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Let*) {
+void GlobalChecker::visit(Stmt::Let*) {
     // Do nothing.
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Static* stmt) {
+void GlobalChecker::visit(Stmt::Static* stmt) {
     std::shared_ptr<Type> expr_type = nullptr;
 
     // Check the type annotation. Type annotation is required for static
@@ -25,7 +23,7 @@ std::any GlobalChecker::visit(Stmt::Static* stmt) {
         auto anno_type_opt =
             annotation_checker->annotation_check(stmt->annotation.value());
         if (!anno_type_opt.has_value())
-            return std::any();
+            return;
         expr_type = anno_type_opt.value();
     }
     else {
@@ -34,10 +32,10 @@ std::any GlobalChecker::visit(Stmt::Static* stmt) {
             stmt->identifier->location,
             "Static variable declaration must have a type annotation."
         );
-        return std::any();
+        return;
     }
 
-    if (PTR_INSTANCEOF(symbol_tree->current_scope, Node::ExternBlock)) {
+    if (isa<Node::ExternBlock>(symbol_tree->current_scope)) {
         if (stmt->expression.has_value()) {
             Diagnostics::inst().emit_error(
                 Err::ExternStaticWithInitializer,
@@ -91,11 +89,10 @@ std::any GlobalChecker::visit(Stmt::Static* stmt) {
         stmt->custom_symbol_opt
     );
     if (!node_opt.has_value()) {
-        return std::any();
+        return;
     }
     else if (
-        auto binding_entry =
-            std::dynamic_pointer_cast<Node::BindingEntry>(node_opt.value())
+        auto binding_entry = dyn_cast<Node::BindingEntry>(node_opt.value())
     ) {
         stmt->binding_entry = binding_entry;
     }
@@ -105,11 +102,9 @@ std::any GlobalChecker::visit(Stmt::Static* stmt) {
             "non-binding entry for a binding entry."
         );
     }
-
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Func* stmt) {
+void GlobalChecker::visit(Stmt::Func* stmt) {
     // Start with the parameters.
     Dictionary<std::string, Binding> param_bindings;
 
@@ -127,13 +122,13 @@ std::any GlobalChecker::visit(Stmt::Func* stmt) {
                 *it->second.location,
                 "Previous declaration of parameter `" + param_string + "` here."
             );
-            return std::any();
+            return;
         }
         // Get the type from the annotation (which is always present).
         auto annotation_type_opt =
             annotation_checker->annotation_check(param.annotation);
         if (!annotation_type_opt.has_value())
-            return std::any();
+            return;
 
         Binding param_binding(
             param.has_var ? Binding::Mutability::Var
@@ -151,7 +146,7 @@ std::any GlobalChecker::visit(Stmt::Func* stmt) {
         auto return_anno_type_opt =
             annotation_checker->annotation_check(stmt->annotation.value());
         if (!return_anno_type_opt.has_value())
-            return std::any();
+            return;
         return_type = return_anno_type_opt.value();
     }
     else {
@@ -160,7 +155,7 @@ std::any GlobalChecker::visit(Stmt::Func* stmt) {
     }
 
     // If the function is declared in an extern block...
-    if (PTR_INSTANCEOF(symbol_tree->current_scope, Node::ExternBlock)) {
+    if (isa<Node::ExternBlock>(symbol_tree->current_scope)) {
         if (stmt->body.has_value()) {
             Diagnostics::inst().emit_error(
                 Err::ExternBlockFuncWithBody,
@@ -198,7 +193,7 @@ std::any GlobalChecker::visit(Stmt::Func* stmt) {
                 stmt->identifier->location,
                 "Non-extern function declaration is not allowed to be variadic."
             );
-            return std::any();
+            return;
         }
     }
 
@@ -240,7 +235,7 @@ std::any GlobalChecker::visit(Stmt::Func* stmt) {
             stmt->custom_symbol_opt
         );
         if (!node_opt.has_value()) {
-            return std::any();
+            return;
         }
         stmt->binding_entry = node_opt.value();
     }
@@ -249,43 +244,36 @@ std::any GlobalChecker::visit(Stmt::Func* stmt) {
         // It is declared as an overloadable function.
         auto node_opt = symbol_tree->add_overloadable_func(binding);
         if (!node_opt.has_value()) {
-            return std::any();
+            return;
         }
         stmt->binding_entry = node_opt.value();
     }
-
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Print*) {
+void GlobalChecker::visit(Stmt::Print*) {
     // Do nothing.
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Dealloc*) {
+void GlobalChecker::visit(Stmt::Dealloc*) {
     // Do nothing.
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Pass*) {
+void GlobalChecker::visit(Stmt::Pass*) {
     // Do nothing.
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Yield*) {
+void GlobalChecker::visit(Stmt::Yield*) {
     // Do nothing.
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Continue*) {
+void GlobalChecker::visit(Stmt::Continue*) {
     // Do nothing.
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Namespace* stmt) {
+void GlobalChecker::visit(Stmt::Namespace* stmt) {
     auto node_opt = symbol_tree->add_namespace(stmt->identifier);
     if (!node_opt.has_value()) {
-        return std::any();
+        return;
     }
 
     stmt->namespace_node = node_opt.value();
@@ -297,13 +285,12 @@ std::any GlobalChecker::visit(Stmt::Namespace* stmt) {
     // statements in the namespace.
 
     symbol_tree->exit_scope();
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::ExternBlock* stmt) {
+void GlobalChecker::visit(Stmt::ExternBlock* stmt) {
     auto node_opt = symbol_tree->add_extern_block(stmt->identifier);
     if (!node_opt.has_value()) {
-        return std::any();
+        return;
     }
 
     stmt->extern_block_node = node_opt.value();
@@ -315,10 +302,9 @@ std::any GlobalChecker::visit(Stmt::ExternBlock* stmt) {
     // statements in the extern block.
 
     symbol_tree->exit_scope();
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::TypeDef* stmt) {
+void GlobalChecker::visit(Stmt::TypeDef* stmt) {
     // First, visit the right side
     auto anno_type_opt = annotation_checker->annotation_check(stmt->annotation);
     // This checker's annotation checker will yield a type, even if the names in
@@ -327,23 +313,21 @@ std::any GlobalChecker::visit(Stmt::TypeDef* stmt) {
     // annotation.
 
     if (!anno_type_opt.has_value()) {
-        return std::any();
+        return;
     }
 
     auto type = anno_type_opt.value();
     auto node_opt = symbol_tree->add_type_def(stmt->identifier, type);
     if (!node_opt.has_value()) {
-        return std::any();
+        return;
     }
     stmt->type_def_node = node_opt.value();
-
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::StructDef* stmt) {
+void GlobalChecker::visit(Stmt::StructDef* stmt) {
     auto struct_node_opt = symbol_tree->add_struct_def(stmt->identifier, false);
     if (!struct_node_opt.has_value()) {
-        return std::any();
+        return;
     }
     auto struct_node = struct_node_opt.value();
     auto struct_type = std::make_shared<Type::Struct>(struct_node);
@@ -352,7 +336,7 @@ std::any GlobalChecker::visit(Stmt::StructDef* stmt) {
     Dictionary<std::string, Binding> struct_fields;
 
     for (auto& stmt : stmt->stmts) {
-        if (auto field_stmt = std::dynamic_pointer_cast<Stmt::Field>(stmt)) {
+        if (auto field_stmt = dyn_cast<Stmt::Field>(stmt)) {
             auto type_opt =
                 annotation_checker->annotation_check(field_stmt->annotation);
             if (!type_opt.has_value()) {
@@ -393,17 +377,14 @@ std::any GlobalChecker::visit(Stmt::StructDef* stmt) {
     stmt->struct_def_node = struct_node;
 
     symbol_tree->exit_scope();
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Field* stmt) {
+void GlobalChecker::visit(Stmt::Field* stmt) {
     // Do nothing. The field is processed in the StructDef visitor.
-    return std::any();
 }
 
-std::any GlobalChecker::visit(Stmt::Eof*) {
+void GlobalChecker::visit(Stmt::Eof*) {
     // Do nothing.
-    return std::any();
 }
 
 void GlobalChecker::run_check(std::unique_ptr<FrontendContext>& context) {
@@ -421,6 +402,8 @@ void GlobalChecker::run_check(std::unique_ptr<FrontendContext>& context) {
     else if (repl_mode) {
         if (symbol_tree->was_modified()) {
             context->status = Status::Pause(Request::DiscardWarn);
+            // The symbol tree may refer to this input's tokens.
+            context->keep_uncommitted_tokens();
         }
         else {
             context->status = Status::Pause(Request::Discard);
@@ -1,8 +1,15 @@
 #include "nico/frontend/components/lexer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <charconv>
+#include <cstdint>
+#include <iterator>
 #include <string>
+#include <thread>
 
+#include "nico/frontend/utils/char_scan.h"
 #include "nico/shared/diagnostics.h"
 #include "nico/shared/error_code.h"
 #include "nico/shared/status.h"
@@ -10,7 +17,14 @@
 
 namespace nico {
 
-std::unordered_map<std::string_view, Tok> Lexer::keywords = {
+// A keyword and its token type.
+struct Keyword {
+    std::string_view word;
+    Tok tok_type;
+};
+
+// The keywords and their respective token types.
+static constexpr Keyword keywords[] = {
     // Literals
 
     {"inf", Tok::FloatDefault},
@@ -71,7 +85,8 @@ std::unordered_map<std::string_view, Tok> Lexer::keywords = {
     {"new", Tok::KwNew}
 };
 
-std::unordered_set<std::string_view> Lexer::reserved_words = {
+// The reserved words, which cannot be used as identifiers.
+static constexpr std::string_view reserved_words[] = {
     "module",
     "import",
     "public",
@@ -84,48 +99,182 @@ std::unordered_set<std::string_view> Lexer::reserved_words = {
     "overloadedfn"
 };
 
+// The number of keywords.
+static constexpr size_t num_keywords = std::size(keywords);
+// The number of keywords and reserved words.
+static constexpr size_t num_special_words =
+    num_keywords + std::size(reserved_words);
+// The number of slots in the word table. A power of two, large enough that a
+// collision-free seed is found quickly.
+static constexpr size_t word_table_size = 256;
+
+/**
+ * @brief Gets a keyword or reserved word by its index in the word table.
+ *
+ * @param index The index of the word. Keywords come first, followed by
+ * reserved words.
+ * @return The word.
+ */
+static constexpr std::string_view special_word(size_t index) {
+    return index < num_keywords ? keywords[index].word
+                                : reserved_words[index - num_keywords];
+}
+
+/**
+ * @brief Hashes a word of at least two characters for the word table.
+ *
+ * The hash only reads the length and the first two and last two characters,
+ * which is enough to tell all keywords and reserved words apart.
+ *
+ * @param word The word to hash.
+ * @param seed The seed of the hash.
+ * @return The slot of the word in the word table.
+ */
+static constexpr size_t hash_word(std::string_view word, uint64_t seed) {
+    auto byte = [&](size_t i) {
+        return static_cast<uint64_t>(static_cast<unsigned char>(word[i]));
+    };
+    uint64_t key = byte(0) | byte(1) << 8 | byte(word.size() - 2) << 16 |
+                   byte(word.size() - 1) << 24 |
+                   static_cast<uint64_t>(word.size()) << 32;
+    key ^= seed;
+    key *= 0x9E3779B97F4A7C15ull;
+    key ^= key >> 32;
+    return key & (word_table_size - 1);
+}
+
+/**
+ * @brief A perfect hash table of the keywords and reserved words.
+ */
+struct WordTable {
+    // Whether a collision-free seed was found.
+    bool valid = false;
+    // The seed of the hash.
+    uint64_t seed = 0;
+    // The length of the longest word. Longer identifiers are not looked up.
+    size_t max_length = 0;
+    // For each slot, 0 if no word hashes to it, or the index of the word plus
+    // one.
+    uint8_t slots[word_table_size] = {};
+};
+
+/**
+ * @brief Finds a seed for which no two words collide and builds the table.
+ *
+ * Runs at compile time.
+ *
+ * @return The word table. If no seed was found, the table is not valid.
+ */
+static constexpr WordTable build_word_table() {
+    WordTable table;
+    for (size_t i = 0; i < num_special_words; i++) {
+        if (special_word(i).size() > table.max_length) {
+            table.max_length = special_word(i).size();
+        }
+    }
+    for (uint64_t seed = 0; seed < 100000; seed++) {
+        table.seed = seed;
+        std::fill(std::begin(table.slots), std::end(table.slots), 0);
+        bool collided = false;
+        for (size_t i = 0; i < num_special_words && !collided; i++) {
+            size_t slot = hash_word(special_word(i), seed);
+            collided = table.slots[slot] != 0;
+            table.slots[slot] = static_cast<uint8_t>(i + 1);
+        }
+        if (!collided) {
+            table.valid = true;
+            return table;
+        }
+    }
+    return table;
+}
+
+// The word table, built at compile time.
+static constexpr WordTable word_table = build_word_table();
+static_assert(num_special_words < 255, "Too many words for the word table.");
+static_assert(word_table.valid, "No collision-free seed for the word table.");
+
+/**
+ * @brief Looks up a word in the word table.
+ *
+ * @param word The word to look up.
+ * @return The index of the word plus one, or 0 if the word is neither a
+ * keyword nor a reserved word.
+ */
+static size_t find_special_word(std::string_view word) {
+    if (word.size() < 2 || word.size() > word_table.max_length) {
+        return 0;
+    }
+    size_t index = word_table.slots[hash_word(word, word_table.seed)];
+    if (index == 0 || special_word(index - 1) != word) {
+        return 0;
+    }
+    return index;
+}
+
 bool Lexer::is_at_end() const {
-    return current >= file->src_code.length();
+    return current >= src.length();
 }
 
-std::shared_ptr<Token> Lexer::make_token(Tok tok_type, std::any literal) const {
-    Location location(file, start, current - start, line);
-    return std::make_shared<Token>(tok_type, location, literal);
+Token Lexer::make_token(Tok tok_type, Literal literal) const {
+    Location location(file->id, start, current - start, line);
+    std::string_view lexeme = src.substr(start, current - start);
+    return Token(tok_type, location, lexeme, literal);
 }
 
-void Lexer::add_token(Tok tok_type, std::any literal) {
+void Lexer::report_error(
+    Err ec, const Location& location, std::string_view message
+) {
+    if (speculative) {
+        found_error = true;
+        return;
+    }
+    Diagnostics::inst().emit_error(ec, location, message);
+}
+
+void Lexer::report_note(const Location& location, std::string_view message) {
+    if (!speculative) {
+        Diagnostics::inst().emit_note(location, message);
+    }
+}
+
+void Lexer::report_note(std::string_view message) {
+    if (!speculative) {
+        Diagnostics::inst().emit_note(message);
+    }
+}
+
+void Lexer::add_token(Tok tok_type, Literal literal) {
     tokens.push_back(make_token(tok_type, literal));
 }
 
 char Lexer::peek(int lookahead) const {
-    return current + lookahead < file->src_code.length()
-               ? file->src_code[current + lookahead]
-               : '\0';
+    return current + lookahead < src.length() ? src[current + lookahead] : '\0';
 }
 
 char Lexer::advance() {
     if (is_at_end())
         return '\0';
     current++;
-    char c = file->src_code[current - 1];
+    char c = src[current - 1];
     return c;
 }
 
 bool Lexer::match(char expected) {
     if (is_at_end())
         return false;
-    if (file->src_code[current] != expected)
+    if (src[current] != expected)
         return false;
     current++;
     return true;
 }
 
 bool Lexer::match_all(std::string_view expected) {
-    if (current + expected.length() > file->src_code.length()) {
+    if (current + expected.length() > src.length()) {
         return false;
     }
     for (size_t i = 0; i < expected.length(); i++) {
-        if (file->src_code[current + i] != expected[i]) {
+        if (src[current + i] != expected[i]) {
             return false;
         }
     }
@@ -183,11 +332,12 @@ void Lexer::consume_whitespace() {
     // Consume all whitespace.
     while (true) {
         char c = peek();
-        if (c == ' ') {
-            current_spaces++;
-        }
-        else if (c == '\t') {
-            current_tabs++;
+        if (c == ' ' || c == '\t') {
+            // Skip the whole run of spaces or tabs at once.
+            size_t run_end = char_scan::skip_run(src, current, c);
+            (c == ' ' ? current_spaces : current_tabs) += run_end - current;
+            current = run_end;
+            continue;
         }
         else if (c == '\r') {
             // Ignore.
@@ -218,27 +368,27 @@ void Lexer::consume_whitespace() {
     // If user tried to mix left spacing...
     if (current_spaces > 0 && current_tabs > 0) {
         auto token = make_token(Tok::Unknown);
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::MixedLeftSpacing,
-            token->location,
+            token.location,
             "Line left spacing contains both tabs and spaces."
         );
         return;
     }
     else if (current_spaces && left_spacing_type == '\t') {
         auto token = make_token(Tok::Unknown);
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::InconsistentLeftSpacing,
-            token->location,
+            token.location,
             "Left spacing uses spaces when previous lines used tabs."
         );
         return;
     }
     else if (current_tabs && left_spacing_type == ' ') {
         auto token = make_token(Tok::Unknown);
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::InconsistentLeftSpacing,
-            token->location,
+            token.location,
             "Left spacing uses tabs when previous lines used spaces."
         );
         return;
@@ -256,20 +406,20 @@ void Lexer::consume_whitespace() {
     }
 
     // Handle indents.
-    if (!tokens.empty() && tokens.back()->tok_type == Tok::Colon) {
+    if (!tokens.empty() && tokens.back().tok_type == Tok::Colon) {
         // If the last token was a colon...
         if (curr_line_left_spacing <= prev_line_left_spacing) {
             // If the current left spacing is not greater than the previous
             // line's spacing, log an error.
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::MalformedIndent,
-                tokens.back()->location,
+                tokens.back().location,
                 "Expected indent with left-spacing greater than " +
                     std::to_string(prev_line_left_spacing) + "."
 
             );
-            Diagnostics::inst().emit_note(
-                make_token(Tok::Unknown)->location,
+            report_note(
+                make_token(Tok::Unknown).location,
                 "Next line only has left-spacing of " +
                     std::to_string(curr_line_left_spacing) +
                     ". If this is meant to be an empty block, add a `pass` "
@@ -277,7 +427,7 @@ void Lexer::consume_whitespace() {
             );
         }
         // Change the colon token to an indent token.
-        tokens.back()->tok_type = Tok::Indent;
+        tokens.back().tok_type = Tok::Indent;
         left_spacing_stack.push_back(prev_line_left_spacing);
     }
 
@@ -292,20 +442,19 @@ void Lexer::consume_whitespace() {
 }
 
 void Lexer::identifier() {
-    while (is_alpha_numeric(peek())) {
-        advance();
-    }
+    current = char_scan::skip_identifier(src, current);
     auto token = make_token(Tok::Identifier);
-    std::string_view text = token->lexeme;
+    std::string_view text = token.lexeme;
 
-    if (auto it = keywords.find(text); it != keywords.end()) {
-        token->tok_type = it->second;
+    size_t word_index = find_special_word(text);
+    if (word_index != 0 && word_index <= num_keywords) {
+        token.tok_type = keywords[word_index - 1].tok_type;
     }
-    else if (reserved_words.find(text) != reserved_words.end()) {
-        Diagnostics::inst().emit_error(
+    else if (word_index != 0) {
+        report_error(
             Err::WordIsReserved,
-            token->location,
-            "'" + std::string(token->lexeme) +
+            token.location,
+            "'" + std::string(token.lexeme) +
                 "' is a reserved word and cannot be used as an identifier."
         );
     }
@@ -328,9 +477,9 @@ void Lexer::tuple_index() {
     );
 
     if (result.ec == std::errc::result_out_of_range) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::TupleIndexOutOfRange,
-            make_token(Tok::Unknown)->location,
+            make_token(Tok::Unknown).location,
             "Tuple index is too large."
         );
         return;
@@ -342,7 +491,7 @@ void Lexer::tuple_index() {
         );
     }
 
-    add_token(Tok::TupleIndex, num);
+    add_token(Tok::TupleIndex, Literal::of(num));
 }
 
 void Lexer::numeric_literal() {
@@ -377,9 +526,9 @@ void Lexer::numeric_literal() {
             if (has_dot || has_exp || base != 10 || !is_digit(peek())) {
                 auto prev_start = start;
                 start = current - 1;
-                Diagnostics::inst().emit_error(
+                report_error(
                     Err::UnexpectedDotInNumber,
-                    make_token(Tok::Unknown)->location,
+                    make_token(Tok::Unknown).location,
                     "Unexpected '.' in number."
                 );
                 start = prev_start;
@@ -401,9 +550,9 @@ void Lexer::numeric_literal() {
             if (has_exp || base != 10 || !is_digit(peek())) {
                 auto prev_start = start;
                 start = current - 1;
-                Diagnostics::inst().emit_error(
+                report_error(
                     Err::UnexpectedExpInNumber,
-                    make_token(Tok::Unknown)->location,
+                    make_token(Tok::Unknown).location,
                     "Unexpected exponent in number."
                 );
                 start = prev_start;
@@ -417,9 +566,9 @@ void Lexer::numeric_literal() {
         // prefix.
         auto prev_start = start;
         start = current;
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedEndOfNumber,
-            make_token(Tok::Unknown)->location,
+            make_token(Tok::Unknown).location,
             "Expected base " + std::to_string(base) + " digit."
         );
         start = prev_start;
@@ -429,64 +578,64 @@ void Lexer::numeric_literal() {
     add_token(Tok::Unknown);
 
     // Handle type suffixes.
-    auto token = tokens.back();
+    Token& token = tokens.back();
     if (match_all("i8")) {
-        token->tok_type = Tok::Int8;
+        token.tok_type = Tok::Int8;
     }
     else if (match_all("i16")) {
-        token->tok_type = Tok::Int16;
+        token.tok_type = Tok::Int16;
     }
     else if (match_all("i32")) {
-        token->tok_type = Tok::Int32;
+        token.tok_type = Tok::Int32;
     }
     else if (match_all("i64")) {
-        token->tok_type = Tok::Int64;
+        token.tok_type = Tok::Int64;
     }
     else if (match_all("u8")) {
-        token->tok_type = Tok::UInt8;
+        token.tok_type = Tok::UInt8;
     }
     else if (match_all("u16")) {
-        token->tok_type = Tok::UInt16;
+        token.tok_type = Tok::UInt16;
     }
     else if (match_all("u32")) {
-        token->tok_type = Tok::UInt32;
+        token.tok_type = Tok::UInt32;
     }
     else if (match_all("u64")) {
-        token->tok_type = Tok::UInt64;
+        token.tok_type = Tok::UInt64;
     }
     else if (match_all("f32")) {
-        token->tok_type = Tok::Float32;
+        token.tok_type = Tok::Float32;
     }
     else if (match_all("f64")) {
-        token->tok_type = Tok::Float64;
+        token.tok_type = Tok::Float64;
     }
     else if (match('l') || match('L')) {
-        token->tok_type = Tok::Int64;
+        token.tok_type = Tok::Int64;
     }
     else if (match_all("ul") || match_all("UL")) {
-        token->tok_type = Tok::UInt64;
+        token.tok_type = Tok::UInt64;
     }
     else if (match('u') || match('U')) {
-        token->tok_type = Tok::UInt32;
+        token.tok_type = Tok::UInt32;
     }
     else if (match('f') || match('F')) {
-        token->tok_type = Tok::Float32;
+        token.tok_type = Tok::Float32;
     }
     else {
         if (has_dot || has_exp) {
-            token->tok_type = Tok::FloatDefault;
+            token.tok_type = Tok::FloatDefault;
         }
         else {
-            token->tok_type = Tok::IntDefault;
+            token.tok_type = Tok::IntDefault;
         }
     }
 
     if (is_digit(peek(), 16)) {
         auto prev_start = start;
         start = current;
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::DigitInWrongBase,
-            make_token(Tok::Unknown)->location,
+            make_token(Tok::Unknown).location,
             "Digit not allowed in numbers of base " + std::to_string(base) + "."
         );
         start = prev_start;
@@ -494,24 +643,33 @@ void Lexer::numeric_literal() {
     else if (is_alpha(peek())) {
         auto prev_start = start;
         start = current;
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::InvalidCharAfterNumber,
-            make_token(Tok::Unknown)->location,
+            make_token(Tok::Unknown).location,
             "Number cannot be followed by an alphabetic character."
         );
-        Diagnostics::inst().emit_note("Consider adding a space here.");
+        report_note("Consider adding a space here.");
         start = prev_start;
     }
 }
 
 void Lexer::str_literal() {
     std::string str_content;
-    while (peek() != '"' && !is_at_end()) {
+    while (true) {
+        // Copy everything up to the next quote, backslash, or newline at once.
+        size_t plain_end =
+            char_scan::find_first_of(src, current, '"', '\\', '\n');
+        str_content.append(src, current, plain_end - current);
+        current = plain_end;
+        if (is_at_end() || peek() == '"') {
+            break;
+        }
+
         // A normal str literal cannot span multiple lines
         if (peek() == '\n') {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnterminatedStr,
-                make_token(Tok::Unknown)->location,
+                make_token(Tok::Unknown).location,
                 "Unterminated string."
             );
             add_token(Tok::Str);
@@ -558,24 +716,21 @@ void Lexer::str_literal() {
             default: {
                 auto prev_start = start;
                 start = current - 1;
-                Diagnostics::inst().emit_error(
+                report_error(
                     Err::InvalidEscSeq,
-                    make_token(Tok::Unknown)->location,
+                    make_token(Tok::Unknown).location,
                     "Invalid escape sequence."
                 );
                 start = prev_start;
             }
             }
         }
-        else {
-            str_content += advance();
-        }
     }
 
     if (is_at_end()) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnterminatedStr,
-            make_token(Tok::Unknown)->location,
+            make_token(Tok::Unknown).location,
             "Unterminated string."
         );
         return;
@@ -583,13 +738,19 @@ void Lexer::str_literal() {
 
     advance(); // Consume the closing quote.
 
-    add_token(Tok::Str, str_content);
+    add_token(
+        Tok::Str,
+        Literal::of_str(token_store.add_string(std::move(str_content)))
+    );
 }
 
 void Lexer::multi_line_comment() {
     unsigned open_count = 1;
     auto opening_token = make_token(Tok::SlashStar);
     while (open_count) {
+        // Skip to the next character that may open or close a comment, or
+        // end a line.
+        current = char_scan::find_first_of(src, current, '/', '*', '\n');
         if (is_at_end()) {
             // If in REPL mode, request more input instead of erroring.
             if (repl_mode) {
@@ -597,9 +758,9 @@ void Lexer::multi_line_comment() {
                 return;
             }
 
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnclosedComment,
-                opening_token->location,
+                opening_token.location,
                 "Unclosed multi-line comment."
             );
 
@@ -609,10 +770,7 @@ void Lexer::multi_line_comment() {
             for (unsigned i = 0; i < open_count; i++)
                 msg += "*/";
             msg += "` here.";
-            Diagnostics::inst().emit_note(
-                make_token(Tok::Unknown)->location,
-                msg
-            );
+            report_note(make_token(Tok::Unknown).location, msg);
             start = prev_start;
             return;
         }
@@ -634,6 +792,83 @@ void Lexer::multi_line_comment() {
     }
 }
 
+void Lexer::save_checkpoint() {
+    size_t line_end = start;
+    while (line_end < src.size() &&
+           (src[line_end] == ' ' || src[line_end] == '\t' ||
+            src[line_end] == '\r')) {
+        line_end++;
+    }
+    if (line_end == src.size() || src[line_end] != '\n') {
+        return;
+    }
+    checkpoint.position = start;
+    checkpoint.line = line;
+    checkpoint.grouping_token_stack = grouping_token_stack;
+    checkpoint.left_spacing_stack = left_spacing_stack;
+    checkpoint.prev_line_left_spacing = prev_line_left_spacing;
+    checkpoint.left_spacing_type = left_spacing_type;
+    checkpoint_token_count = tokens.size();
+    checkpoint_last_tok_type =
+        tokens.empty() ? Tok::Unknown : tokens.back().tok_type;
+}
+
+void Lexer::resume_from_checkpoint(std::unique_ptr<FrontendContext>& context) {
+    auto& saved = context->lexer_checkpoint;
+    if (!saved.has_value()) {
+        return;
+    }
+    std::string_view saved_src = saved->file->src_code();
+    if (src.size() <= saved_src.size() || !src.starts_with(saved_src) ||
+        src[saved_src.size()] != '\n') {
+        saved.reset();
+        return;
+    }
+
+    checkpoint = std::move(*saved);
+    saved.reset();
+    tokens = std::move(checkpoint.tokens);
+    checkpoint.tokens = {};
+    // The new input extends the saved one, so the restored tokens are at the
+    // same offsets in it. Moving them onto the new file lets the saved file be
+    // released rather than kept alive for the rest of the session.
+    for (auto& token : tokens) {
+        token.location.file_id = file->id;
+        if (token.lexeme.data() >= saved_src.data() &&
+            token.lexeme.data() <= saved_src.data() + saved_src.size()) {
+            size_t offset = token.lexeme.data() - saved_src.data();
+            token.lexeme = src.substr(offset, token.lexeme.size());
+        }
+    }
+    checkpoint.file = nullptr;
+    checkpoint_token_count = tokens.size();
+    checkpoint_last_tok_type =
+        tokens.empty() ? Tok::Unknown : tokens.back().tok_type;
+
+    current = checkpoint.position;
+    line = checkpoint.line;
+    grouping_token_stack = checkpoint.grouping_token_stack;
+    left_spacing_stack = checkpoint.left_spacing_stack;
+    prev_line_left_spacing = checkpoint.prev_line_left_spacing;
+    left_spacing_type = checkpoint.left_spacing_type;
+}
+
+void Lexer::store_checkpoint(std::unique_ptr<FrontendContext>& context) {
+    if (!Diagnostics::inst().get_errors().empty()) {
+        context->lexer_checkpoint.reset();
+        return;
+    }
+    // Drop the tokens scanned after the checkpoint; they are scanned again
+    // with the rest of the input.
+    tokens.erase(tokens.begin() + checkpoint_token_count, tokens.end());
+    if (!tokens.empty()) {
+        tokens.back().tok_type = checkpoint_last_tok_type;
+    }
+    checkpoint.file = file;
+    checkpoint.tokens = std::move(tokens);
+    context->lexer_checkpoint = std::move(checkpoint);
+}
+
 void Lexer::scan_token() {
     char c = advance();
     switch (c) {
@@ -641,6 +876,9 @@ void Lexer::scan_token() {
     case '\t':
     case '\r':
     case '\n':
+        if (repl_mode) {
+            save_checkpoint();
+        }
         consume_whitespace();
         break;
     case '(':
@@ -658,16 +896,16 @@ void Lexer::scan_token() {
     case ')': {
         auto t = make_token(Tok::RParen);
         if (grouping_token_stack.empty()) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ClosingUnopenedGrouping,
-                t->location,
+                t.location,
                 "Found ')' without '('."
             );
         }
         else if (grouping_token_stack.back() != c) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnclosedGrouping,
-                t->location,
+                t.location,
                 "Expected '" + std::string(1, grouping_token_stack.back()) +
                     "' before ')'."
             );
@@ -681,16 +919,16 @@ void Lexer::scan_token() {
     case '}': {
         auto t = make_token(Tok::RBrace);
         if (grouping_token_stack.empty()) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ClosingUnopenedGrouping,
-                t->location,
+                t.location,
                 "Found '}' without '{'."
             );
         }
         else if (grouping_token_stack.back() != c) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnclosedGrouping,
-                t->location,
+                t.location,
                 "Expected '" + std::string(1, grouping_token_stack.back()) +
                     "' before '}'."
             );
@@ -704,16 +942,16 @@ void Lexer::scan_token() {
     case ']': {
         auto t = make_token(Tok::RSquare);
         if (grouping_token_stack.empty()) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ClosingUnopenedGrouping,
-                t->location,
+                t.location,
                 "Found ']' without '['."
             );
         }
         else if (grouping_token_stack.back() != c) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnclosedGrouping,
-                t->location,
+                t.location,
                 "Expected '" + std::string(1, grouping_token_stack.back()) +
                     "' before ']'."
             );
@@ -757,9 +995,9 @@ void Lexer::scan_token() {
         if (match('='))
             add_token(Tok::StarEq);
         else if (match('/'))
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ClosingUnopenedComment,
-                make_token(Tok::Unknown)->location,
+                make_token(Tok::Unknown).location,
                 "Found '*/' without '/*'."
             );
         else
@@ -770,8 +1008,7 @@ void Lexer::scan_token() {
             add_token(Tok::SlashEq);
         else if (match('/'))
             // Single-line comment.
-            while (peek() != '\n' && !is_at_end())
-                advance();
+            current = char_scan::find_char(src, current, '\n');
         else if (match('*'))
             // Multi-line comment.
             multi_line_comment();
@@ -820,7 +1057,7 @@ void Lexer::scan_token() {
             identifier();
         }
         else if (is_digit(c)) {
-            if (tokens.size() > 0 && tokens.back()->tok_type == Tok::Dot)
+            if (tokens.size() > 0 && tokens.back().tok_type == Tok::Dot)
                 // If the previous token was a dot, scan as a tuple index.
                 tuple_index();
             else
@@ -828,37 +1065,22 @@ void Lexer::scan_token() {
         }
         else {
             auto token = make_token(Tok::Unknown);
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnexpectedChar,
-                token->location,
+                token.location,
                 "Unexpected character."
             );
         }
     }
 }
 
-void Lexer::run_scan(std::unique_ptr<FrontendContext>& context) {
-    while (!is_at_end()) {
-        start = current;
-        scan_token();
-    }
-
-    if (repl_mode) {
-        // If in REPL mode, and we need more input, pause.
-        if (unclosed_comment || !grouping_token_stack.empty() ||
-            !left_spacing_stack.empty() ||
-            (!tokens.empty() && tokens.back()->tok_type == Tok::Colon)) {
-            context->status = Status::Pause(Request::Input);
-            return;
-        }
-    }
-
+void Lexer::add_end_tokens() {
     auto eof_token = make_token(Tok::Eof);
 
     if (!grouping_token_stack.empty()) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnclosedGrouping,
-            eof_token->location,
+            eof_token.location,
             "Expected '" + std::string(1, grouping_token_stack.back()) +
                 "' before end of file."
         );
@@ -870,6 +1092,28 @@ void Lexer::run_scan(std::unique_ptr<FrontendContext>& context) {
     }
 
     tokens.push_back(eof_token);
+}
+
+void Lexer::run_scan(std::unique_ptr<FrontendContext>& context) {
+    while (!is_at_end()) {
+        start = current;
+        scan_token();
+    }
+
+    if (repl_mode) {
+        // If in REPL mode, and we need more input, pause.
+        if (unclosed_comment || !grouping_token_stack.empty() ||
+            !left_spacing_stack.empty() ||
+            (!tokens.empty() && tokens.back().tok_type == Tok::Colon)) {
+            context->status = Status::Pause(Request::Input);
+            store_checkpoint(context);
+            return;
+        }
+        // The input is complete, so the next input starts over.
+        context->lexer_checkpoint.reset();
+    }
+
+    add_end_tokens();
 
     if (Diagnostics::inst().get_errors().empty()) {
         context->status = Status::Ok();
@@ -892,8 +1136,213 @@ void Lexer::scan(
         panic("Lexer::scan: Context is already in an error state.");
     }
 
-    Lexer lexer(file, repl_mode);
+    Lexer lexer(file, context->token_store, repl_mode);
+    if (repl_mode) {
+        lexer.resume_from_checkpoint(context);
+    }
     lexer.run_scan(context);
+    // A checkpoint's tokens are moved onto the next input's file when scanning
+    // resumes, so the store does not need to keep this file alive.
+    if (!context->lexer_checkpoint.has_value()) {
+        context->token_store.add_file(file);
+    }
+}
+
+// A position where a chunk of a file can start, and its line number.
+struct SplitPoint {
+    size_t offset;
+    size_t line;
+};
+
+/**
+ * @brief Finds positions to split a file at for scanning in parallel.
+ *
+ * A split point is the start of a line that begins with an identifier or
+ * keyword at column 0, outside of any grouping tokens, comments, or strings.
+ * The split points are at least `chunk_size` characters apart.
+ *
+ * This mirrors only as much of the lexer as is needed to track groupings,
+ * comments, and strings. Input with lexical errors may produce unsafe split
+ * points, which the chunk lexers then detect.
+ *
+ * @param src The source code to split.
+ * @param chunk_size The minimum number of characters between split points.
+ * @return The split points, in order. Does not include the start of the file.
+ */
+static std::vector<SplitPoint>
+find_split_points(std::string_view src, size_t chunk_size) {
+    std::vector<SplitPoint> points;
+    size_t next_split = chunk_size;
+    size_t line = 1;
+    size_t grouping_depth = 0;
+    size_t i = 0;
+    while (i < src.size()) {
+        char c = src[i];
+        char next = i + 1 < src.size() ? src[i + 1] : '\0';
+        if (c == '\n') {
+            line++;
+            i++;
+            if (i >= next_split && grouping_depth == 0 && i < src.size() &&
+                (std::isalpha(static_cast<unsigned char>(src[i])) ||
+                 src[i] == '_')) {
+                points.push_back({i, line});
+                next_split = i + chunk_size;
+            }
+            continue;
+        }
+        else if (c == '(' || c == '[' || c == '{') {
+            grouping_depth++;
+        }
+        else if ((c == ')' || c == ']' || c == '}') && grouping_depth > 0) {
+            grouping_depth--;
+        }
+        else if (c == '"') {
+            // Strings end at a quote or, as an error, at the end of the line.
+            i = char_scan::find_first_of(src, i + 1, '"', '\\', '\n');
+            while (i < src.size() && src[i] == '\\') {
+                i = char_scan::find_first_of(src, i + 2, '"', '\\', '\n');
+            }
+            if (i < src.size() && src[i] == '"') {
+                i++;
+            }
+            continue;
+        }
+        else if (c == '/' && next == '/') {
+            i = char_scan::find_char(src, i, '\n');
+            continue;
+        }
+        else if (c == '/' && next == '*') {
+            // Multi-line comments may be nested.
+            unsigned open_count = 1;
+            i += 2;
+            while (open_count > 0 && i < src.size()) {
+                i = char_scan::find_first_of(src, i, '/', '*', '\n');
+                if (i >= src.size()) {
+                    break;
+                }
+                next = i + 1 < src.size() ? src[i + 1] : '\0';
+                if (src[i] == '/' && next == '*') {
+                    open_count++;
+                    i++;
+                }
+                else if (src[i] == '*' && next == '/') {
+                    open_count--;
+                    i++;
+                }
+                else if (src[i] == '\n') {
+                    line++;
+                }
+                i++;
+            }
+            continue;
+        }
+        i++;
+    }
+    return points;
+}
+
+size_t Lexer::scan_parallel(
+    std::unique_ptr<FrontendContext>& context,
+    const std::shared_ptr<CodeFile>& file,
+    unsigned num_threads
+) {
+    if (IS_VARIANT(context->status, Status::Error)) {
+        panic("Lexer::scan_parallel: Context is already in an error state.");
+    }
+
+    // Chunks smaller than this are not worth handing to another thread. There
+    // are a few chunks per thread so that threads that finish early can take
+    // more.
+    constexpr size_t min_chunk_size = 64 * 1024;
+    std::string_view src_code = file->src_code();
+    std::vector<SplitPoint> points;
+    if (num_threads > 1 && src_code.size() >= 2 * min_chunk_size) {
+        size_t chunk_size =
+            std::max(min_chunk_size, src_code.size() / (num_threads * 4));
+        points = find_split_points(src_code, chunk_size);
+    }
+    if (points.empty()) {
+        scan(context, file);
+        return 1;
+    }
+
+    context->token_store.add_file(file);
+    points.insert(points.begin(), SplitPoint{0, 1});
+    size_t num_chunks = points.size();
+
+    // Each chunk has its own store for string literal values, since stores
+    // are not thread-safe.
+    std::vector<std::unique_ptr<Lexer>> lexers;
+    for (size_t i = 0; i < num_chunks; i++) {
+        size_t end =
+            i + 1 < num_chunks ? points[i + 1].offset : src_code.size();
+        auto lexer = std::unique_ptr<Lexer>(
+            new Lexer(file, context->token_store.add_nested_store())
+        );
+        lexer->src = src_code.substr(0, end);
+        lexer->current = points[i].offset;
+        lexer->line = points[i].line;
+        lexer->speculative = true;
+        lexers.push_back(std::move(lexer));
+    }
+
+    // Threads take chunks in order from a shared counter. The calling thread
+    // is one of the threads.
+    std::atomic<size_t> next_chunk = 0;
+    auto scan_chunks = [&]() {
+        size_t i;
+        while ((i = next_chunk.fetch_add(1)) < num_chunks) {
+            Lexer& lexer = *lexers[i];
+            while (!lexer.is_at_end()) {
+                lexer.start = lexer.current;
+                lexer.scan_token();
+            }
+            if (i + 1 == num_chunks) {
+                lexer.add_end_tokens();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min<size_t>(num_threads, num_chunks); i++) {
+        threads.emplace_back(scan_chunks);
+    }
+    scan_chunks();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Each chunk but the last ends just before a line at column 0, where its
+    // lexer has already added the dedents that close all indentation. Any
+    // other state means that the split point was not safe.
+    size_t num_tokens = 0;
+    for (const auto& lexer : lexers) {
+        if (lexer->found_error || !lexer->grouping_token_stack.empty() ||
+            !lexer->left_spacing_stack.empty()) {
+            Lexer serial_lexer(file, context->token_store);
+            serial_lexer.run_scan(context);
+            return 1;
+        }
+        num_tokens += lexer->tokens.size();
+    }
+
+    std::vector<Token> tokens;
+    tokens.reserve(num_tokens);
+    for (size_t i = 0; i < num_chunks; i++) {
+        tokens.insert(
+            tokens.end(),
+            lexers[i]->tokens.begin(),
+            lexers[i]->tokens.end()
+        );
+    }
+
+    if (Diagnostics::inst().get_errors().empty()) {
+        context->status = Status::Ok();
+        context->scanned_tokens = std::move(tokens);
+    }
+    else {
+        context->status = Status::Error();
+    }
+    return num_chunks;
 }
 
 } // namespace nico
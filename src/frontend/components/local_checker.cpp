@@ -9,13 +9,12 @@ namespace nico {
 
 // MARK: Statements
 
-std::any LocalChecker::visit(Stmt::Expression* stmt) {
+void LocalChecker::visit(Stmt::Expression* stmt) {
     // Visit the expression.
     expression_checker->expr_check(stmt->expression, false, true);
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Let* stmt) {
+void LocalChecker::visit(Stmt::Let* stmt) {
     std::shared_ptr<Type> expr_type = nullptr;
 
     // Visit the initializer (if present).
@@ -23,7 +22,7 @@ std::any LocalChecker::visit(Stmt::Let* stmt) {
         auto expr_type_opt =
             expression_checker->expr_check(stmt->expression.value(), false);
         if (!expr_type_opt.has_value())
-            return std::any();
+            return;
         expr_type = expr_type_opt.value();
     }
 
@@ -35,7 +34,7 @@ std::any LocalChecker::visit(Stmt::Let* stmt) {
         auto anno_type_opt =
             annotation_checker->annotation_check(stmt->annotation.value());
         if (!anno_type_opt.has_value())
-            return std::any();
+            return;
         auto anno_type = anno_type_opt.value();
 
         // If an initializer is present, check that the annotation type and
@@ -48,7 +47,7 @@ std::any LocalChecker::visit(Stmt::Let* stmt) {
                     "` is not assignable to type in annotation `" +
                     anno_type->to_string() + "`."
             );
-            return std::any();
+            return;
         }
         // On occassion, two different types are compatible with each other.
         // E.g., the annotation is @i32, but the expression is nullptr.
@@ -66,7 +65,7 @@ std::any LocalChecker::visit(Stmt::Let* stmt) {
                 std::string(stmt->identifier->lexeme) + "` of unsized type `" +
                 expr_type->to_string() + "`."
         );
-        return std::any();
+        return;
     }
 
     if (!stmt->has_var && !stmt->expression.has_value()) {
@@ -75,7 +74,7 @@ std::any LocalChecker::visit(Stmt::Let* stmt) {
             stmt->identifier->location,
             "Immutable variable declaration must have an initializer."
         );
-        return std::any();
+        return;
     }
 
     // Create the binding entry.
@@ -91,14 +90,13 @@ std::any LocalChecker::visit(Stmt::Let* stmt) {
         repl_mode ? Linkage::External : Linkage::Internal
     );
     if (!node_opt.has_value()) {
-        return std::any();
+        return;
     }
     else if (
-        auto binding_node =
-            std::dynamic_pointer_cast<Node::BindingEntry>(node_opt.value())
+        auto binding_node = dyn_cast<Node::BindingEntry>(node_opt.value())
     ) {
         stmt->binding_entry = binding_node;
-        return std::any();
+        return;
     }
     else {
         panic(
@@ -107,23 +105,21 @@ std::any LocalChecker::visit(Stmt::Let* stmt) {
             "entry for a binding entry."
         );
     }
-
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Static* stmt) {
+void LocalChecker::visit(Stmt::Static* stmt) {
     // Binding has already been created.
     // We only need to check if the initializer expression.
 
     if (!stmt->expression.has_value()) {
         // No initializer; do nothing.
-        return std::any();
+        return;
     }
 
     auto expr_type_opt =
         expression_checker->expr_check(stmt->expression.value(), false);
     if (!expr_type_opt.has_value())
-        return std::any();
+        return;
     auto expr_type = expr_type_opt.value();
     auto binding_type = stmt->binding_entry.lock()->binding.type;
 
@@ -156,11 +152,9 @@ std::any LocalChecker::visit(Stmt::Static* stmt) {
         stmt->binding_entry.lock()->binding.default_expr =
             stmt->expression.value();
     }
-
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Func* stmt) {
+void LocalChecker::visit(Stmt::Func* stmt) {
     // Get the function's type
     auto func_type_opt =
         Type::as_a<Type::Function>(stmt->binding_entry.lock()->binding.type);
@@ -214,13 +208,13 @@ std::any LocalChecker::visit(Stmt::Func* stmt) {
         }
         else {
             param.binding_entry =
-                std::dynamic_pointer_cast<Node::BindingEntry>(node_opt.value());
+                dyn_cast<Node::BindingEntry>(node_opt.value());
         }
     }
     // If there was an error in the parameters, avoid checking the body.
     if (has_error) {
         symbol_tree->exit_scope();
-        return std::any();
+        return;
     }
 
     // Check the body.
@@ -239,20 +233,17 @@ std::any LocalChecker::visit(Stmt::Func* stmt) {
                 "` is not compatible with declared return type `" +
                 func_type->return_type->to_string() + "`."
         );
-        return std::any();
+        return;
     }
     // Exit the parameter local scope.
     symbol_tree->exit_scope();
-
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Pass* /*stmt*/) {
+void LocalChecker::visit(Stmt::Pass* /*stmt*/) {
     // A pass statement does nothing.
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Yield* stmt) {
+void LocalChecker::visit(Stmt::Yield* stmt) {
 
     std::optional<std::shared_ptr<Node::LocalScope>> target_scope =
         std::nullopt;
@@ -265,7 +256,7 @@ std::any LocalChecker::visit(Stmt::Yield* stmt) {
                 stmt->yield_token->location,
                 "Cannot break outside of a loop."
             );
-            return std::any();
+            return;
         }
     }
     else if (stmt->yield_token->tok_type == Tok::KwReturn) {
@@ -277,20 +268,18 @@ std::any LocalChecker::visit(Stmt::Yield* stmt) {
                 stmt->yield_token->location,
                 "Cannot return outside of a function."
             );
-            return std::any();
+            return;
         }
     }
     else if (stmt->yield_token->tok_type == Tok::KwYield) {
-        target_scope = std::dynamic_pointer_cast<Node::LocalScope>(
-            symbol_tree->current_scope
-        );
+        target_scope = dyn_cast<Node::LocalScope>(symbol_tree->current_scope);
         if (!target_scope.has_value() || target_scope.value() == nullptr) {
             Diagnostics::inst().emit_error(
                 Err::YieldOutsideLocalScope,
                 stmt->yield_token->location,
                 "Cannot yield outside of a local scope."
             );
-            return std::any();
+            return;
         }
     }
     else {
@@ -305,7 +294,7 @@ std::any LocalChecker::visit(Stmt::Yield* stmt) {
     auto expr_type_opt =
         expression_checker->expr_check(stmt->expression, false);
     if (!expr_type_opt.has_value())
-        return std::any();
+        return;
     auto expr_type = expr_type_opt.value();
 
     if (!local_scope->yield_type) {
@@ -323,11 +312,9 @@ std::any LocalChecker::visit(Stmt::Yield* stmt) {
                 local_scope->yield_type.value()->to_string() + "`."
         );
     }
-
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Continue* stmt) {
+void LocalChecker::visit(Stmt::Continue* stmt) {
     auto target_scope =
         symbol_tree->get_local_scope_of_kind(Expr::Block::Kind::Loop);
     if (!target_scope) {
@@ -336,25 +323,23 @@ std::any LocalChecker::visit(Stmt::Continue* stmt) {
             stmt->continue_token->location,
             "Cannot use continue outside of a loop."
         );
-        return std::any();
+        return;
     }
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Print* stmt) {
+void LocalChecker::visit(Stmt::Print* stmt) {
     // Visit each expression in the print statement.
     for (auto& expr : stmt->expressions) {
         // expr->accept(this, false);
         expression_checker->expr_check(expr, false);
     }
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Dealloc* stmt) {
+void LocalChecker::visit(Stmt::Dealloc* stmt) {
     auto expr_type_opt =
         expression_checker->expr_check(stmt->expression, false);
     if (!expr_type_opt.has_value())
-        return std::any();
+        return;
     auto expr_type = expr_type_opt.value();
 
     if (Type::is_a<Type::Nullptr>(expr_type)) {
@@ -363,7 +348,7 @@ std::any LocalChecker::visit(Stmt::Dealloc* stmt) {
             stmt->expression->location,
             "Cannot deallocate pointer of nullptr type."
         );
-        return std::any();
+        return;
     }
     else if (!Type::is_a<Type::IRawPtr>(expr_type)) {
         Diagnostics::inst().emit_error(
@@ -372,7 +357,7 @@ std::any LocalChecker::visit(Stmt::Dealloc* stmt) {
             "Cannot deallocate non-raw pointer type `" +
                 expr_type->to_string() + "`."
         );
-        return std::any();
+        return;
     }
     else if (!symbol_tree->is_context_unsafe()) {
         Diagnostics::inst().emit_error(
@@ -380,13 +365,11 @@ std::any LocalChecker::visit(Stmt::Dealloc* stmt) {
             stmt->expression->location,
             "Cannot deallocate outside of unsafe context."
         );
-        return std::any();
+        return;
     }
-
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Namespace* stmt) {
+void LocalChecker::visit(Stmt::Namespace* stmt) {
     auto previous_scope = symbol_tree->current_scope;
     symbol_tree->current_scope = stmt->namespace_node.lock();
 
@@ -403,21 +386,17 @@ std::any LocalChecker::visit(Stmt::Namespace* stmt) {
     // We could probably do `symbol_tree->exit_scope()` here and that would be
     // fine and possibly just as safe, but this is more predictable and saves us
     // the trouble of proving that `exit_scope()` works.
-
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::ExternBlock* /*stmt*/) {
+void LocalChecker::visit(Stmt::ExternBlock* /*stmt*/) {
     // Extern blocks do not contain execution-space statements.
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::TypeDef* /*stmt*/) {
+void LocalChecker::visit(Stmt::TypeDef* /*stmt*/) {
     // Type definitions do not contain execution-space statements.
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::StructDef* stmt) {
+void LocalChecker::visit(Stmt::StructDef* stmt) {
     auto previous_scope = symbol_tree->current_scope;
     symbol_tree->current_scope = stmt->struct_def_node.lock();
 
@@ -433,8 +412,7 @@ std::any LocalChecker::visit(Stmt::StructDef* stmt) {
     auto struct_type = struct_type_opt.value();
 
     for (auto& inner_stmt : stmt->stmts) {
-        if (auto field_stmt =
-                std::dynamic_pointer_cast<Stmt::Field>(inner_stmt)) {
+        if (auto field_stmt = dyn_cast<Stmt::Field>(inner_stmt)) {
             auto field_binding =
                 struct_type->fields
                     .at(std::string(field_stmt->identifier->lexeme))
@@ -466,18 +444,13 @@ std::any LocalChecker::visit(Stmt::StructDef* stmt) {
     }
 
     symbol_tree->current_scope = previous_scope;
-
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Field* /*stmt*/) {
+void LocalChecker::visit(Stmt::Field* /*stmt*/) {
     // Field definitions do not contain execution-space statements.
-    return std::any();
 }
 
-std::any LocalChecker::visit(Stmt::Eof* stmt) {
-    return std::any();
-}
+void LocalChecker::visit(Stmt::Eof* stmt) {}
 
 void LocalChecker::run_check(std::unique_ptr<FrontendContext>& context) {
     symbol_tree->clear_modified();
@@ -492,6 +465,8 @@ void LocalChecker::run_check(std::unique_ptr<FrontendContext>& context) {
     else if (repl_mode) {
         if (symbol_tree->was_modified()) {
             context->status = Status::Pause(Request::DiscardWarn);
+            // The symbol tree may refer to this input's tokens.
+            context->keep_uncommitted_tokens();
         }
         else {
             context->status = Status::Pause(Request::Discard);
@@ -510,7 +485,11 @@ void LocalChecker::check(
         panic("LocalChecker::check: Context is already in an error state.");
     }
 
-    LocalChecker checker(context->symbol_tree, repl_mode);
+    LocalChecker checker(
+        context->symbol_tree,
+        context->token_store,
+        repl_mode
+    );
     checker.run_check(context);
 }
 
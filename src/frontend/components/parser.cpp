@@ -1,40 +1,83 @@
 #include "nico/frontend/components/parser.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
 #include <cstdint>
+#include <thread>
 
 #include "nico/shared/diagnostics.h"
 #include "nico/shared/utils.h"
 
 namespace nico {
 
+void Parser::report_error(
+    Err ec, const Location& location, std::string_view message
+) {
+    if (speculative) {
+        found_error = true;
+        return;
+    }
+    Diagnostics::inst().emit_error(ec, location, message);
+}
+
+void Parser::report_error(
+    Err ec, const Location* location, std::string_view message
+) {
+    if (speculative) {
+        found_error = true;
+        return;
+    }
+    Diagnostics::inst().emit_error(ec, location, message);
+}
+
+void Parser::report_note(const Location& location, std::string_view message) {
+    if (!speculative) {
+        Diagnostics::inst().emit_note(location, message);
+    }
+}
+
+void Parser::report_note(std::string_view message) {
+    if (!speculative) {
+        Diagnostics::inst().emit_note(message);
+    }
+}
+
 bool Parser::is_at_end() const {
     return current >= tokens.size();
 }
 
-const std::shared_ptr<Token>& Parser::peek() const {
+Token* Parser::peek() const {
     if (is_at_end()) {
-        return tokens.back();
+        return &tokens.back();
     }
-    return tokens.at(current);
+    return &tokens.at(current);
 }
 
-const std::shared_ptr<Token>& Parser::previous() const {
+Token* Parser::previous() const {
     if (current == 0) {
         panic("Parser::previous: No previous token.");
     }
-    return tokens.at(current - 1);
+    return &tokens.at(current - 1);
 }
 
-const std::shared_ptr<Token>& Parser::advance() {
+Token* Parser::advance() {
     if (!is_at_end()) {
         current++;
     }
-    return tokens.at(current - 1);
+    return &tokens.at(current - 1);
+}
+
+Tok Parser::peek_next_type() const {
+    if (current + 1 >= tokens.size()) {
+        return Tok::Eof;
+    }
+    return tokens.at(current + 1).tok_type;
 }
 
-bool Parser::match(const std::vector<Tok>& types) {
-    for (const auto& type : types) {
+bool Parser::match(std::initializer_list<Tok> types) {
+    for (auto type : types) {
         if (peek()->tok_type == type) {
             advance();
             return true;
@@ -105,8 +148,8 @@ void Parser::synchronize_statements() {
     }
 }
 
-std::shared_ptr<Token>
-Parser::binary_op_from_compound_op(const std::shared_ptr<Token>& compound_op) {
+const Token*
+Parser::binary_op_from_compound_op(const Token* compound_op) {
     Tok binary_op_type;
     switch (compound_op->tok_type) {
     case Tok::PlusEq:
@@ -136,7 +179,11 @@ Parser::binary_op_from_compound_op(const std::shared_ptr<Token>& compound_op) {
     // '='
     auto binary_op_loc = compound_op->location;
     binary_op_loc.length -= 1;
-    return std::make_shared<Token>(binary_op_type, binary_op_loc);
+    return token_store.add_token(Token(
+        binary_op_type,
+        binary_op_loc,
+        compound_op->lexeme.substr(0, binary_op_loc.length)
+    ));
 }
 
 // MARK: Modifiers
@@ -145,7 +192,7 @@ std::optional<Modifier> Parser::modifier() {
     if (peek()->tok_type == Tok::Identifier ||
         tokens::is_keyword(peek()->tok_type)) {
         auto identifier_tok = advance();
-        std::vector<std::shared_ptr<Token>> args;
+        std::vector<const Token*> args;
         if (match({Tok::LParen})) {
             // Modifier arguments are special.
             // Rather than being a comma separate list of expressions,
@@ -162,7 +209,7 @@ std::optional<Modifier> Parser::modifier() {
         return Modifier(identifier_tok, std::move(args));
     }
     else {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAModifier,
             peek()->location,
             "Expected an identifier-like token here."
@@ -185,7 +232,7 @@ std::optional<std::vector<Modifier>> Parser::modifier_list() {
     } while (match({Tok::Comma}));
 
     if (!match({Tok::RSquare})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected ']' after modifier list."
@@ -208,12 +255,12 @@ std::optional<std::shared_ptr<Expr>> Parser::block(Expr::Block::Kind kind) {
         closing_token_type = Tok::RBrace;
     }
     else if (peek()->tok_type == Tok::Colon) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ColonInsteadOfIndent,
             peek()->location,
             "Unexpected `:` after `block` keyword."
         );
-        Diagnostics::inst().emit_note(
+        report_note(
             "Indentation is possibly ignored here. Consider using `{` for "
             "this "
             "block or using indentation for the surrounding scope."
@@ -221,7 +268,7 @@ std::optional<std::shared_ptr<Expr>> Parser::block(Expr::Block::Kind kind) {
         return std::nullopt;
     }
     else {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotABlock,
             peek()->location,
             "Expected '{' or an indent to start a block expression."
@@ -237,15 +284,14 @@ std::optional<std::shared_ptr<Expr>> Parser::block(Expr::Block::Kind kind) {
             synchronize_statements();
             continue;
         }
-        auto exec_allowed_stmt =
-            std::dynamic_pointer_cast<Stmt::IExecAllowed>(*stmt);
+        auto exec_allowed_stmt = dyn_cast<Stmt::IExecAllowed>(*stmt);
         if (!exec_allowed_stmt) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NonExecAllowedStmt,
                 stmt.value()->location,
                 "Block expression does not allow this kind of statement."
             );
-            Diagnostics::inst().emit_note(
+            report_note(
                 "Only execution-space statements are allowed in block "
                 "expressions. Declarations must be made outside of block "
                 "expressions."
@@ -281,12 +327,12 @@ std::optional<std::shared_ptr<Expr>> Parser::conditional() {
         then_branch = expression();
     }
     else if (peek()->tok_type == Tok::Colon) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ColonInsteadOfIndent,
             peek()->location,
             "Unexpected `:` after condition clause."
         );
-        Diagnostics::inst().emit_note(
+        report_note(
             "Indentation is possibly ignored here. Consider using `{` for "
             "this "
             "block or using indentation for the surrounding scope."
@@ -294,7 +340,7 @@ std::optional<std::shared_ptr<Expr>> Parser::conditional() {
         return std::nullopt;
     }
     else {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ConditionalWithoutThenOrBlock,
             peek()->location,
             "Conditional expression requires `then` keyword or a block."
@@ -321,7 +367,9 @@ std::optional<std::shared_ptr<Expr>> Parser::conditional() {
     else {
         // If there is no `else` keyword, we inject a void value.
         else_branch = std::make_shared<Expr::Literal>(
-            std::make_shared<Token>(Tok::Void, if_kw->location)
+            token_store.add_token(
+                Token(Tok::Void, if_kw->location, if_kw->lexeme)
+            )
         );
         implicit_else = true;
     }
@@ -367,12 +415,12 @@ std::optional<std::shared_ptr<Expr>> Parser::loop() {
             expr_body = expression();
         }
         else if (peek()->tok_type == Tok::Colon) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ColonInsteadOfIndent,
                 peek()->location,
                 "Unexpected `:` after while loop condition."
             );
-            Diagnostics::inst().emit_note(
+            report_note(
                 "Indentation is possibly ignored here. Consider using `{` "
                 "for "
                 "this "
@@ -381,7 +429,7 @@ std::optional<std::shared_ptr<Expr>> Parser::loop() {
             return std::nullopt;
         }
         else {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::WhileLoopWithoutDoOrBlock,
                 peek()->location,
                 "While loop requires `do` keyword or a block."
@@ -392,8 +440,7 @@ std::optional<std::shared_ptr<Expr>> Parser::loop() {
             return std::nullopt;
 
         // If the condition is literally `true`...
-        if (auto literal =
-                std::dynamic_pointer_cast<Expr::Literal>(*condition)) {
+        if (auto literal = dyn_cast<Expr::Literal>(*condition)) {
             if (literal->token->lexeme == "true") {
                 // Treat this like a loop-loop
                 loops_once = true;
@@ -409,12 +456,12 @@ std::optional<std::shared_ptr<Expr>> Parser::loop() {
             expr_body = block(Expr::Block::Kind::Loop);
         }
         else if (peek()->tok_type == Tok::Colon) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ColonInsteadOfIndent,
                 peek()->location,
                 "Unexpected `:` after `do` keyword."
             );
-            Diagnostics::inst().emit_note(
+            report_note(
                 "Indentation is possibly ignored here. Consider using `{` "
                 "for "
                 "this "
@@ -430,7 +477,7 @@ std::optional<std::shared_ptr<Expr>> Parser::loop() {
 
         // Check for the `while` keyword.
         if (!match({Tok::KwWhile})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::DoWhileLoopWithoutWhile,
                 peek()->location,
                 "`do` must be followed by `while`."
@@ -442,8 +489,7 @@ std::optional<std::shared_ptr<Expr>> Parser::loop() {
         if (!condition)
             return std::nullopt;
         // If the condition is literally `true`...
-        if (auto literal =
-                std::dynamic_pointer_cast<Expr::Literal>(*condition)) {
+        if (auto literal = dyn_cast<Expr::Literal>(*condition)) {
             if (literal->token->lexeme == "true") {
                 // Treat this like a loop-loop
                 condition = std::nullopt;
@@ -457,7 +503,7 @@ std::optional<std::shared_ptr<Expr>> Parser::loop() {
     // The body must be a block.
     // If it is not a block, we wrap it in one.
     std::shared_ptr<Expr::Block> body =
-        std::dynamic_pointer_cast<Expr::Block>(expr_body.value());
+        dyn_cast<Expr::Block>(expr_body.value());
     if (!body) {
         body = std::make_shared<Expr::Block>(
             loop_kw,
@@ -496,7 +542,7 @@ std::optional<std::shared_ptr<Expr>> Parser::grouping_or_tuple() {
     } while (comma_matched);
 
     if (!match({Tok::RParen})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `)` after expression grouping."
@@ -538,7 +584,7 @@ std::optional<std::shared_ptr<Expr>> Parser::array() {
     } while (comma_matched);
 
     if (!match({Tok::RSquare})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `]` after array literal."
@@ -569,7 +615,7 @@ std::optional<std::shared_ptr<Expr>> Parser::object() {
         }
 
         if (!match({Tok::Identifier})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NotAnIdentifier,
                 peek()->location,
                 "Expected an identifier for the field name in object "
@@ -580,7 +626,7 @@ std::optional<std::shared_ptr<Expr>> Parser::object() {
         }
         auto field_token = previous();
         if (!match({Tok::Colon})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnexpectedToken,
                 peek()->location,
                 "Expected a colon after the field name in object literal."
@@ -599,7 +645,7 @@ std::optional<std::shared_ptr<Expr>> Parser::object() {
     } while (match({Tok::Comma}));
 
     if (!match({Tok::RBrace})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `}` after object literal."
@@ -613,7 +659,7 @@ std::optional<std::shared_ptr<Expr>> Parser::object() {
 std::optional<std::shared_ptr<Expr>> Parser::new_instance() {
     auto new_kw = previous();
     if (!match({Tok::Identifier})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotANamedType,
             peek()->location,
             "Expected a named type after `new` keyword."
@@ -626,7 +672,7 @@ std::optional<std::shared_ptr<Expr>> Parser::new_instance() {
     }
 
     if (!match({Tok::LBrace})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `{` after type annotation in instance initializer."
@@ -643,7 +689,7 @@ std::optional<std::shared_ptr<Expr>> Parser::new_instance() {
         }
 
         if (!match({Tok::Identifier})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NotAnIdentifier,
                 peek()->location,
                 "Expected an identifier for the field name in object "
@@ -654,7 +700,7 @@ std::optional<std::shared_ptr<Expr>> Parser::new_instance() {
         }
         auto field_token = previous();
         if (!match({Tok::Colon})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnexpectedToken,
                 peek()->location,
                 "Expected a colon after the field name in object literal."
@@ -673,7 +719,7 @@ std::optional<std::shared_ptr<Expr>> Parser::new_instance() {
     } while (match({Tok::Comma}));
 
     if (!match({Tok::RBrace})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `}` after object literal."
@@ -701,7 +747,7 @@ std::optional<std::shared_ptr<Expr>> Parser::allocation() {
             return std::nullopt;
         // Check for 'of' keyword.
         if (!match({Tok::KwOf})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::AllocForWithoutOf,
                 peek()->location,
                 "Expected `of` keyword after amount expression after "
@@ -754,7 +800,7 @@ std::optional<std::shared_ptr<Expr>> Parser::allocation() {
 
 std::optional<size_t> Parser::array_size() {
     if (peek()->tok_type != Tok::IntDefault) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NaturalNumberWithoutIntDefaultToken,
             peek()->location,
             "Expected a non-negative integer without a sign or type suffix."
@@ -768,12 +814,12 @@ std::optional<size_t> Parser::array_size() {
             continue;
         }
         else if (!std::isdigit(lexeme[i])) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::AlphaCharInArraySize,
                 peek()->location,
                 "Array size contains non-digit characters."
             );
-            Diagnostics::inst().emit_note(
+            report_note(
                 "Only base-10 digits (0-9) and underscores are allowed in "
                 "this "
                 "number."
@@ -783,11 +829,10 @@ std::optional<size_t> Parser::array_size() {
         numeric_string += lexeme[i];
     }
     advance();
-    auto token = previous();
-    auto [any_val, ec] = parse_number<size_t>(numeric_string, 10);
+    auto [literal, ec] = parse_number<size_t>(numeric_string, 10);
 
     if (ec == std::errc::result_out_of_range) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ArraySizeTooLarge,
             previous()->location,
             "Array size is too large."
@@ -798,13 +843,11 @@ std::optional<size_t> Parser::array_size() {
         panic("Parser::array_size: Number in unexpected format.");
         return std::nullopt;
     }
-    token->literal = any_val;
-    token->tok_type = Tok::ArraySize;
-    return std::any_cast<size_t>(any_val);
+    return literal.get<size_t>();
 }
 
 std::optional<std::shared_ptr<Name>> Parser::name() {
-    std::shared_ptr<Token> identifier = previous();
+    const Token* identifier = previous();
     if (identifier->tok_type != Tok::Identifier) {
         panic(
             "Parser::name: Attempted to parse a name, but previous token "
@@ -816,7 +859,7 @@ std::optional<std::shared_ptr<Name>> Parser::name() {
 
     while (match({Tok::ColonColon})) {
         if (!match({Tok::Identifier})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NotAnIdentifier,
                 peek()->location,
                 "Expected an identifier after `::`."
@@ -828,18 +871,59 @@ std::optional<std::shared_ptr<Name>> Parser::name() {
     return name;
 }
 
+// The size of the buffer that number_literal copies digits into. Longer
+// numbers are copied into a string instead.
+static constexpr size_t NUMBER_BUFFER_SIZE = 64;
+
+/**
+ * @brief Prepares the digits of a numeric literal for parsing, removing
+ * underscores and adding a negative sign if needed.
+ *
+ * If nothing needs to change, the digits are returned as they are. Otherwise,
+ * they are copied into `buffer`, or into `fallback` if they do not fit.
+ *
+ * @param digits The digits of the number, without a base prefix.
+ * @param negative Whether to add a negative sign.
+ * @param buffer A buffer of `NUMBER_BUFFER_SIZE` characters.
+ * @param fallback A string to use if the buffer is too small.
+ * @return The digits to parse.
+ */
+static std::string_view prepare_digits(
+    std::string_view digits, bool negative, char* buffer, std::string& fallback
+) {
+    if (!negative && digits.find('_') == std::string_view::npos) {
+        return digits;
+    }
+    size_t max_length = digits.size() + 1;
+    char* out = buffer;
+    if (max_length > NUMBER_BUFFER_SIZE) {
+        fallback.resize(max_length);
+        out = fallback.data();
+    }
+    char* begin = out;
+    if (negative) {
+        *out++ = '-';
+    }
+    for (char c : digits) {
+        if (c != '_') {
+            *out++ = c;
+        }
+    }
+    return std::string_view(begin, out - begin);
+}
+
 std::optional<std::shared_ptr<Expr>> Parser::number_literal() {
-    std::string numeric_string;
-    if (current > 0 && previous()->tok_type == Tok::Negative) {
+    bool negative = false;
+    if (current > 0 && previous() == negation_token) {
         if (tokens::is_unsigned_integer(peek()->tok_type)) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NegativeOnUnsignedLiteral,
                 previous()->location,
                 "Cannot use unary `-` on unsigned integer literal."
             );
             return std::nullopt;
         }
-        numeric_string += "-";
+        negative = true;
     }
     auto lexeme = peek()->lexeme;
     int base = 10;
@@ -856,17 +940,19 @@ std::optional<std::shared_ptr<Expr>> Parser::number_literal() {
         base = 8;
         start_index = 2;
     }
-    for (size_t i = start_index; i < lexeme.size(); i++) {
-        if (lexeme[i] != '_') {
-            numeric_string += lexeme[i];
-        }
-    }
+    // Most numbers are parsed straight from the lexeme or from a buffer on the
+    // stack, so no string is allocated for them.
+    char buffer[NUMBER_BUFFER_SIZE];
+    std::string fallback;
+    std::string_view numeric_string =
+        prepare_digits(lexeme.substr(start_index), negative, buffer, fallback);
 
     advance();
     auto token = previous();
-    std::pair<std::any, std::errc> parse_result;
+    Tok tok_type = token->tok_type;
+    std::pair<Literal, std::errc> parse_result;
 
-    switch (token->tok_type) {
+    switch (tok_type) {
     case Tok::Int8:
         parse_result = parse_number<int8_t>(numeric_string, base);
         break;
@@ -898,11 +984,11 @@ std::optional<std::shared_ptr<Expr>> Parser::number_literal() {
         parse_result = parse_number<double>(numeric_string);
         break;
     case Tok::IntDefault:
-        token->tok_type = Tok::Int32;
+        tok_type = Tok::Int32;
         parse_result = parse_number<int32_t>(numeric_string, base);
         break;
     case Tok::FloatDefault:
-        token->tok_type = Tok::Float64;
+        tok_type = Tok::Float64;
         parse_result = parse_number<double>(numeric_string);
         break;
     default:
@@ -910,9 +996,9 @@ std::optional<std::shared_ptr<Expr>> Parser::number_literal() {
         return std::nullopt;
     }
 
-    auto [any_val, ec] = parse_result;
+    auto [literal, ec] = parse_result;
     if (ec == std::errc::result_out_of_range) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NumberOutOfRange,
             previous()->location,
             "Numeric literal is out of range for its type."
@@ -923,8 +1009,9 @@ std::optional<std::shared_ptr<Expr>> Parser::number_literal() {
         panic("Parser::number_literal: Number in unexpected format.");
         return std::nullopt;
     }
-    token->literal = any_val;
-    return std::make_shared<Expr::Literal>(token);
+    // The scanned token is left as it is, since other parsers may be reading
+    // it. The value and resolved type are kept on the node instead.
+    return std::make_shared<Expr::Literal>(token, tok_type, literal);
 }
 
 std::optional<std::shared_ptr<Expr>> Parser::primary() {
@@ -976,7 +1063,7 @@ std::optional<std::shared_ptr<Expr>> Parser::primary() {
         incomplete_statement = true;
     }
     else {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAnExpression,
             advance()->location,
             "Expected expression."
@@ -996,7 +1083,7 @@ std::optional<std::shared_ptr<Expr>> Parser::postfix() {
                 left = std::make_shared<Expr::Access>(*left, op, previous());
             }
             else {
-                Diagnostics::inst().emit_error(
+                report_error(
                     Err::UnexpectedTokenAfterDot,
                     peek()->location,
                     "Expected identifier or integer after `.`."
@@ -1010,7 +1097,7 @@ std::optional<std::shared_ptr<Expr>> Parser::postfix() {
             if (!index_expr)
                 return std::nullopt;
             if (!match({Tok::RSquare})) {
-                Diagnostics::inst().emit_error(
+                report_error(
                     Err::UnexpectedToken,
                     peek()->location,
                     "Expected `]` after array subscript."
@@ -1030,7 +1117,7 @@ std::optional<std::shared_ptr<Expr>> Parser::postfix() {
                     break;
                 }
                 if (peek()->tok_type == Tok::Identifier &&
-                    tokens.at(current + 1)->tok_type == Tok::Colon) {
+                    peek_next_type() == Tok::Colon) {
                     // This token definitely exists because there is a
                     // guaranteed `)` from the lexer.
                     has_named_args = true;
@@ -1050,7 +1137,7 @@ std::optional<std::shared_ptr<Expr>> Parser::postfix() {
                         return std::nullopt;
                     pos_args.push_back(*expr);
                     if (has_named_args) {
-                        Diagnostics::inst().emit_error(
+                        report_error(
                             Err::PosArgumentAfterNamedArgument,
                             expr->get()->location,
                             "Positional arguments cannot follow named "
@@ -1061,7 +1148,7 @@ std::optional<std::shared_ptr<Expr>> Parser::postfix() {
                 }
             } while (match({Tok::Comma}));
             if (!match({Tok::RParen})) {
-                Diagnostics::inst().emit_error(
+                report_error(
                     Err::UnexpectedToken,
                     peek()->location,
                     "Expected `)` after arguments in function call."
@@ -1081,8 +1168,8 @@ std::optional<std::shared_ptr<Expr>> Parser::postfix() {
 
 std::optional<std::shared_ptr<Expr>> Parser::unary() {
     if (match({Tok::Minus})) {
-        auto token = previous();
-        token->tok_type = Tok::Negative;
+        negation_token = previous();
+        auto minus_token = negation_token;
         auto right = unary();
         if (!right)
             return std::nullopt;
@@ -1090,7 +1177,14 @@ std::optional<std::shared_ptr<Expr>> Parser::unary() {
             // number_literal already handles the negation.
             return right;
 
-        return std::make_shared<Expr::Unary>(token, *right);
+        // The scanned token is left as it is, since other parsers may be
+        // reading it. The operator refers to a copy retyped as a negation.
+        Token negative_token = *minus_token;
+        negative_token.tok_type = Tok::Negative;
+        return std::make_shared<Expr::Unary>(
+            token_store.add_token(negative_token),
+            *right
+        );
     }
     if (match({Tok::KwNot, Tok::Bang})) {
         auto token = previous();
@@ -1115,7 +1209,7 @@ std::optional<std::shared_ptr<Expr>> Parser::unary() {
         return std::make_shared<Expr::Address>(token, *right, has_var);
     }
     else if (has_var) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedVarInExpression,
             peek()->location,
             "`var` must be followed by address-of operator `@` or `&`."
@@ -1125,143 +1219,106 @@ std::optional<std::shared_ptr<Expr>> Parser::unary() {
     return postfix();
 }
 
-std::optional<std::shared_ptr<Expr>> Parser::cast() {
-    auto left = unary();
-    if (!left)
-        return std::nullopt;
-    while (match({Tok::KwAs})) {
-        auto as_token = previous();
-        auto anno = annotation();
-        if (!anno)
-            return std::nullopt;
-        left = std::make_shared<Expr::Cast>(*left, as_token, *anno);
-    }
-    return left;
+// The binding power of each token type as an infix operator, indexed by the
+// token type.
+static constexpr auto BINDING_POWERS = [] {
+    std::array<BindingPower, static_cast<size_t>(Tok::_KeywordsEnd) + 1>
+        powers{};
+    auto set = [&](std::initializer_list<Tok> types, BindingPower power) {
+        for (auto type : types) {
+            powers[static_cast<size_t>(type)] = power;
+        }
+    };
+    set({Tok::Eq,
+         Tok::PlusEq,
+         Tok::MinusEq,
+         Tok::StarEq,
+         Tok::SlashEq,
+         Tok::PercentEq},
+        BindingPower::Assignment);
+    set({Tok::KwOr}, BindingPower::Or);
+    set({Tok::KwAnd}, BindingPower::And);
+    set({Tok::EqEq, Tok::BangEq}, BindingPower::Equality);
+    set({Tok::Lt, Tok::Gt, Tok::LtEq, Tok::GtEq}, BindingPower::Comparison);
+    set({Tok::Plus, Tok::Minus}, BindingPower::Term);
+    set({Tok::Star, Tok::Slash, Tok::Percent}, BindingPower::Factor);
+    set({Tok::KwAs}, BindingPower::Cast);
+    return powers;
+}();
+
+/**
+ * @brief Gets the binding power of a token type as an infix operator.
+ *
+ * @param type The token type.
+ * @return The binding power, or `BindingPower::None` if the token type is not
+ * an infix operator.
+ */
+static BindingPower binding_power(Tok type) {
+    return BINDING_POWERS[static_cast<size_t>(type)];
 }
 
-std::optional<std::shared_ptr<Expr>> Parser::factor() {
-    auto left = cast();
-    if (!left)
-        return std::nullopt;
-    while (match({Tok::Star, Tok::Slash, Tok::Percent})) {
-        auto op = previous();
-        auto right = cast();
-        if (!right)
-            return std::nullopt;
-        left = std::make_shared<Expr::Binary>(*left, op, *right);
-    }
-    return left;
-}
-
-std::optional<std::shared_ptr<Expr>> Parser::term() {
-    auto left = factor();
-    if (!left)
-        return std::nullopt;
-    while (match({Tok::Plus, Tok::Minus})) {
-        auto op = previous();
-        auto right = factor();
-        if (!right)
-            return std::nullopt;
-        left = std::make_shared<Expr::Binary>(*left, op, *right);
-    }
-    return left;
-}
-
-std::optional<std::shared_ptr<Expr>> Parser::comparison() {
-    auto left = term();
-    if (!left)
-        return std::nullopt;
-    while (match({Tok::Lt, Tok::Gt, Tok::LtEq, Tok::GtEq})) {
-        auto op = previous();
-        auto right = term();
-        if (!right)
-            return std::nullopt;
-        left = std::make_shared<Expr::Binary>(*left, op, *right);
-    }
-    return left;
-}
-
-std::optional<std::shared_ptr<Expr>> Parser::equality() {
-    auto left = comparison();
-    if (!left)
-        return std::nullopt;
-    while (match({Tok::EqEq, Tok::BangEq})) {
-        auto op = previous();
-        auto right = comparison();
-        if (!right)
-            return std::nullopt;
-        left = std::make_shared<Expr::Binary>(*left, op, *right);
-    }
-    return left;
-}
-
-std::optional<std::shared_ptr<Expr>> Parser::logical_and() {
-    auto left = equality();
-    if (!left)
-        return std::nullopt;
-    while (match({Tok::KwAnd})) {
-        auto op = previous();
-        auto right = equality();
-        if (!right)
-            return std::nullopt;
-        left = std::make_shared<Expr::Logical>(*left, op, *right);
-    }
-    return left;
-}
-
-std::optional<std::shared_ptr<Expr>> Parser::logical_or() {
-    auto left = logical_and();
-    if (!left)
-        return std::nullopt;
-    while (match({Tok::KwOr})) {
-        auto op = previous();
-        auto right = logical_and();
-        if (!right)
-            return std::nullopt;
-        left = std::make_shared<Expr::Logical>(*left, op, *right);
-    }
-    return left;
-}
-
-std::optional<std::shared_ptr<Expr>> Parser::assignment() {
-    auto left = logical_or();
+std::optional<std::shared_ptr<Expr>> Parser::infix(BindingPower min_power) {
+    auto left = unary();
     if (!left)
         return std::nullopt;
-    if (match({Tok::Eq})) {
-        auto op = previous();
-        auto right = assignment();
-        if (!right)
-            return std::nullopt;
-        return std::make_shared<Expr::Assign>(*left, op, *right);
-    }
-    else if (
-        match(
-            {Tok::PlusEq,
-             Tok::MinusEq,
-             Tok::StarEq,
-             Tok::SlashEq,
-             Tok::PercentEq}
-        )
-    ) {
-        auto op = previous();
-        auto right = assignment();
-        if (!right)
-            return std::nullopt;
-
-        auto binary_op_token = binary_op_from_compound_op(op);
-        auto binary_expr =
-            std::make_shared<Expr::Binary>(*left, binary_op_token, *right);
-        return std::make_shared<Expr::Assign>(
-            *left,
-            std::make_shared<Token>(Tok::Eq, op->location),
-            binary_expr
-        );
+    while (true) {
+        auto power = binding_power(peek()->tok_type);
+        if (power == BindingPower::None || power < min_power) {
+            break;
+        }
+        auto op = advance();
+        if (power == BindingPower::Cast) {
+            auto anno = annotation();
+            if (!anno)
+                return std::nullopt;
+            left = std::make_shared<Expr::Cast>(*left, op, *anno);
+        }
+        else if (power == BindingPower::Assignment) {
+            // Assignments are right-associative, so the right side may
+            // contain further assignments.
+            auto right = infix(BindingPower::Assignment);
+            if (!right)
+                return std::nullopt;
+            if (op->tok_type == Tok::Eq) {
+                left = std::make_shared<Expr::Assign>(*left, op, *right);
+            }
+            else {
+                auto binary_op_token = binary_op_from_compound_op(op);
+                auto binary_expr = std::make_shared<Expr::Binary>(
+                    *left,
+                    binary_op_token,
+                    *right
+                );
+                left = std::make_shared<Expr::Assign>(
+                    *left,
+                    token_store.add_token(
+                        Token(Tok::Eq, op->location, op->lexeme)
+                    ),
+                    binary_expr
+                );
+            }
+        }
+        else {
+            // All other operators are left-associative, so the right side
+            // only contains operators that bind more tightly.
+            auto right = infix(
+                static_cast<BindingPower>(static_cast<uint8_t>(power) + 1)
+            );
+            if (!right)
+                return std::nullopt;
+            if (power == BindingPower::Or || power == BindingPower::And) {
+                left = std::make_shared<Expr::Logical>(*left, op, *right);
+            }
+            else {
+                left = std::make_shared<Expr::Binary>(*left, op, *right);
+            }
+        }
     }
     return left;
 }
 
 std::optional<std::shared_ptr<Expr>> Parser::expression() {
-    return assignment();
+    return infix(BindingPower::Assignment);
 }
 
 // MARK: Statements
@@ -1273,7 +1330,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::variable_statement() {
 
     // Get identifier
     if (!match({Tok::Identifier})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAnIdentifier,
             previous()->location,
             "Expected identifier in declaration."
@@ -1283,7 +1340,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::variable_statement() {
     auto identifier = previous();
 
     if (match({Tok::ColonColon})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::DeclarationIdentWithColonColon,
             previous()->location,
             "Declaration identifier cannot contain `::`."
@@ -1313,13 +1370,13 @@ std::optional<std::shared_ptr<Stmt>> Parser::variable_statement() {
         if (start_token->tok_type == Tok::KwStatic &&
             !expr.value()->is_constant()) {
 
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NonCompileTimeExpr,
                 previous()->location,
                 "Static variable initializer is not a compile-time "
                 "constant."
             );
-            Diagnostics::inst().emit_note(
+            report_note(
                 "Static variables must be initialized with compile-time "
                 "constant "
                 "expressions."
@@ -1330,7 +1387,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::variable_statement() {
 
     // If expr and annotation are both nullopt, we have an error.
     if (!expr && !anno) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::VariableWithoutTypeOrValue,
             peek()->location,
             "Variable declaration must have a type annotation or value."
@@ -1376,7 +1433,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::field_statement() {
 
     // Get identifier
     if (!match({Tok::Identifier})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAnIdentifier,
             previous()->location,
             "Expected identifier in field declaration."
@@ -1386,7 +1443,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::field_statement() {
     auto identifier = previous();
 
     if (match({Tok::ColonColon})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::DeclarationIdentWithColonColon,
             previous()->location,
             "Declaration identifier cannot contain `::`."
@@ -1404,7 +1461,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::field_statement() {
         }
     }
     else {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::FieldWithoutType,
             peek()->location,
             "Field declaration must have a type annotation."
@@ -1435,7 +1492,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
     auto start_token = previous();
     // Identifier
     if (!match({Tok::Identifier})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAnIdentifier,
             peek()->location,
             "Expected identifier in declaration."
@@ -1445,7 +1502,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
     auto identifier = previous();
 
     if (match({Tok::ColonColon})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::DeclarationIdentWithColonColon,
             previous()->location,
             "Declaration identifier cannot contain `::`."
@@ -1455,7 +1512,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
 
     // Open parenthesis
     if (!match({Tok::LParen})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::FuncWithoutOpeningParen,
             peek()->location,
             "Expected `(` after function name."
@@ -1476,7 +1533,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
         // Variadic parameter?
         if (match({Tok::DotDotDot})) {
             if (peek()->tok_type != Tok::RParen) {
-                Diagnostics::inst().emit_error(
+                report_error(
                     Err::UnexpectedTokenAfterVariadicParam,
                     peek()->location,
                     "Expected closing `)` after variadic parameter."
@@ -1492,7 +1549,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
         bool has_var = match({Tok::KwVar});
         // Parameter name
         if (!match({Tok::Identifier})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NotAnIdentifier,
                 peek()->location,
                 "Expected identifier in function parameter."
@@ -1503,7 +1560,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
         auto param_name = previous();
         // Annotation (always required)
         if (!match({Tok::Colon})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NotAType,
                 peek()->location,
                 "Expected type annotation in function parameter."
@@ -1534,7 +1591,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
 
     // Closing parenthesis
     if (!match({Tok::RParen})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `)` after parsing parameters."
@@ -1561,7 +1618,9 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
             previous(),
             std::vector<std::shared_ptr<Stmt::IExecAllowed>>{std::make_shared<
                 Stmt::Yield>(
-                std::make_shared<Token>(Tok::KwReturn, previous()->location),
+                token_store.add_token(Token(
+                    Tok::KwReturn, previous()->location, previous()->lexeme
+                )),
                 *expression()
             )},
             Expr::Block::Kind::Function,
@@ -1577,15 +1636,15 @@ std::optional<std::shared_ptr<Stmt>> Parser::func_statement() {
             // At this point, an error has already been logged.
             return std::nullopt;
         }
-        body_expr = std::dynamic_pointer_cast<Expr::Block>(*block_expr);
+        body_expr = dyn_cast<Expr::Block>(*block_expr);
     }
     else if (peek()->tok_type == Tok::Colon) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ColonInsteadOfIndent,
             peek()->location,
             "Unexpected `:` after `block` keyword."
         );
-        Diagnostics::inst().emit_note(
+        report_note(
             "Indentation is possibly ignored here. Consider using `{` for "
             "this "
             "block or using indentation for the surrounding scope."
@@ -1613,7 +1672,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::namespace_statement() {
     auto start_token = previous();
     // Identifier
     if (!match({Tok::Identifier})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAnIdentifier,
             peek()->location,
             "Expected identifier in namespace declaration."
@@ -1623,7 +1682,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::namespace_statement() {
     auto identifier = previous();
 
     if (match({Tok::ColonColon})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::DeclarationIdentWithColonColon,
             previous()->location,
             "Declaration identifier cannot contain `::`."
@@ -1640,12 +1699,12 @@ std::optional<std::shared_ptr<Stmt>> Parser::namespace_statement() {
         closing_token_type = Tok::RBrace;
     }
     else if (peek()->tok_type == Tok::Colon) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ColonInsteadOfIndent,
             peek()->location,
             "Unexpected `:` after namespace identifier."
         );
-        Diagnostics::inst().emit_note(
+        report_note(
             "Indentation is possibly ignored here. Consider using `{` for "
             "this "
             "block or using indentation for the surrounding scope."
@@ -1653,7 +1712,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::namespace_statement() {
         return std::nullopt;
     }
     else {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NamespaceWithoutBlock,
             peek()->location,
             "Expected indented block or `{` after namespace declaration."
@@ -1669,23 +1728,22 @@ std::optional<std::shared_ptr<Stmt>> Parser::namespace_statement() {
             synchronize_statements();
             continue;
         }
-        auto decl_allowed_stmt =
-            std::dynamic_pointer_cast<Stmt::IDeclAllowed>(*stmt);
+        auto decl_allowed_stmt = dyn_cast<Stmt::IDeclAllowed>(*stmt);
         if (!decl_allowed_stmt) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NonDeclAllowedStmt,
                 stmt.value()->location,
                 "Namespace does not allow this kind of statement."
             );
-            Diagnostics::inst().emit_note(
+            report_note(
                 "Only declaration-space statements are allowed directly "
                 "inside "
                 "a namespace. Execution-space statements must be in a "
                 "local "
                 "scope or at the top level."
             );
-            if (PTR_INSTANCEOF(stmt.value(), Stmt::Let)) {
-                Diagnostics::inst().emit_note(
+            if (isa<Stmt::Let>(stmt.value())) {
+                report_note(
                     "Variables declared with `let` are execution-space "
                     "statements. Consider using `static` instead of `let`."
                 );
@@ -1714,17 +1772,17 @@ std::optional<std::shared_ptr<Stmt>> Parser::extern_block_statement() {
             abi = ABI::C;
         }
         else {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ExternBlockUnrecognizedABI,
                 previous()->location,
                 "Unknown ABI specified in extern block declaration."
             );
-            Diagnostics::inst().emit_note("Supported ABIs are: \"C\".");
+            report_note("Supported ABIs are: \"C\".");
         }
     }
 
     if (!match({Tok::Identifier})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAnIdentifier,
             peek()->location,
             "Expected identifier after `extern`."
@@ -1732,7 +1790,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::extern_block_statement() {
         return std::nullopt;
     }
     if (match({Tok::ColonColon})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::DeclarationIdentWithColonColon,
             previous()->location,
             "Declaration identifier cannot contain `::`."
@@ -1749,12 +1807,12 @@ std::optional<std::shared_ptr<Stmt>> Parser::extern_block_statement() {
         closing_token_type = Tok::RBrace;
     }
     else if (peek()->tok_type == Tok::Colon) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ColonInsteadOfIndent,
             peek()->location,
             "Unexpected `:` after extern block identifier."
         );
-        Diagnostics::inst().emit_note(
+        report_note(
             "Indentation is possibly ignored here. Consider using `{` for "
             "this "
             "block or using indentation for the surrounding scope."
@@ -1762,7 +1820,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::extern_block_statement() {
         return std::nullopt;
     }
     else {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ExternBlockWithoutBlock,
             peek()->location,
             "Expected indented block or `{` after extern block declaration."
@@ -1780,17 +1838,16 @@ std::optional<std::shared_ptr<Stmt>> Parser::extern_block_statement() {
         }
         auto stmt = stmt_opt.value();
 
-        if (!PTR_INSTANCEOF(stmt, Stmt::Func) &&
-            !PTR_INSTANCEOF(stmt, Stmt::Static)) {
-            Diagnostics::inst().emit_error(
+        if (!isa<Stmt::Func>(stmt) && !isa<Stmt::Static>(stmt)) {
+            report_error(
                 Err::ExternBlockStmtNotVarOrFunc,
                 stmt->location,
                 "Expected function declaration or static variable "
                 "declaration "
                 "in extern block."
             );
-            if (PTR_INSTANCEOF(stmt, Stmt::Let)) {
-                Diagnostics::inst().emit_note(
+            if (isa<Stmt::Let>(stmt)) {
+                report_note(
                     "Variables declared with `let` are execution-space "
                     "statements. Consider using `static` instead of `let`."
                 );
@@ -1798,8 +1855,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::extern_block_statement() {
             continue;
         }
 
-        auto decl_allowed_stmt =
-            std::dynamic_pointer_cast<Stmt::IDeclAllowed>(stmt);
+        auto decl_allowed_stmt = dyn_cast<Stmt::IDeclAllowed>(stmt);
         body_stmts.push_back(decl_allowed_stmt);
     }
 
@@ -1814,7 +1870,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::extern_block_statement() {
 std::optional<std::shared_ptr<Stmt>> Parser::typedef_statement() {
     auto typedef_token = previous();
     if (!match({Tok::Identifier})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAnIdentifier,
             peek()->location,
             "Expected identifier after `typedef`."
@@ -1822,7 +1878,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::typedef_statement() {
         return std::nullopt;
     }
     if (match({Tok::ColonColon})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::DeclarationIdentWithColonColon,
             previous()->location,
             "Declaration identifier cannot contain `::`."
@@ -1831,7 +1887,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::typedef_statement() {
     }
     auto identifier = previous();
     if (!match({Tok::Eq})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `=` after typedef identifier."
@@ -1852,14 +1908,14 @@ std::optional<std::shared_ptr<Stmt>> Parser::typedef_statement() {
 std::optional<std::shared_ptr<Stmt>> Parser::struct_def_statement() {
     auto struct_token = previous();
     if (!match({Tok::Identifier})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::NotAnIdentifier,
             peek()->location,
             "Expected identifier after `struct`."
         );
     }
     if (match({Tok::ColonColon})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::DeclarationIdentWithColonColon,
             previous()->location,
             "Declaration identifier cannot contain `::`."
@@ -1876,12 +1932,12 @@ std::optional<std::shared_ptr<Stmt>> Parser::struct_def_statement() {
         closing_token_type = Tok::RBrace;
     }
     else if (peek()->tok_type == Tok::Colon) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::ColonInsteadOfIndent,
             peek()->location,
             "Unexpected `:` after struct identifier."
         );
-        Diagnostics::inst().emit_note(
+        report_note(
             "Indentation is possibly ignored here. Consider using `{` for "
             "this "
             "block or using indentation for the surrounding scope."
@@ -1889,7 +1945,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::struct_def_statement() {
         return std::nullopt;
     }
     else {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::StructWithoutBlock,
             peek()->location,
             "Expected indented block or `{` after struct declaration."
@@ -1907,18 +1963,18 @@ std::optional<std::shared_ptr<Stmt>> Parser::struct_def_statement() {
         }
         auto stmt = stmt_opt.value();
 
-        if (!PTR_INSTANCEOF(stmt, Stmt::IStructAllowed)) {
-            Diagnostics::inst().emit_error(
+        if (!isa<Stmt::IStructAllowed>(stmt)) {
+            report_error(
                 Err::NonStructAllowedStmt,
                 stmt->location,
                 "Struct does not allow this kind of statement."
             );
-            Diagnostics::inst().emit_note(
+            report_note(
                 "Only struct member declarations and declaration-space "
                 "statements are allowed in struct definitions."
             );
-            if (PTR_INSTANCEOF(stmt, Stmt::Let)) {
-                Diagnostics::inst().emit_note(
+            if (isa<Stmt::Let>(stmt)) {
+                report_note(
                     "Variables declared with `let` are execution-space "
                     "statements. Consider using `static` instead of `let`."
                 );
@@ -1926,8 +1982,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::struct_def_statement() {
             continue;
         }
 
-        auto struct_allowed_stmt =
-            std::dynamic_pointer_cast<Stmt::IStructAllowed>(stmt);
+        auto struct_allowed_stmt = dyn_cast<Stmt::IStructAllowed>(stmt);
         body_stmts.push_back(struct_allowed_stmt);
     }
 
@@ -2001,7 +2056,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::statement() {
             modifiers = modifier_list();
         }
         else {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnexpectedTokenAfterHash,
                 previous()->location,
                 "Expected directive or modifier list after `#`."
@@ -2010,7 +2065,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::statement() {
         }
 
         if (match({Tok::Semicolon})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ModifierWithoutStatement,
                 previous()->location,
                 "Modifiers must be attached to a statement."
@@ -2042,7 +2097,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::statement() {
     }
     else if (match({Tok::Eof})) {
         if (modifiers.has_value()) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::ModifierWithoutStatement,
                 peek()->location,
                 "Modifiers must be attached to a statement."
@@ -2073,7 +2128,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::statement() {
         for (const auto& modifier : *modifiers) {
             bool result = stmt.value()->apply_modifier(modifier);
             if (!result) {
-                Diagnostics::inst().emit_error(
+                report_error(
                     Err::InvalidModifierForStatement,
                     modifier.location,
                     "This modifier cannot be applied to this statement."
@@ -2090,7 +2145,7 @@ std::optional<std::shared_ptr<Stmt>> Parser::statement() {
 std::optional<std::shared_ptr<Annotation>> Parser::type_of_annotation() {
     auto typeof_token = previous();
     if (!match({Tok::LParen})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::TypeofWithoutOpeningParen,
             peek()->location,
             "Expected `(` after `typeof`."
@@ -2099,7 +2154,7 @@ std::optional<std::shared_ptr<Annotation>> Parser::type_of_annotation() {
     }
     auto expr = expression();
     if (!match({Tok::RParen})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `)` after expression in "
@@ -2142,7 +2197,7 @@ std::optional<std::shared_ptr<Annotation::Tuple>> Parser::tuple_annotation() {
     } while (match({Tok::Comma}));
 
     if (!match({Tok::RParen})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `)` after expression in "
@@ -2167,7 +2222,7 @@ std::optional<std::shared_ptr<Annotation::Array>> Parser::array_annotation() {
     if (!element_anno)
         return std::nullopt;
     if (!match({Tok::Semicolon})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `;` after element type in array annotation."
@@ -2184,7 +2239,7 @@ std::optional<std::shared_ptr<Annotation::Array>> Parser::array_annotation() {
             return std::nullopt;
     }
     if (!match({Tok::RSquare})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `]` after size in array annotation."
@@ -2216,7 +2271,7 @@ std::optional<std::shared_ptr<Annotation::Object>> Parser::object_annotation() {
         }
 
         if (!match({Tok::Identifier})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::NotAnIdentifier,
                 peek()->location,
                 "Expected identifier in object annotation field."
@@ -2226,7 +2281,7 @@ std::optional<std::shared_ptr<Annotation::Object>> Parser::object_annotation() {
         }
         auto field_name_token = previous();
         if (!match({Tok::Colon})) {
-            Diagnostics::inst().emit_error(
+            report_error(
                 Err::UnexpectedToken,
                 peek()->location,
                 "Expected `:` after field name in object annotation."
@@ -2251,7 +2306,7 @@ std::optional<std::shared_ptr<Annotation::Object>> Parser::object_annotation() {
     } while (match({Tok::Comma}));
 
     if (!match({Tok::RBrace})) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedToken,
             peek()->location,
             "Expected `}` after field in object annotation."
@@ -2297,7 +2352,7 @@ std::optional<std::shared_ptr<Annotation>> Parser::annotation() {
     }
 
     if (has_var) {
-        Diagnostics::inst().emit_error(
+        report_error(
             Err::UnexpectedVarInAnnotation,
             previous()->location,
             "`var` is not allowed here. Use only with pointers or "
@@ -2328,28 +2383,56 @@ std::optional<std::shared_ptr<Annotation>> Parser::annotation() {
     if (match({Tok::LBrace})) {
         return object_annotation();
     }
-    Diagnostics::inst()
-        .emit_error(Err::NotAType, peek()->location, "Not a valid type.");
+    report_error(Err::NotAType, peek()->location, "Not a valid type.");
     return std::nullopt;
 }
 
 // MARK: Interface
 
-void Parser::run_parse(std::unique_ptr<FrontendContext>& context) {
+std::optional<std::shared_ptr<Stmt>> Parser::top_level_statement() {
+    auto stmt = statement();
+    if (!stmt.has_value()) {
+        synchronize_statements();
+        return std::nullopt;
+    }
+    else if (!isa<Stmt::ITopLevel>(stmt.value())) {
+        report_error(
+            Err::NonTopLevelAllowedStmt,
+            stmt.value()->location,
+            "Top level does not allow this kind of statement."
+        );
+        return std::nullopt;
+    }
+    return stmt;
+}
+
+void Parser::run_parse(
+    std::unique_ptr<FrontendContext>& context, std::vector<ParsedChunk> chunks
+) {
     size_t start_size = context->stmts.size();
+    size_t next_chunk = 0;
 
     while (!is_at_end()) {
-        auto stmt = statement();
-        if (!stmt.has_value()) {
-            synchronize_statements();
+        // Skip chunks that a statement before them continued into.
+        while (next_chunk < chunks.size() &&
+               chunks[next_chunk].start < current) {
+            next_chunk++;
+        }
+        if (next_chunk < chunks.size() &&
+            chunks[next_chunk].start == current &&
+            !chunks[next_chunk].found_error) {
+            auto& chunk = chunks[next_chunk++];
+            context->stmts.insert(
+                context->stmts.end(),
+                std::make_move_iterator(chunk.stmts.begin()),
+                std::make_move_iterator(chunk.stmts.end())
+            );
+            current = chunk.end;
             continue;
         }
-        else if (!PTR_INSTANCEOF(stmt.value(), Stmt::ITopLevel)) {
-            Diagnostics::inst().emit_error(
-                Err::NonTopLevelAllowedStmt,
-                stmt.value()->location,
-                "Top level does not allow this kind of statement."
-            );
+
+        auto stmt = top_level_statement();
+        if (!stmt.has_value()) {
             continue;
         }
         else if (repl_mode && incomplete_statement) {
@@ -2381,9 +2464,134 @@ void Parser::parse(std::unique_ptr<FrontendContext>& context, bool repl_mode) {
         panic("Parser::parse: Context is already in an error state.");
     }
 
-    Parser parser(std::move(context->scanned_tokens), repl_mode);
+    auto& tokens =
+        context->token_store.add_tokens(std::move(context->scanned_tokens));
     context->scanned_tokens = {};
+    Parser parser(tokens, context->token_store, repl_mode);
     parser.run_parse(context);
 }
 
+/**
+ * @brief Finds token indices to split the tokens at for parsing in parallel.
+ *
+ * A split point is a statement-starting keyword outside of any blocks or
+ * grouping tokens, tracked the same way as in `synchronize_statements`, that
+ * does not follow a modifier list. The split points are at least `chunk_size`
+ * tokens apart.
+ *
+ * A split point is only where a top-level statement is expected to start.
+ * If the statement before it continues past it, the chunk parsers detect this.
+ *
+ * @param tokens The tokens to split.
+ * @param chunk_size The minimum number of tokens between split points.
+ * @return The split points, in order. Does not include the first token.
+ */
+static std::vector<unsigned>
+find_split_points(const std::vector<Token>& tokens, size_t chunk_size) {
+    std::vector<unsigned> points;
+    size_t next_split = chunk_size;
+    size_t nesting_level = 0;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        Tok type = tokens[i].tok_type;
+        if (type == Tok::LParen || type == Tok::LSquare ||
+            type == Tok::LBrace || type == Tok::Indent) {
+            nesting_level++;
+        }
+        else if (
+            type == Tok::RParen || type == Tok::RSquare ||
+            type == Tok::RBrace || type == Tok::Dedent
+        ) {
+            if (nesting_level > 0) {
+                nesting_level--;
+            }
+        }
+        else if (
+            nesting_level == 0 && i >= next_split &&
+            tokens::is_stmt_starting_keyword(type) &&
+            tokens[i - 1].tok_type != Tok::RSquare
+        ) {
+            points.push_back(static_cast<unsigned>(i));
+            next_split = i + chunk_size;
+        }
+    }
+    return points;
+}
+
+void Parser::parse_parallel(
+    std::unique_ptr<FrontendContext>& context, unsigned num_threads
+) {
+    if (IS_VARIANT(context->status, Status::Error)) {
+        panic("Parser::parse_parallel: Context is already in an error state.");
+    }
+
+    auto& tokens =
+        context->token_store.add_tokens(std::move(context->scanned_tokens));
+    context->scanned_tokens = {};
+    Parser parser(tokens, context->token_store);
+
+    // Chunks smaller than this are not worth handing to another thread. There
+    // are a few chunks per thread so that threads that finish early can take
+    // more.
+    constexpr size_t min_chunk_size = 16 * 1024;
+    std::vector<unsigned> points;
+    if (num_threads > 1 && tokens.size() >= 2 * min_chunk_size) {
+        size_t chunk_size =
+            std::max(min_chunk_size, tokens.size() / (num_threads * 4));
+        points = find_split_points(tokens, chunk_size);
+    }
+    if (points.empty()) {
+        parser.run_parse(context);
+        return;
+    }
+
+    points.insert(points.begin(), 0);
+    size_t num_chunks = points.size();
+
+    // Each chunk has its own token store, since stores are not thread-safe.
+    std::vector<std::unique_ptr<Parser>> chunk_parsers;
+    for (size_t i = 0; i < num_chunks; i++) {
+        auto chunk_parser = std::unique_ptr<Parser>(
+            new Parser(tokens, context->token_store.add_nested_store())
+        );
+        chunk_parser->current = points[i];
+        chunk_parser->speculative = true;
+        chunk_parsers.push_back(std::move(chunk_parser));
+    }
+    std::vector<ParsedChunk> chunks(num_chunks);
+
+    // Threads take chunks in order from a shared counter. The calling thread
+    // is one of the threads.
+    std::atomic<size_t> next_chunk = 0;
+    auto parse_chunks = [&]() {
+        size_t i;
+        while ((i = next_chunk.fetch_add(1)) < num_chunks) {
+            Parser& chunk_parser = *chunk_parsers[i];
+            ParsedChunk& chunk = chunks[i];
+            size_t end = i + 1 < num_chunks ? points[i + 1] : tokens.size();
+            chunk.start = points[i];
+            while (chunk_parser.current < end && !chunk_parser.found_error) {
+                auto stmt = chunk_parser.top_level_statement();
+                if (stmt.has_value()) {
+                    chunk.stmts.push_back(*stmt);
+                }
+            }
+            chunk.end = chunk_parser.current;
+            chunk.found_error = chunk_parser.found_error;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min<size_t>(num_threads, num_chunks); i++) {
+        threads.emplace_back(parse_chunks);
+    }
+    parse_chunks();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // The parser's state depends only on its position in the tokens, so a
+    // chunk's statements are exactly what a serial parse reaching its start
+    // would produce. The rest is parsed serially.
+    parser.run_parse(context, std::move(chunks));
+}
+
 } // namespace nico
@@ -5,39 +5,77 @@
 #include "nico/frontend/components/lexer.h"
 #include "nico/frontend/components/local_checker.h"
 #include "nico/frontend/components/parser.h"
+#include "nico/shared/phase_timer.h"
 #include "nico/shared/status.h"
 
 namespace nico {
 
 std::unique_ptr<FrontendContext>&
 Frontend::compile(const std::shared_ptr<CodeFile>& file, bool repl_mode) {
-    context->mod_ctx.initialize();
+    // A context that has not compiled anything yet, e.g. one prepared before a
+    // compile server forks, keeps its module rather than creating another
+    // LLVM context and target machine.
+    if (!context->stmts.empty() || !context->mod_ctx.is_fresh()) {
+        context->mod_ctx.initialize("main", context->target_spec);
+    }
+
+    // Free earlier REPL input that did not compile. An incomplete input that
+    // left a lexer checkpoint is kept, since the checkpoint's string literals
+    // are in the store.
+    if (repl_mode && !context->lexer_checkpoint.has_value()) {
+        context->release_uncommitted_tokens();
+    }
 
-    Lexer::scan(context, file, repl_mode);
+    {
+        auto phase = PhaseTimer::inst().scope("Lexer");
+        if (num_lexer_threads > 1 && !repl_mode) {
+            Lexer::scan_parallel(context, file, num_lexer_threads);
+        }
+        else {
+            Lexer::scan(context, file, repl_mode);
+        }
+    }
     if (!IS_VARIANT(context->status, Status::Ok))
         return context;
 
-    Parser::parse(context, repl_mode);
+    {
+        auto phase = PhaseTimer::inst().scope("Parser");
+        if (num_parser_threads > 1 && !repl_mode) {
+            Parser::parse_parallel(context, num_parser_threads);
+        }
+        else {
+            Parser::parse(context, repl_mode);
+        }
+    }
     if (!IS_VARIANT(context->status, Status::Ok))
         return context;
 
-    GlobalChecker::check(context, repl_mode);
+    {
+        auto phase = PhaseTimer::inst().scope("GlobalChecker");
+        GlobalChecker::check(context, repl_mode);
+    }
     if (!IS_VARIANT(context->status, Status::Ok))
         return context;
 
-    LocalChecker::check(context, repl_mode);
+    {
+        auto phase = PhaseTimer::inst().scope("LocalChecker");
+        LocalChecker::check(context, repl_mode);
+    }
     if (!IS_VARIANT(context->status, Status::Ok))
         return context;
 
-    if (repl_mode) {
-        CodeGenerator::generate_repl_ir(context, ir_printing_enabled);
-    }
-    else {
-        CodeGenerator::generate_exe_ir(
-            context,
-            ir_printing_enabled,
-            panic_recoverable
-        );
+    {
+        auto phase = PhaseTimer::inst().scope("CodeGenerator");
+        if (repl_mode) {
+            CodeGenerator::generate_repl_ir(context, ir_printing_enabled);
+        }
+        else {
+            CodeGenerator::generate_exe_ir(
+                context,
+                ir_printing_enabled,
+                panic_recoverable
+            );
+        }
     }
 
     context->commit();
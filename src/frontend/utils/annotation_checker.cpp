@@ -4,11 +4,12 @@
 
 namespace nico {
 
-std::any AnnotationChecker::visit(Annotation::NameRef* annotation) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::NameRef* annotation) {
     std::shared_ptr<Type> type = nullptr;
     if (symbol_tree->try_resolve_name(annotation->name)) {
         auto node = annotation->name->node.lock();
-        if (auto type_node = std::dynamic_pointer_cast<Node::ITypeNode>(node)) {
+        if (auto type_node = dyn_cast<Node::ITypeNode>(node)) {
             type = type_node->type;
             return type;
         }
@@ -19,7 +20,7 @@ std::any AnnotationChecker::visit(Annotation::NameRef* annotation) {
                 "` does not "
                 "refer to a type."
         );
-        return std::any();
+        return std::nullopt;
     }
     else if (allow_unresolved_named_types) {
         auto node = symbol_tree->add_unresolved_type(annotation->name);
@@ -31,14 +32,15 @@ std::any AnnotationChecker::visit(Annotation::NameRef* annotation) {
         annotation->name->identifier->location,
         "Could not resolve name `" + annotation->name->to_string() + "`."
     );
-    return std::any();
+    return std::nullopt;
 }
 
-std::any AnnotationChecker::visit(Annotation::Pointer* annotation) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::Pointer* annotation) {
     std::shared_ptr<Type> type = nullptr;
     auto base_opt = annotation_check(annotation->base);
     if (!base_opt.has_value())
-        return std::any();
+        return std::nullopt;
     type = std::make_shared<Type::RawTypedPtr>(
         base_opt.value(),
         annotation->is_mutable
@@ -46,21 +48,24 @@ std::any AnnotationChecker::visit(Annotation::Pointer* annotation) {
     return type;
 }
 
-std::any AnnotationChecker::visit(Annotation::Nullptr* /*annotation*/) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::Nullptr* /*annotation*/) {
     std::shared_ptr<Type> type = std::make_shared<Type::Nullptr>();
     return type;
 }
 
-std::any AnnotationChecker::visit(Annotation::Void* /*annotation*/) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::Void* /*annotation*/) {
     std::shared_ptr<Type> type = std::make_shared<Type::Void>();
     return type;
 }
 
-std::any AnnotationChecker::visit(Annotation::Reference* annotation) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::Reference* annotation) {
     std::shared_ptr<Type> type = nullptr;
     auto base_opt = annotation_check(annotation->base);
     if (!base_opt.has_value())
-        return std::any();
+        return std::nullopt;
     type = std::make_shared<Type::Reference>(
         base_opt.value(),
         annotation->is_mutable
@@ -68,7 +73,8 @@ std::any AnnotationChecker::visit(Annotation::Reference* annotation) {
     return type;
 }
 
-std::any AnnotationChecker::visit(Annotation::Array* annotation) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::Array* annotation) {
     std::shared_ptr<Type> type = nullptr;
     if (!annotation->base.has_value()) {
         type = std::make_shared<Type::EmptyArray>();
@@ -76,7 +82,7 @@ std::any AnnotationChecker::visit(Annotation::Array* annotation) {
     }
     auto base_opt = annotation_check(annotation->base.value());
     if (!base_opt.has_value())
-        return std::any();
+        return std::nullopt;
     if (annotation->size.has_value()) {
         type = std::make_shared<Type::Array>(
             base_opt.value(),
@@ -89,7 +95,8 @@ std::any AnnotationChecker::visit(Annotation::Array* annotation) {
     return type;
 }
 
-std::any AnnotationChecker::visit(Annotation::Object* annotation) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::Object* annotation) {
     std::shared_ptr<Type> type = nullptr;
 
     Dictionary<std::string, Binding> fields_dict;
@@ -114,7 +121,7 @@ std::any AnnotationChecker::visit(Annotation::Object* annotation) {
 
         auto field_type_opt = annotation_check(field.annotation);
         if (!field_type_opt.has_value())
-            return std::any();
+            return std::nullopt;
 
         fields_dict.insert(
             field_name,
@@ -128,19 +135,20 @@ std::any AnnotationChecker::visit(Annotation::Object* annotation) {
     }
 
     if (has_error)
-        return std::any();
+        return std::nullopt;
 
     type = std::make_shared<Type::Object>(std::move(fields_dict));
     return type;
 }
 
-std::any AnnotationChecker::visit(Annotation::Tuple* annotation) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::Tuple* annotation) {
     std::shared_ptr<Type> type = nullptr;
     std::vector<std::shared_ptr<Type>> element_types;
     for (const auto& element : annotation->elements) {
         auto elem_opt = annotation_check(element);
         if (!elem_opt.has_value())
-            return std::any();
+            return std::nullopt;
         element_types.push_back(elem_opt.value());
     }
     if (element_types.empty()) {
@@ -153,21 +161,22 @@ std::any AnnotationChecker::visit(Annotation::Tuple* annotation) {
     return type;
 }
 
-std::any AnnotationChecker::visit(Annotation::TypeOf* annotation) {
+std::optional<std::shared_ptr<Type>>
+AnnotationChecker::visit(Annotation::TypeOf* annotation) {
     if (expr_checker.expired()) {
         Diagnostics::inst().emit_error(
             Err::UncheckableTypeofAnnotation,
             annotation->location,
             "Cannot use `typeof` annotation in declaration space."
         );
-        return std::any();
+        return std::nullopt;
     }
     annotation->expression->accept(expr_checker.lock().get(), false);
     if (!annotation->expression->type) {
         panic(
             "Annotation::TypeOf::visit: expression has no type after checking."
         );
-        return std::any();
+        return std::nullopt;
     }
     return annotation->expression->type;
 }
@@ -186,10 +195,7 @@ std::shared_ptr<AnnotationChecker> AnnotationChecker::create(
 
 std::optional<std::shared_ptr<Type>>
 AnnotationChecker::annotation_check(std::shared_ptr<Annotation> annotation) {
-    auto type_any = annotation->accept(this);
-    if (!type_any.has_value())
-        return std::nullopt;
-    return std::any_cast<std::shared_ptr<Type>>(type_any);
+    return annotation->accept(this);
 }
 
 } // namespace nico
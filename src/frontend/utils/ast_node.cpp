@@ -30,7 +30,7 @@ bool Stmt::IBindingDecl::apply_modifier(const Modifier& modifier) {
         }
 
         auto linkage_arg =
-            std::any_cast<std::string>(modifier.args.at(0)->literal);
+            modifier.args.at(0)->literal.get<std::string>();
 
         if (linkage_arg == "internal") {
             linkage_opt = Linkage::Internal;
@@ -72,7 +72,7 @@ bool Stmt::IBindingDecl::apply_modifier(const Modifier& modifier) {
         }
 
         custom_symbol_opt =
-            std::any_cast<std::string>(modifier.args.at(0)->literal);
+            modifier.args.at(0)->literal.get<std::string>();
         return true;
     }
 
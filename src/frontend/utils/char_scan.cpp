@@ -0,0 +1,304 @@
+#include "nico/frontend/utils/char_scan.h"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define NICO_CHAR_SCAN_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__)
+// AVX2 code is compiled with a target attribute and only run if the host
+// supports it, so the rest of the program does not require AVX2.
+#define NICO_CHAR_SCAN_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace nico::char_scan {
+
+// Scalar implementations. These are also used for the tails of the vectorized
+// implementations.
+
+static bool is_identifier_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+}
+
+static size_t skip_identifier_scalar(std::string_view src, size_t pos) {
+    while (pos < src.size() && is_identifier_char(src[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+static size_t skip_run_scalar(std::string_view src, size_t pos, char c) {
+    while (pos < src.size() && src[pos] == c) {
+        pos++;
+    }
+    return pos;
+}
+
+static size_t
+find_first_of_scalar(std::string_view src, size_t pos, char a, char b, char c) {
+    while (pos < src.size() && src[pos] != a && src[pos] != b &&
+           src[pos] != c) {
+        pos++;
+    }
+    return pos;
+}
+
+#ifdef NICO_CHAR_SCAN_SSE2
+
+// SSE2 implementations. Each loads 16 characters at a time and computes a
+// bit mask of the characters to stop at. Comparisons are signed, so bytes of
+// 0x80 and above never fall in the ASCII ranges checked for.
+
+static __m128i sse2_in_range(__m128i chars, char lo, char hi) {
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(chars, _mm_set1_epi8(static_cast<char>(lo - 1))),
+        _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), chars)
+    );
+}
+
+static size_t skip_identifier_sse2(std::string_view src, size_t pos) {
+    const char* data = src.data();
+    while (pos + 16 <= src.size()) {
+        __m128i chars =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        // Setting bit 5 maps uppercase letters to lowercase.
+        __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+        __m128i ident = _mm_or_si128(
+            _mm_or_si128(
+                sse2_in_range(lower, 'a', 'z'),
+                sse2_in_range(chars, '0', '9')
+            ),
+            _mm_cmpeq_epi8(chars, _mm_set1_epi8('_'))
+        );
+        uint32_t stop =
+            ~static_cast<uint32_t>(_mm_movemask_epi8(ident)) & 0xFFFF;
+        if (stop) {
+            return pos + std::countr_zero(stop);
+        }
+        pos += 16;
+    }
+    return skip_identifier_scalar(src, pos);
+}
+
+static size_t skip_run_sse2(std::string_view src, size_t pos, char c) {
+    const char* data = src.data();
+    __m128i target = _mm_set1_epi8(c);
+    while (pos + 16 <= src.size()) {
+        __m128i chars =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        uint32_t stop =
+            ~static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chars, target))
+            ) &
+            0xFFFF;
+        if (stop) {
+            return pos + std::countr_zero(stop);
+        }
+        pos += 16;
+    }
+    return skip_run_scalar(src, pos, c);
+}
+
+static size_t
+find_first_of_sse2(std::string_view src, size_t pos, char a, char b, char c) {
+    const char* data = src.data();
+    __m128i target_a = _mm_set1_epi8(a);
+    __m128i target_b = _mm_set1_epi8(b);
+    __m128i target_c = _mm_set1_epi8(c);
+    while (pos + 16 <= src.size()) {
+        __m128i chars =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i found = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi8(chars, target_a),
+                _mm_cmpeq_epi8(chars, target_b)
+            ),
+            _mm_cmpeq_epi8(chars, target_c)
+        );
+        uint32_t stop = static_cast<uint32_t>(_mm_movemask_epi8(found));
+        if (stop) {
+            return pos + std::countr_zero(stop);
+        }
+        pos += 16;
+    }
+    return find_first_of_scalar(src, pos, a, b, c);
+}
+
+#endif // NICO_CHAR_SCAN_SSE2
+
+#ifdef NICO_CHAR_SCAN_AVX2
+
+// AVX2 implementations. These mirror the SSE2 implementations, 32 characters
+// at a time, and finish with the SSE2 implementations.
+
+#define NICO_AVX2 __attribute__((target("avx2")))
+
+NICO_AVX2 static __m256i avx2_in_range(__m256i chars, char lo, char hi) {
+    return _mm256_and_si256(
+        _mm256_cmpgt_epi8(chars, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), chars)
+    );
+}
+
+NICO_AVX2 static size_t
+skip_identifier_avx2(std::string_view src, size_t pos) {
+    const char* data = src.data();
+    while (pos + 32 <= src.size()) {
+        __m256i chars =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+        __m256i ident = _mm256_or_si256(
+            _mm256_or_si256(
+                avx2_in_range(lower, 'a', 'z'),
+                avx2_in_range(chars, '0', '9')
+            ),
+            _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_'))
+        );
+        uint32_t stop = ~static_cast<uint32_t>(_mm256_movemask_epi8(ident));
+        if (stop) {
+            return pos + std::countr_zero(stop);
+        }
+        pos += 32;
+    }
+    return skip_identifier_sse2(src, pos);
+}
+
+NICO_AVX2 static size_t
+skip_run_avx2(std::string_view src, size_t pos, char c) {
+    const char* data = src.data();
+    __m256i target = _mm256_set1_epi8(c);
+    while (pos + 32 <= src.size()) {
+        __m256i chars =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        uint32_t stop = ~static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, target))
+        );
+        if (stop) {
+            return pos + std::countr_zero(stop);
+        }
+        pos += 32;
+    }
+    return skip_run_sse2(src, pos, c);
+}
+
+NICO_AVX2 static size_t
+find_first_of_avx2(std::string_view src, size_t pos, char a, char b, char c) {
+    const char* data = src.data();
+    __m256i target_a = _mm256_set1_epi8(a);
+    __m256i target_b = _mm256_set1_epi8(b);
+    __m256i target_c = _mm256_set1_epi8(c);
+    while (pos + 32 <= src.size()) {
+        __m256i chars =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i found = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(chars, target_a),
+                _mm256_cmpeq_epi8(chars, target_b)
+            ),
+            _mm256_cmpeq_epi8(chars, target_c)
+        );
+        uint32_t stop = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+        if (stop) {
+            return pos + std::countr_zero(stop);
+        }
+        pos += 32;
+    }
+    return find_first_of_sse2(src, pos, a, b, c);
+}
+
+#undef NICO_AVX2
+
+#endif // NICO_CHAR_SCAN_AVX2
+
+Isa best_supported_isa() {
+#if defined(NICO_CHAR_SCAN_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::AVX2;
+    }
+    return Isa::SSE2;
+#elif defined(NICO_CHAR_SCAN_SSE2)
+    return Isa::SSE2;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+// The instruction set in use. Read on every call, so it is atomic in case it
+// is changed while another thread is scanning.
+static std::atomic<Isa> current_isa{best_supported_isa()};
+
+Isa get_isa() {
+    return current_isa.load(std::memory_order_relaxed);
+}
+
+Isa set_isa(Isa isa) {
+    Isa best = best_supported_isa();
+    if (static_cast<int>(isa) > static_cast<int>(best)) {
+        isa = best;
+    }
+    current_isa.store(isa, std::memory_order_relaxed);
+    return isa;
+}
+
+size_t skip_identifier(std::string_view src, size_t pos) {
+    switch (get_isa()) {
+#ifdef NICO_CHAR_SCAN_AVX2
+    case Isa::AVX2:
+        return skip_identifier_avx2(src, pos);
+#endif
+#ifdef NICO_CHAR_SCAN_SSE2
+    case Isa::SSE2:
+        return skip_identifier_sse2(src, pos);
+#endif
+    default:
+        return skip_identifier_scalar(src, pos);
+    }
+}
+
+size_t skip_run(std::string_view src, size_t pos, char c) {
+    switch (get_isa()) {
+#ifdef NICO_CHAR_SCAN_AVX2
+    case Isa::AVX2:
+        return skip_run_avx2(src, pos, c);
+#endif
+#ifdef NICO_CHAR_SCAN_SSE2
+    case Isa::SSE2:
+        return skip_run_sse2(src, pos, c);
+#endif
+    default:
+        return skip_run_scalar(src, pos, c);
+    }
+}
+
+size_t find_char(std::string_view src, size_t pos, char c) {
+    if (pos >= src.size()) {
+        return src.size();
+    }
+    // memchr is already vectorized by the C library.
+    const void* found = std::memchr(src.data() + pos, c, src.size() - pos);
+    return found ? static_cast<const char*>(found) - src.data() : src.size();
+}
+
+size_t find_first_of(std::string_view src, size_t pos, char a, char b, char c) {
+    switch (get_isa()) {
+#ifdef NICO_CHAR_SCAN_AVX2
+    case Isa::AVX2:
+        return find_first_of_avx2(src, pos, a, b, c);
+#endif
+#ifdef NICO_CHAR_SCAN_SSE2
+    case Isa::SSE2:
+        return find_first_of_sse2(src, pos, a, b, c);
+#endif
+    default:
+        return find_first_of_scalar(src, pos, a, b, c);
+    }
+}
+
+} // namespace nico::char_scan
@@ -43,7 +43,7 @@ ExpressionChecker::implicit_full_dereference(std::shared_ptr<Expr>& expr) {
             }
         }
         expr = std::make_shared<Expr::Deref>(
-            std::make_shared<Token>(Tok::Star, *expr->location),
+            token_store->add_token(Token(Tok::Star, *expr->location)),
             expr
         );
         i++;
@@ -69,7 +69,7 @@ ExpressionChecker::implicit_full_dereference(std::shared_ptr<Expr>& expr) {
 bool ExpressionChecker::check_pointer_cast(
     std::shared_ptr<Type::IPointer> expr_type,
     std::shared_ptr<Type::IPointer> target_type,
-    std::shared_ptr<Token> as_token
+    const Token* as_token
 ) {
     // Beyond this point, both types must be raw pointer types.
     auto expr_raw_ptr_type =
@@ -297,7 +297,7 @@ ExpressionChecker::try_match_args_to_params(
     return arg_mapping;
 }
 
-std::any ExpressionChecker::visit(Expr::Assign* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Assign* expr, bool as_lvalue) {
     // An assignment expression should never be an lvalue.
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
@@ -308,9 +308,9 @@ std::any ExpressionChecker::visit(Expr::Assign* expr, bool as_lvalue) {
     }
 
     auto l_type_opt = expr_check(expr->left, true);
-    auto l_lvalue = std::dynamic_pointer_cast<Expr::IPLValue>(expr->left);
+    auto l_lvalue = dyn_cast<Expr::IPLValue>(expr->left);
     if (!l_type_opt.has_value() || !l_lvalue)
-        return std::any();
+        return;
 
     auto l_type = l_type_opt.value();
 
@@ -327,12 +327,12 @@ std::any ExpressionChecker::visit(Expr::Assign* expr, bool as_lvalue) {
                 "This is not mutable."
             );
         }
-        return std::any();
+        return;
     }
 
     auto r_type_opt = expr_check(expr->right, false);
     if (!r_type_opt.has_value())
-        return std::any();
+        return;
 
     auto r_type = r_type_opt.value();
 
@@ -345,21 +345,20 @@ std::any ExpressionChecker::visit(Expr::Assign* expr, bool as_lvalue) {
             std::string("Type `") + r_type->to_string() +
                 "` is not compatible with type `" + l_type->to_string() + "`."
         );
-        return std::any();
+        return;
     }
 
     expr->type = l_type;
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Logical* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Logical* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->op->location,
             "Logical expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
 
     bool has_error = false;
@@ -389,20 +388,19 @@ std::any ExpressionChecker::visit(Expr::Logical* expr, bool as_lvalue) {
     }
 
     if (has_error)
-        return std::any();
+        return;
 
     expr->type = expr->left->type; // The result type is `Bool`.
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Binary* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Binary* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->op->location,
             "Binary expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
 
     bool has_error = false;
@@ -416,7 +414,7 @@ std::any ExpressionChecker::visit(Expr::Binary* expr, bool as_lvalue) {
         has_error = true;
 
     if (has_error)
-        return std::any();
+        return;
 
     auto l_type = l_type_opt.value();
     auto r_type = r_type_opt.value();
@@ -565,10 +563,9 @@ std::any ExpressionChecker::visit(Expr::Binary* expr, bool as_lvalue) {
     else {
         expr->type = l_type; // The result type is the same as the left operand.
     }
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Unary* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Unary* expr, bool as_lvalue) {
     // An unary expression should never be an lvalue.
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
@@ -576,12 +573,12 @@ std::any ExpressionChecker::visit(Expr::Unary* expr, bool as_lvalue) {
             expr->op->location,
             "Unary expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
 
     auto r_type_opt = expr_check(expr->right, false);
     if (!r_type_opt.has_value())
-        return std::any();
+        return;
     auto r_type = r_type_opt.value();
 
     switch (expr->op->tok_type) {
@@ -593,7 +590,7 @@ std::any ExpressionChecker::visit(Expr::Unary* expr, bool as_lvalue) {
                 expr->op->location,
                 "Operand must be of a numeric type."
             );
-            return std::any();
+            return;
         }
         // Type cannot be an unsigned integer.
         if (auto int_type = Type::as_a<Type::Int>(r_type).value_or(nullptr)) {
@@ -603,11 +600,11 @@ std::any ExpressionChecker::visit(Expr::Unary* expr, bool as_lvalue) {
                     expr->op->location,
                     "Cannot use unary '-' on unsigned integer type."
                 );
-                return std::any();
+                return;
             }
         }
         expr->type = r_type;
-        return std::any();
+        return;
     case Tok::KwNot:
     case Tok::Bang:
         if (!Type::is_a<Type::Bool>(r_type)) {
@@ -616,34 +613,34 @@ std::any ExpressionChecker::visit(Expr::Unary* expr, bool as_lvalue) {
                 expr->op->location,
                 "Operand must be of type `bool`."
             );
-            return std::any();
+            return;
         }
         expr->type = r_type; // The result type is `Bool`.
-        return std::any();
+        return;
     default:
         panic(
             "ExpressionChecker::visit(Expr::Unary*): Could not handle case for "
             "operator of token type " +
             std::to_string(static_cast<int>(expr->op->tok_type))
         );
-        return std::any();
+        return;
     }
 }
 
-std::any ExpressionChecker::visit(Expr::Address* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Address* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->op->location,
             "Address-of expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
 
     auto r_type_opt = expr_check(expr->right, true);
-    auto r_lvalue = std::dynamic_pointer_cast<Expr::IPLValue>(expr->right);
+    auto r_lvalue = dyn_cast<Expr::IPLValue>(expr->right);
     if (!r_type_opt.has_value() || !r_lvalue)
-        return std::any();
+        return;
 
     auto r_type = r_type_opt.value();
 
@@ -681,17 +678,15 @@ std::any ExpressionChecker::visit(Expr::Address* expr, bool as_lvalue) {
                 "This is not mutable."
             );
         }
-        return std::any();
+        return;
     }
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Deref* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Deref* expr, bool as_lvalue) {
     // Dereference expressions *are* possible lvalues.
     auto r_type_opt = expr_check(expr->right, false);
     if (!r_type_opt.has_value())
-        return std::any();
+        return;
     auto r_type = r_type_opt.value();
 
     if (!Type::is_a<Type::IPointer>(r_type)) {
@@ -700,7 +695,7 @@ std::any ExpressionChecker::visit(Expr::Deref* expr, bool as_lvalue) {
             expr->op->location,
             "Cannot dereference non-pointer type `" + r_type->to_string() + "`."
         );
-        return std::any();
+        return;
     }
     if (auto ptr_type = Type::as_a<Type::ITypedPtr>(r_type).value_or(nullptr)) {
         expr->type = ptr_type->base;
@@ -716,10 +711,10 @@ std::any ExpressionChecker::visit(Expr::Deref* expr, bool as_lvalue) {
                 expr->op->location,
                 "Cannot dereference raw pointer outside of an unsafe block."
             );
-            return std::any();
+            return;
         }
 
-        return std::any();
+        return;
     }
     else {
         Diagnostics::inst().emit_error(
@@ -728,29 +723,29 @@ std::any ExpressionChecker::visit(Expr::Deref* expr, bool as_lvalue) {
             "Cannot dereference non-typed pointer `" + r_type->to_string() +
                 "`."
         );
-        return std::any();
+        return;
     }
 }
 
-std::any ExpressionChecker::visit(Expr::Cast* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Cast* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->as_token->location,
             "Cast expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
 
     auto expr_type_opt = expr_check(expr->expression, false);
     if (!expr_type_opt.has_value())
-        return std::any();
+        return;
     auto expr_type = expr_type_opt.value();
 
-    auto anno_any = expr->annotation->accept(annotation_checker.get());
-    if (!anno_any.has_value())
-        return std::any();
-    auto target_type = std::any_cast<std::shared_ptr<Type>>(anno_any);
+    auto anno_opt = expr->annotation->accept(annotation_checker.get());
+    if (!anno_opt.has_value())
+        return;
+    auto target_type = anno_opt.value();
     expr->target_type = target_type;
 
     // Check that the cast is valid.
@@ -771,7 +766,7 @@ std::any ExpressionChecker::visit(Expr::Cast* expr, bool as_lvalue) {
                 target_ptr_type,
                 expr->as_token
             )) {
-            return std::any();
+            return;
         }
         // A pointer cast is a NoOp cast.
         expr->operation = Expr::Cast::Operation::NoOp;
@@ -873,20 +868,19 @@ std::any ExpressionChecker::visit(Expr::Cast* expr, bool as_lvalue) {
             std::string("Cannot cast from type `") + expr_type->to_string() +
                 "` to type `" + target_type->to_string() + "`."
         );
-        return std::any();
+        return;
     }
 
     expr->type = target_type;
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
     if (!expr_check(expr->left, true))
-        return std::any();
+        return;
     auto l_type_opt = implicit_full_dereference(expr->left);
-    auto l_lvalue = std::dynamic_pointer_cast<Expr::IPLValue>(expr->left);
+    auto l_lvalue = dyn_cast<Expr::IPLValue>(expr->left);
     if (!l_type_opt.has_value() || !l_lvalue)
-        return std::any();
+        return;
     auto l_type = l_type_opt.value();
 
     if (!l_type->is_definitely_sized()) {
@@ -899,12 +893,12 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
         Diagnostics::inst().emit_note(
             "Aggregate type members must be sized to calculate member offsets."
         );
-        return std::any();
+        return;
     }
 
     if (auto tuple_l_type = Type::as_a<Type::Tuple>(l_type).value_or(nullptr)) {
         if (expr->right_token->tok_type == Tok::TupleIndex) {
-            size_t index = std::any_cast<size_t>(expr->right_token->literal);
+            size_t index = expr->right_token->literal.get<size_t>();
             if (index >= tuple_l_type->elements.size()) {
                 Diagnostics::inst().emit_error(
                     Err::TupleIndexOutOfBounds,
@@ -917,7 +911,7 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
                     expr->left->location,
                     "Expression has type `" + l_type->to_string() + "`."
                 );
-                return std::any();
+                return;
             }
             expr->type = tuple_l_type->elements[index];
 
@@ -926,7 +920,7 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
             expr->assignable = l_lvalue->assignable;
             expr->error_location = l_lvalue->error_location;
 
-            return std::any();
+            return;
         }
         else {
             Diagnostics::inst().emit_error(
@@ -934,7 +928,7 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
                 expr->right_token->location,
                 "Tuple can only be accessed with an integer literal."
             );
-            return std::any();
+            return;
         }
     }
     else if (
@@ -949,7 +943,7 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
                 "Type `" + l_type->to_string() + "` has no member named `" +
                     member_name + "`."
             );
-            return std::any();
+            return;
         }
         expr->type = matched_field_opt.value().type;
 
@@ -972,7 +966,7 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
             break;
         }
 
-        return std::any();
+        return;
     }
     else if (
         auto struct_l_type = Type::as_a<Type::Struct>(l_type).value_or(nullptr)
@@ -986,7 +980,7 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
                 "Type `" + l_type->to_string() + "` has no member named `" +
                     member_name + "`."
             );
-            return std::any();
+            return;
         }
         expr->type = matched_field_opt.value().type;
 
@@ -1009,7 +1003,7 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
             break;
         }
 
-        return std::any();
+        return;
     }
     else {
         Diagnostics::inst().emit_error(
@@ -1017,22 +1011,22 @@ std::any ExpressionChecker::visit(Expr::Access* expr, bool as_lvalue) {
             expr->left->location,
             "Dot operator is not valid for this kind of expression."
         );
-        return std::any();
+        return;
     }
 }
 
-std::any ExpressionChecker::visit(Expr::Subscript* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Subscript* expr, bool as_lvalue) {
     if (!expr_check(expr->left, true))
-        return std::any();
+        return;
     auto l_type_opt = implicit_full_dereference(expr->left);
-    auto l_lvalue = std::dynamic_pointer_cast<Expr::IPLValue>(expr->left);
+    auto l_lvalue = dyn_cast<Expr::IPLValue>(expr->left);
     if (!l_type_opt.has_value() || !l_lvalue)
-        return std::any();
+        return;
     auto l_type = l_type_opt.value();
 
     auto index_type_opt = expr_check(expr->index, false);
     if (!index_type_opt.has_value())
-        return std::any();
+        return;
     auto index_type = index_type_opt.value();
 
     if (auto array_l_type = Type::as_a<Type::Array>(l_type).value_or(nullptr)) {
@@ -1048,7 +1042,7 @@ std::any ExpressionChecker::visit(Expr::Subscript* expr, bool as_lvalue) {
                 "Array element types must be sized to calculate element "
                 "offsets."
             );
-            return std::any();
+            return;
         }
         // Index must be an integer type.
         if (!Type::is_a<Type::Int>(index_type)) {
@@ -1057,7 +1051,7 @@ std::any ExpressionChecker::visit(Expr::Subscript* expr, bool as_lvalue) {
                 expr->index->location,
                 "Array index must be of an integer type."
             );
-            return std::any();
+            return;
         }
         expr->type = array_l_type->base;
 
@@ -1073,17 +1067,15 @@ std::any ExpressionChecker::visit(Expr::Subscript* expr, bool as_lvalue) {
             "Subscript operator is not valid for this kind of expression."
         );
     }
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Call* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Call* expr, bool as_lvalue) {
     std::vector<std::shared_ptr<Type::Function>> candidate_funcs;
     std::vector<std::shared_ptr<Node::BindingEntry>> overload_binding_entries;
 
     auto callee_type_opt = expr_check(expr->callee, false);
     if (!callee_type_opt.has_value())
-        return std::any();
+        return;
     auto callee_type = callee_type_opt.value();
 
     // If the callee is an exact function, add it to the candidate list.
@@ -1111,7 +1103,7 @@ std::any ExpressionChecker::visit(Expr::Call* expr, bool as_lvalue) {
             "Callee expression is not callable."
         );
         Diagnostics::inst().emit_note(expr->location, "Call occurs here.");
-        return std::any();
+        return;
     }
 
     // Check each argument once
@@ -1123,7 +1115,7 @@ std::any ExpressionChecker::visit(Expr::Call* expr, bool as_lvalue) {
         has_error |= expr_check(arg, false) == std::nullopt;
     }
     if (has_error)
-        return std::any();
+        return;
     // Don't worry about the types right now; we'll check them during matching.
 
     std::optional<Dictionary<std::string, std::weak_ptr<Expr>>> matched_args;
@@ -1150,8 +1142,7 @@ std::any ExpressionChecker::visit(Expr::Call* expr, bool as_lvalue) {
         // If the callee is an overloaded function...
         if (!overload_binding_entries.empty()) {
             expr->callee->type = matched_func;
-            auto name_ref =
-                std::dynamic_pointer_cast<Expr::NameRef>(expr->callee);
+            auto name_ref = dyn_cast<Expr::NameRef>(expr->callee);
             // Due to the semantics of the overloadedfn type, the callee must be
             // a name reference.
             if (name_ref) {
@@ -1159,7 +1150,7 @@ std::any ExpressionChecker::visit(Expr::Call* expr, bool as_lvalue) {
                     overload_binding_entries[matched_candidate_indices[0]];
             }
         }
-        return std::any();
+        return;
     }
     else if (matched_candidate_indices.size() > 1) {
         // More than one candidate matched.
@@ -1173,7 +1164,7 @@ std::any ExpressionChecker::visit(Expr::Call* expr, bool as_lvalue) {
             note_msg += " - " + candidate_funcs[index]->to_string() + "\n";
         }
         Diagnostics::inst().emit_note(note_msg);
-        return std::any();
+        return;
     }
     else {
         // No candidates matched.
@@ -1187,41 +1178,37 @@ std::any ExpressionChecker::visit(Expr::Call* expr, bool as_lvalue) {
             note_msg += " - " + candidate_func->to_string() + "\n";
         }
         Diagnostics::inst().emit_note(note_msg);
-        return std::any();
+        return;
     }
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::SizeOf* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::SizeOf* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "Sizeof expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
 
-    auto type_any = expr->annotation->accept(annotation_checker.get());
-    if (!type_any.has_value())
-        return std::any();
-    auto type = std::any_cast<std::shared_ptr<Type>>(type_any);
+    auto type_opt = expr->annotation->accept(annotation_checker.get());
+    if (!type_opt.has_value())
+        return;
+    auto type = type_opt.value();
     if (!type->is_definitely_sized()) {
         Diagnostics::inst().emit_error(
             Err::SizeOfUnsizedType,
             expr->location,
             "Cannot measure size of unsized type `" + type->to_string() + "`."
         );
-        return std::any();
+        return;
     }
     expr->inner_type = type;
     expr->type = std::make_shared<Type::Int>(false, 64); // Sizeof returns u64.
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
     // As a reminder: pointers are not possible lvalues.
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
@@ -1229,7 +1216,7 @@ std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
             expr->location,
             "Alloc expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
     // You can still do `(alloc expr).property` since it contains a dereference.
 
@@ -1239,7 +1226,7 @@ std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
         // `alloc for <amount_expr> of <type_annotation>`
         auto amount_type_opt = expr_check(expr->amount_expr.value(), false);
         if (!amount_type_opt.has_value())
-            return std::any();
+            return;
         auto amount_type = amount_type_opt.value();
 
         if (!Type::is_a<Type::Int>(amount_type)) {
@@ -1248,13 +1235,13 @@ std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
                 expr->amount_expr.value()->location,
                 "Amount expression for alloc must be of an integer type."
             );
-            return std::any();
+            return;
         }
-        auto anno_any =
+        auto anno_opt =
             expr->type_annotation.value()->accept(annotation_checker.get());
-        if (!anno_any.has_value())
-            return std::any();
-        auto alloc_inner_type = std::any_cast<std::shared_ptr<Type>>(anno_any);
+        if (!anno_opt.has_value())
+            return;
+        auto alloc_inner_type = anno_opt.value();
         // alloc inner type must be sized.
         if (!alloc_inner_type->is_definitely_sized()) {
             Diagnostics::inst().emit_error(
@@ -1266,7 +1253,7 @@ std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
             Diagnostics::inst().emit_note(
                 "Allocated types must be sized to calculate memory layout."
             );
-            return std::any();
+            return;
         }
 
         alloc_type = std::make_shared<Type::Array>(alloc_inner_type);
@@ -1275,16 +1262,16 @@ std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
         // `alloc with <init_expr>`
         auto init_type_opt = expr_check(expr->expression.value(), false);
         if (!init_type_opt.has_value())
-            return std::any();
+            return;
         alloc_type = init_type_opt.value();
     }
     else {
         // `alloc <type_annotation> [with <init_expr>]`
-        auto anno_any =
+        auto anno_opt =
             expr->type_annotation.value()->accept(annotation_checker.get());
-        if (!anno_any.has_value())
-            return std::any();
-        auto alloc_inner_type = std::any_cast<std::shared_ptr<Type>>(anno_any);
+        if (!anno_opt.has_value())
+            return;
+        auto alloc_inner_type = anno_opt.value();
         // alloc inner type must be sized.
         if (!alloc_inner_type->is_definitely_sized()) {
             Diagnostics::inst().emit_error(
@@ -1296,13 +1283,13 @@ std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
             Diagnostics::inst().emit_note(
                 "Allocated types must be sized to calculate memory layout."
             );
-            return std::any();
+            return;
         }
 
         if (expr->expression.has_value()) {
             auto init_type_opt = expr_check(expr->expression.value(), false);
             if (!init_type_opt.has_value())
-                return std::any();
+                return;
             auto init_type = init_type_opt.value();
 
             if (!init_type->is_assignable_to(alloc_inner_type)) {
@@ -1314,7 +1301,7 @@ std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
                         "` is not compatible with allocated type `" +
                         alloc_inner_type->to_string() + "`."
                 );
-                return std::any();
+                return;
             }
             // alloc_inner_type takes precedence over init_type, so we don't do
             // anything else with init_type here.
@@ -1325,24 +1312,23 @@ std::any ExpressionChecker::visit(Expr::Alloc* expr, bool as_lvalue) {
 
     // Alloc always returns a mutable raw pointer.
     expr->type = std::make_shared<Type::RawTypedPtr>(alloc_type, true);
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::NewInst* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::NewInst* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "New instance expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
 
     // First, get the type of the new instance from the annotation.
-    auto anno_any = expr->annotation->accept(annotation_checker.get());
-    if (!anno_any.has_value())
-        return std::any();
-    auto new_inst_type = std::any_cast<std::shared_ptr<Type>>(anno_any);
+    auto anno_opt = expr->annotation->accept(annotation_checker.get());
+    if (!anno_opt.has_value())
+        return;
+    auto new_inst_type = anno_opt.value();
 
     if (!Type::is_a<Type::Struct>(new_inst_type)) {
         Diagnostics::inst().emit_error(
@@ -1351,7 +1337,7 @@ std::any ExpressionChecker::visit(Expr::NewInst* expr, bool as_lvalue) {
             "Non-struct type `" + new_inst_type->to_string() +
                 "` cannot be instantiated using `new`."
         );
-        return std::any();
+        return;
     }
     auto struct_type = Type::as_a<Type::Struct>(new_inst_type).value();
 
@@ -1425,11 +1411,9 @@ std::any ExpressionChecker::visit(Expr::NewInst* expr, bool as_lvalue) {
 
     // The type of the new instance expression is the struct type.
     expr->type = struct_type;
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::NameRef* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::NameRef* expr, bool as_lvalue) {
     if (!symbol_tree->try_resolve_name(expr->name)) {
         Diagnostics::inst().emit_error(
             Err::NameNotFound,
@@ -1454,11 +1438,10 @@ std::any ExpressionChecker::visit(Expr::NameRef* expr, bool as_lvalue) {
                 Diagnostics::inst().emit_note("Did you mean `:" + *it + "`?");
             }
         }
-        return std::any();
+        return;
     }
     auto resolved_node = expr->name->node.lock();
-    auto binding_entry =
-        std::dynamic_pointer_cast<Node::BindingEntry>(resolved_node);
+    auto binding_entry = dyn_cast<Node::BindingEntry>(resolved_node);
     if (!binding_entry) {
         Diagnostics::inst().emit_error(
             Err::NotAVariable,
@@ -1466,7 +1449,7 @@ std::any ExpressionChecker::visit(Expr::NameRef* expr, bool as_lvalue) {
             "Name reference `" + expr->name->to_string() +
                 "` is not a variable."
         );
-        return std::any();
+        return;
     }
     // Set assignability and possible error location based on whether the
     // binding is mutable.
@@ -1480,19 +1463,18 @@ std::any ExpressionChecker::visit(Expr::NameRef* expr, bool as_lvalue) {
 
     expr->type = binding_entry->binding.type;
     expr->binding_entry = binding_entry;
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Literal* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Literal* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "Literal expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
-    switch (expr->token->tok_type) {
+    switch (expr->tok_type) {
     case Tok::Int8:
         expr->type = std::make_shared<Type::Int>(true, 8);
         break;
@@ -1539,20 +1521,19 @@ std::any ExpressionChecker::visit(Expr::Literal* expr, bool as_lvalue) {
         panic(
             "ExpressionChecker::visit(Expr::Literal*): Could not handle case "
             "for token type " +
-            std::to_string(static_cast<int>(expr->token->tok_type))
+            std::to_string(static_cast<int>(expr->tok_type))
         );
     }
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Tuple* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Tuple* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "Tuple expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
     std::vector<std::shared_ptr<Type>> element_types;
     bool has_error = false;
@@ -1564,29 +1545,28 @@ std::any ExpressionChecker::visit(Expr::Tuple* expr, bool as_lvalue) {
         element_types.push_back(element->type);
     }
     if (has_error)
-        return std::any();
+        return;
     if (element_types.empty()) {
         expr->type = std::make_shared<Type::Unit>();
     }
     else {
         expr->type = std::make_shared<Type::Tuple>(element_types);
     }
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Array* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Array* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "Array expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
     bool has_error = false;
     if (expr->elements.empty()) {
         expr->type = std::make_shared<Type::EmptyArray>();
-        return std::any();
+        return;
     }
     // Visit every element once.
     for (auto& element : expr->elements) {
@@ -1595,7 +1575,7 @@ std::any ExpressionChecker::visit(Expr::Array* expr, bool as_lvalue) {
             has_error = true;
     }
     if (has_error)
-        return std::any();
+        return;
 
     auto first_elem_type = expr->elements[0]->type;
     // Ensure all elements have the same type.
@@ -1613,21 +1593,19 @@ std::any ExpressionChecker::visit(Expr::Array* expr, bool as_lvalue) {
         }
     }
     if (has_error)
-        return std::any();
+        return;
     expr->type =
         std::make_shared<Type::Array>(first_elem_type, expr->elements.size());
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Object* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Object* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "Object expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
     bool has_error = false;
     Dictionary<std::string, Binding> fields;
@@ -1649,23 +1627,21 @@ std::any ExpressionChecker::visit(Expr::Object* expr, bool as_lvalue) {
         );
     }
     if (has_error)
-        return std::any();
+        return;
     expr->type = std::make_shared<Type::Object>(std::move(fields));
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Block* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Block* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "Block expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
     auto local_scope_opt = symbol_tree->add_local_scope(
-        std::dynamic_pointer_cast<Expr::Block>(expr->shared_from_this())
+        dyn_cast<Expr::Block>(expr->shared_from_this())
     );
     if (!local_scope_opt.has_value()) {
         panic(
@@ -1681,18 +1657,16 @@ std::any ExpressionChecker::visit(Expr::Block* expr, bool as_lvalue) {
     );
     expr->type = yield_type;
     symbol_tree->exit_scope();
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Conditional* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Conditional* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "Conditional expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
     // We use this flag to try and report as many errors as possible before
     // returning.
@@ -1725,7 +1699,7 @@ std::any ExpressionChecker::visit(Expr::Conditional* expr, bool as_lvalue) {
 
     // If there was an error in any of the branches, return early.
     if (has_error)
-        return std::any();
+        return;
 
     auto cond_type = cond_type_opt.value();
     auto then_type = then_type_opt.value();
@@ -1761,18 +1735,16 @@ std::any ExpressionChecker::visit(Expr::Conditional* expr, bool as_lvalue) {
     if (!has_error) {
         expr->type = then_type;
     }
-
-    return std::any();
 }
 
-std::any ExpressionChecker::visit(Expr::Loop* expr, bool as_lvalue) {
+void ExpressionChecker::visit(Expr::Loop* expr, bool as_lvalue) {
     if (as_lvalue) {
         Diagnostics::inst().emit_error(
             Err::NotAPossibleLValue,
             expr->location,
             "Loop expression cannot be an lvalue."
         );
-        return std::any();
+        return;
     }
 
     bool has_error = false;
@@ -1813,19 +1785,19 @@ std::any ExpressionChecker::visit(Expr::Loop* expr, bool as_lvalue) {
     if (!has_error) {
         expr->type = body_type_opt.value();
     }
-
-    return std::any();
 }
 
 std::
     pair<std::shared_ptr<ExpressionChecker>, std::shared_ptr<AnnotationChecker>>
     ExpressionChecker::create(
         std::shared_ptr<SymbolTree> symbol_tree,
-        Stmt::Visitor* stmt_visitor,
+        TokenStore& token_store,
+        Stmt::Visitor<void>* stmt_visitor,
         bool repl_mode
     ) {
     auto checker = std::make_shared<ExpressionChecker>(Private());
     checker->symbol_tree = symbol_tree;
+    checker->token_store = &token_store;
     checker->stmt_visitor = stmt_visitor;
     checker->annotation_checker = AnnotationChecker::create(
         symbol_tree,
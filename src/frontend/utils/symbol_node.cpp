@@ -46,7 +46,7 @@ bool Node::IScope::add_child(
             "Name `" + child->short_name + "` already exists in this scope."
         );
         if (auto existing_locatable =
-                std::dynamic_pointer_cast<Node::ILocatable>(existing.value())) {
+                dyn_cast<Node::ILocatable>(existing.value())) {
             Diagnostics::inst().emit_note(
                 existing_locatable->location,
                 "Previous declaration of name `" + child->short_name +
@@ -67,7 +67,7 @@ bool Node::IScope::add_child(
 }
 
 std::shared_ptr<Node::Namespace> Node::Namespace::create(
-    std::shared_ptr<Node::IScope> parent, std::shared_ptr<Token> token
+    std::shared_ptr<Node::IScope> parent, const Token* token
 ) {
     auto node = std::make_shared<Namespace>(Private());
     node->parent = parent;
@@ -77,7 +77,7 @@ std::shared_ptr<Node::Namespace> Node::Namespace::create(
 }
 
 std::shared_ptr<Node::ExternBlock> Node::ExternBlock::create(
-    std::shared_ptr<Node::IScope> parent, std::shared_ptr<Token> token
+    std::shared_ptr<Node::IScope> parent, const Token* token
 ) {
     auto node = std::make_shared<ExternBlock>(Private());
     node->parent = parent;
@@ -92,8 +92,7 @@ bool Node::ExternBlock::add_child(
     std::optional<std::string> custom_symbol
 ) {
     // Extern blocks can only contain binding entries that represent functions.
-    if (auto extern_child =
-            std::dynamic_pointer_cast<Node::ExternBlock>(child)) {
+    if (auto extern_child = dyn_cast<Node::ExternBlock>(child)) {
         Diagnostics::inst().emit_error(
             Err::ExternBlockInExternBlock,
             child->location,
@@ -101,7 +100,7 @@ bool Node::ExternBlock::add_child(
         );
         return false;
     }
-    else if (auto ns = std::dynamic_pointer_cast<Node::Namespace>(child)) {
+    else if (auto ns = dyn_cast<Node::Namespace>(child)) {
         Diagnostics::inst().emit_error(
             Err::NamespaceInExternBlock,
             child->location,
@@ -109,9 +108,7 @@ bool Node::ExternBlock::add_child(
         );
         return false;
     }
-    else if (
-        auto struct_def = std::dynamic_pointer_cast<Node::StructDef>(child)
-    ) {
+    else if (auto struct_def = dyn_cast<Node::StructDef>(child)) {
         Diagnostics::inst().emit_error(
             Err::StructDefInExternBlock,
             child->location,
@@ -119,7 +116,7 @@ bool Node::ExternBlock::add_child(
         );
         return false;
     }
-    else if (PTR_INSTANCEOF(child, Node::LocalScope)) {
+    else if (isa<Node::LocalScope>(child)) {
         panic(
             "Node::ExternBlock::add_child: Attempted to add local scope as a "
             "direct child to an extern block."
@@ -148,7 +145,7 @@ std::shared_ptr<Node::PrimitiveType> Node::PrimitiveType::create(
 
 std::shared_ptr<Node::TypeDef> Node::TypeDef::create(
     std::shared_ptr<Node::IScope> parent,
-    std::shared_ptr<Token> token,
+    const Token* token,
     std::shared_ptr<Type> type
 ) {
     auto node = std::make_shared<TypeDef>(Private(), &token->location);
@@ -164,7 +161,7 @@ std::shared_ptr<Node::TypeDef> Node::TypeDef::create(
 
 std::shared_ptr<Node::StructDef> Node::StructDef::create(
     std::shared_ptr<Node::IScope> parent,
-    std::shared_ptr<Token> token,
+    const Token* token,
     bool is_class
 ) {
     auto node = std::make_shared<StructDef>(Private());
@@ -179,7 +176,7 @@ bool Node::StructDef::add_child(
     std::shared_ptr<Node::ILocatable> child,
     std::optional<std::string> custom_symbol
 ) {
-    if (auto ns = std::dynamic_pointer_cast<Node::Namespace>(child)) {
+    if (auto ns = dyn_cast<Node::Namespace>(child)) {
         Diagnostics::inst().emit_error(
             Err::NamespaceInStructDef,
             child->location,
@@ -187,9 +184,7 @@ bool Node::StructDef::add_child(
         );
         return false;
     }
-    else if (
-        auto struct_def = std::dynamic_pointer_cast<Node::StructDef>(child)
-    ) {
+    else if (auto struct_def = dyn_cast<Node::StructDef>(child)) {
         Diagnostics::inst().emit_error(
             Err::StructDefInStructDef,
             child->location,
@@ -197,16 +192,14 @@ bool Node::StructDef::add_child(
         );
         return false;
     }
-    else if (PTR_INSTANCEOF(child, Node::LocalScope)) {
+    else if (isa<Node::LocalScope>(child)) {
         panic(
             "Node::StructDef::add_child: Attempted to add local scope as a "
             "direct child to a struct definition."
         );
         return false;
     }
-    else if (
-        auto extern_block = std::dynamic_pointer_cast<Node::ExternBlock>(child)
-    ) {
+    else if (auto extern_block = dyn_cast<Node::ExternBlock>(child)) {
         Diagnostics::inst().emit_error(
             Err::ExternBlockInStructDef,
             child->location,
@@ -234,7 +227,7 @@ bool Node::LocalScope::add_child(
     std::shared_ptr<Node::ILocatable> child,
     std::optional<std::string> custom_symbol
 ) {
-    if (PTR_INSTANCEOF(child, Node::IGlobalScope)) {
+    if (isa<Node::IGlobalScope>(child)) {
         panic(
             "Node::LocalScope::add_child: Attempted to add global scope as a "
             "direct child to a local scope."
@@ -255,10 +248,10 @@ std::shared_ptr<Node::BindingEntry> Node::BindingEntry::create(
     node->short_name = binding.name;
     node->location = binding.location;
     // If declared in a global scope, this should use an LLVM global variable.
-    node->is_global = PTR_INSTANCEOF(parent, Node::IGlobalScope);
+    node->is_global = isa<Node::IGlobalScope>(parent);
     // If declared in an extern block, the binding should have been initialized
     // elsewhere.
-    node->is_initialized = PTR_INSTANCEOF(parent, Node::ExternBlock);
+    node->is_initialized = isa<Node::ExternBlock>(parent);
 
     return node;
 }
@@ -326,7 +319,7 @@ Node::OverloadGroup::OverloadGroup(
     std::string_view overload_name,
     const Location* first_overload_location
 )
-    : Node(Private()),
+    : Node(Private(), Kind::OverloadGroup),
       Node::ILocatable(Private()),
       Node::BindingEntry(
           Private(),
@@ -354,10 +347,9 @@ std::shared_ptr<Node::OverloadGroup> Node::OverloadGroup::create(
     node->parent = parent;
     node->short_name = std::string(overload_name);
     node->location = first_overload_location;
-    node->is_global = PTR_INSTANCEOF(parent, Node::IGlobalScope);
+    node->is_global = isa<Node::IGlobalScope>(parent);
 
-    auto overloaded_fn_type =
-        std::dynamic_pointer_cast<Type::OverloadedFn>(node->binding.type);
+    auto overloaded_fn_type = dyn_cast<Type::OverloadedFn>(node->binding.type);
     overloaded_fn_type->overload_group = node;
 
     return node;
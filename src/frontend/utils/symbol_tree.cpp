@@ -122,7 +122,7 @@ bool SymbolTree::try_resolve_name_downward_from_scope(
             return false;
         }
         // Ensure the base's node is a scope.
-        auto base_scope = std::dynamic_pointer_cast<Node::IScope>(
+        auto base_scope = dyn_cast<Node::IScope>(
             name->base.value()->node.lock()
         );
         if (!base_scope) {
@@ -235,7 +235,7 @@ bool SymbolTree::register_symbol(
 }
 
 std::optional<std::shared_ptr<Node::Namespace>>
-SymbolTree::add_namespace(std::shared_ptr<Token> token) {
+SymbolTree::add_namespace(const Token* token) {
     auto new_node = Node::Namespace::create(current_scope, token);
     auto ok = current_scope->add_child(*this, new_node);
     if (!ok) {
@@ -247,7 +247,7 @@ SymbolTree::add_namespace(std::shared_ptr<Token> token) {
 }
 
 std::optional<std::shared_ptr<Node::ExternBlock>>
-SymbolTree::add_extern_block(std::shared_ptr<Token> token) {
+SymbolTree::add_extern_block(const Token* token) {
     auto new_node = Node::ExternBlock::create(current_scope, token);
     auto ok = current_scope->add_child(*this, new_node);
     if (!ok) {
@@ -259,7 +259,7 @@ SymbolTree::add_extern_block(std::shared_ptr<Token> token) {
 }
 
 std::optional<std::shared_ptr<Node::TypeDef>> SymbolTree::add_type_def(
-    std::shared_ptr<Token> token, std::shared_ptr<Type> type
+    const Token* token, std::shared_ptr<Type> type
 ) {
     auto new_node = Node::TypeDef::create(current_scope, token, type);
     auto ok = current_scope->add_child(*this, new_node);
@@ -271,7 +271,7 @@ std::optional<std::shared_ptr<Node::TypeDef>> SymbolTree::add_type_def(
 }
 
 std::optional<std::shared_ptr<Node::StructDef>>
-SymbolTree::add_struct_def(std::shared_ptr<Token> token, bool is_class) {
+SymbolTree::add_struct_def(const Token* token, bool is_class) {
     auto new_node = Node::StructDef::create(current_scope, token, is_class);
     auto ok = current_scope->add_child(*this, new_node);
     if (!ok) {
@@ -328,7 +328,7 @@ bool SymbolTree::try_resolve_name_from_scope(
     // If the resolved name is an OverloadGroup with exactly one overload, set
     // the name's node to the single overload instead.
     if (auto overload_group =
-            std::dynamic_pointer_cast<Node::OverloadGroup>(name->node.lock())) {
+            dyn_cast<Node::OverloadGroup>(name->node.lock())) {
         if (overload_group->overloads.size() == 1) {
             name->node = overload_group->overloads.at(0);
         }
@@ -350,8 +350,7 @@ std::optional<std::shared_ptr<Node::LocalScope>>
 SymbolTree::get_local_scope_of_kind(Expr::Block::Kind kind) const {
     auto current = current_scope;
     while (current) {
-        if (auto local_scope =
-                std::dynamic_pointer_cast<Node::LocalScope>(current)) {
+        if (auto local_scope = dyn_cast<Node::LocalScope>(current)) {
             // If this is a local scope, check if it matches the kind.
             if (local_scope->block && local_scope->block->kind == kind) {
                 return local_scope;
@@ -390,7 +389,7 @@ SymbolTree::add_binding_entry(
             *binding.location,
             "Name `" + binding.name + "` already exists in the current scope."
         );
-        if (PTR_INSTANCEOF(node.value(), Node::OverloadGroup) &&
+        if (isa<Node::OverloadGroup>(node.value()) &&
             Type::is_a<Type::Function>(binding.type)) {
             // The binding being declared is a non-overloadable function, but
             // there is an overload group with the same name.
@@ -399,8 +398,7 @@ SymbolTree::add_binding_entry(
                 "name with an overloadable function."
             );
         }
-        if (auto locatable =
-                std::dynamic_pointer_cast<Node::ILocatable>(node.value())) {
+        if (auto locatable = dyn_cast<Node::ILocatable>(node.value())) {
             Diagnostics::inst().emit_note(
                 locatable->location,
                 "Previous declaration here."
@@ -439,7 +437,7 @@ SymbolTree::add_overloadable_func(const Binding& binding) {
 
     if (auto node = current_scope->children.at(binding.name)) {
         if (auto existing_overload_group =
-                std::dynamic_pointer_cast<Node::OverloadGroup>(node.value())) {
+                dyn_cast<Node::OverloadGroup>(node.value())) {
             // If existing name is an overload group, add to it.
             overload_group = existing_overload_group;
         }
@@ -452,8 +450,7 @@ SymbolTree::add_overloadable_func(const Binding& binding) {
                     "` already exists in the current scope and is not an "
                     "overloadable function."
             );
-            if (auto locatable =
-                    std::dynamic_pointer_cast<Node::ILocatable>(node.value())) {
+            if (auto locatable = dyn_cast<Node::ILocatable>(node.value())) {
                 Diagnostics::inst().emit_note(
                     locatable->location,
                     "Previous declaration here."
@@ -478,7 +475,7 @@ SymbolTree::add_overloadable_func(const Binding& binding) {
         }
     }
 
-    auto func_type = std::dynamic_pointer_cast<Type::Function>(binding.type);
+    auto func_type = dyn_cast<Type::Function>(binding.type);
     if (!func_type)
         panic("Binding added as overloadable function is not a function.");
     auto [m_f1, d_f1] = func_type->get_param_sets();
@@ -486,9 +483,8 @@ SymbolTree::add_overloadable_func(const Binding& binding) {
     // Check for overload conflicts.
     std::vector<std::shared_ptr<Node::BindingEntry>> conflicts;
     for (const auto& existing_overload : overload_group->overloads) {
-        auto existing_func_type = std::dynamic_pointer_cast<Type::Function>(
-            existing_overload->binding.type
-        );
+        auto existing_func_type =
+            dyn_cast<Type::Function>(existing_overload->binding.type);
         if (!existing_func_type)
             panic("Existing overload in overload group is not a function.");
         auto [m_f2, d_f2] = existing_func_type->get_param_sets();
@@ -510,8 +506,7 @@ SymbolTree::add_overloadable_func(const Binding& binding) {
             "Function overload conflict for function `" + binding.name + "`."
         );
         for (const auto& conflict : conflicts) {
-            if (auto locatable =
-                    std::dynamic_pointer_cast<Node::ILocatable>(conflict)) {
+            if (auto locatable = dyn_cast<Node::ILocatable>(conflict)) {
                 Diagnostics::inst().emit_note(
                     locatable->location,
                     "Conflicting overload declared here."
@@ -551,8 +546,7 @@ SymbolTree::add_unresolved_type(std::shared_ptr<Name> name) {
 }
 
 bool SymbolTree::is_context_unsafe() const {
-    auto local_scope =
-        std::dynamic_pointer_cast<Node::LocalScope>(current_scope);
+    auto local_scope = dyn_cast<Node::LocalScope>(current_scope);
     return local_scope && local_scope->block->is_unsafe;
 }
 
@@ -575,8 +569,7 @@ bool SymbolTree::resolve_unresolved_types() {
             has_error = true;
             continue;
         }
-        auto type_node =
-            std::dynamic_pointer_cast<Node::ITypeNode>(name->node.lock());
+        auto type_node = dyn_cast<Node::ITypeNode>(name->node.lock());
         // Confirm that the resolved name is indeed a type.
         if (!type_node) {
             Diagnostics::inst().emit_error(
@@ -597,7 +590,7 @@ bool SymbolTree::resolve_unresolved_types() {
             auto node = type->node.lock();
             // Node should always be locatable; only primitive types are not
             // locatable, and they are always be resolved.
-            auto locatable = std::dynamic_pointer_cast<Node::ILocatable>(node);
+            auto locatable = dyn_cast<Node::ILocatable>(node);
             Diagnostics::inst().emit_error(
                 Err::UnsizedNamedType,
                 locatable ? locatable->location : nullptr,
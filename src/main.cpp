@@ -1,19 +1,49 @@
 #include <iostream>
 
+#include "nico/driver/aot_builder.h"
+#include "nico/driver/compile_server.h"
+#include "nico/driver/driver_options.h"
 #include "nico/driver/jit_runner.h"
 #include "nico/driver/repl.h"
+#include "nico/shared/utils.h"
 
 int main(int argc, char** argv) {
-    if (argc > 2) {
-        std::cout << "Usage: nico [source_file]" << std::endl;
+    auto options = nico::parse_driver_options(argc, argv);
+    if (!options.has_value()) {
+        nico::print_usage(std::cerr);
         return 64;
     }
 
-    if (argc == 2) {
-        nico::compile_and_run(argv[1]);
+    // A compile server's requests run in forked copies of it, which report
+    // their own phases if the client asks for it.
+    if (options->mode != nico::DriverMode::Serve) {
+        nico::report_phases_at_exit(options->time_phases);
     }
-    else {
-        nico::REPL::run();
+
+    switch (options->mode) {
+    case nico::DriverMode::Help:
+        nico::print_usage(std::cout);
+        break;
+    case nico::DriverMode::Version:
+        std::cout << nico::project_version() << std::endl;
+        break;
+    case nico::DriverMode::Run:
+        if (options->use_server) {
+            auto exit_code = nico::run_on_server(*options, argc, argv);
+            if (exit_code.has_value()) {
+                return *exit_code;
+            }
+        }
+        nico::compile_and_run(*options);
+        break;
+    case nico::DriverMode::Build:
+        nico::compile_and_build(*options);
+        break;
+    case nico::DriverMode::Serve:
+        return nico::serve(*options);
+    case nico::DriverMode::Repl:
+        nico::REPL::run(std::cin, std::cout, *options);
+        break;
     }
 
     return 0;
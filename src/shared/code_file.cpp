@@ -0,0 +1,247 @@
+#include "nico/shared/code_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "nico/shared/utils.h"
+
+#if defined(__unix__) || defined(__unix) ||                                    \
+    (defined(__APPLE__) && defined(__MACH__))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NICO_HAS_MMAP 1
+#endif
+
+namespace nico {
+
+/**
+ * @brief A fixed-size table of the live files, indexed by ID.
+ */
+struct FileTable {
+    // The number of slots in the table.
+    const size_t capacity;
+    // The files, indexed by ID. Slots of destroyed files are null.
+    const std::unique_ptr<std::atomic<const CodeFile*>[]> slots;
+
+    explicit FileTable(size_t capacity)
+        : capacity(capacity),
+          slots(new std::atomic<const CodeFile*>[capacity]()) {}
+};
+
+// The initial number of slots in the file table.
+static constexpr size_t initial_file_table_capacity = 64;
+
+// The current file table. Lookups read it without locking, so a table that has
+// been replaced may still be in use and is never freed.
+static std::atomic<FileTable*> live_files = nullptr;
+// Guards changes to the file table, `free_file_ids` and `next_file_id`.
+static std::mutex live_files_mutex;
+// The IDs of destroyed files, which are given to new files before new IDs.
+static std::vector<uint32_t> free_file_ids;
+// The lowest ID that has never been given to a file.
+static uint32_t next_file_id = 0;
+
+/**
+ * @brief Registers a file under an unused ID.
+ *
+ * IDs of destroyed files are reused, so the table only grows with the number
+ * of files alive at once. When the table is full, it is copied into one twice
+ * its size.
+ *
+ * @param file The file to register.
+ * @return The ID of the file.
+ */
+static uint32_t register_file(const CodeFile* file) {
+    std::lock_guard<std::mutex> lock(live_files_mutex);
+    uint32_t id;
+    if (!free_file_ids.empty()) {
+        id = free_file_ids.back();
+        free_file_ids.pop_back();
+    }
+    else {
+        id = next_file_id++;
+    }
+
+    FileTable* table = live_files.load(std::memory_order_relaxed);
+    if (!table || id >= table->capacity) {
+        auto larger = new FileTable(
+            table ? table->capacity * 2 : initial_file_table_capacity
+        );
+        for (size_t i = 0; table && i < table->capacity; i++) {
+            larger->slots[i].store(
+                table->slots[i].load(std::memory_order_relaxed),
+                std::memory_order_relaxed
+            );
+        }
+        table = larger;
+        live_files.store(table, std::memory_order_release);
+    }
+    table->slots[id].store(file, std::memory_order_release);
+    return id;
+}
+
+/**
+ * @brief Checks that a source is small enough for token locations, which store
+ * offsets and lengths in 32 bits.
+ *
+ * @param size The size of the source in bytes.
+ * @return The size.
+ * @warning If the source is too large, the program will panic.
+ */
+static size_t checked_source_size(size_t size) {
+    if (size > CodeFile::max_size) {
+        panic("CodeFile: Source code is too large.");
+    }
+    return size;
+}
+
+CodeFile::CodeFile(std::string&& src_code, const std::string& path_string)
+    : owned_code(std::move(src_code)),
+      code(owned_code.data(), checked_source_size(owned_code.size())),
+      id(register_file(this)),
+      path_string(path_string) {}
+
+CodeFile::CodeFile(void* mapping, size_t length, const std::string& path_string)
+    : mapping(mapping),
+      code(static_cast<const char*>(mapping), checked_source_size(length)),
+      id(register_file(this)),
+      path_string(path_string) {}
+
+CodeFile::~CodeFile() {
+#ifdef NICO_HAS_MMAP
+    if (mapping) {
+        munmap(mapping, code.size());
+    }
+#endif
+    std::lock_guard<std::mutex> lock(live_files_mutex);
+    FileTable* table = live_files.load(std::memory_order_relaxed);
+    table->slots[id].store(nullptr, std::memory_order_release);
+    free_file_ids.push_back(id);
+}
+
+const CodeFile& CodeFile::get(uint32_t id) {
+    const FileTable* table = live_files.load(std::memory_order_acquire);
+    const CodeFile* file = nullptr;
+    if (table && id < table->capacity) {
+        file = table->slots[id].load(std::memory_order_acquire);
+    }
+    if (file == nullptr) {
+        panic("CodeFile::get: No live file has the ID " + std::to_string(id));
+    }
+    return *file;
+}
+
+std::pair<size_t, size_t> CodeFile::get_line_bounds(size_t offset) const {
+    std::call_once(line_starts_flag, [this]() {
+        line_starts.push_back(0);
+        size_t newline = code.find('\n');
+        while (newline != std::string_view::npos) {
+            line_starts.push_back(static_cast<uint32_t>(newline + 1));
+            newline = code.find('\n', newline + 1);
+        }
+    });
+
+    // Find the last line that starts at or before the offset.
+    auto next_line = std::upper_bound(
+        line_starts.begin(),
+        line_starts.end(),
+        static_cast<uint32_t>(offset)
+    );
+    size_t line_start = *(next_line - 1);
+    size_t line_end =
+        next_line == line_starts.end() ? code.length() : *next_line - 1;
+    return {line_start, line_end};
+}
+
+std::optional<std::shared_ptr<CodeFile>>
+read_code_file(std::string_view file_name) {
+    // Read the file's path.
+    std::filesystem::path path = file_name;
+
+    // Files are read in chunks of this many bytes when they are not mapped.
+    constexpr size_t chunk_size = 64 * 1024;
+    std::string src_code;
+
+#ifdef NICO_HAS_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    // Map regular, non-empty files.
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) &&
+        file_stat.st_size > 0) {
+        size_t length = static_cast<size_t>(file_stat.st_size);
+        if (length > CodeFile::max_size) {
+            close(fd);
+            return std::nullopt;
+        }
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            close(fd);
+            return std::shared_ptr<CodeFile>(new CodeFile(
+                mapping,
+                length,
+                std::filesystem::absolute(path).string()
+            ));
+        }
+    }
+
+    // Anything else, e.g. a pipe, has no known size and is read until EOF.
+    // The same descriptor is used, since reopening a pipe may lose its data.
+    char buffer[chunk_size];
+    while (true) {
+        ssize_t count = read(fd, buffer, chunk_size);
+        if (count == 0) {
+            break;
+        }
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            close(fd);
+            return std::nullopt;
+        }
+        if (src_code.size() + count > CodeFile::max_size) {
+            close(fd);
+            return std::nullopt;
+        }
+        src_code.append(buffer, count);
+    }
+    close(fd);
+#else
+    // Open the file.
+    std::ifstream file(std::string(file_name), std::ios::binary);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    // Read the file until EOF. Its size is not asked for up front, since
+    // seeking fails on pipes.
+    char buffer[chunk_size];
+    while (file.read(buffer, chunk_size) || file.gcount() > 0) {
+        size_t count = static_cast<size_t>(file.gcount());
+        if (src_code.size() + count > CodeFile::max_size) {
+            return std::nullopt;
+        }
+        src_code.append(buffer, count);
+    }
+    file.close();
+#endif
+
+    return std::make_shared<CodeFile>(
+        std::move(src_code),
+        std::filesystem::absolute(path).string()
+    );
+}
+
+} // namespace nico
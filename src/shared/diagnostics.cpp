@@ -10,26 +10,16 @@ namespace nico {
 void Diagnostics::print_code_at_location(
     const Location& location, std::ostream& (*color_manip)(std::ostream& o)
 ) {
-    const std::string& src_code = location.file->src_code;
+    const CodeFile& file = location.file();
+    std::string_view src_code = file.src_code();
     size_t start = location.start;
     size_t length = location.length;
 
-    // The start of the line.
-    size_t line_start = src_code.rfind('\n', start);
-    if (line_start == std::string::npos) {
-        line_start = 0;
-    }
-    else {
-        line_start += 1; // Move past the newline character.
-    }
-
-    // The end of the line.
-    size_t line_end = src_code.find('\n', start + length);
-    if (line_end == std::string::npos) {
-        line_end = src_code.length();
-    }
+    // The start of the first line and the end of the last line of the code.
+    size_t line_start = file.get_line_bounds(start).first;
+    size_t line_end = file.get_line_bounds(start + length).second;
 
-    std::string line = src_code.substr(line_start, line_end - line_start);
+    std::string_view line = src_code.substr(line_start, line_end - line_start);
 
     *out << location.to_string() << "\n";
 
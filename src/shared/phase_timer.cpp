@@ -0,0 +1,141 @@
+#include "nico/shared/phase_timer.h"
+
+#include <ctime>
+#include <iomanip>
+
+#if defined(__unix__) || defined(__unix) ||                                    \
+    (defined(__APPLE__) && defined(__MACH__))
+#include <sys/resource.h>
+#define NICO_HAS_GETRUSAGE 1
+#endif
+
+namespace nico {
+
+// The number of phases the current thread is nested in.
+static thread_local size_t current_depth = 0;
+
+/**
+ * @brief Gets the CPU time used by the process so far.
+ *
+ * @return The CPU time, in milliseconds.
+ */
+static double get_cpu_ms() {
+#ifdef NICO_HAS_GETRUSAGE
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        auto to_ms = [](const timeval& t) {
+            return t.tv_sec * 1000.0 + t.tv_usec / 1000.0;
+        };
+        return to_ms(usage.ru_utime) + to_ms(usage.ru_stime);
+    }
+#endif
+    return std::clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/**
+ * @brief Gets the peak resident set size of the process so far.
+ *
+ * @return The peak RSS, in kilobytes, or 0 if the platform does not report it.
+ */
+static long get_peak_rss_kb() {
+#ifdef NICO_HAS_GETRUSAGE
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__) && defined(__MACH__)
+        return usage.ru_maxrss / 1024; // Reported in bytes on macOS.
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
+
+PhaseTimer::Scope::Scope(PhaseTimer* timer, std::string_view name)
+    : timer(timer) {
+    if (!timer) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(timer->mutex);
+        index = timer->records.size();
+        timer->records.push_back(Record{std::string(name), current_depth});
+    }
+    current_depth++;
+    peak_rss_start_kb = get_peak_rss_kb();
+    cpu_start_ms = get_cpu_ms();
+    wall_start = std::chrono::steady_clock::now();
+}
+
+PhaseTimer::Scope::~Scope() {
+    if (!timer) {
+        return;
+    }
+    auto wall_end = std::chrono::steady_clock::now();
+    double cpu_end_ms = get_cpu_ms();
+    long peak_rss_end_kb = get_peak_rss_kb();
+    current_depth--;
+
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    Record& record = timer->records[index];
+    record.wall_ms =
+        std::chrono::duration<double, std::milli>(wall_end - wall_start)
+            .count();
+    record.cpu_ms = cpu_end_ms - cpu_start_ms;
+    record.peak_rss_delta_kb = peak_rss_end_kb - peak_rss_start_kb;
+}
+
+void PhaseTimer::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    records.clear();
+}
+
+std::vector<PhaseTimer::Record> PhaseTimer::get_records() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+void PhaseTimer::print_report(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto flags = out.flags();
+    out << std::left << std::setw(28) << "Phase" << std::right << std::setw(12)
+        << "Wall (ms)" << std::setw(12) << "CPU (ms)" << std::setw(16)
+        << "Peak RSS (KB)" << "\n";
+    out << std::fixed << std::setprecision(3);
+    for (const auto& record : records) {
+        std::string name = std::string(record.depth * 2, ' ') + record.name;
+        std::string rss = "+" + std::to_string(record.peak_rss_delta_kb);
+        out << std::left << std::setw(28) << name << std::right
+            << std::setw(12) << record.wall_ms << std::setw(12)
+            << record.cpu_ms << std::setw(16) << rss << "\n";
+    }
+    out.flags(flags);
+}
+
+void PhaseTimer::print_json(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"phases\":[";
+    for (size_t i = 0; i < records.size(); i++) {
+        const Record& record = records[i];
+        if (i > 0) {
+            out << ",";
+        }
+        out << "{\"name\":\"";
+        for (char c : record.name) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << "\",\"depth\":" << record.depth
+            << ",\"wall_ms\":" << record.wall_ms
+            << ",\"cpu_ms\":" << record.cpu_ms
+            << ",\"peak_rss_delta_kb\":" << record.peak_rss_delta_kb << "}";
+    }
+    out << "]}\n";
+    out.flags(flags);
+}
+
+} // namespace nico
@@ -0,0 +1,48 @@
+#include "nico/shared/target_spec.h"
+
+#include <string_view>
+#include <vector>
+
+#include <llvm/TargetParser/Host.h>
+#include <llvm/TargetParser/Triple.h>
+
+namespace nico {
+
+llvm::Expected<llvm::orc::JITTargetMachineBuilder>
+TargetSpec::create_target_machine_builder() const {
+    llvm::orc::JITTargetMachineBuilder jtmb(
+        llvm::Triple(llvm::sys::getProcessTriple())
+    );
+
+    if (cpu == "native") {
+        auto host_or_err = llvm::orc::JITTargetMachineBuilder::detectHost();
+        if (!host_or_err) {
+            return host_or_err.takeError();
+        }
+        jtmb = std::move(*host_or_err);
+    }
+    else {
+        jtmb.setCPU(cpu);
+    }
+
+    // Split the feature string on commas, e.g. "+avx2,-fma".
+    std::vector<std::string> feature_list;
+    std::string_view remaining = features;
+    while (!remaining.empty()) {
+        size_t comma = remaining.find(',');
+        std::string_view feature = remaining.substr(0, comma);
+        if (!feature.empty()) {
+            feature_list.emplace_back(feature);
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        remaining.remove_prefix(comma + 1);
+    }
+    jtmb.addFeatures(feature_list);
+
+    jtmb.setRelocationModel(llvm::Reloc::PIC_);
+    return jtmb;
+}
+
+} // namespace nico
@@ -0,0 +1,388 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "nico/backend/emitter.h"
+#include "nico/driver/aot_builder.h"
+#include "nico/driver/compile_server.h"
+#include "nico/driver/driver_options.h"
+#include "nico/frontend/frontend.h"
+
+#include "test_utils.h"
+
+#if defined(__unix__) || defined(__unix) ||                                    \
+    (defined(__APPLE__) && defined(__MACH__))
+#include <csignal>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define NICO_IS_UNIX 1
+#endif
+
+/**
+ * @brief Parses the given arguments as if they were passed to the driver.
+ *
+ * The program name is prepended automatically.
+ *
+ * @param args The arguments to parse, excluding the program name.
+ * @return The parsed options, or std::nullopt if the arguments are malformed.
+ */
+std::optional<nico::DriverOptions>
+parse_args(const std::vector<const char*>& args) {
+    std::vector<const char*> argv = {"nico"};
+    argv.insert(argv.end(), args.begin(), args.end());
+    std::ostringstream err;
+    return nico::parse_driver_options(
+        static_cast<int>(argv.size()),
+        argv.data(),
+        err
+    );
+}
+
+TEST_CASE("Driver options modes", "[driver]") {
+    SECTION("No arguments") {
+        auto options = parse_args({});
+        REQUIRE(options.has_value());
+        CHECK(options->mode == nico::DriverMode::Repl);
+    }
+
+    SECTION("Run file") {
+        auto options = parse_args({"main.nico"});
+        REQUIRE(options.has_value());
+        CHECK(options->mode == nico::DriverMode::Run);
+        CHECK(options->input_file == "main.nico");
+    }
+
+    SECTION("Build file") {
+        auto options = parse_args({"build", "main.nico", "-o", "main", "-O2"});
+        REQUIRE(options.has_value());
+        CHECK(options->mode == nico::DriverMode::Build);
+        CHECK(options->input_file == "main.nico");
+        CHECK(options->output_file == "main");
+        CHECK(options->opt_level == llvm::OptimizationLevel::O2);
+    }
+
+    SECTION("Build default output") {
+        auto options = parse_args({"build", "main.nico"});
+        REQUIRE(options.has_value());
+        CHECK(options->output_file == "a.out");
+        CHECK(options->opt_level == llvm::OptimizationLevel::O0);
+    }
+
+    SECTION("Target options") {
+        auto options =
+            parse_args({"main.nico", "-mcpu=skylake", "-mattr=+avx2"});
+        REQUIRE(options.has_value());
+        CHECK(options->target_spec.cpu == "skylake");
+        CHECK(options->target_spec.features == "+avx2");
+    }
+
+    SECTION("Default target") {
+        auto options = parse_args({"main.nico"});
+        REQUIRE(options.has_value());
+        CHECK(options->target_spec.cpu == "native");
+        CHECK(options->target_spec.features.empty());
+    }
+
+    SECTION("Compile threads") {
+        auto options = parse_args({"main.nico", "--compile-threads=4"});
+        REQUIRE(options.has_value());
+        CHECK(options->num_compile_threads == 4);
+    }
+
+    SECTION("Lexer threads") {
+        auto options = parse_args({"main.nico", "--lex-threads=4"});
+        REQUIRE(options.has_value());
+        CHECK(options->num_lexer_threads == 4);
+    }
+
+    SECTION("Parser threads") {
+        auto options = parse_args({"main.nico", "--parse-threads=4"});
+        REQUIRE(options.has_value());
+        CHECK(options->num_parser_threads == 4);
+    }
+
+    SECTION("Profiling") {
+        auto options = parse_args({"main.nico", "--profile"});
+        REQUIRE(options.has_value());
+        CHECK(options->enable_profiling);
+    }
+
+    SECTION("Phase timing") {
+        auto options = parse_args({"main.nico"});
+        REQUIRE(options.has_value());
+        CHECK(options->time_phases == nico::PhaseTiming::Off);
+
+        options = parse_args({"main.nico", "--time-phases"});
+        REQUIRE(options.has_value());
+        CHECK(options->time_phases == nico::PhaseTiming::Text);
+
+        options = parse_args({"main.nico", "--time-phases=json"});
+        REQUIRE(options.has_value());
+        CHECK(options->time_phases == nico::PhaseTiming::Json);
+    }
+
+    SECTION("Serve") {
+        auto options = parse_args({"--serve", "--socket=/tmp/nico.sock"});
+        REQUIRE(options.has_value());
+        CHECK(options->mode == nico::DriverMode::Serve);
+        CHECK(options->socket_path == "/tmp/nico.sock");
+    }
+
+    SECTION("Client") {
+        auto options = parse_args({"--client", "main.nico"});
+        REQUIRE(options.has_value());
+        CHECK(options->mode == nico::DriverMode::Run);
+        CHECK(options->use_server);
+        CHECK(options->socket_path.empty());
+    }
+
+    SECTION("Cache directory") {
+        auto options = parse_args({"main.nico", "--cache-dir=/tmp/nico"});
+        REQUIRE(options.has_value());
+        REQUIRE(options->cache_dir.has_value());
+        CHECK(*options->cache_dir == "/tmp/nico");
+    }
+
+    SECTION("No cache by default") {
+        auto options = parse_args({"main.nico"});
+        REQUIRE(options.has_value());
+        CHECK_FALSE(options->cache_dir.has_value());
+    }
+
+    SECTION("Help") {
+        auto options = parse_args({"build", "--help"});
+        REQUIRE(options.has_value());
+        CHECK(options->mode == nico::DriverMode::Help);
+    }
+}
+
+TEST_CASE("Driver options errors", "[driver]") {
+    SECTION("Build without file") {
+        CHECK_FALSE(parse_args({"build"}).has_value());
+    }
+
+    SECTION("Output without build") {
+        CHECK_FALSE(parse_args({"main.nico", "-o", "main"}).has_value());
+    }
+
+    SECTION("Missing output name") {
+        CHECK_FALSE(parse_args({"build", "main.nico", "-o"}).has_value());
+    }
+
+    SECTION("Bad optimization level") {
+        CHECK_FALSE(parse_args({"build", "main.nico", "-O9"}).has_value());
+    }
+
+    SECTION("Unknown option") {
+        CHECK_FALSE(parse_args({"--frobnicate"}).has_value());
+    }
+
+    SECTION("Empty CPU name") {
+        CHECK_FALSE(parse_args({"main.nico", "-mcpu="}).has_value());
+    }
+
+    SECTION("Serve with file") {
+        CHECK_FALSE(parse_args({"--serve", "main.nico"}).has_value());
+    }
+
+    SECTION("Client without file") {
+        CHECK_FALSE(parse_args({"--client"}).has_value());
+    }
+
+    SECTION("Two files") {
+        CHECK_FALSE(parse_args({"a.nico", "b.nico"}).has_value());
+    }
+}
+
+#ifdef NICO_IS_UNIX
+/**
+ * @brief Runs an executable and captures its standard output.
+ *
+ * @param path The path of the executable. It must not need quoting.
+ * @return The output of the executable.
+ */
+std::string run_executable(const std::string& path) {
+    std::string output;
+    FILE* pipe = popen(path.c_str(), "r");
+    REQUIRE(pipe != nullptr);
+    char buffer[256];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        output.append(buffer, n);
+    }
+    CHECK(pclose(pipe) == 0);
+    return output;
+}
+
+TEST_CASE("Build executable", "[driver]") {
+    auto dir = std::filesystem::temp_directory_path() /
+               ("nico-build-test-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    auto old_cwd = std::filesystem::current_path();
+    std::filesystem::current_path(dir);
+    std::ofstream("main.nico") << "printout \"Hello, build!\"\n";
+
+    SECTION("Shell characters in the output path") {
+        // None of these may be interpreted, since no shell is involved.
+        std::string output = "out $(touch injected) `touch injected2` $HOME";
+        auto options = parse_args({"build", "main.nico", "-o", output.c_str()});
+        REQUIRE(options.has_value());
+        nico::compile_and_build(*options);
+        CHECK(std::filesystem::exists(output));
+        CHECK_FALSE(std::filesystem::exists("injected"));
+        CHECK_FALSE(std::filesystem::exists("injected2"));
+        CHECK_FALSE(std::filesystem::exists(output + ".o"));
+    }
+
+    SECTION("Split across compile threads") {
+        // Enough functions that every part gets some, with calls and a global
+        // that cross parts.
+        std::string source = "let var total = 0\n"
+                             "func g0(x: i32) -> i32 => x\n";
+        for (int i = 1; i < 200; i++) {
+            source += "func g" + std::to_string(i) + "(x: i32) -> i32 => g" +
+                      std::to_string(i - 1) + "(x) + 1\n";
+        }
+        source += "total = g199(1)\n"
+                  "printout total, \" \", g100(0)\n";
+        std::ofstream("split.nico") << source;
+
+        auto single_options = parse_args({"build", "split.nico", "-o", "one"});
+        REQUIRE(single_options.has_value());
+        nico::compile_and_build(*single_options);
+
+        auto split_options = parse_args(
+            {"build", "split.nico", "-o", "four", "--compile-threads=4"}
+        );
+        REQUIRE(split_options.has_value());
+        nico::compile_and_build(*split_options);
+        CHECK_FALSE(std::filesystem::exists("four.o"));
+        CHECK_FALSE(std::filesystem::exists("four.3.o"));
+
+        std::string single_output = run_executable("./one");
+        CHECK(single_output == "200 100");
+        CHECK(run_executable("./four") == single_output);
+    }
+
+    SECTION("Split output that cannot be opened") {
+        // A directory in place of the third part makes opening it fail after
+        // the first two parts have been created.
+        std::filesystem::create_directory("blocked.2.o");
+        nico::Frontend frontend;
+        auto file = nico::make_test_code_file("printout \"Hello, build!\"\n");
+        std::unique_ptr<nico::FrontendContext>& context =
+            frontend.compile(file, false);
+        REQUIRE(IS_VARIANT(context->status, nico::Status::Ok));
+
+        nico::Emitter emitter;
+        auto paths = emitter.emit_split(context->mod_ctx, "blocked.o", 4);
+        CHECK_FALSE(paths.has_value());
+        CHECK_FALSE(std::filesystem::exists("blocked.o"));
+        CHECK_FALSE(std::filesystem::exists("blocked.1.o"));
+        CHECK_FALSE(std::filesystem::exists("blocked.3.o"));
+    }
+
+    std::filesystem::current_path(old_cwd);
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Compile server round trip", "[driver]") {
+    auto dir = std::filesystem::temp_directory_path() /
+               ("nico-server-test-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    auto socket_path = (dir / "server.sock").string();
+    auto input_path = (dir / "main.nico").string();
+    std::ofstream(input_path) << "printout \"Hello, server!\"\n";
+
+    std::string socket_arg = "--socket=" + socket_path;
+    auto server_options = parse_args({"--serve", socket_arg.c_str()});
+    REQUIRE(server_options.has_value());
+    pid_t server = fork();
+    REQUIRE(server >= 0);
+    if (server == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDERR_FILENO);
+        _exit(nico::serve(*server_options));
+    }
+
+    std::vector<const char*> argv = {
+        "nico",
+        "--client",
+        socket_arg.c_str(),
+        input_path.c_str()
+    };
+    auto client_options = nico::parse_driver_options(
+        static_cast<int>(argv.size()),
+        argv.data(),
+        std::cerr
+    );
+    REQUIRE(client_options.has_value());
+    auto run_client = [&]() {
+        return nico::run_on_server(
+            *client_options,
+            static_cast<int>(argv.size()),
+            argv.data()
+        );
+    };
+
+    // The server warms up before it listens, so wait for it.
+    std::optional<int> exit_code;
+    auto [out, _] = nico::capture_stdout([&]() {
+        for (int i = 0; i < 600 && !exit_code.has_value(); i++) {
+            exit_code = run_client();
+            if (!exit_code.has_value()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }
+    });
+    REQUIRE(exit_code.has_value());
+    CHECK(*exit_code == 0);
+    CHECK(out == "Hello, server!");
+
+    // The request's phase report is printed to the client's stderr.
+    std::vector<const char*> timed_argv = {
+        "nico",
+        "--client",
+        socket_arg.c_str(),
+        "--time-phases=json",
+        input_path.c_str()
+    };
+    std::optional<int> timed_exit_code;
+    auto [timed_out, timed_err] = nico::capture_stdout([&]() {
+        timed_exit_code = nico::run_on_server(
+            *client_options,
+            static_cast<int>(timed_argv.size()),
+            timed_argv.data()
+        );
+    });
+    REQUIRE(timed_exit_code.has_value());
+    CHECK(*timed_exit_code == 0);
+    CHECK(timed_out == "Hello, server!");
+    CHECK(timed_err.find("{\"phases\":[") != std::string::npos);
+
+    // A socket that other users could have replaced is not trusted.
+    chmod(socket_path.c_str(), 0666);
+    std::optional<int> untrusted_exit_code;
+    auto [untrusted_out, untrusted_err] = nico::capture_stdout([&]() {
+        untrusted_exit_code = run_client();
+    });
+    CHECK_FALSE(untrusted_exit_code.has_value());
+    CHECK(untrusted_out.empty());
+    CHECK(untrusted_err.find("not private") != std::string::npos);
+
+    kill(server, SIGTERM);
+    waitpid(server, nullptr, 0);
+    std::filesystem::remove_all(dir);
+}
+#endif
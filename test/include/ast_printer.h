@@ -1,7 +1,6 @@
 #ifndef NICO_AST_PRINTER_H
 #define NICO_AST_PRINTER_H
 
-#include <any>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,44 +16,45 @@ namespace nico {
  * This class does not need to be reset after use as it does not store any
  * state.
  */
-class AstPrinter : public Stmt::Visitor, public Expr::Visitor {
-    std::any visit(Stmt::Expression* stmt) override;
-    std::any visit(Stmt::Let* stmt) override;
-    std::any visit(Stmt::Static* stmt) override;
-    std::any visit(Stmt::Func* stmt) override;
-    std::any visit(Stmt::Print* stmt) override;
-    std::any visit(Stmt::Dealloc* stmt) override;
-    std::any visit(Stmt::Pass* stmt) override;
-    std::any visit(Stmt::Yield* stmt) override;
-    std::any visit(Stmt::Continue* stmt) override;
-    std::any visit(Stmt::Namespace* stmt) override;
-    std::any visit(Stmt::ExternBlock* stmt) override;
-    std::any visit(Stmt::TypeDef* stmt) override;
-    std::any visit(Stmt::StructDef* stmt) override;
-    std::any visit(Stmt::Field* stmt) override;
-    std::any visit(Stmt::Eof* stmt) override;
+class AstPrinter : public Stmt::Visitor<std::string>,
+                   public Expr::Visitor<std::string> {
+    std::string visit(Stmt::Expression* stmt) override;
+    std::string visit(Stmt::Let* stmt) override;
+    std::string visit(Stmt::Static* stmt) override;
+    std::string visit(Stmt::Func* stmt) override;
+    std::string visit(Stmt::Print* stmt) override;
+    std::string visit(Stmt::Dealloc* stmt) override;
+    std::string visit(Stmt::Pass* stmt) override;
+    std::string visit(Stmt::Yield* stmt) override;
+    std::string visit(Stmt::Continue* stmt) override;
+    std::string visit(Stmt::Namespace* stmt) override;
+    std::string visit(Stmt::ExternBlock* stmt) override;
+    std::string visit(Stmt::TypeDef* stmt) override;
+    std::string visit(Stmt::StructDef* stmt) override;
+    std::string visit(Stmt::Field* stmt) override;
+    std::string visit(Stmt::Eof* stmt) override;
 
-    std::any visit(Expr::Assign* expr, bool as_lvalue) override;
-    std::any visit(Expr::Logical* expr, bool as_lvalue) override;
-    std::any visit(Expr::Binary* expr, bool as_lvalue) override;
-    std::any visit(Expr::Unary* expr, bool as_lvalue) override;
-    std::any visit(Expr::Address* expr, bool as_lvalue) override;
-    std::any visit(Expr::Deref* expr, bool as_lvalue) override;
-    std::any visit(Expr::Cast* expr, bool as_lvalue) override;
-    std::any visit(Expr::Access* expr, bool as_lvalue) override;
-    std::any visit(Expr::Subscript* expr, bool as_lvalue) override;
-    std::any visit(Expr::Call* expr, bool as_lvalue) override;
-    std::any visit(Expr::SizeOf* expr, bool as_lvalue) override;
-    std::any visit(Expr::Alloc* expr, bool as_lvalue) override;
-    std::any visit(Expr::NewInst* expr, bool as_lvalue) override;
-    std::any visit(Expr::NameRef* expr, bool as_lvalue) override;
-    std::any visit(Expr::Literal* expr, bool as_lvalue) override;
-    std::any visit(Expr::Tuple* expr, bool as_lvalue) override;
-    std::any visit(Expr::Array* expr, bool as_lvalue) override;
-    std::any visit(Expr::Object* expr, bool as_lvalue) override;
-    std::any visit(Expr::Block* expr, bool as_lvalue) override;
-    std::any visit(Expr::Conditional* expr, bool as_lvalue) override;
-    std::any visit(Expr::Loop* expr, bool as_lvalue) override;
+    std::string visit(Expr::Assign* expr, bool as_lvalue) override;
+    std::string visit(Expr::Logical* expr, bool as_lvalue) override;
+    std::string visit(Expr::Binary* expr, bool as_lvalue) override;
+    std::string visit(Expr::Unary* expr, bool as_lvalue) override;
+    std::string visit(Expr::Address* expr, bool as_lvalue) override;
+    std::string visit(Expr::Deref* expr, bool as_lvalue) override;
+    std::string visit(Expr::Cast* expr, bool as_lvalue) override;
+    std::string visit(Expr::Access* expr, bool as_lvalue) override;
+    std::string visit(Expr::Subscript* expr, bool as_lvalue) override;
+    std::string visit(Expr::Call* expr, bool as_lvalue) override;
+    std::string visit(Expr::SizeOf* expr, bool as_lvalue) override;
+    std::string visit(Expr::Alloc* expr, bool as_lvalue) override;
+    std::string visit(Expr::NewInst* expr, bool as_lvalue) override;
+    std::string visit(Expr::NameRef* expr, bool as_lvalue) override;
+    std::string visit(Expr::Literal* expr, bool as_lvalue) override;
+    std::string visit(Expr::Tuple* expr, bool as_lvalue) override;
+    std::string visit(Expr::Array* expr, bool as_lvalue) override;
+    std::string visit(Expr::Object* expr, bool as_lvalue) override;
+    std::string visit(Expr::Block* expr, bool as_lvalue) override;
+    std::string visit(Expr::Conditional* expr, bool as_lvalue) override;
+    std::string visit(Expr::Loop* expr, bool as_lvalue) override;
 
 public:
     /**
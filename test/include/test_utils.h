@@ -30,8 +30,7 @@ std::shared_ptr<CodeFile> make_test_code_file(std::string_view src_code);
  * @param tokens The vector of tokens to extract token types from.
  * @return A vector of token types.
  */
-std::vector<Tok>
-extract_token_types(const std::vector<std::shared_ptr<Token>>& tokens);
+std::vector<Tok> extract_token_types(const std::vector<Token>& tokens);
 
 /**
  * @brief Captures output from C functions that normally print to stdout and
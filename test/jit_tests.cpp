@@ -1,15 +1,21 @@
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <llvm/Passes/OptimizationLevel.h>
 #include <llvm/Support/Error.h>
 
 #include "nico/backend/jit.h"
+#include "nico/backend/object_cache.h"
+#include "nico/backend/perf_map_listener.h"
 #include "nico/frontend/frontend.h"
 #include "nico/frontend/utils/frontend_context.h"
 #include "nico/shared/diagnostics.h"
@@ -49,6 +55,17 @@ struct JITTestOptions {
     bool print_ir = false;
     // Whether to print the stderr output of the JIT. Defaults to false.
     bool print_stderr_output = false;
+    // The optimization level to run the JIT at. Defaults to O0.
+    llvm::OptimizationLevel opt_level = llvm::OptimizationLevel::O0;
+    // Whether to use the lazy JIT, which compiles functions on first call.
+    // Defaults to false.
+    bool lazy_jit = false;
+    // The number of threads the JIT compiles on. Defaults to 0, which compiles
+    // on the calling thread.
+    unsigned num_compile_threads = 0;
+    // Whether to register JIT-compiled code with perf and GDB. Defaults to
+    // false.
+    bool enable_profiling = false;
 };
 
 /**
@@ -92,7 +109,18 @@ void run_jit_test(
                   << context->symbol_tree->to_tree_string() << "\n";
     }
 
-    auto jit = std::make_unique<nico::SimpleJIT>();
+    nico::JITOptions jit_options{
+        .opt_level = options.opt_level,
+        .num_compile_threads = options.num_compile_threads,
+        .enable_profiling = options.enable_profiling
+    };
+    std::unique_ptr<nico::SimpleJIT> jit;
+    if (options.lazy_jit) {
+        jit = std::make_unique<nico::LazyJIT>(jit_options);
+    }
+    else {
+        jit = std::make_unique<nico::SimpleJIT>(jit_options);
+    }
 
     auto jit_err = jit->add_module_and_context(std::move(context->mod_ctx));
     REQUIRE(!jit_err);
@@ -2034,3 +2062,381 @@ TEST_CASE("JIT struct declarations", "[jit]") {
         );
     }
 }
+
+TEST_CASE("JIT optimization levels", "[jit]") {
+    std::string_view source = R"(
+        func sum_to(n: i32) -> i32:
+            let var total = 0
+            let var i = 1
+            while i <= n:
+                total = total + i
+                i = i + 1
+            return total
+        printout sum_to(100)
+        )";
+
+    SECTION("O1") {
+        run_jit_test(
+            source,
+            JITTestOptions{
+                .expected_output = "5050",
+                .opt_level = llvm::OptimizationLevel::O1
+            }
+        );
+    }
+
+    SECTION("O2") {
+        run_jit_test(
+            source,
+            JITTestOptions{
+                .expected_output = "5050",
+                .opt_level = llvm::OptimizationLevel::O2
+            }
+        );
+    }
+
+    SECTION("O3") {
+        run_jit_test(
+            source,
+            JITTestOptions{
+                .expected_output = "5050",
+                .opt_level = llvm::OptimizationLevel::O3
+            }
+        );
+    }
+
+    SECTION("Bounds check panic at O2") {
+        run_jit_test(
+            R"(
+            let arr = [1, 2, 3]
+            let var i = 0
+            while i < 4:
+                printout arr[i]
+                i = i + 1
+            )",
+            JITTestOptions{
+                .expect_panic = true,
+                .opt_level = llvm::OptimizationLevel::O2
+            }
+        );
+    }
+}
+
+TEST_CASE("JIT object cache", "[jit]") {
+    auto cache_dir =
+        std::filesystem::temp_directory_path() / "nico_test_object_cache";
+    std::filesystem::remove_all(cache_dir);
+
+    std::string_view source = R"(printout "Hello, cache!")";
+
+    // The first run compiles and stores the object; the second loads it.
+    for (int run = 0; run < 2; run++) {
+        nico::Diagnostics::inst().reset();
+        auto file = nico::make_test_code_file(source);
+
+        nico::Frontend frontend;
+        std::unique_ptr<nico::FrontendContext>& context =
+            frontend.compile(file, false);
+        REQUIRE(IS_VARIANT(context->status, nico::Status::Ok));
+
+        context->mod_ctx.ir_module->setModuleIdentifier(
+            nico::ObjectFileCache::make_key(
+                *file,
+                false,
+                llvm::OptimizationLevel::O0,
+                *context->mod_ctx.target_machine
+            )
+        );
+        nico::ObjectFileCache cache(cache_dir.string());
+        CHECK(cache.contains(context->mod_ctx.ir_module.get()) == (run == 1));
+
+        auto jit = std::make_unique<nico::SimpleJIT>(
+            nico::JITOptions{.cache_dir = cache_dir.string()}
+        );
+        auto jit_err = jit->add_module_and_context(std::move(context->mod_ctx));
+        REQUIRE(!jit_err);
+
+        std::optional<llvm::Expected<int>> return_code;
+        auto [out, err] = nico::capture_stdout([&]() {
+            return_code = jit->run_main_func(0, nullptr, context->main_fn_name);
+        });
+        REQUIRE(return_code.has_value());
+        REQUIRE(return_code.value());
+        CHECK(out == "Hello, cache!");
+    }
+
+    std::filesystem::remove_all(cache_dir);
+}
+
+TEST_CASE("JIT object cache keys", "[jit]") {
+    std::string_view source = R"(printout 1 / 0)";
+    auto file = nico::make_test_code_file(source);
+    nico::Frontend frontend;
+    std::unique_ptr<nico::FrontendContext>& context =
+        frontend.compile(file, false);
+    REQUIRE(IS_VARIANT(context->status, nico::Status::Ok));
+    const auto& target_machine = *context->mod_ctx.target_machine;
+
+    auto key = nico::ObjectFileCache::make_key(
+        *file,
+        false,
+        llvm::OptimizationLevel::O0,
+        target_machine
+    );
+    CHECK(
+        nico::ObjectFileCache::make_key(
+            *nico::make_test_code_file(source),
+            false,
+            llvm::OptimizationLevel::O0,
+            target_machine
+        ) == key
+    );
+
+    // Panic messages name the file, so the same source at another path must
+    // not share an object.
+    auto moved =
+        std::make_shared<nico::CodeFile>(std::string(source), "/other.nico");
+    CHECK(
+        nico::ObjectFileCache::make_key(
+            *moved,
+            false,
+            llvm::OptimizationLevel::O0,
+            target_machine
+        ) != key
+    );
+    CHECK(
+        nico::ObjectFileCache::make_key(
+            *file,
+            true,
+            llvm::OptimizationLevel::O0,
+            target_machine
+        ) != key
+    );
+    CHECK(
+        nico::ObjectFileCache::make_key(
+            *file,
+            false,
+            llvm::OptimizationLevel::O2,
+            target_machine
+        ) != key
+    );
+    nico::Diagnostics::inst().reset();
+}
+
+TEST_CASE("JIT profiling", "[jit]") {
+    std::string map_path = nico::PerfMapListener::default_map_path();
+    std::filesystem::remove(map_path);
+
+    run_jit_test(
+        R"(
+        func add(x: i32, y: i32) -> i32 => x + y
+        printout add(1, 2)
+        )",
+        JITTestOptions{.expected_output = "3", .enable_profiling = true}
+    );
+
+    // Each line is "<start> <size> <name>".
+    std::ifstream map_file(map_path);
+    REQUIRE(map_file.is_open());
+    bool found_main = false;
+    std::string start, size, name;
+    while (map_file >> start >> size >> name) {
+        if (name == "main") {
+            found_main = true;
+        }
+    }
+    CHECK(found_main);
+
+    map_file.close();
+    std::filesystem::remove(map_path);
+}
+
+TEST_CASE("JIT REPL rolled back inputs", "[jit]") {
+    nico::Diagnostics::inst().reset();
+    nico::Diagnostics::inst().set_printing_enabled(false);
+    nico::Frontend frontend;
+
+    // Compiles an input the way the REPL does, returning a weak pointer to its
+    // file so that the test can tell whether the front end still keeps it.
+    auto compile = [&](std::string_view src, bool expect_ok) {
+        nico::Diagnostics::inst().reset();
+        auto file = nico::make_test_code_file(src);
+        auto& context = frontend.compile(file, true);
+        CHECK(IS_VARIANT(context->status, nico::Status::Ok) == expect_ok);
+        return std::weak_ptr<nico::CodeFile>(file);
+    };
+
+    auto compiled = compile("let x = 1", true);
+    auto parse_error = compile("let = 1", false);
+    auto check_error = compile("printout undefined_name", false);
+    CHECK_FALSE(check_error.expired());
+    compile("let y = x", true);
+
+    // Inputs that were rolled back are freed before the next input compiles.
+    CHECK_FALSE(compiled.expired());
+    CHECK(parse_error.expired());
+    CHECK(check_error.expired());
+
+    nico::Diagnostics::inst().reset();
+    nico::Diagnostics::inst().set_printing_enabled(true);
+}
+
+TEST_CASE("JIT lazy compilation", "[jit]") {
+    SECTION("Lazy print") {
+        run_jit_test(
+            R"(printout "Hello, World!")",
+            JITTestOptions{.expected_output = "Hello, World!", .lazy_jit = true}
+        );
+    }
+
+    SECTION("Lazy function calls") {
+        run_jit_test(
+            R"(
+            func add(x: i32, y: i32) -> i32 {
+                return x + y
+            }
+            func unused() -> i32 {
+                return 0
+            }
+            printout add(5, 10), ",", add(1, 2)
+            )",
+            JITTestOptions{.expected_output = "15,3", .lazy_jit = true}
+        );
+    }
+
+    SECTION("Lazy recursive function") {
+        run_jit_test(
+            R"(
+            func fact(n: i32) -> i32 => if n <= 1 then 1 else n * fact(n - 1)
+            printout fact(5)
+            )",
+            JITTestOptions{.expected_output = "120", .lazy_jit = true}
+        );
+    }
+
+    SECTION("Lazy at O2") {
+        run_jit_test(
+            R"(
+            func square(x: i32) -> i32 => x * x
+            printout square(7)
+            )",
+            JITTestOptions{
+                .expected_output = "49",
+                .opt_level = llvm::OptimizationLevel::O2,
+                .lazy_jit = true
+            }
+        );
+    }
+
+    SECTION("Lazy panic") {
+        run_jit_test(
+            R"(
+            let arr = [1, 2, 3]
+            printout arr[3]
+            )",
+            JITTestOptions{.expect_panic = true, .lazy_jit = true}
+        );
+    }
+}
+
+TEST_CASE("JIT concurrent compilation", "[jit]") {
+    SECTION("Small module on compile threads") {
+        run_jit_test(
+            R"(
+            func add(x: i32, y: i32) -> i32 {
+                return x + y
+            }
+            printout add(5, 10)
+            )",
+            JITTestOptions{.expected_output = "15", .num_compile_threads = 4}
+        );
+    }
+
+    SECTION("Split module") {
+        // Enough functions that the module is split into several parts, with
+        // calls crossing from one part to another.
+        std::string source = "func f0(x: i32) -> i32 => x\n";
+        for (int i = 1; i < 1000; i++) {
+            source += "func f" + std::to_string(i) + "(x: i32) -> i32 => f" +
+                      std::to_string(i - 1) + "(x) + 1\n";
+        }
+        source += "printout f999(0)";
+        run_jit_test(
+            source,
+            JITTestOptions{.expected_output = "999", .num_compile_threads = 4}
+        );
+    }
+
+    SECTION("Split module at O2") {
+        std::string source = "func f0(x: i32) -> i32 => x\n";
+        for (int i = 1; i < 1000; i++) {
+            source += "func f" + std::to_string(i) + "(x: i32) -> i32 => f" +
+                      std::to_string(i - 1) + "(x) + 1\n";
+        }
+        source += "printout f999(1)";
+        run_jit_test(
+            source,
+            JITTestOptions{
+                .expected_output = "1000",
+                .opt_level = llvm::OptimizationLevel::O2,
+                .num_compile_threads = 4
+            }
+        );
+    }
+
+    SECTION("Cached module on compile threads") {
+        // Large enough to be split, but a module with a cache key is compiled
+        // whole so that its object can be stored.
+        std::string source = "func f0(x: i32) -> i32 => x\n";
+        for (int i = 1; i < 1000; i++) {
+            source += "func f" + std::to_string(i) + "(x: i32) -> i32 => f" +
+                      std::to_string(i - 1) + "(x) + 1\n";
+        }
+        source += "printout f999(0)";
+        auto cache_dir = std::filesystem::temp_directory_path() /
+                         "nico_test_split_object_cache";
+        std::filesystem::remove_all(cache_dir);
+
+        for (int run = 0; run < 2; run++) {
+            nico::Diagnostics::inst().reset();
+            auto file = nico::make_test_code_file(source);
+
+            nico::Frontend frontend;
+            std::unique_ptr<nico::FrontendContext>& context =
+                frontend.compile(file, false);
+            REQUIRE(IS_VARIANT(context->status, nico::Status::Ok));
+
+            context->mod_ctx.ir_module->setModuleIdentifier(
+                nico::ObjectFileCache::make_key(
+                    *file,
+                    false,
+                    llvm::OptimizationLevel::O0,
+                    *context->mod_ctx.target_machine
+                )
+            );
+            nico::ObjectFileCache cache(cache_dir.string());
+            CHECK(
+                cache.contains(context->mod_ctx.ir_module.get()) == (run == 1)
+            );
+
+            auto jit = std::make_unique<nico::SimpleJIT>(nico::JITOptions{
+                .cache_dir = cache_dir.string(),
+                .num_compile_threads = 4
+            });
+            auto jit_err =
+                jit->add_module_and_context(std::move(context->mod_ctx));
+            REQUIRE(!jit_err);
+
+            std::optional<llvm::Expected<int>> return_code;
+            auto [out, err] = nico::capture_stdout([&]() {
+                return_code =
+                    jit->run_main_func(0, nullptr, context->main_fn_name);
+            });
+            REQUIRE(return_code.has_value());
+            REQUIRE(return_code.value());
+            CHECK(out == "999");
+        }
+
+        std::filesystem::remove_all(cache_dir);
+    }
+}
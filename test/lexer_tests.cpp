@@ -1,9 +1,11 @@
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
 #include "nico/frontend/components/lexer.h"
+#include "nico/frontend/utils/char_scan.h"
 #include "nico/frontend/utils/frontend_context.h"
 #include "nico/shared/diagnostics.h"
 #include "nico/shared/token.h"
@@ -386,6 +388,67 @@ TEST_CASE("Lexer basic keywords (run_lexer_test)", "[lexer]") {
              Tok::Eof}
         );
     }
+
+    SECTION("Words that resemble keywords") {
+        run_lexer_test(
+            "lets i iff nan6 inf_32 modules overloadedfns a_s _",
+            {Tok::Identifier,
+             Tok::Identifier,
+             Tok::Identifier,
+             Tok::Identifier,
+             Tok::Identifier,
+             Tok::Identifier,
+             Tok::Identifier,
+             Tok::Identifier,
+             Tok::Identifier,
+             Tok::Eof}
+        );
+    }
+
+    SECTION("Every keyword") {
+        run_lexer_test(
+            "static field func namespace extern struct typedef break continue "
+            "return yield pass dealloc printout mut block unsafe then else "
+            "loop while do for of with as is sizeof typeof transmute alloc "
+            "new nullptr void if",
+            {Tok::KwStatic,
+             Tok::KwField,
+             Tok::KwFunc,
+             Tok::KwNamespace,
+             Tok::KwExtern,
+             Tok::KwStruct,
+             Tok::KwTypedef,
+             Tok::KwBreak,
+             Tok::KwContinue,
+             Tok::KwReturn,
+             Tok::KwYield,
+             Tok::KwPass,
+             Tok::KwDealloc,
+             Tok::KwPrintout,
+             Tok::KwMut,
+             Tok::KwBlock,
+             Tok::KwUnsafe,
+             Tok::KwThen,
+             Tok::KwElse,
+             Tok::KwLoop,
+             Tok::KwWhile,
+             Tok::KwDo,
+             Tok::KwFor,
+             Tok::KwOf,
+             Tok::KwWith,
+             Tok::KwAs,
+             Tok::KwIs,
+             Tok::KwSizeof,
+             Tok::KwTypeof,
+             Tok::KwTransmute,
+             Tok::KwAlloc,
+             Tok::KwNew,
+             Tok::Nullptr,
+             Tok::Void,
+             Tok::KwIf,
+             Tok::Eof}
+        );
+    }
 }
 
 // TODO: Prior to test cleanup, Lexer number tests also checked that the literal
@@ -675,3 +738,281 @@ TEST_CASE("Lexer reserved word errors", "[lexer]") {
         run_lexer_error_test("overloadedfn", Err::WordIsReserved);
     }
 }
+
+TEST_CASE("Lexer token values", "[lexer]") {
+    auto context = std::make_unique<nico::FrontendContext>();
+
+    SECTION("Locations and lexemes") {
+        auto file = nico::make_test_code_file("let x\n  = 12");
+        nico::Lexer::scan(context, file);
+        const auto& tokens = context->scanned_tokens;
+        REQUIRE(tokens.size() == 5);
+        CHECK(tokens[3].lexeme == "12");
+        CHECK(tokens[3].location.file_id == file->id);
+        CHECK(tokens[3].location.line == 2);
+        CHECK(&tokens[3].location.file() == file.get());
+    }
+
+    SECTION("Str literal") {
+        auto file = nico::make_test_code_file(R"("a\tb")");
+        nico::Lexer::scan(context, file);
+        const auto& tokens = context->scanned_tokens;
+        REQUIRE(tokens.size() == 2);
+        REQUIRE(tokens[0].literal.get_kind() == nico::Literal::Kind::Str);
+        CHECK(tokens[0].literal.get<std::string>() == "a\tb");
+    }
+
+    SECTION("Tuple index") {
+        auto file = nico::make_test_code_file("t.3");
+        nico::Lexer::scan(context, file);
+        const auto& tokens = context->scanned_tokens;
+        REQUIRE(tokens.size() == 4);
+        CHECK(tokens[2].literal.get<size_t>() == 3);
+        CHECK_FALSE(tokens[0].literal.has_value());
+    }
+
+    context->initialize();
+    nico::Diagnostics::inst().reset();
+}
+
+TEST_CASE("Lexer parallel scanning", "[lexer]") {
+    // Each piece is repeated until the source is large enough to be split.
+    // Some contain lines at column 0 that are not safe split points.
+    auto make_source = [](std::string_view piece) {
+        std::string src;
+        while (src.size() < 512 * 1024) {
+            src += piece;
+        }
+        return src;
+    };
+    // Checks that the result matches a serial scan, and whether the file was
+    // split into chunks rather than scanned serially.
+    auto check_same_as_serial = [](const std::string& src, bool split) {
+        auto file = nico::make_test_code_file(src);
+        auto serial = std::make_unique<nico::FrontendContext>();
+        nico::Lexer::scan(serial, file);
+        auto serial_errors = nico::Diagnostics::inst().get_errors();
+        nico::Diagnostics::inst().reset();
+        nico::Diagnostics::inst().set_printing_enabled(false);
+
+        auto parallel = std::make_unique<nico::FrontendContext>();
+        size_t num_chunks = nico::Lexer::scan_parallel(parallel, file, 4);
+        CHECK((num_chunks > 1) == split);
+        CHECK(nico::Diagnostics::inst().get_errors() == serial_errors);
+        CHECK(parallel->status.index() == serial->status.index());
+
+        const auto& expected = serial->scanned_tokens;
+        const auto& tokens = parallel->scanned_tokens;
+        REQUIRE(tokens.size() == expected.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < tokens.size(); i++) {
+            if (tokens[i].tok_type != expected[i].tok_type ||
+                tokens[i].lexeme != expected[i].lexeme ||
+                tokens[i].location.start != expected[i].location.start ||
+                tokens[i].location.line != expected[i].location.line) {
+                mismatches++;
+            }
+        }
+        CHECK(mismatches == 0);
+        nico::Diagnostics::inst().reset();
+    };
+
+    SECTION("Blocks") {
+        check_same_as_serial(
+            make_source(
+                "func f(a: i32) -> i32:\n"
+                "    if a > 0:\n"
+                "        block:\n"
+                "            printout \"x\\n\"\n"
+                "    return a.0\n"
+                "\n"
+                "let x = 1\n"
+            ),
+            true
+        );
+    }
+
+    SECTION("Groupings across lines") {
+        check_same_as_serial(
+            make_source(
+                "let t = (\n"
+                "a,\n"
+                "b[\n"
+                "c]\n"
+                ")\n"
+            ),
+            true
+        );
+    }
+
+    SECTION("Comments") {
+        check_same_as_serial(
+            make_source(
+                "/* a\n"
+                "let x = 1 /* b\n"
+                "let y = 2 */\n"
+                "*/\n"
+                "let z = 3 // c\n"
+                "// d\n"
+            ),
+            true
+        );
+    }
+
+    SECTION("Errors") {
+        nico::Diagnostics::inst().set_printing_enabled(false);
+        std::string src = make_source("let x = (1,\n2)\n");
+        src += "let y = $\n";
+        src += make_source("let z = 3\n");
+        // A chunk finds the error, so the file is scanned again serially.
+        check_same_as_serial(src, false);
+    }
+
+    SECTION("Small files") {
+        check_same_as_serial("let x = 1\n", false);
+    }
+}
+
+TEST_CASE("Lexer REPL checkpoints", "[lexer]") {
+    // Feeds lines to the lexer the way the REPL does, then checks that the
+    // tokens match a scan of the whole input from the start.
+    auto check_same_as_full_scan = [](const std::vector<std::string>& lines) {
+        auto context = std::make_unique<nico::FrontendContext>();
+        std::string input;
+        // The inputs that were checkpointed, which should not be kept alive.
+        std::vector<std::weak_ptr<nico::CodeFile>> paused_files;
+        uint32_t last_file_id = 0;
+        for (const auto& line : lines) {
+            nico::Diagnostics::inst().reset();
+            input += line;
+            context->status = nico::Status::Ok();
+            auto file = nico::make_test_code_file(input);
+            last_file_id = file->id;
+            nico::Lexer::scan(context, file, true);
+            if (WITH_VARIANT(context->status, nico::Status::Pause, pause)) {
+                if (pause->request == nico::Request::Input) {
+                    // Checkpoints are only kept while there are no errors.
+                    CHECK(
+                        context->lexer_checkpoint.has_value() ==
+                        nico::Diagnostics::inst().get_errors().empty()
+                    );
+                    if (context->lexer_checkpoint.has_value()) {
+                        paused_files.push_back(file);
+                    }
+                    input += "\n";
+                }
+            }
+        }
+        for (const auto& paused_file : paused_files) {
+            CHECK(paused_file.expired());
+        }
+        auto resumed_errors = nico::Diagnostics::inst().get_errors();
+        nico::Diagnostics::inst().reset();
+
+        auto full = std::make_unique<nico::FrontendContext>();
+        nico::Lexer::scan(full, nico::make_test_code_file(input), true);
+        CHECK(nico::Diagnostics::inst().get_errors() == resumed_errors);
+        CHECK(context->status.index() == full->status.index());
+        CHECK_FALSE(context->lexer_checkpoint.has_value());
+
+        const auto& expected = full->scanned_tokens;
+        const auto& tokens = context->scanned_tokens;
+        REQUIRE(tokens.size() == expected.size());
+        for (size_t i = 0; i < tokens.size(); i++) {
+            CHECK(tokens[i].tok_type == expected[i].tok_type);
+            CHECK(tokens[i].lexeme == expected[i].lexeme);
+            CHECK(tokens[i].location.start == expected[i].location.start);
+            CHECK(tokens[i].location.line == expected[i].location.line);
+            CHECK(tokens[i].location.file_id == last_file_id);
+        }
+        nico::Diagnostics::inst().reset();
+    };
+
+    SECTION("Blocks") {
+        check_same_as_full_scan(
+            {"func f(a: i32) -> i32:",
+             "    if a > 0:",
+             "        block:",
+             "            return a",
+             "",
+             "    return 0",
+             ""}
+        );
+    }
+
+    SECTION("Groupings across lines") {
+        check_same_as_full_scan({"let t = (", "a,", "b[", "c]", ")"});
+    }
+
+    SECTION("Comments across lines") {
+        check_same_as_full_scan({"/* a", "/* b */", "c */ let x = 1"});
+    }
+
+    SECTION("Blank lines with spacing") {
+        check_same_as_full_scan({"block:", "    pass", "   ", "\t", ""});
+    }
+
+    SECTION("Error on an earlier line") {
+        nico::Diagnostics::inst().set_printing_enabled(false);
+        check_same_as_full_scan({"let x = (1,", "$,", "3)"});
+    }
+
+    SECTION("Input that does not continue the last input") {
+        auto context = std::make_unique<nico::FrontendContext>();
+        nico::Lexer::scan(context, nico::make_test_code_file("block:"), true);
+        REQUIRE(context->lexer_checkpoint.has_value());
+        context->status = nico::Status::Ok();
+        nico::Lexer::scan(context, nico::make_test_code_file("let x"), true);
+        CHECK(IS_VARIANT(context->status, nico::Status::Ok));
+        CHECK_FALSE(context->lexer_checkpoint.has_value());
+        CHECK(
+            nico::extract_token_types(context->scanned_tokens) ==
+            std::vector<Tok>{Tok::KwLet, Tok::Identifier, Tok::Eof}
+        );
+    }
+}
+
+TEST_CASE("Lexer character scanning", "[lexer]") {
+    using nico::char_scan::Isa;
+
+    // Runs of each kind of character, with lengths around the vector widths,
+    // followed by a stop character. Bytes above 0x7F must stop identifiers.
+    std::vector<std::string> inputs;
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 64, 100}) {
+        inputs.push_back(std::string(len, 'a') + "-tail");
+        inputs.push_back(std::string(len, 'Z') + "\xC3\xA9");
+        inputs.push_back(std::string(len, '_') + "9 ");
+        inputs.push_back(std::string(len, ' ') + "\tx");
+        inputs.push_back(std::string(len, '\t') + " x");
+        inputs.push_back(std::string(len, 'x') + "\"");
+        inputs.push_back(std::string(len, 'x') + "\\n");
+        inputs.push_back(std::string(len, 'x') + "*/");
+        inputs.push_back(std::string(len, 'x'));
+    }
+
+    auto scan_all = [&](Isa isa) {
+        nico::char_scan::set_isa(isa);
+        std::vector<size_t> results;
+        for (const auto& input : inputs) {
+            for (size_t pos = 0; pos <= input.size(); pos++) {
+                results.push_back(nico::char_scan::skip_identifier(input, pos));
+                results.push_back(nico::char_scan::skip_run(input, pos, ' '));
+                results.push_back(nico::char_scan::skip_run(input, pos, '\t'));
+                results.push_back(nico::char_scan::find_char(input, pos, '"'));
+                results.push_back(
+                    nico::char_scan::find_first_of(input, pos, '"', '\\', '\n')
+                );
+                results.push_back(
+                    nico::char_scan::find_first_of(input, pos, '/', '*', '\n')
+                );
+            }
+        }
+        return results;
+    };
+
+    Isa best = nico::char_scan::best_supported_isa();
+    auto expected = scan_all(Isa::Scalar);
+    CHECK(scan_all(Isa::SSE2) == expected);
+    CHECK(scan_all(Isa::AVX2) == expected);
+    nico::char_scan::set_isa(best);
+}
@@ -1,4 +1,5 @@
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
@@ -240,6 +241,18 @@ TEST_CASE("Parser numbers", "[parser]") {
         );
     }
 
+    SECTION("Long numbers") {
+        // Longer than the buffer the parser copies digits into.
+        std::string zeros(80, '0');
+        run_parser_expr_test(
+            zeros + "4_2; -" + zeros + "1_0; 0x" + zeros + "F_F",
+            {"(expr (lit i32 42))",
+             "(expr (lit i32 -10))",
+             "(expr (lit i32 255))",
+             "(stmt:eof)"}
+        );
+    }
+
     SECTION("Int 32 Max Plus One") {
         run_parser_expr_error_test(
             "2147483648", // One more than max int32_t
@@ -430,6 +443,30 @@ TEST_CASE("Parser expressions", "[parser]") {
         );
     }
 
+    SECTION("Left associativity") {
+        run_parser_expr_test(
+            "1 - 2 - 3; a / b % c; a or b or c",
+            {"(expr (binary - (binary - (lit i32 1) (lit i32 2)) (lit i32 "
+             "3)))",
+             "(expr (binary % (binary / (nameref a) (nameref b)) (nameref "
+             "c)))",
+             "(expr (logical or (logical or (nameref a) (nameref b)) "
+             "(nameref c)))",
+             "(stmt:eof)"}
+        );
+    }
+
+    SECTION("Mixed precedence") {
+        run_parser_expr_test(
+            "a = b or c and d == e < f + g * h",
+            {"(expr (assign (nameref a) (logical or (nameref b) (logical and "
+             "(nameref c) (binary == (nameref d) (binary < (nameref e) "
+             "(binary + (nameref f) (binary * (nameref g) (nameref "
+             "h)))))))))",
+             "(stmt:eof)"}
+        );
+    }
+
     SECTION("Assignment 1") {
         run_parser_expr_test(
             "a = 1",
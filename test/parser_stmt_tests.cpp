@@ -1,4 +1,5 @@
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
@@ -1213,3 +1214,84 @@ TEST_CASE("Parser modifiers linkage and symbol", "[parser]") {
         );
     }
 }
+
+TEST_CASE("Parser parallel parsing", "[parser]") {
+    // Each piece is repeated until the source is large enough to be split.
+    auto make_source = [](std::string_view piece) {
+        std::string src;
+        while (src.size() < 512 * 1024) {
+            src += piece;
+        }
+        return src;
+    };
+    auto check_same_as_serial = [](const std::string& src, bool has_errors) {
+        nico::Diagnostics::inst().set_printing_enabled(false);
+        auto file = nico::make_test_code_file(src);
+        auto serial = std::make_unique<nico::FrontendContext>();
+        nico::Lexer::scan(serial, file);
+        REQUIRE(IS_VARIANT(serial->status, nico::Status::Ok));
+        nico::Parser::parse(serial);
+        auto serial_errors = nico::Diagnostics::inst().get_errors();
+        CHECK(serial_errors.empty() != has_errors);
+        nico::Diagnostics::inst().reset();
+        nico::Diagnostics::inst().set_printing_enabled(false);
+
+        auto parallel = std::make_unique<nico::FrontendContext>();
+        nico::Lexer::scan(parallel, file);
+        nico::Parser::parse_parallel(parallel, 4);
+        CHECK(nico::Diagnostics::inst().get_errors() == serial_errors);
+        CHECK(parallel->status.index() == serial->status.index());
+
+        nico::AstPrinter printer;
+        CHECK(
+            printer.stmts_to_strings(parallel->stmts) ==
+            printer.stmts_to_strings(serial->stmts)
+        );
+        nico::Diagnostics::inst().reset();
+    };
+
+    SECTION("Declarations") {
+        check_same_as_serial(
+            make_source(
+                "namespace n:\n"
+                "    func f(a: i32) -> i32:\n"
+                "        let x = (a, [1, 2])\n"
+                "        yield a\n"
+                "struct S:\n"
+                "    field x: i32\n"
+                "extern ex:\n"
+                "    func g()\n"
+                "func h() => block { let y = 1; y }\n"
+                "let z = 1\n"
+            ),
+            false
+        );
+    }
+
+    SECTION("Modifiers") {
+        check_same_as_serial(
+            make_source(
+                "#[linkage(\"external\")]\n"
+                "func f() -> i32 => 42\n"
+                "#[symbol(\"s\")]\n"
+                "static var s: i32 = 1\n"
+                "let x = 1\n"
+            ),
+            false
+        );
+    }
+
+    SECTION("Errors") {
+        // Negations, number literals, and array sizes come before each error,
+        // in the chunks that are parsed again serially.
+        std::string valid = make_source(
+            "func f(a: i32) -> i32 => -a\n"
+            "let b: [i32; 2] = [-1, 2.5 as i32]\n"
+        );
+        check_same_as_serial(
+            valid + "let = 1\nfunc 5() => 1\n" + valid + "let a = 1 +\n" +
+                valid,
+            true
+        );
+    }
+}
@@ -26,14 +26,13 @@ std::shared_ptr<CodeFile> make_test_code_file(std::string_view src_code) {
     return file;
 }
 
-std::vector<Tok>
-extract_token_types(const std::vector<std::shared_ptr<Token>>& tokens) {
+std::vector<Tok> extract_token_types(const std::vector<Token>& tokens) {
     std::vector<Tok> token_types;
     std::transform(
         tokens.begin(),
         tokens.end(),
         std::back_inserter(token_types),
-        [](const auto& token) { return token->tok_type; }
+        [](const auto& token) { return token.tok_type; }
     );
     return token_types;
 }
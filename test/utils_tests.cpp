@@ -1,13 +1,30 @@
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include "nico/frontend/utils/token_store.h"
+#include "nico/shared/code_file.h"
 #include "nico/shared/dictionary.h"
+#include "nico/shared/phase_timer.h"
 #include "nico/shared/sets.h"
+#include "nico/shared/token.h"
 #include "nico/shared/utils.h"
 
+#if defined(__unix__) || defined(__unix) ||                                    \
+    (defined(__APPLE__) && defined(__MACH__))
+#include <sys/stat.h>
+#define NICO_IS_UNIX 1
+#endif
+
 TEST_CASE("Utility break message", "[utils]") {
     SECTION("Short sentence") {
         std::string_view message = "This is a short message.";
@@ -306,3 +323,219 @@ TEST_CASE("Utility dictionary", "[utils]") {
         REQUIRE(dict.get_index("date") == -1);
     }
 }
+
+TEST_CASE("Utility phase timer", "[utils]") {
+    auto& timer = nico::PhaseTimer::inst();
+    timer.reset();
+
+    SECTION("Disabled timer records nothing") {
+        timer.set_enabled(false);
+        {
+            auto phase = timer.scope("Lexer");
+        }
+        REQUIRE(timer.get_records().empty());
+    }
+
+    SECTION("Nested phases") {
+        timer.set_enabled(true);
+        {
+            auto outer = timer.scope("CodeGenerator");
+            auto inner = timer.scope("verify_ir");
+        }
+        {
+            auto phase = timer.scope("Optimizer");
+        }
+        timer.set_enabled(false);
+
+        auto records = timer.get_records();
+        REQUIRE(records.size() == 3);
+        CHECK(records[0].name == "CodeGenerator");
+        CHECK(records[0].depth == 0);
+        CHECK(records[1].name == "verify_ir");
+        CHECK(records[1].depth == 1);
+        CHECK(records[2].name == "Optimizer");
+        CHECK(records[2].depth == 0);
+        CHECK(records[0].wall_ms >= records[1].wall_ms);
+    }
+
+    SECTION("JSON output") {
+        timer.set_enabled(true);
+        {
+            auto phase = timer.scope("Parser");
+        }
+        timer.set_enabled(false);
+
+        std::ostringstream out;
+        timer.print_json(out);
+        std::string json = out.str();
+        CHECK(json.starts_with("{\"phases\":[{\"name\":\"Parser\","));
+        CHECK(json.find("\"depth\":0,") != std::string::npos);
+        CHECK(json.find("\"peak_rss_delta_kb\":") != std::string::npos);
+        CHECK(json.ends_with("}]}\n"));
+    }
+
+    timer.reset();
+}
+
+TEST_CASE("Utility code file line bounds", "[utils]") {
+    SECTION("Lines") {
+        nico::CodeFile file("ab\n\ncd\n", "test.nico");
+        using Bounds = std::pair<size_t, size_t>;
+        CHECK(file.get_line_bounds(0) == Bounds{0, 2});
+        CHECK(file.get_line_bounds(2) == Bounds{0, 2});
+        CHECK(file.get_line_bounds(3) == Bounds{3, 3});
+        CHECK(file.get_line_bounds(4) == Bounds{4, 6});
+        CHECK(file.get_line_bounds(6) == Bounds{4, 6});
+        CHECK(file.get_line_bounds(7) == Bounds{7, 7});
+    }
+
+    SECTION("No newlines") {
+        nico::CodeFile file("abc", "test.nico");
+        using Bounds = std::pair<size_t, size_t>;
+        CHECK(file.get_line_bounds(0) == Bounds{0, 3});
+        CHECK(file.get_line_bounds(3) == Bounds{0, 3});
+    }
+
+    SECTION("Location columns") {
+        nico::CodeFile file("let x\n  = 12", "test.nico");
+        nico::Location first(file.id, 4, 1, 1);
+        nico::Location second(file.id, 10, 2, 2);
+        CHECK(first.to_string() == "test.nico:1:5");
+        CHECK(second.to_string() == "test.nico:2:5");
+    }
+}
+
+TEST_CASE("Utility code file IDs", "[utils]") {
+    SECTION("Lookup while the table grows") {
+        auto first = std::make_shared<nico::CodeFile>("a", "first.nico");
+        uint32_t first_id = first->id;
+
+        // Look up a file on another thread while new files are registered.
+        std::atomic<bool> done = false;
+        std::atomic<bool> found_all = true;
+        std::thread reader([&]() {
+            while (!done) {
+                if (&nico::CodeFile::get(first_id) != first.get()) {
+                    found_all = false;
+                }
+            }
+        });
+        std::vector<std::shared_ptr<nico::CodeFile>> files;
+        for (int i = 0; i < 1000; i++) {
+            files.push_back(std::make_shared<nico::CodeFile>("b", "b.nico"));
+        }
+        done = true;
+        reader.join();
+        CHECK(found_all);
+
+        for (const auto& file : files) {
+            CHECK(&nico::CodeFile::get(file->id) == file.get());
+        }
+    }
+
+    SECTION("Reused IDs") {
+        auto file = std::make_unique<nico::CodeFile>("a", "a.nico");
+        uint32_t id = file->id;
+        file.reset();
+        auto next = std::make_unique<nico::CodeFile>("b", "b.nico");
+        CHECK(next->id == id);
+        CHECK(nico::CodeFile::get(id).path_string == "b.nico");
+    }
+}
+
+TEST_CASE("Utility read code file", "[utils]") {
+    auto dir = std::filesystem::temp_directory_path() / "nico_test_code_file";
+    std::filesystem::create_directories(dir);
+
+    SECTION("Mapped file") {
+        auto path = dir / "mapped.nico";
+        std::ofstream(path, std::ios::binary) << "let x = 1\nlet y = 2";
+        auto file = nico::read_code_file(path.string());
+        REQUIRE(file.has_value());
+        CHECK((*file)->src_code() == "let x = 1\nlet y = 2");
+        CHECK((*file)->path_string == std::filesystem::absolute(path).string());
+        using Bounds = std::pair<size_t, size_t>;
+        CHECK((*file)->get_line_bounds(12) == Bounds{10, 19});
+        nico::Token token(nico::Tok::Identifier, {(*file)->id, 14, 1, 2});
+        CHECK(token.lexeme == "y");
+    }
+
+    SECTION("Empty file") {
+        auto path = dir / "empty.nico";
+        std::ofstream(path, std::ios::binary);
+        auto file = nico::read_code_file(path.string());
+        REQUIRE(file.has_value());
+        CHECK((*file)->src_code().empty());
+    }
+
+    SECTION("Missing file") {
+        auto file = nico::read_code_file((dir / "missing.nico").string());
+        CHECK_FALSE(file.has_value());
+    }
+
+#ifdef NICO_IS_UNIX
+    SECTION("Pipe") {
+        // A pipe has no size, so it is read until EOF. The contents span
+        // several reads.
+        auto path = dir / "pipe.nico";
+        REQUIRE(mkfifo(path.c_str(), 0600) == 0);
+        std::string src_code;
+        for (int i = 0; i < 20000; i++) {
+            src_code += "let x" + std::to_string(i) + " = 1\n";
+        }
+        std::thread writer([&]() {
+            std::ofstream(path, std::ios::binary) << src_code;
+        });
+        auto file = nico::read_code_file(path.string());
+        writer.join();
+        REQUIRE(file.has_value());
+        CHECK((*file)->src_code() == src_code);
+    }
+#endif
+
+    SECTION("Too large file") {
+        // Locations store offsets in 32 bits, so 4 GiB is too large. The file
+        // is sparse, so it takes no space on disk.
+        auto path = dir / "large.nico";
+        std::ofstream(path, std::ios::binary);
+        std::filesystem::resize_file(path, nico::CodeFile::max_size + 1);
+        auto file = nico::read_code_file(path.string());
+        CHECK_FALSE(file.has_value());
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Utility token store release", "[utils]") {
+    nico::TokenStore store;
+    auto kept_file = std::make_shared<nico::CodeFile>("let x", "kept.nico");
+    store.add_file(kept_file);
+    const nico::Token* kept_token = store.add_token(
+        nico::Token(nico::Tok::KwLet, {kept_file->id, 0, 3, 1})
+    );
+    const std::string& kept_string = store.add_string("kept");
+    auto mark = store.mark();
+
+    auto released_file =
+        std::make_shared<nico::CodeFile>("let y", "released.nico");
+    std::weak_ptr<nico::CodeFile> released = released_file;
+    store.add_file(released_file);
+    released_file = nullptr;
+    store.add_tokens({nico::Token(nico::Tok::Eof, {0, 0, 0, 1})});
+    store.add_token(nico::Token(nico::Tok::KwLet, {0, 0, 3, 1}));
+    store.add_string("released");
+    store.add_nested_store().add_string("nested");
+    CHECK_FALSE(released.expired());
+
+    store.release(mark);
+    CHECK(released.expired());
+    CHECK(kept_token->tok_type == nico::Tok::KwLet);
+    CHECK(kept_token->lexeme == "let");
+    CHECK(kept_string == "kept");
+    auto after = store.mark();
+    CHECK(after.scans == 0);
+    CHECK(after.synthetic_tokens == 1);
+    CHECK(after.strings == 1);
+    CHECK(after.files == 1);
+    CHECK(after.nested_stores == 0);
+}